@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+#include <helper/accuracy.h>
+#include <helper/wtls.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+constexpr size_t sampleSize = 1024;
+
+void setUlpCounters(benchmark::State& state, const char* prefix, const UlpSummary& summary, size_t calls) {
+    std::string name(prefix);
+    state.counters[name + "MaxUlp"] = summary.max;
+    state.counters[name + "P50Ulp"] = summary.p50;
+    state.counters[name + "P99Ulp"] = summary.p99;
+    state.counters[name + "P999Ulp"] = summary.p999;
+    state.counters[name + "FailureRate"] = static_cast<double>(summary.failures) / calls;
+}
+
+}
+
+
+// Speed of each solver alongside its error against the high precision reference on the same sample,
+// one row per solver and input family, so the two can be read off as a speed/accuracy frontier.
+static void BM_QuadraticAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    PolynomialSample sample = generate_polynomials(accuracyCase, 2, sampleSize, 1);
+    double roots[2];
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            found += calculate_real_roots(sample.a[i], sample.b[i], sample.c[i], roots);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    setUlpCounters(state, "root", measure_quadratic_accuracy(sample).error, sampleSize);
+}
+BENCHMARK(BM_QuadraticAccuracy)->DenseRange(0, accuracyCaseCount - 1);
+
+
+static void BM_CubicAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    PolynomialSample sample = generate_polynomials(accuracyCase, 3, sampleSize, 2);
+    double roots[3];
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            found += calculate_real_roots(sample.a[i], sample.b[i], sample.c[i], sample.d[i], roots);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    setUlpCounters(state, "root", measure_cubic_accuracy(sample).error, sampleSize);
+}
+BENCHMARK(BM_CubicAccuracy)->DenseRange(0, accuracyCaseCount - 1);
+
+
+static void BM_QuarticAccuracy(benchmark::State& state) {
+    QuarticMethod method = static_cast<QuarticMethod>(state.range(0));
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(1));
+    PolynomialSample sample = generate_polynomials(accuracyCase, 4, sampleSize, 3);
+    double roots[4];
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            found += calculate_real_roots(method, sample.a[i], sample.b[i], sample.c[i], sample.d[i], sample.e[i], roots);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(std::string(toString(method)) + " " + toString(accuracyCase));
+    setUlpCounters(state, "root", measure_quartic_accuracy(method, sample).error, sampleSize);
+}
+BENCHMARK(BM_QuarticAccuracy)->ArgsProduct({
+    benchmark::CreateDenseRange(0, quarticMethodCount - 1, 1), benchmark::CreateDenseRange(0, accuracyCaseCount - 1, 1)
+});
+
+
+static void BM_WtlsAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    StatisticsSample sample = generate_statistics(accuracyCase, sampleSize, 4);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            double estimate = wtls_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i]);
+            sum += wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i], estimate);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    EstimatorAccuracyReport report = measure_wtls_accuracy(sample);
+    setUlpCounters(state, "estimate", report.estimate, sampleSize);
+    setUlpCounters(state, "variance", report.variance, sampleSize);
+}
+BENCHMARK(BM_WtlsAccuracy)->DenseRange(0, accuracyCaseCount - 1);
+
+
+// The fused estimate and variance against the pair above, with its variance also measured against the Hessian.
+static void BM_WtlsEstimateVarianceAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    StatisticsSample sample = generate_statistics(accuracyCase, sampleSize, 4);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            double estimate, variance;
+            wtls_estimate_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i], estimate, variance);
+            sum += variance;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    EstimatorAccuracyReport report = measure_wtls_estimate_variance_accuracy(sample);
+    setUlpCounters(state, "estimate", report.estimate, sampleSize);
+    setUlpCounters(state, "variance", report.variance, sampleSize);
+}
+BENCHMARK(BM_WtlsEstimateVarianceAccuracy)->DenseRange(0, accuracyCaseCount - 1);
+
+
+static void BM_DualWtlsAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    StatisticsSample sample = generate_statistics(accuracyCase, sampleSize, 4);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            double estimate = 0.0;
+            if (dual_wtls_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate) == EstimatorStatus::Ok) {
+                sum += dual_wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    EstimatorAccuracyReport report = measure_dual_wtls_accuracy(sample);
+    setUlpCounters(state, "estimate", report.estimate, sampleSize);
+    setUlpCounters(state, "variance", report.variance, sampleSize);
+}
+BENCHMARK(BM_DualWtlsAccuracy)->DenseRange(0, accuracyCaseCount - 1);
+
+
+// The approximate dual estimate after 0 to 3 Newton steps, against the same reference as the exact solve above.
+static void BM_DualWtlsApproximateAccuracy(benchmark::State& state) {
+    AccuracyCase accuracyCase = static_cast<AccuracyCase>(state.range(0));
+    int newtonSteps = static_cast<int>(state.range(1));
+    StatisticsSample sample = generate_statistics(accuracyCase, sampleSize, 4);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            double estimate = dual_wtls_approximate_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], newtonSteps);
+            sum += dual_wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sampleSize);
+    state.SetLabel(toString(accuracyCase));
+    EstimatorAccuracyReport report = measure_dual_wtls_approximate_accuracy(sample, newtonSteps);
+    setUlpCounters(state, "estimate", report.estimate, sampleSize);
+    setUlpCounters(state, "variance", report.variance, sampleSize);
+}
+BENCHMARK(BM_DualWtlsApproximateAccuracy)->ArgsProduct({
+    benchmark::CreateDenseRange(0, accuracyCaseCount - 1, 1), benchmark::CreateDenseRange(0, 3, 1)
+});
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <ApproximateDualVarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+constexpr size_t fleetSize = 1024;
+
+// Each cell has its own slope and an x to y variance ratio that wanders around its nominal one by up to spread times.
+template <typename Estimator>
+std::vector<Estimator> makeFleet(double spread) {
+    std::vector<Estimator> fleet(fleetSize, Estimator(1.0, 0.99, 10.0, 10.0));
+    for (size_t i = 0; i < fleetSize; ++i) {
+        double slope = 0.5 + 0.003 * i;
+        for (int m = 0; m < 100; ++m) {
+            double x = 1.0 + 0.01 * m;
+            double y = slope * x + 0.01 * (((i + 3) * (m + 7)) % 11) - 0.05;
+            double yVariance = 1e-3 * (1 + m % 3);
+            double wander = std::pow(spread, ((i * 13 + m * 7) % 17) / 16.0);
+            fleet[i].update(x, y, 4 * yVariance * wander, yVariance);
+        }
+    }
+    return fleet;
+}
+
+// Largest relative difference between the fleets' estimates, reported next to the approximate estimator's speed.
+double maxRelativeError(
+    std::vector<ApproximateDualVarianceWeightedTotalLeastSquares>& approximate, std::vector<DualVarianceWeightedTotalLeastSquares>& exact
+) {
+    double error = 0.0;
+    for (size_t i = 0; i < fleetSize; ++i) {
+        double expected = exact[i].getEstimate();
+        error = std::max(error, std::fabs(approximate[i].getEstimate() - expected) / std::fabs(expected));
+    }
+    return error;
+}
+
+}
+
+
+// Estimate of a fleet with 0 to 3 Newton steps, with variance ratios fixed (spread 1) or wandering 4 times.
+static void BM_AWTLSEstimate(benchmark::State& state) {
+    double spread = static_cast<double>(state.range(1));
+    std::vector<ApproximateDualVarianceWeightedTotalLeastSquares> fleet = makeFleet<ApproximateDualVarianceWeightedTotalLeastSquares>(spread);
+    for (ApproximateDualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+        estimator.setNewtonSteps(static_cast<int>(state.range(0)));
+    }
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (ApproximateDualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            sum += estimator.getEstimate();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> exact = makeFleet<DualVarianceWeightedTotalLeastSquares>(spread);
+    state.counters["maxRelativeError"] = maxRelativeError(fleet, exact);
+}
+BENCHMARK(BM_AWTLSEstimate)->ArgsProduct({{0, 1, 2, 3}, {1, 4}});
+
+
+// The exact estimate it replaces: a quartic solve and merit comparison per estimate.
+static void BM_AWTLSExactEstimate(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet = makeFleet<DualVarianceWeightedTotalLeastSquares>(static_cast<double>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (DualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            sum += estimator.getEstimate();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_AWTLSExactEstimate)->Arg(1)->Arg(4);
+
+
+// The batch kernels over statistics arrays.
+static void BM_AWTLSEstimateBatch(benchmark::State& state) {
+    std::vector<double> c1(fleetSize), c2(fleetSize), c3(fleetSize), c4(fleetSize), c5(fleetSize), c6(fleetSize);
+    for (size_t i = 0; i < fleetSize; ++i) {
+        double k = 0.5 + 0.003 * i;
+        c1[i] = 100.0;
+        c2[i] = 100.0 * k;
+        c3[i] = 100.0 * k * k + 0.1;
+        c4[i] = 50.0 + i % 7;
+        c5[i] = (50.0 + i % 7) * k;
+        c6[i] = (50.0 + i % 7) * k * k + 0.2;
+    }
+    std::vector<double> estimates(fleetSize), variances(fleetSize);
+    std::vector<EstimatorStatus> statuses(fleetSize);
+    bool approximate = state.range(0) != 0;
+    for (auto _ : state) {
+        if (approximate) {
+            dual_wtls_approximate_estimate_batch(
+                c1.data(), c2.data(), c3.data(), c4.data(), c5.data(), c6.data(), fleetSize, 3, estimates.data(), variances.data()
+            );
+        } else {
+            dual_wtls_estimate_batch(
+                c1.data(), c2.data(), c3.data(), c4.data(), c5.data(), c6.data(), fleetSize, estimates.data(), variances.data(), statuses.data()
+            );
+        }
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+    state.SetLabel(approximate ? "approximate" : "exact");
+}
+BENCHMARK(BM_AWTLSEstimateBatch)->Arg(0)->Arg(1);
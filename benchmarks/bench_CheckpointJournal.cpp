@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <CheckpointJournal.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+
+std::string benchPath(const char* name) {
+    return "/tmp/recursive-optimizers-bench-" + std::string(name) + "-" + std::to_string(getpid());
+}
+
+void removeJournal(const std::string& path) {
+    std::remove((path + ".base").c_str());
+    std::remove((path + ".journal").c_str());
+}
+
+}
+
+
+// One checkpoint of a fleet of state.range(0) estimators where one in state.range(1) was updated since the last.
+static void BM_JournalCheckpoint(benchmark::State& state) {
+    size_t cells = state.range(0);
+    size_t updateEvery = state.range(1);
+    std::string path = benchPath("checkpoint");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), cells, 1.0, false);
+
+    double y = 1.0;
+    size_t offset = 0;
+    size_t written = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        y += 1e-6;
+        for (size_t i = offset; i < cells; i += updateEvery) {
+            fleet[i].update(1.0, y, 1e-2, 1e-2);
+        }
+        offset = (offset + 1) % updateEvery;
+        state.ResumeTiming();
+        written += journal.checkpoint(fleet.data());
+    }
+    state.counters["bytesPerEstimator"] = static_cast<double>(journal.journalBytes()) / std::max<size_t>(1, written);
+    removeJournal(path);
+}
+BENCHMARK(BM_JournalCheckpoint)->Args({1 << 20, 100})->Args({1 << 20, 10000})->Unit(benchmark::kMillisecond);
+
+
+// Same as BM_JournalCheckpoint, but the caller passes the indices it updated so the fleet isn't scanned.
+static void BM_JournalCheckpointCandidates(benchmark::State& state) {
+    size_t cells = state.range(0);
+    size_t updateEvery = state.range(1);
+    std::string path = benchPath("candidates");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), cells, 1.0, false);
+
+    double y = 1.0;
+    size_t offset = 0;
+    std::vector<size_t> touched;
+    for (auto _ : state) {
+        state.PauseTiming();
+        y += 1e-6;
+        touched.clear();
+        for (size_t i = offset; i < cells; i += updateEvery) {
+            fleet[i].update(1.0, y, 1e-2, 1e-2);
+            touched.push_back(i);
+        }
+        offset = (offset + 1) % updateEvery;
+        state.ResumeTiming();
+        journal.checkpoint(fleet.data(), touched.data(), touched.size());
+    }
+    removeJournal(path);
+}
+BENCHMARK(BM_JournalCheckpointCandidates)->Args({1 << 20, 100})->Args({1 << 20, 10000})->Unit(benchmark::kMillisecond);
+
+
+// Baseline: a full snapshot of the same fleet every time.
+static void BM_FullSnapshot(benchmark::State& state) {
+    size_t cells = state.range(0);
+    std::string path = benchPath("snapshot");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), cells, 1.0, false);
+
+    for (auto _ : state) {
+        journal.compact(fleet.data());
+    }
+    removeJournal(path);
+}
+BENCHMARK(BM_FullSnapshot)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+// Startup: restore a fleet from a snapshot and 60 checkpoints of 1% of it.
+static void BM_JournalRecover(benchmark::State& state) {
+    size_t cells = 1 << 20;
+    std::string path = benchPath("recover");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+    {
+        CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), cells, 0, false);
+        for (int tick = 0; tick < 60; ++tick) {
+            for (size_t i = tick; i < cells; i += 100) {
+                fleet[i].update(1.0, 1.0 + tick * 1e-3, 1e-2, 1e-2);
+            }
+            journal.checkpoint(fleet.data());
+        }
+    }
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> recovered(cells, prototype);
+    for (auto _ : state) {
+        size_t records = CheckpointJournal<DualVarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), cells, state.range(0));
+        benchmark::DoNotOptimize(records);
+    }
+    removeJournal(path);
+}
+BENCHMARK(BM_JournalRecover)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
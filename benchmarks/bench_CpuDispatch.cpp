@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+#include <helper/cpuDispatch.h>
+#include <helper/roots.h>
+#include <helper/wtls.h>
+#include <vector>
+
+
+namespace {
+
+constexpr size_t kernelCount = 4096;
+
+// Runs a benchmark at the ISA level given as its argument, skipping levels this CPU lacks.
+bool enterLevel(benchmark::State& state) {
+    IsaLevel level = static_cast<IsaLevel>(state.range(0));
+    if (level > detected_isa_level()) {
+        state.SkipWithError("ISA level not supported by this CPU");
+        return false;
+    }
+    set_isa_level(level);
+    state.SetLabel(toString(level));
+    return true;
+}
+
+void leaveLevel() {
+    set_isa_level(detected_isa_level());
+}
+
+struct Statistics {
+    std::vector<double> c1, c2, c3, c4, c5, c6;
+
+    explicit Statistics(size_t count) : c1(count), c2(count), c3(count), c4(count), c5(count), c6(count) {
+        for (size_t i = 0; i < count; ++i) {
+            double k = 0.5 + 0.001 * (i % 1000);
+            this->c1[i] = 10.0;
+            this->c2[i] = 10.0 * k;
+            this->c3[i] = 10.0 * k * k + 0.1;
+            this->c4[i] = 20.0;
+            this->c5[i] = 20.0 * k;
+            this->c6[i] = 20.0 * k * k + 0.2;
+        }
+    }
+};
+
+}
+
+
+static void BM_RootsScalarVector(benchmark::State& state) {
+    Statistics s(kernelCount);
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < kernelCount; ++i) {
+            found += calculate_real_roots(s.c5[i], s.c4[i] - s.c1[i], s.c2[i], s.c1[i] - s.c3[i], -s.c2[i]).size();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+}
+BENCHMARK(BM_RootsScalarVector);
+
+
+// Only built generically, see calculate_real_roots_batch.
+static void BM_RootsBatch(benchmark::State& state) {
+    Statistics s(kernelCount);
+    std::vector<double> b(kernelCount), d(kernelCount), e(kernelCount), roots(4 * kernelCount);
+    std::vector<unsigned char> rootCounts(kernelCount);
+    for (size_t i = 0; i < kernelCount; ++i) {
+        b[i] = s.c4[i] - s.c1[i];
+        d[i] = s.c1[i] - s.c3[i];
+        e[i] = -s.c2[i];
+    }
+    for (auto _ : state) {
+        calculate_real_roots_batch(s.c5.data(), b.data(), s.c2.data(), d.data(), e.data(), kernelCount, roots.data(), rootCounts.data());
+        benchmark::DoNotOptimize(roots.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+}
+BENCHMARK(BM_RootsBatch);
+
+
+static void BM_WtlsUpdateBatch(benchmark::State& state) {
+    if (!enterLevel(state)) {
+        return;
+    }
+    Statistics s(kernelCount);
+    std::vector<double> forgettingFactor(kernelCount, 0.99), precision(kernelCount, 10.0);
+    for (auto _ : state) {
+        wtls_update_batch(
+            forgettingFactor.data(), s.c1.data(), s.c2.data(), s.c3.data(),
+            s.c4.data(), s.c5.data(), precision.data(), kernelCount
+        );
+        benchmark::DoNotOptimize(s.c1.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+    leaveLevel();
+}
+BENCHMARK(BM_WtlsUpdateBatch)->DenseRange(0, 2);
+
+
+static void BM_WtlsEstimateBatch(benchmark::State& state) {
+    if (!enterLevel(state)) {
+        return;
+    }
+    Statistics s(kernelCount);
+    std::vector<double> ratioSq(kernelCount, 1.0), estimates(kernelCount), variances(kernelCount);
+    for (auto _ : state) {
+        wtls_estimate_batch(s.c1.data(), s.c2.data(), s.c3.data(), ratioSq.data(), kernelCount, estimates.data(), variances.data());
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+    leaveLevel();
+}
+BENCHMARK(BM_WtlsEstimateBatch)->DenseRange(0, 2);
+
+
+// Estimate and closed form variance together, one square root per estimator.
+static void BM_WtlsEstimateVarianceBatch(benchmark::State& state) {
+    if (!enterLevel(state)) {
+        return;
+    }
+    Statistics s(kernelCount);
+    std::vector<double> ratioSq(kernelCount, 1.0), estimates(kernelCount), variances(kernelCount);
+    for (auto _ : state) {
+        wtls_estimate_variance_batch(s.c1.data(), s.c2.data(), s.c3.data(), ratioSq.data(), kernelCount, estimates.data(), variances.data());
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+    leaveLevel();
+}
+BENCHMARK(BM_WtlsEstimateVarianceBatch)->DenseRange(0, 2);
+
+
+static void BM_DualWtlsEstimateBatch(benchmark::State& state) {
+    Statistics s(kernelCount);
+    std::vector<double> estimates(kernelCount), variances(kernelCount);
+    std::vector<EstimatorStatus> statuses(kernelCount);
+    for (auto _ : state) {
+        dual_wtls_estimate_batch(
+            s.c1.data(), s.c2.data(), s.c3.data(), s.c4.data(), s.c5.data(), s.c6.data(),
+            kernelCount, estimates.data(), variances.data(), statuses.data()
+        );
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kernelCount);
+}
+BENCHMARK(BM_DualWtlsEstimateBatch);
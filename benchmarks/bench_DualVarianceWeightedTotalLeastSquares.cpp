@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+// Every other estimator has seen a zero variance measurement, so its quartic has no real roots.
+std::vector<DualVarianceWeightedTotalLeastSquares> makeFleet(size_t count, bool degenerate) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(count, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    for (size_t i = 0; i < count; ++i) {
+        if (degenerate && i % 2 == 0) {
+            fleet[i].update(1.0, 1.0, 0.0, 1.0);
+        } else {
+            fleet[i].update(1.0, 1.0 + 1e-3 * i, 1e-2, 1e-2);
+        }
+    }
+    return fleet;
+}
+
+}
+
+
+static void BM_DVWTLSEstimateThrowing(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet = makeFleet(state.range(0), state.range(1));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (DualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            try {
+                sum += estimator.getEstimate();
+            } catch (const std::domain_error&) {
+                sum += 1.0;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+BENCHMARK(BM_DVWTLSEstimateThrowing)->Args({1024, 0})->Args({1024, 1});
+
+
+static void BM_DVWTLSEstimateNonThrowing(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet = makeFleet(state.range(0), state.range(1));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (DualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            sum += estimator.tryGetEstimate().value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+BENCHMARK(BM_DVWTLSEstimateNonThrowing)->Args({1024, 0})->Args({1024, 1});
+
+
+static void BM_DVWTLSVarianceThrowing(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet = makeFleet(state.range(0), state.range(1));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (DualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            try {
+                sum += estimator.getVariance();
+            } catch (const std::domain_error&) {
+                sum += 1.0;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+BENCHMARK(BM_DVWTLSVarianceThrowing)->Args({1024, 0})->Args({1024, 1});
+
+
+static void BM_DVWTLSVarianceNonThrowing(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet = makeFleet(state.range(0), state.range(1));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (DualVarianceWeightedTotalLeastSquares& estimator : fleet) {
+            sum += estimator.tryGetVariance().value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+BENCHMARK(BM_DVWTLSVarianceNonThrowing)->Args({1024, 0})->Args({1024, 1});
+
+
+// Half of the parameter sets have an invalid forgetting factor.
+static void BM_DVWTLSConstructThrowing(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                fleet[i] = DualVarianceWeightedTotalLeastSquares(1.0, (i % 2 == 0) ? 0.0 : 1.0, 1.0, 1.0, 1.0);
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        benchmark::DoNotOptimize(fleet.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DVWTLSConstructThrowing)->Arg(1024);
+
+
+static void BM_DVWTLSConstructBatch(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(count);
+    std::vector<EstimatorStatus> statuses(count);
+    std::vector<double> nominal(count, 1.0);
+    std::vector<double> forgettingFactors(count);
+    std::vector<double> variances(count, 1.0);
+    std::vector<double> ratios(count, 1.0);
+    for (size_t i = 0; i < count; ++i) {
+        forgettingFactors[i] = (i % 2 == 0) ? 0.0 : 1.0;
+    }
+
+    for (auto _ : state) {
+        size_t created = DualVarianceWeightedTotalLeastSquares::createBatch(
+            nominal.data(), forgettingFactors.data(), variances.data(), variances.data(),
+            ratios.data(), count, fleet.data(), statuses.data()
+        );
+        benchmark::DoNotOptimize(created);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DVWTLSConstructBatch)->Arg(1024);
@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+#include <EstimatorPool.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+typedef DualVarianceWeightedTotalLeastSquares Estimator;
+
+const Estimator prototype(1.0, 0.99, 1.0, 1.0);
+
+// Each round a tenth of the population leaves, at random, and the same number joins.
+constexpr size_t churnDivisor = 10;
+
+struct PooledFleet {
+    EstimatorPool<Estimator> pool;
+    std::vector<EstimatorHandle> handles;
+
+    explicit PooledFleet(size_t count) : pool(count) {
+        for (size_t i = 0; i < count; ++i) {
+            this->handles.push_back(this->pool.create(prototype));
+        }
+    }
+
+    void churn(std::mt19937_64& generator) {
+        for (size_t i = 0; i < this->handles.size() / churnDivisor; ++i) {
+            size_t leaving = generator() % this->handles.size();
+            this->pool.destroy(this->handles[leaving]);
+            this->handles[leaving] = this->pool.create(prototype);
+        }
+    }
+};
+
+// The ownership the pool replaces: every estimator allocated on its own.
+struct OwnedFleet {
+    std::vector<std::unique_ptr<Estimator>> estimators;
+
+    explicit OwnedFleet(size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            this->estimators.push_back(std::unique_ptr<Estimator>(new Estimator(prototype)));
+        }
+    }
+
+    void churn(std::mt19937_64& generator) {
+        for (size_t i = 0; i < this->estimators.size() / churnDivisor; ++i) {
+            size_t leaving = generator() % this->estimators.size();
+            this->estimators[leaving].reset(new Estimator(prototype));
+        }
+    }
+};
+
+}
+
+
+// One round of churn: destroy and create a tenth of the fleet.
+static void BM_PoolChurn(benchmark::State& state) {
+    PooledFleet fleet(state.range(0));
+    std::mt19937_64 generator(1);
+    for (auto _ : state) {
+        fleet.churn(generator);
+        fleet.pool.compactIfFragmented();
+    }
+    state.SetItemsProcessed(state.iterations() * (state.range(0) / churnDivisor));
+}
+BENCHMARK(BM_PoolChurn)->Arg(1 << 14)->Arg(1 << 20);
+
+
+static void BM_UniquePtrChurn(benchmark::State& state) {
+    OwnedFleet fleet(state.range(0));
+    std::mt19937_64 generator(1);
+    for (auto _ : state) {
+        fleet.churn(generator);
+    }
+    state.SetItemsProcessed(state.iterations() * (state.range(0) / churnDivisor));
+}
+BENCHMARK(BM_UniquePtrChurn)->Arg(1 << 14)->Arg(1 << 20);
+
+
+// Updating every live estimator after many rounds of churn: a sequential pass over the compacted pool
+// against chasing pointers to estimators scattered over the heap.
+static void BM_PoolSequentialUpdate(benchmark::State& state) {
+    PooledFleet fleet(state.range(0));
+    std::mt19937_64 generator(2);
+    for (int round = 0; round < 20; ++round) {
+        fleet.churn(generator);
+    }
+    fleet.pool.compact();
+
+    for (auto _ : state) {
+        Estimator* estimators = fleet.pool.data();
+        for (size_t i = 0; i < fleet.pool.size(); ++i) {
+            estimators[i].update(1.0, 2.0, 1e-2, 1e-2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoolSequentialUpdate)->Arg(1 << 14)->Arg(1 << 20);
+
+
+static void BM_UniquePtrSequentialUpdate(benchmark::State& state) {
+    OwnedFleet fleet(state.range(0));
+    std::mt19937_64 generator(2);
+    for (int round = 0; round < 20; ++round) {
+        fleet.churn(generator);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < fleet.estimators.size(); ++i) {
+            fleet.estimators[i]->update(1.0, 2.0, 1e-2, 1e-2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UniquePtrSequentialUpdate)->Arg(1 << 14)->Arg(1 << 20);
+
+
+// Updating through stable handles (one indirection) without compacting.
+static void BM_PoolHandleUpdate(benchmark::State& state) {
+    PooledFleet fleet(state.range(0));
+    std::mt19937_64 generator(2);
+    for (int round = 0; round < 20; ++round) {
+        fleet.churn(generator);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < fleet.handles.size(); ++i) {
+            fleet.pool.update(fleet.handles[i], 1.0, 2.0, 1e-2, 1e-2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoolHandleUpdate)->Arg(1 << 14)->Arg(1 << 20);
+
+
+// Bulk creation from parameter arrays against allocating each estimator.
+static void BM_PoolCreateBatch(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<double> nominalValues(count, 1.0), forgettingFactors(count, 0.99), variances(count, 1.0), ratios(count, -1.0);
+    std::vector<EstimatorHandle> handles(count);
+    for (auto _ : state) {
+        EstimatorPool<Estimator> pool;
+        pool.createBatch(count, handles.data(), nullptr, nominalValues.data(), forgettingFactors.data(), variances.data(), variances.data(), ratios.data());
+        benchmark::DoNotOptimize(pool.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PoolCreateBatch)->Arg(1 << 14)->Arg(1 << 20);
+
+
+static void BM_UniquePtrCreate(benchmark::State& state) {
+    size_t count = state.range(0);
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<Estimator>> estimators;
+        for (size_t i = 0; i < count; ++i) {
+            estimators.push_back(std::unique_ptr<Estimator>(new Estimator(1.0, 0.99, 1.0, 1.0, -1.0)));
+        }
+        benchmark::DoNotOptimize(estimators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_UniquePtrCreate)->Arg(1 << 14)->Arg(1 << 20);
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <FixedPointVarianceWeightedTotalLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+namespace {
+
+constexpr size_t sampleCount = 4096;
+
+// Time stamp counter where the host has one, so results read as cycles like a microcontroller's cycle counter.
+inline uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+template <typename Fixed>
+struct FixedSamples {
+    std::vector<Fixed> x;
+    std::vector<Fixed> y;
+    std::vector<Fixed> yVariance;
+};
+
+template <typename Fixed>
+FixedSamples<Fixed> makeFixedSamples() {
+    FixedSamples<Fixed> samples;
+    for (size_t i = 0; i < sampleCount; ++i) {
+        double x = 0.5 + 0.001 * (i % 997);
+        samples.x.push_back(Fixed::fromDouble(x));
+        samples.y.push_back(Fixed::fromDouble(2.0 * x + 0.001 * ((i * 7919) % 13)));
+        samples.yVariance.push_back(Fixed::fromDouble(0.1 + 0.0001 * (i % 89)));
+    }
+    return samples;
+}
+
+template <typename Storage, int FractionBits>
+void updateFixed(benchmark::State& state) {
+    typedef FixedPoint<Storage, FractionBits> Fixed;
+    FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits> estimator(Fixed::one(), Fixed::one(), Fixed::fromDouble(0.99));
+    FixedSamples<Fixed> samples = makeFixedSamples<Fixed>();
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        uint64_t start = readCycles();
+        for (size_t i = 0; i < sampleCount; ++i) {
+            estimator.update(samples.x[i], samples.y[i], samples.yVariance[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+        cycles += readCycles() - start;
+    }
+    state.SetItemsProcessed(state.iterations() * sampleCount);
+    state.counters["cyclesPerUpdate"] = static_cast<double>(cycles) / (state.iterations() * sampleCount);
+}
+
+template <typename Storage, int FractionBits>
+void estimateFixed(benchmark::State& state) {
+    typedef FixedPoint<Storage, FractionBits> Fixed;
+    FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits> estimator(Fixed::one(), Fixed::one(), Fixed::fromDouble(0.99));
+    FixedSamples<Fixed> samples = makeFixedSamples<Fixed>();
+    for (size_t i = 0; i < 64; ++i) {
+        estimator.update(samples.x[i], samples.y[i], samples.yVariance[i]);
+    }
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        uint64_t start = readCycles();
+        benchmark::DoNotOptimize(estimator);
+        benchmark::DoNotOptimize(estimator.getEstimate());
+        benchmark::DoNotOptimize(estimator.getVariance());
+        cycles += readCycles() - start;
+    }
+    state.counters["cyclesPerEstimate"] = static_cast<double>(cycles) / state.iterations();
+}
+
+}
+
+
+// Update with a variance (one Newton reciprocal) against the double precision estimator's division.
+static void BM_FixedPointUpdate_Q16(benchmark::State& state) {
+    updateFixed<int32_t, 16>(state);
+}
+BENCHMARK(BM_FixedPointUpdate_Q16);
+
+
+static void BM_FixedPointUpdate_Q8(benchmark::State& state) {
+    updateFixed<int16_t, 8>(state);
+}
+BENCHMARK(BM_FixedPointUpdate_Q8);
+
+
+static void BM_DoubleUpdate(benchmark::State& state) {
+    VarianceWeightedTotalLeastSquares estimator(1.0, 1.0, 0.99);
+    FixedSamples<FixedPoint<int32_t, 16>> samples = makeFixedSamples<FixedPoint<int32_t, 16>>();
+    std::vector<double> x, y, yVariance;
+    for (size_t i = 0; i < sampleCount; ++i) {
+        x.push_back(samples.x[i].toDouble());
+        y.push_back(samples.y[i].toDouble());
+        yVariance.push_back(samples.yVariance[i].toDouble());
+    }
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        uint64_t start = readCycles();
+        for (size_t i = 0; i < sampleCount; ++i) {
+            estimator.update(x[i], y[i], yVariance[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+        cycles += readCycles() - start;
+    }
+    state.SetItemsProcessed(state.iterations() * sampleCount);
+    state.counters["cyclesPerUpdate"] = static_cast<double>(cycles) / (state.iterations() * sampleCount);
+}
+BENCHMARK(BM_DoubleUpdate);
+
+
+// Closed form estimate and variance: integer square root and reciprocals against the floating point ones.
+static void BM_FixedPointEstimate_Q16(benchmark::State& state) {
+    estimateFixed<int32_t, 16>(state);
+}
+BENCHMARK(BM_FixedPointEstimate_Q16);
+
+
+static void BM_FixedPointEstimate_Q8(benchmark::State& state) {
+    estimateFixed<int16_t, 8>(state);
+}
+BENCHMARK(BM_FixedPointEstimate_Q8);
+
+
+static void BM_DoubleEstimate(benchmark::State& state) {
+    VarianceWeightedTotalLeastSquares estimator(1.0, 1.0, 0.99);
+    for (size_t i = 0; i < 64; ++i) {
+        double x = 0.5 + 0.001 * i;
+        estimator.update(x, 2.0 * x, 0.1);
+    }
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        uint64_t start = readCycles();
+        benchmark::DoNotOptimize(estimator);
+        benchmark::DoNotOptimize(estimator.getEstimate());
+        benchmark::DoNotOptimize(estimator.getVariance());
+        cycles += readCycles() - start;
+    }
+    state.counters["cyclesPerEstimate"] = static_cast<double>(cycles) / state.iterations();
+}
+BENCHMARK(BM_DoubleEstimate);
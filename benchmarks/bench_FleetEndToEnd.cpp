@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <FleetLoadGenerator.h>
+#include <IngestPipeline.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <chrono>
+#include <vector>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const DualVarianceWeightedTotalLeastSquares prototype(3.5, 0.9999, 100.0, 100.0);
+
+// Pregenerated so the benchmark times the estimators, not the generator.
+struct Ticks {
+    std::vector<uint32_t> cells;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> xVariance;
+    std::vector<double> yVariance;
+
+    Ticks(size_t fleet, size_t ticks) {
+        FleetLoadConfig config;
+        config.cells = fleet;
+        size_t count = fleet * ticks;
+        cells.resize(count);
+        x.resize(count);
+        y.resize(count);
+        xVariance.resize(count);
+        yVariance.resize(count);
+        FleetLoadGenerator(config).next(count, cells.data(), x.data(), y.data(), xVariance.data(), yVariance.data());
+    }
+};
+
+}
+
+
+// Generator throughput, so it can be checked to be far faster than the estimators it feeds.
+static void BM_FleetLoadGenerator(benchmark::State& state) {
+    FleetLoadConfig config;
+    FleetLoadGenerator generator(config);
+    const size_t count = 1 << 16;
+    std::vector<uint32_t> cells(count);
+    std::vector<double> x(count), y(count), xVariance(count), yVariance(count);
+
+    for (auto _ : state) {
+        generator.next(count, cells.data(), x.data(), y.data(), xVariance.data(), yVariance.data());
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FleetLoadGenerator);
+
+
+// One iteration: construct a fleet of state.range(0) cells, apply 8 ticks of measurements and read every
+// cell's estimate and variance. Reports samples/s, percentiles of sampled update and read latencies and
+// bytes per estimator.
+static void BM_FleetEndToEnd(benchmark::State& state) {
+    size_t fleetSize = state.range(0);
+    const size_t ticks = 8;
+    Ticks stream(fleetSize, ticks);
+    size_t count = stream.cells.size();
+
+    std::vector<double> updateLatencies;
+    std::vector<double> readLatencies;
+    for (auto _ : state) {
+        std::vector<DualVarianceWeightedTotalLeastSquares> fleet(fleetSize, prototype);
+        for (size_t i = 0; i < count; ++i) {
+            IngestRecord record = {stream.cells[i], stream.x[i], stream.y[i], stream.xVariance[i], stream.yVariance[i]};
+            if (i % 256 == 0) {
+                Clock::time_point begin = Clock::now();
+                applyIngestRecord(fleet[record.estimatorId], record);
+                updateLatencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - begin).count());
+            } else {
+                applyIngestRecord(fleet[record.estimatorId], record);
+            }
+        }
+
+        double sum = 0;
+        for (size_t cell = 0; cell < fleetSize; ++cell) {
+            Clock::time_point begin = Clock::now();
+            sum += fleet[cell].tryGetEstimate().value + fleet[cell].tryGetVariance().value;
+            if (cell % 16 == 0) {
+                readLatencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - begin).count());
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    LatencySummary update = summarize_latencies(updateLatencies);
+    LatencySummary read = summarize_latencies(readLatencies);
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(count) * state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["update_p50_ns"] = update.p50;
+    state.counters["update_p99_ns"] = update.p99;
+    state.counters["update_p999_ns"] = update.p999;
+    state.counters["read_p50_ns"] = read.p50;
+    state.counters["read_p99_ns"] = read.p99;
+    state.counters["read_p999_ns"] = read.p999;
+    state.counters["bytesPerEstimator"] = sizeof(DualVarianceWeightedTotalLeastSquares);
+}
+BENCHMARK(BM_FleetEndToEnd)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <FleetExecutor.h>
+#include <vector>
+
+
+// state.range(0) estimators, state.range(1) threads. Every 16th estimator sees a large jump
+// so the fleet mixes cheap and expensive root solves.
+static void BM_FleetExecutorDualTick(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(count, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    std::vector<double> x(count), y(count), xVariance(count, 1e-2), yVariance(count, 1e-2);
+    std::vector<double> estimates(count), variances(count);
+    std::vector<EstimatorStatus> statuses(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + 1e-6 * i;
+        y[i] = (i % 16 == 0) ? -50.0 * x[i] : 2.0 * x[i];
+    }
+
+    FleetExecutor executor(state.range(1), true);
+    for (auto _ : state) {
+        executor.updateAndEstimate(fleet.data(), count, x.data(), y.data(), xVariance.data(), yVariance.data(),
+                                   estimates.data(), variances.data(), statuses.data());
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FleetExecutorDualTick)
+    ->ArgsProduct({{1 << 20}, {1, 2, 4, 8, 16, 32, 64}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+
+static void BM_FleetExecutorVWTLSTick(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(count);
+    std::vector<double> x(count, 1.0), y(count, 2.0), yVariance(count, 1e-2);
+    std::vector<double> estimates(count), variances(count);
+
+    FleetExecutor executor(state.range(1), true);
+    for (auto _ : state) {
+        executor.updateAndEstimate(fleet.data(), count, x.data(), y.data(), yVariance.data(),
+                                   estimates.data(), variances.data(), nullptr);
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FleetExecutorVWTLSTick)
+    ->ArgsProduct({{1 << 20}, {1, 2, 4, 8, 16, 32, 64}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
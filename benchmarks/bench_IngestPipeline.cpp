@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <IngestPipeline.h>
+#include <thread>
+#include <vector>
+
+
+// state.range(0) producers and state.range(0) shards push state.range(1) records each.
+static void BM_IngestPipelineThroughput(benchmark::State& state) {
+    unsigned int threads = state.range(0);
+    size_t records = state.range(1);
+    const size_t estimators = 1 << 16;
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(estimators);
+
+    for (auto _ : state) {
+        IngestPipeline<VarianceWeightedTotalLeastSquares> pipeline(fleet.data(), fleet.size(), threads, threads);
+        pipeline.start();
+
+        std::vector<std::thread> readers;
+        for (unsigned int p = 0; p < threads; ++p) {
+            readers.emplace_back([&pipeline, p, records, estimators]() {
+                IngestPipeline<VarianceWeightedTotalLeastSquares>::Producer& producer = pipeline.getProducer(p);
+                size_t id = p;
+                for (size_t i = 0; i < records; ++i) {
+                    id = (id * 2654435761u + 1) % estimators;
+                    producer.push({id, 1.0, 2.0, 0.0, 1e-2});
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        pipeline.stop();
+    }
+    state.SetItemsProcessed(state.iterations() * threads * records);
+}
+BENCHMARK(BM_IngestPipelineThroughput)
+    ->ArgsProduct({{1, 2, 4, 8}, {1 << 20}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+
+// Baseline: the same records applied directly from one thread.
+static void BM_IngestSerialUpdate(benchmark::State& state) {
+    size_t records = state.range(0);
+    const size_t estimators = 1 << 16;
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(estimators);
+
+    for (auto _ : state) {
+        size_t id = 0;
+        for (size_t i = 0; i < records; ++i) {
+            id = (id * 2654435761u + 1) % estimators;
+            fleet[id].update(1.0, 2.0, 1e-2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * records);
+}
+BENCHMARK(BM_IngestSerialUpdate)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <LazyEstimatorBank.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+
+}
+
+
+// One tick: every cell is updated, one in state.range(1) cells is read.
+static void BM_EagerFleetTick(benchmark::State& state) {
+    size_t cells = state.range(0);
+    size_t readEvery = state.range(1);
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+    std::vector<double> estimates(cells);
+    std::vector<double> variances(cells);
+
+    double y = 1.0;
+    for (auto _ : state) {
+        y += 1e-6;
+        for (size_t i = 0; i < cells; ++i) {
+            fleet[i].update(1.0, y, 1e-2, 1e-2);
+            estimates[i] = fleet[i].tryGetEstimate().value;
+            variances[i] = fleet[i].tryGetVariance().value;
+        }
+        double sum = 0.0;
+        for (size_t i = 0; i < cells; i += readEvery) {
+            sum += estimates[i] + variances[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * cells);
+}
+BENCHMARK(BM_EagerFleetTick)->Args({4096, 1})->Args({4096, 100});
+
+
+static void BM_LazyFleetTick(benchmark::State& state) {
+    size_t cells = state.range(0);
+    size_t readEvery = state.range(1);
+    LazyEstimatorBank<DualVarianceWeightedTotalLeastSquares> bank(cells, prototype);
+
+    double y = 1.0;
+    for (auto _ : state) {
+        y += 1e-6;
+        for (size_t i = 0; i < cells; ++i) {
+            bank.update(i, 1.0, y, 1e-2, 1e-2);
+        }
+        double sum = 0.0;
+        for (size_t i = 0; i < cells; i += readEvery) {
+            sum += bank.getEstimate(i).value + bank.getVariance(i).value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * cells);
+}
+BENCHMARK(BM_LazyFleetTick)->Args({4096, 1})->Args({4096, 100});
+
+
+// Every cell is updated, then the dirty ones are recomputed across state.range(1) threads.
+static void BM_LazyRecomputeDirty(benchmark::State& state) {
+    size_t cells = state.range(0);
+    LazyEstimatorBank<DualVarianceWeightedTotalLeastSquares> bank(cells, prototype);
+
+    double y = 1.0;
+    for (auto _ : state) {
+        y += 1e-6;
+        for (size_t i = 0; i < cells; ++i) {
+            bank.update(i, 1.0, y, 1e-2, 1e-2);
+        }
+        bank.recomputeDirty(state.range(1));
+    }
+    state.SetItemsProcessed(state.iterations() * cells);
+}
+BENCHMARK(BM_LazyRecomputeDirty)->Args({65536, 1})->Args({65536, 4})->UseRealTime();
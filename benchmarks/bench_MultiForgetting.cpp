@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <MultiForgettingVarianceWeightedTotalLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+// Forgetting factors spread from no forgetting down to a memory of about ten samples.
+std::vector<double> spreadForgettingFactors(size_t count) {
+    std::vector<double> forgettingFactors(count);
+    for (size_t k = 0; k < count; ++k) {
+        forgettingFactors[k] = 1.0 - 0.1 * k / count;
+    }
+    return forgettingFactors;
+}
+
+}
+
+
+// One update of the bank (shared increments, scores and statistics of every hypothesis), per hypothesis.
+static void BM_MultiForgettingUpdate(benchmark::State& state) {
+    size_t hypotheses = state.range(0);
+    MultiForgettingVarianceWeightedTotalLeastSquares estimator(spreadForgettingFactors(hypotheses), 1.0, 1.0, 100.0, 0.99);
+    double x = 1.0;
+    for (auto _ : state) {
+        x = (x > 2.0) ? 1.0 : x + 0.001;
+        estimator.update(x, 3.6 * x, 0.01);
+    }
+    state.SetItemsProcessed(state.iterations() * hypotheses);
+}
+BENCHMARK(BM_MultiForgettingUpdate)->RangeMultiplier(2)->Range(1, 64);
+
+
+// The same hypotheses as separate estimators, updated without scoring.
+static void BM_SeparateForgettingUpdate(benchmark::State& state) {
+    size_t hypotheses = state.range(0);
+    std::vector<VarianceWeightedTotalLeastSquares> estimators;
+    for (double forgettingFactor : spreadForgettingFactors(hypotheses)) {
+        estimators.push_back(VarianceWeightedTotalLeastSquares(1.0, 1.0, forgettingFactor, 100.0));
+    }
+    double x = 1.0;
+    for (auto _ : state) {
+        x = (x > 2.0) ? 1.0 : x + 0.001;
+        for (size_t k = 0; k < hypotheses; ++k) {
+            estimators[k].update(x, 3.6 * x, 0.01);
+        }
+        benchmark::DoNotOptimize(estimators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * hypotheses);
+}
+BENCHMARK(BM_SeparateForgettingUpdate)->RangeMultiplier(2)->Range(1, 64);
+
+
+// Separate estimators scored the way the bank scores them, estimating each one every sample.
+static void BM_SeparateForgettingScoredUpdate(benchmark::State& state) {
+    size_t hypotheses = state.range(0);
+    std::vector<VarianceWeightedTotalLeastSquares> estimators;
+    for (double forgettingFactor : spreadForgettingFactors(hypotheses)) {
+        estimators.push_back(VarianceWeightedTotalLeastSquares(1.0, 1.0, forgettingFactor, 100.0));
+    }
+    std::vector<double> scores(hypotheses, 0.0);
+    double x = 1.0;
+    for (auto _ : state) {
+        x = (x > 2.0) ? 1.0 : x + 0.001;
+        double y = 3.6 * x;
+        for (size_t k = 0; k < hypotheses; ++k) {
+            double estimate = estimators[k].getEstimate();
+            double spread = 1 + estimate * estimate;
+            double residual = y - estimate * x;
+            scores[k] = 0.99 * scores[k] - 0.5 * std::log(spread) - 50.0 * residual * residual / spread;
+            estimators[k].update(x, y, 0.01);
+        }
+        benchmark::DoNotOptimize(scores.data());
+        benchmark::DoNotOptimize(estimators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * hypotheses);
+}
+BENCHMARK(BM_SeparateForgettingScoredUpdate)->RangeMultiplier(2)->Range(1, 64);
+
+
+// Picking and blending: every hypothesis's estimate and variance, and the weights.
+static void BM_MultiForgettingBlend(benchmark::State& state) {
+    size_t hypotheses = state.range(0);
+    MultiForgettingVarianceWeightedTotalLeastSquares estimator(spreadForgettingFactors(hypotheses), 1.0, 1.0, 100.0, 0.99);
+    for (int i = 0; i < 100; ++i) {
+        double x = 1.0 + 0.01 * i;
+        estimator.update(x, 3.6 * x, 0.01);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(estimator.tryGetBlendedEstimate());
+        benchmark::DoNotOptimize(estimator.tryGetBlendedVariance());
+    }
+    state.SetItemsProcessed(state.iterations() * hypotheses);
+}
+BENCHMARK(BM_MultiForgettingBlend)->RangeMultiplier(2)->Range(1, 64);
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <MultiOutputDualVarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+struct Outputs {
+    std::vector<double> y;
+    std::vector<double> yVariance;
+
+    explicit Outputs(size_t count) : y(count), yVariance(count) {
+        for (size_t k = 0; k < count; ++k) {
+            this->y[k] = 3.6 + 0.001 * (k % 97);
+            this->yVariance[k] = 1e-4 * (1 + k % 3);
+        }
+    }
+};
+
+}
+
+
+static void BM_MultiOutputUpdate(benchmark::State& state) {
+    size_t outputs = state.range(0);
+    Outputs data(outputs);
+    MultiOutputDualVarianceWeightedTotalLeastSquares estimator(outputs, 1.0, 0.999, 100.0, 100.0, 1.0);
+    double x = 1.0;
+    for (auto _ : state) {
+        x = (x > 2.0) ? 1.0 : x + 0.001;
+        estimator.update(x, 0.01, data.y.data(), data.yVariance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * outputs);
+}
+BENCHMARK(BM_MultiOutputUpdate)->RangeMultiplier(2)->Range(8, 1024);
+
+
+static void BM_IndependentUpdate(benchmark::State& state) {
+    size_t outputs = state.range(0);
+    Outputs data(outputs);
+    std::vector<DualVarianceWeightedTotalLeastSquares> estimators(
+        outputs, DualVarianceWeightedTotalLeastSquares(1.0, 0.999, 100.0, 100.0, 1.0)
+    );
+    double x = 1.0;
+    for (auto _ : state) {
+        x = (x > 2.0) ? 1.0 : x + 0.001;
+        for (size_t k = 0; k < outputs; ++k) {
+            estimators[k].update(x, data.y[k], 0.01, data.yVariance[k]);
+        }
+        benchmark::DoNotOptimize(estimators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * outputs);
+}
+BENCHMARK(BM_IndependentUpdate)->RangeMultiplier(2)->Range(8, 1024);
+
+
+static void BM_MultiOutputEstimates(benchmark::State& state) {
+    size_t outputs = state.range(0);
+    Outputs data(outputs);
+    MultiOutputDualVarianceWeightedTotalLeastSquares estimator(outputs, 1.0, 0.999, 100.0, 100.0, 1.0);
+    for (int i = 0; i < 50; ++i) {
+        estimator.update(1.0 + 0.02 * i, 0.01, data.y.data(), data.yVariance.data());
+    }
+    std::vector<double> estimates(outputs), variances(outputs);
+    for (auto _ : state) {
+        estimator.getEstimates(estimates.data(), variances.data(), nullptr);
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * outputs);
+}
+BENCHMARK(BM_MultiOutputEstimates)->RangeMultiplier(2)->Range(8, 1024);
+
+
+static void BM_IndependentEstimates(benchmark::State& state) {
+    size_t outputs = state.range(0);
+    Outputs data(outputs);
+    std::vector<DualVarianceWeightedTotalLeastSquares> estimators(
+        outputs, DualVarianceWeightedTotalLeastSquares(1.0, 0.999, 100.0, 100.0, 1.0)
+    );
+    for (int i = 0; i < 50; ++i) {
+        for (size_t k = 0; k < outputs; ++k) {
+            estimators[k].update(1.0 + 0.02 * i, data.y[k], 0.01, data.yVariance[k]);
+        }
+    }
+    std::vector<double> estimates(outputs), variances(outputs);
+    for (auto _ : state) {
+        for (size_t k = 0; k < outputs; ++k) {
+            estimates[k] = estimators[k].tryGetEstimate().value;
+            variances[k] = estimators[k].tryGetVariance().value;
+        }
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * outputs);
+}
+BENCHMARK(BM_IndependentEstimates)->RangeMultiplier(2)->Range(8, 1024);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <ParallelAccumulate.h>
+
+
+namespace {
+
+// Measurements are generated from their index so a 10^9 sample stream needs no memory.
+inline void synthetic(size_t i, double& x, double& y) {
+    x = 1.0 + (i % 97) * 0.01;
+    y = 2.5 * x + ((i * 2654435761u) % 1000) * 1e-6;
+}
+
+}
+
+
+// state.range(0) samples accumulated on state.range(1) threads.
+static void BM_ParallelAccumulateVWTLS(benchmark::State& state) {
+    size_t count = state.range(0);
+    WorkStealingPool pool(state.range(1), true);
+    VarianceWeightedTotalLeastSquares initial(0.0, 1.0, 1.0);
+
+    for (auto _ : state) {
+        VarianceWeightedTotalLeastSquares result = parallelAccumulate(initial, count, 1 << 20, pool,
+            [](VarianceWeightedTotalLeastSquares& partial, size_t begin, size_t end) {
+                double x, y;
+                for (size_t i = begin; i < end; ++i) {
+                    synthetic(i, x, y);
+                    partial.update(x, y, 1e-2);
+                }
+            }
+        );
+        benchmark::DoNotOptimize(result.getEstimate());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParallelAccumulateVWTLS)
+    ->ArgsProduct({{1 << 24, 1000000000}, {1, 2, 4, 8, 16, 32, 64}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+
+static void BM_ParallelAccumulateDVWTLS(benchmark::State& state) {
+    size_t count = state.range(0);
+    WorkStealingPool pool(state.range(1), true);
+    DualVarianceWeightedTotalLeastSquares initial(0.0, 1.0, 1.0, 1.0, 1.0);
+
+    for (auto _ : state) {
+        DualVarianceWeightedTotalLeastSquares result = parallelAccumulate(initial, count, 1 << 20, pool,
+            [](DualVarianceWeightedTotalLeastSquares& partial, size_t begin, size_t end) {
+                double x, y;
+                for (size_t i = begin; i < end; ++i) {
+                    synthetic(i, x, y);
+                    partial.update(x, y, 1e-2, 1e-2);
+                }
+            }
+        );
+        benchmark::DoNotOptimize(result.getEstimate());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParallelAccumulateDVWTLS)
+    ->ArgsProduct({{1 << 24, 1000000000}, {1, 2, 4, 8, 16, 32, 64}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <ParallelTrajectory.h>
+#include <vector>
+
+
+namespace {
+
+// A year of one measurement per second.
+const size_t yearOfSeconds = 365 * 24 * 3600;
+
+struct Stream {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> xVariance;
+    std::vector<double> yVariance;
+
+    explicit Stream(size_t count) : x(count), y(count), xVariance(count, 1e-2), yVariance(count, 2e-2) {
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = 1.0 + (i % 97) * 0.01;
+            y[i] = 2.5 * x[i] + ((i * 2654435761u) % 1000) * 1e-6;
+        }
+    }
+};
+
+}
+
+
+// Baseline: replay the year through update, solving after every step.
+static void BM_SerialTrajectoryDVWTLS(benchmark::State& state) {
+    Stream stream(yearOfSeconds);
+    std::vector<EstimatorResult> estimates(yearOfSeconds);
+    DualVarianceWeightedTotalLeastSquares initial(2.5, 0.9999, 1.0, 1.0, 1.0);
+
+    for (auto _ : state) {
+        DualVarianceWeightedTotalLeastSquares estimator = initial;
+        for (size_t i = 0; i < yearOfSeconds; ++i) {
+            estimator.update(stream.x[i], stream.y[i], stream.xVariance[i], stream.yVariance[i]);
+            estimates[i] = estimator.tryGetEstimate();
+        }
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * yearOfSeconds);
+}
+BENCHMARK(BM_SerialTrajectoryDVWTLS)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+
+// The year's estimates with the blocked scan on state.range(0) threads.
+static void BM_ParallelTrajectoryDVWTLS(benchmark::State& state) {
+    Stream stream(yearOfSeconds);
+    std::vector<EstimatorResult> estimates(yearOfSeconds);
+    DualVarianceWeightedTotalLeastSquares initial(2.5, 0.9999, 1.0, 1.0, 1.0);
+    WorkStealingPool pool(state.range(0), true);
+
+    for (auto _ : state) {
+        parallelTrajectory(initial, stream.x.data(), stream.y.data(), stream.xVariance.data(), stream.yVariance.data(),
+            yearOfSeconds, estimates.data(), nullptr, pool);
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * yearOfSeconds);
+}
+BENCHMARK(BM_ParallelTrajectoryDVWTLS)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+
+// Estimates and variances of a year for the closed form estimator on state.range(0) threads.
+static void BM_ParallelTrajectoryVWTLS(benchmark::State& state) {
+    Stream stream(yearOfSeconds);
+    std::vector<EstimatorResult> estimates(yearOfSeconds);
+    std::vector<EstimatorResult> variances(yearOfSeconds);
+    VarianceWeightedTotalLeastSquares initial(2.5, 1.0, 0.9999);
+    WorkStealingPool pool(state.range(0), true);
+
+    for (auto _ : state) {
+        parallelTrajectory(initial, stream.x.data(), stream.y.data(), stream.yVariance.data(),
+            yearOfSeconds, estimates.data(), variances.data(), pool);
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * yearOfSeconds);
+}
+BENCHMARK(BM_ParallelTrajectoryVWTLS)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseRealTime()->Unit(benchmark::kMillisecond);
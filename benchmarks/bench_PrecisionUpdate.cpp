@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+struct Measurements {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> xVariance;
+    std::vector<double> yVariance;
+    std::vector<double> xPrecision;
+    std::vector<double> yPrecision;
+};
+
+Measurements makeMeasurements(size_t count) {
+    Measurements m;
+    m.x.resize(count);
+    m.y.resize(count);
+    m.xVariance.resize(count);
+    m.yVariance.resize(count);
+    m.xPrecision.resize(count);
+    m.yPrecision.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m.x[i] = 0.5 + 0.001 * (i % 997);
+        m.y[i] = 2.0 * m.x[i] + 0.001 * ((i * 7919) % 13);
+        m.xVariance[i] = 0.05 + 0.001 * (i % 31);
+        m.yVariance[i] = 0.1 + 0.001 * (i % 17);
+        m.xPrecision[i] = 1 / m.xVariance[i];
+        m.yPrecision[i] = 1 / m.yVariance[i];
+    }
+    return m;
+}
+
+constexpr size_t measurementCount = 4096;
+
+}
+
+
+static void BM_VWTLSUpdateVariance(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    VarianceWeightedTotalLeastSquares estimator(0.0, 1.0, 0.99);
+    for (auto _ : state) {
+        for (size_t i = 0; i < measurementCount; ++i) {
+            estimator.update(m.x[i], m.y[i], m.yVariance[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_VWTLSUpdateVariance);
+
+
+static void BM_VWTLSUpdatePrecision(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    VarianceWeightedTotalLeastSquares estimator(0.0, 1.0, 0.99);
+    for (auto _ : state) {
+        for (size_t i = 0; i < measurementCount; ++i) {
+            estimator.updatePrecision(m.x[i], m.y[i], m.yPrecision[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_VWTLSUpdatePrecision);
+
+
+static void BM_VWTLSUpdateVarianceBatch(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    VarianceWeightedTotalLeastSquares estimator(0.0, 1.0, 0.99);
+    for (auto _ : state) {
+        estimator.update(m.x.data(), m.y.data(), m.yVariance.data(), measurementCount);
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_VWTLSUpdateVarianceBatch);
+
+
+static void BM_VWTLSUpdatePrecisionBatch(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    VarianceWeightedTotalLeastSquares estimator(0.0, 1.0, 0.99);
+    for (auto _ : state) {
+        estimator.updatePrecision(m.x.data(), m.y.data(), m.yPrecision.data(), measurementCount);
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_VWTLSUpdatePrecisionBatch);
+
+
+static void BM_DVWTLSUpdateVariance(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    DualVarianceWeightedTotalLeastSquares estimator(0.0, 0.99, 100.0, 100.0, 1.0);
+    for (auto _ : state) {
+        for (size_t i = 0; i < measurementCount; ++i) {
+            estimator.update(m.x[i], m.y[i], m.xVariance[i], m.yVariance[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_DVWTLSUpdateVariance);
+
+
+static void BM_DVWTLSUpdatePrecision(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    DualVarianceWeightedTotalLeastSquares estimator(0.0, 0.99, 100.0, 100.0, 1.0);
+    for (auto _ : state) {
+        for (size_t i = 0; i < measurementCount; ++i) {
+            estimator.updatePrecision(m.x[i], m.y[i], m.xPrecision[i], m.yPrecision[i]);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_DVWTLSUpdatePrecision);
+
+
+static void BM_DVWTLSUpdateVarianceBatch(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    DualVarianceWeightedTotalLeastSquares estimator(0.0, 0.99, 100.0, 100.0, 1.0);
+    for (auto _ : state) {
+        estimator.update(m.x.data(), m.y.data(), m.xVariance.data(), m.yVariance.data(), measurementCount);
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_DVWTLSUpdateVarianceBatch);
+
+
+static void BM_DVWTLSUpdatePrecisionBatch(benchmark::State& state) {
+    Measurements m = makeMeasurements(measurementCount);
+    DualVarianceWeightedTotalLeastSquares estimator(0.0, 0.99, 100.0, 100.0, 1.0);
+    for (auto _ : state) {
+        estimator.updatePrecision(m.x.data(), m.y.data(), m.xPrecision.data(), m.yPrecision.data(), measurementCount);
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * measurementCount);
+}
+BENCHMARK(BM_DVWTLSUpdatePrecisionBatch);
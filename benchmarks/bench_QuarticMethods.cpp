@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <helper/roots.h>
+#include <vector>
+
+
+namespace {
+
+struct Quartics {
+    std::vector<double> a, b, c, d, e;
+};
+
+// Coefficients taken from estimators fed a noisy line, with the variance ratio swept from 1e-3 to 1e3
+// so the sample includes the near degenerate quartics extreme ratios produce.
+Quartics estimatorQuartics(size_t count) {
+    Quartics q;
+    for (size_t i = 0; i < count; ++i) {
+        double ratio = std::pow(10.0, -3.0 + 6.0 * i / count);
+        DualVarianceWeightedTotalLeastSquares estimator(1.0, 0.99, 100.0, 100.0, ratio);
+        for (int j = 0; j < 20; ++j) {
+            double x = 1.0 + 0.1 * j;
+            estimator.update(x, 1.5 * x + 0.01 * ((j * 7 + i) % 5), 0.01, 0.01 * ratio * ratio);
+        }
+        double coefficients[5];
+        estimator.getQuarticCoefficients(coefficients);
+        q.a.push_back(coefficients[0]);
+        q.b.push_back(coefficients[1]);
+        q.c.push_back(coefficients[2]);
+        q.d.push_back(coefficients[3]);
+        q.e.push_back(coefficients[4]);
+    }
+    return q;
+}
+
+}
+
+
+static void BM_QuarticMethod(benchmark::State& state) {
+    QuarticMethod method = static_cast<QuarticMethod>(state.range(0));
+    Quartics q = estimatorQuartics(1024);
+    double roots[4];
+    for (auto _ : state) {
+        size_t found = 0;
+        for (size_t i = 0; i < q.a.size(); ++i) {
+            found += calculate_real_roots(method, q.a[i], q.b[i], q.c[i], q.d[i], q.e[i], roots);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * q.a.size());
+    state.SetLabel(toString(method));
+
+    QuarticCalibration calibration = calibrate_quartic_method(
+        q.a.data(), q.b.data(), q.c.data(), q.d.data(), q.e.data(), q.a.size(), 1e-8
+    );
+    state.counters["maxError"] = calibration.maxError[state.range(0)];
+}
+BENCHMARK(BM_QuarticMethod)->DenseRange(0, quarticMethodCount - 1);
+
+
+static void BM_QuarticCalibration(benchmark::State& state) {
+    Quartics q = estimatorQuartics(256);
+    for (auto _ : state) {
+        QuarticCalibration calibration = calibrate_quartic_method(
+            q.a.data(), q.b.data(), q.c.data(), q.d.data(), q.e.data(), q.a.size(), 1e-8
+        );
+        benchmark::DoNotOptimize(calibration);
+        state.SetLabel(toString(calibration.method));
+    }
+}
+BENCHMARK(BM_QuarticCalibration)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <ReorderBuffer.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <TimestampedEstimator.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+typedef TimestampedEstimator<DualVarianceWeightedTotalLeastSquares> Timestamped;
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 0.99, 1.0, 1.0, 1.0);
+const size_t cells = 4096;
+const size_t records = 1 << 18;
+
+// One measurement per time unit spread over the fleet, delivered after an exponentially distributed delay
+// with the given mean plus a rare long outage, then sorted into arrival order.
+std::vector<TimestampedRecord> arrivals(double meanDelay) {
+    std::mt19937_64 generator(42);
+    std::exponential_distribution<double> delay(1.0 / meanDelay);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<std::pair<double, TimestampedRecord>> stream;
+    stream.reserve(records);
+    for (size_t i = 0; i < records; ++i) {
+        double timestamp = static_cast<double>(i);
+        double arrival = timestamp + delay(generator) + (unit(generator) < 1e-3 ? 50 * meanDelay : 0.0);
+        double x = 1.0 + unit(generator);
+        stream.push_back({arrival, {(i * 2654435761u) % cells, timestamp, x, 2.0 * x, 1e-2, 1e-2}});
+    }
+    std::sort(stream.begin(), stream.end(), [](const std::pair<double, TimestampedRecord>& a, const std::pair<double, TimestampedRecord>& b) {
+        return a.first < b.first;
+    });
+
+    std::vector<TimestampedRecord> ordered;
+    ordered.reserve(records);
+    for (const auto& entry : stream) {
+        ordered.push_back(entry.second);
+    }
+    return ordered;
+}
+
+// Push the whole stream through a buffer with the given window, returning the fraction that arrived late.
+template <typename Estimator>
+double reorder(std::vector<Estimator>& fleet, const std::vector<TimestampedRecord>& stream, double window) {
+    ReorderBuffer<Estimator> buffer(fleet.data(), fleet.size(), window, 1 << 16);
+    for (const TimestampedRecord& record : stream) {
+        buffer.push(record);
+    }
+    buffer.flush();
+    return static_cast<double>(buffer.late()) / records;
+}
+
+}
+
+
+// Throughput through the buffer with a window of state.range(1) against a mean delay of state.range(0) time units,
+// into time stamped estimators, or plain ones updated in release order when state.range(2) is set.
+static void BM_ReorderBufferThroughput(benchmark::State& state) {
+    std::vector<TimestampedRecord> stream = arrivals(state.range(0));
+    std::vector<Timestamped> timestamped(cells, Timestamped(prototype));
+    std::vector<DualVarianceWeightedTotalLeastSquares> sequential(cells, prototype);
+
+    double late = 0;
+    for (auto _ : state) {
+        late = state.range(2) ? reorder(sequential, stream, state.range(1)) : reorder(timestamped, stream, state.range(1));
+    }
+    state.counters["lateFraction"] = late;
+    state.SetItemsProcessed(state.iterations() * records);
+}
+BENCHMARK(BM_ReorderBufferThroughput)
+    ->Args({8, 32, 0})->Args({8, 128, 0})->Args({64, 256, 0})->Args({64, 1024, 0})->Args({64, 1024, 1})
+    ->Unit(benchmark::kMillisecond);
+
+
+// Baseline: the same arrivals straight into updateAt, which already handles late measurements exactly.
+static void BM_UpdateAtArrivalOrder(benchmark::State& state) {
+    std::vector<TimestampedRecord> stream = arrivals(state.range(0));
+    std::vector<Timestamped> fleet(cells, Timestamped(prototype));
+
+    for (auto _ : state) {
+        for (const TimestampedRecord& record : stream) {
+            applyTimestampedRecord(fleet[record.estimatorId], record);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * records);
+}
+BENCHMARK(BM_UpdateAtArrivalOrder)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond);
+
+
+// Latency: how long after arrival a measurement reaches its estimator, in pushes, for a window of state.range(1).
+static void BM_ReorderBufferHold(benchmark::State& state) {
+    std::vector<TimestampedRecord> stream = arrivals(state.range(0));
+    std::vector<Timestamped> fleet(cells, Timestamped(prototype));
+
+    double meanHeld = 0;
+    for (auto _ : state) {
+        ReorderBuffer<Timestamped> buffer(fleet.data(), cells, state.range(1), 1 << 16);
+        double held = 0;
+        for (const TimestampedRecord& record : stream) {
+            buffer.push(record);
+            held += buffer.pending();
+        }
+        buffer.flush();
+        // By Little's law the mean number pending is the mean wait in pushes.
+        meanHeld = held / records;
+    }
+    state.counters["meanHeldPushes"] = meanHeld;
+    state.SetItemsProcessed(state.iterations() * records);
+}
+BENCHMARK(BM_ReorderBufferHold)->Args({8, 32})->Args({64, 256})->Unit(benchmark::kMillisecond);
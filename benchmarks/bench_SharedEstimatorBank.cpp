@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include <SharedEstimatorBank.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+const size_t slots = 1024;
+
+// Child process that reads every slot of the bank until it is killed.
+pid_t spawnReader(const std::string& name) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> bank(name);
+        double sum = 0.0;
+        while (true) {
+            for (size_t i = 0; i < bank.size(); ++i) {
+                sum += bank.readEstimate(i).value;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    return pid;
+}
+
+void stop(std::vector<pid_t>& children) {
+    for (pid_t pid : children) {
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+    children.clear();
+}
+
+}
+
+
+// Writer cost of update + publish while state.range(0) other processes read the bank.
+static void BM_SharedBankWrite(benchmark::State& state) {
+    std::string name = "/recursive-optimizers-bench-write-" + std::to_string(getpid());
+    SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> bank(name, slots, prototype);
+    std::vector<pid_t> readers;
+    for (long r = 0; r < state.range(0); ++r) {
+        readers.push_back(spawnReader(name));
+    }
+
+    double y = 1.0;
+    size_t slot = 0;
+    for (auto _ : state) {
+        y += 1e-6;
+        bank.update(slot, 1.0, y, 1e-2, 1e-2);
+        bank.publish(slot);
+        slot = (slot + 1) % slots;
+    }
+    stop(readers);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedBankWrite)->Arg(0)->Arg(1)->Arg(4)->UseRealTime();
+
+
+// Reader cost of a consistent snapshot of one slot from another process's bank while it is being written.
+static void BM_SharedBankRead(benchmark::State& state) {
+    std::string name = "/recursive-optimizers-bench-read-" + std::to_string(getpid());
+    SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> writer(name, slots, prototype);
+
+    std::vector<pid_t> children;
+    if (state.range(0)) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            double y = 1.0;
+            while (true) {
+                y += 1e-6;
+                for (size_t i = 0; i < slots; ++i) {
+                    writer.update(i, 1.0, y, 1e-2, 1e-2);
+                    writer.publish(i);
+                }
+            }
+        }
+        children.push_back(pid);
+    }
+
+    SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> reader(name);
+    DualVarianceWeightedTotalLeastSquares copy;
+    EstimatorResult estimate;
+    size_t slot = 0;
+    for (auto _ : state) {
+        reader.read(slot, copy, &estimate);
+        benchmark::DoNotOptimize(estimate);
+        slot = (slot + 1) % slots;
+    }
+    stop(children);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedBankRead)->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <StaticVarianceWeightedTotalLeastSquares.h>
+#include <StaticDualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+struct Samples {
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+Samples makeSamples(size_t count) {
+    Samples samples;
+    samples.x.resize(count);
+    samples.y.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples.x[i] = 0.5 + 0.001 * (i % 997);
+        samples.y[i] = 2.0 * samples.x[i] + 0.001 * ((i * 7919) % 13);
+    }
+    return samples;
+}
+
+template <typename Estimator>
+void updateVWTLS(benchmark::State& state, Estimator estimator) {
+    Samples samples = makeSamples(4096);
+    for (auto _ : state) {
+        for (size_t i = 0; i < samples.x.size(); ++i) {
+            estimator.update(samples.x[i], samples.y[i], 0.1);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * samples.x.size());
+    state.counters["bytes"] = sizeof(Estimator);
+}
+
+template <typename Estimator>
+void estimateVWTLS(benchmark::State& state, Estimator estimator) {
+    Samples samples = makeSamples(64);
+    for (size_t i = 0; i < samples.x.size(); ++i) {
+        estimator.update(samples.x[i], samples.y[i], 0.1);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(estimator);
+        benchmark::DoNotOptimize(estimator.getEstimate());
+        benchmark::DoNotOptimize(estimator.getVariance());
+    }
+}
+
+template <typename Estimator>
+void updateDVWTLS(benchmark::State& state, Estimator estimator) {
+    Samples samples = makeSamples(4096);
+    for (auto _ : state) {
+        for (size_t i = 0; i < samples.x.size(); ++i) {
+            estimator.update(samples.x[i], samples.y[i], 0.1, 0.1);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * samples.x.size());
+    state.counters["bytes"] = sizeof(Estimator);
+}
+
+}
+
+
+static void BM_VWTLSUpdateRuntime(benchmark::State& state) {
+    updateVWTLS(state, VarianceWeightedTotalLeastSquares(0.0, 1.0, 1.0));
+}
+BENCHMARK(BM_VWTLSUpdateRuntime);
+
+
+static void BM_VWTLSUpdateNoForgetting(benchmark::State& state) {
+    updateVWTLS(state, StaticVarianceWeightedTotalLeastSquares<>());
+}
+BENCHMARK(BM_VWTLSUpdateNoForgetting);
+
+
+static void BM_VWTLSUpdateConstantForgetting(benchmark::State& state) {
+    updateVWTLS(state, StaticVarianceWeightedTotalLeastSquares<ConstantForgetting<99, 100>>());
+}
+BENCHMARK(BM_VWTLSUpdateConstantForgetting);
+
+
+static void BM_VWTLSEstimateRuntime(benchmark::State& state) {
+    estimateVWTLS(state, VarianceWeightedTotalLeastSquares(0.0, 1.0, 1.0));
+}
+BENCHMARK(BM_VWTLSEstimateRuntime);
+
+
+static void BM_VWTLSEstimateUnitRatio(benchmark::State& state) {
+    estimateVWTLS(state, StaticVarianceWeightedTotalLeastSquares<>());
+}
+BENCHMARK(BM_VWTLSEstimateUnitRatio);
+
+
+static void BM_DVWTLSUpdateRuntime(benchmark::State& state) {
+    updateDVWTLS(state, DualVarianceWeightedTotalLeastSquares(0.0, 1.0, 100.0, 100.0, 1.0));
+}
+BENCHMARK(BM_DVWTLSUpdateRuntime);
+
+
+static void BM_DVWTLSUpdateNoForgetting(benchmark::State& state) {
+    updateDVWTLS(state, StaticDualVarianceWeightedTotalLeastSquares<>());
+}
+BENCHMARK(BM_DVWTLSUpdateNoForgetting);
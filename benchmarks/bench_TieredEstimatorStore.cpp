@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <TieredEstimatorStore.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+const size_t cells = 1 << 20;
+
+// Every cell has seen a few updates, then all but one in hotEvery go cold.
+void warm(TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares>& store, size_t hotEvery) {
+    for (size_t i = 0; i < cells; ++i) {
+        store.update(i, 1.0, 1.0 + i * 1e-7, 1e-2, 1e-2);
+        store.update(i, 2.0, 2.0 + i * 1e-7, 1e-2, 1e-2);
+    }
+    store.tick();
+    for (size_t i = 0; i < cells; i += hotEvery) {
+        store.get(i);
+    }
+    store.demoteIdle(1);
+    store.compactCold();
+}
+
+}
+
+
+// Memory per estimator with one in state.range(0) cells hot, compared to a plain vector of estimators.
+static void BM_TieredStoreFootprint(benchmark::State& state) {
+    for (auto _ : state) {
+        TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(cells, prototype);
+        warm(store, state.range(0));
+        state.counters["bytesPerEstimator"] = static_cast<double>(store.memoryBytes()) / cells;
+        state.counters["plainBytesPerEstimator"] = sizeof(DualVarianceWeightedTotalLeastSquares);
+    }
+}
+BENCHMARK(BM_TieredStoreFootprint)->Arg(1000)->Arg(100)->Arg(10)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+
+// Latency of an update that has to promote a cold estimator, it is demoted again outside the timing.
+static void BM_TieredStorePromote(benchmark::State& state) {
+    TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(cells, prototype);
+    warm(store, cells);
+
+    size_t id = 1;
+    for (auto _ : state) {
+        store.update(id, 1.0, 1.0, 1e-2, 1e-2);
+        state.PauseTiming();
+        store.demote(id);
+        id = (id * 2654435761u) % cells;
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_TieredStorePromote);
+
+
+// Latency of an update to an estimator that is already hot.
+static void BM_TieredStoreHotUpdate(benchmark::State& state) {
+    TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(cells, prototype);
+    warm(store, 100);
+
+    size_t id = 0;
+    for (auto _ : state) {
+        store.update(id, 1.0, 1.0, 1e-2, 1e-2);
+        id = (id + 100) % cells;
+    }
+}
+BENCHMARK(BM_TieredStoreHotUpdate);
+
+
+// Baseline: the same update on a plain vector of estimators.
+static void BM_PlainVectorUpdate(benchmark::State& state) {
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(cells, prototype);
+
+    size_t id = 0;
+    for (auto _ : state) {
+        fleet[id].update(1.0, 1.0, 1e-2, 1e-2);
+        id = (id + 100) % cells;
+    }
+}
+BENCHMARK(BM_PlainVectorUpdate);
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <TimestampedEstimator.h>
+#include <helper/fastMath.h>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+// Irregular stream: bursts of samples 0.1 periods apart separated by gaps of up to 20 periods.
+std::vector<double> irregularTimestamps(size_t count) {
+    std::vector<double> timestamps(count);
+    double time = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        time += (i % 10 == 0) ? 1.0 + (i % 20) : 0.1;
+        timestamps[i] = time;
+    }
+    return timestamps;
+}
+
+}
+
+
+static void BM_ForgettingDecayStdPow(benchmark::State& state) {
+    std::vector<double> steps = irregularTimestamps(1024);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (double step : steps) {
+            sum += std::pow(0.99, step);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * steps.size());
+}
+BENCHMARK(BM_ForgettingDecayStdPow);
+
+
+static void BM_ForgettingDecayFast(benchmark::State& state) {
+    std::vector<double> steps = irregularTimestamps(1024);
+    double log2ForgettingFactor = std::log2(0.99);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (double step : steps) {
+            sum += forgetting_decay(0.99, log2ForgettingFactor, step);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * steps.size());
+}
+BENCHMARK(BM_ForgettingDecayFast);
+
+
+static void BM_VWTLSUpdate(benchmark::State& state) {
+    VarianceWeightedTotalLeastSquares estimator(1.0, 1.0, 0.99);
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            estimator.update(1.0, 2.0, 0.01);
+        }
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_VWTLSUpdate);
+
+
+static void BM_VWTLSUpdateAtIrregular(benchmark::State& state) {
+    TimestampedEstimator<VarianceWeightedTotalLeastSquares> estimator(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.99));
+    std::vector<double> timestamps = irregularTimestamps(1024);
+    std::vector<double> x(1024, 1.0), y(1024, 2.0), variances(1024, 0.01);
+    double offset = 0.0;
+    for (auto _ : state) {
+        for (double& timestamp : timestamps) {
+            timestamp += offset;
+        }
+        offset = timestamps.back();
+        estimator.updateAt(timestamps.data(), x.data(), y.data(), variances.data(), timestamps.size());
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_VWTLSUpdateAtIrregular);
+
+
+static void BM_DVWTLSUpdateAtIrregular(benchmark::State& state) {
+    TimestampedEstimator<DualVarianceWeightedTotalLeastSquares> estimator(DualVarianceWeightedTotalLeastSquares(1.0, 0.99, 1.0, 1.0, 1.0));
+    std::vector<double> timestamps = irregularTimestamps(1024);
+    std::vector<double> x(1024, 1.0), y(1024, 2.0), variances(1024, 0.01);
+    double offset = 0.0;
+    for (auto _ : state) {
+        for (double& timestamp : timestamps) {
+            timestamp += offset;
+        }
+        offset = timestamps.back();
+        estimator.updateAt(timestamps.data(), x.data(), y.data(), variances.data(), variances.data(), timestamps.size());
+        benchmark::DoNotOptimize(estimator);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_DVWTLSUpdateAtIrregular);
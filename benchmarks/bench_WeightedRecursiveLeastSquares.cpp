@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+#include <WeightedRecursiveLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+constexpr size_t streamCount = 64;
+constexpr size_t streamLength = 256;
+constexpr double yDeviation = 0.05;
+
+// Streams of y = w x with their own slopes w, noise on y and (when xDeviation isn't 0) on x, shared by every estimator.
+struct Streams {
+    double xDeviation;
+    std::vector<double> slopes;
+    std::vector<double> x;
+    std::vector<double> y;
+
+    explicit Streams(double xDeviation) : xDeviation(xDeviation), slopes(streamCount), x(streamCount * streamLength), y(streamCount * streamLength) {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> slope(0.5, 4.0);
+        std::uniform_real_distribution<double> input(1.0, 2.0);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        for (size_t s = 0; s < streamCount; ++s) {
+            this->slopes[s] = slope(generator);
+            for (size_t m = 0; m < streamLength; ++m) {
+                double trueX = input(generator);
+                this->x[s * streamLength + m] = trueX + xDeviation * noise(generator);
+                this->y[s * streamLength + m] = this->slopes[s] * trueX + yDeviation * noise(generator);
+            }
+        }
+    }
+};
+
+// Each estimator given what it models of the noise, VarianceWeightedTotalLeastSquares through the x over y deviation ratio.
+// The total least squares estimators are given a tiny x variance for the noiseless x streams, as they need one.
+WeightedRecursiveLeastSquares makeEstimator(WeightedRecursiveLeastSquares*, const Streams&) {
+    return WeightedRecursiveLeastSquares(1.0, 1.0, 100.0);
+}
+
+VarianceWeightedTotalLeastSquares makeEstimator(VarianceWeightedTotalLeastSquares*, const Streams& streams) {
+    return VarianceWeightedTotalLeastSquares(1.0, std::max(streams.xDeviation, 1e-6) / yDeviation, 1.0, 100.0);
+}
+
+DualVarianceWeightedTotalLeastSquares makeEstimator(DualVarianceWeightedTotalLeastSquares*, const Streams&) {
+    return DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 100.0, 100.0);
+}
+
+void update(WeightedRecursiveLeastSquares& estimator, const Streams&, double x, double y) {
+    estimator.update(x, y, yDeviation * yDeviation);
+}
+
+void update(VarianceWeightedTotalLeastSquares& estimator, const Streams&, double x, double y) {
+    estimator.update(x, y, yDeviation * yDeviation);
+}
+
+void update(DualVarianceWeightedTotalLeastSquares& estimator, const Streams& streams, double x, double y) {
+    double xDeviation = std::max(streams.xDeviation, 1e-6);
+    estimator.update(x, y, xDeviation * xDeviation, yDeviation * yDeviation);
+}
+
+// Run every stream through a fresh estimator, estimating after every measurement, and report the final estimates'
+// RMS relative error against the true slopes next to the throughput.
+template <typename Estimator>
+void runStreams(benchmark::State& state) {
+    Streams streams(state.range(0) == 0 ? 0.0 : 0.2);
+    std::vector<double> estimates(streamCount);
+    for (auto _ : state) {
+        for (size_t s = 0; s < streamCount; ++s) {
+            Estimator estimator = makeEstimator(static_cast<Estimator*>(nullptr), streams);
+            double estimate = 0.0;
+            for (size_t m = 0; m < streamLength; ++m) {
+                update(estimator, streams, streams.x[s * streamLength + m], streams.y[s * streamLength + m]);
+                estimate = estimator.getEstimate();
+            }
+            estimates[s] = estimate;
+        }
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * streamCount * streamLength);
+
+    double squaredError = 0.0;
+    for (size_t s = 0; s < streamCount; ++s) {
+        double error = (estimates[s] - streams.slopes[s]) / streams.slopes[s];
+        squaredError += error * error;
+    }
+    state.counters["rmsRelativeError"] = std::sqrt(squaredError / streamCount);
+    state.SetLabel(state.range(0) == 0 ? "x exact" : "x noisy");
+}
+
+}
+
+
+// Update and estimate per measurement, on streams with exact (0) or noisy (1) x.
+static void BM_WRLSStreams(benchmark::State& state) {
+    runStreams<WeightedRecursiveLeastSquares>(state);
+}
+BENCHMARK(BM_WRLSStreams)->Arg(0)->Arg(1);
+
+
+static void BM_WRLSVWTLSStreams(benchmark::State& state) {
+    runStreams<VarianceWeightedTotalLeastSquares>(state);
+}
+BENCHMARK(BM_WRLSVWTLSStreams)->Arg(0)->Arg(1);
+
+
+static void BM_WRLSDVWTLSStreams(benchmark::State& state) {
+    runStreams<DualVarianceWeightedTotalLeastSquares>(state);
+}
+BENCHMARK(BM_WRLSDVWTLSStreams)->Arg(0)->Arg(1);
+
+
+// The batch kernels over a fleet's statistics arrays, one measurement and estimate per estimator.
+static void BM_WRLSBatch(benchmark::State& state) {
+    size_t count = state.range(0);
+    std::vector<double> forgettingFactor(count, 0.99), c1(count, 0.01), c2(count, 0.01);
+    std::vector<double> x(count), y(count), yPrecision(count, 400.0);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + 0.001 * i;
+        y[i] = 2.0 * x[i];
+    }
+    std::vector<double> estimates(count), variances(count);
+    for (auto _ : state) {
+        wrls_update_batch(forgettingFactor.data(), c1.data(), c2.data(), x.data(), y.data(), yPrecision.data(), count);
+        wrls_estimate_batch(c1.data(), c2.data(), count, estimates.data(), variances.data());
+        benchmark::DoNotOptimize(estimates.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_WRLSBatch)->RangeMultiplier(4)->Range(16, 4096);
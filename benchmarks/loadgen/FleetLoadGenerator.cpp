@@ -0,0 +1,276 @@
+#include "FleetLoadGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include "helper/cpuDispatch.h"
+
+
+namespace {
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Expands the seed into the four streams' states.
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+CPU_DISPATCH_INLINE double from_bits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+CPU_DISPATCH_INLINE uint64_t to_bits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// One step of four xoshiro256** streams, lane fastest.
+CPU_DISPATCH_INLINE void xoshiro_step(uint64_t* a, uint64_t* b, uint64_t* c, uint64_t* d, uint64_t* result) {
+    for (int lane = 0; lane < 4; ++lane) {
+        result[lane] = rotl(b[lane] * 5, 7) * 9;
+        uint64_t t = b[lane] << 17;
+        c[lane] ^= a[lane];
+        d[lane] ^= b[lane];
+        b[lane] ^= c[lane];
+        a[lane] ^= d[lane];
+        c[lane] ^= t;
+        d[lane] = rotl(d[lane], 45);
+    }
+}
+
+// state holds s0, s1, s2 and s3 of the four streams, lane fastest.
+CPU_DISPATCH_INLINE void xoshiro_fill_body(uint64_t* state, uint64_t* out, size_t count) {
+    // Work on local copies, out could alias state and would force every state word back to memory.
+    uint64_t a[4], b[4], c[4], d[4];
+    std::copy(state, state + 4, a);
+    std::copy(state + 4, state + 8, b);
+    std::copy(state + 8, state + 12, c);
+    std::copy(state + 12, state + 16, d);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint64_t result[4];
+        xoshiro_step(a, b, c, d, result);
+        std::copy(result, result + 4, out + i);
+    }
+    if (i < count) {
+        uint64_t result[4];
+        xoshiro_step(a, b, c, d, result);
+        std::copy(result, result + (count - i), out + i);
+    }
+
+    std::copy(a, a + 4, state);
+    std::copy(b, b + 4, state + 4);
+    std::copy(c, c + 4, state + 8);
+    std::copy(d, d + 4, state + 12);
+}
+
+// The top 52 bits as the mantissa of a number in [1, 2), minus 1, avoids a 64 bit integer conversion AVX2 doesn't have.
+CPU_DISPATCH_INLINE void uniform_body(const uint64_t* bits, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = from_bits((bits[i] >> 12) | 0x3ff0000000000000ull) - 1.0;
+    }
+}
+
+// Box-Muller with branch free approximations of log, sin and cos (relative error below 1e-10) so the loop vectorises.
+// Uniforms p and pairs + p give normals out[p] and out[pairs + p].
+CPU_DISPATCH_INLINE void box_muller_body(const double* uniforms, double* out, size_t pairs) {
+    const double ln2 = 0.6931471805599453;
+    const double halfPi = 1.5707963267948966;
+    for (size_t p = 0; p < pairs; ++p) {
+        // log(v) for v in (0, 1] as e ln 2 + log(m), with m in [1, 2) and log(m) = 2 atanh((m - 1) / (m + 1)).
+        // The exponent goes through the 2^52 trick since AVX2 can't convert 64 bit integers.
+        double v = 1.0 - uniforms[p];
+        uint64_t bits = to_bits(v);
+        double exponent = from_bits((bits >> 52) | 0x4330000000000000ull) - (4503599627370496.0 + 1023.0);
+        double m = from_bits((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+        double s = (m - 1.0) / (m + 1.0);
+        double s2 = s * s;
+        double series = 1.0 / 19 + s2 / 21;
+        series = 1.0 / 11 + s2 * (1.0 / 13 + s2 * (1.0 / 15 + s2 * (1.0 / 17 + s2 * series)));
+        series = 1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 * series))));
+        double logV = exponent * ln2 + 2.0 * s * series;
+        double radius = std::sqrt(-2.0 * logV);
+
+        // Angle in [-pi, pi) (the sign doesn't matter to a normal), reduced to r in [-pi/4, pi/4] and a quadrant 0 to 3.
+        double angle = 6.283185307179586 * (uniforms[pairs + p] - 0.5);
+        // angle / halfPi + 2.5 is positive, so truncation is floor and quadrant q runs 0 to 4 (4 is the same as 0).
+        int32_t q = static_cast<int32_t>(angle / halfPi + 2.5);
+        double r = angle - (q - 2) * halfPi;
+        double r2 = r * r;
+        double sinR = r * (1.0 - r2 / 6 * (1.0 - r2 / 20 * (1.0 - r2 / 42 * (1.0 - r2 / 72 * (1.0 - r2 / 110)))));
+        double cosR = 1.0 - r2 / 2 * (1.0 - r2 / 12 * (1.0 - r2 / 30 * (1.0 - r2 / 56 * (1.0 - r2 / 90 * (1.0 - r2 / 132)))));
+
+        double odd = q & 1;
+        double sinNegative = (q >> 1) & 1;
+        double cosNegative = ((q + 1) >> 1) & 1;
+        double sinA = odd * cosR + (1.0 - odd) * sinR;
+        double cosA = odd * sinR + (1.0 - odd) * cosR;
+
+        out[p] = radius * (1.0 - 2.0 * cosNegative) * cosA;
+        out[pairs + p] = radius * (1.0 - 2.0 * sinNegative) * sinA;
+    }
+}
+
+typedef void (*XoshiroFillKernel)(uint64_t*, uint64_t*, size_t);
+typedef void (*UniformKernel)(const uint64_t*, double*, size_t);
+typedef void (*BoxMullerKernel)(const double*, double*, size_t);
+
+#define LOADGEN_KERNELS(suffix, target) \
+    target void xoshiro_fill_##suffix(uint64_t* state, uint64_t* out, size_t count) { \
+        xoshiro_fill_body(state, out, count); \
+    } \
+    target void uniform_##suffix(const uint64_t* bits, double* out, size_t count) { \
+        uniform_body(bits, out, count); \
+    } \
+    target void box_muller_##suffix(const double* uniforms, double* out, size_t pairs) { \
+        box_muller_body(uniforms, out, pairs); \
+    }
+
+LOADGEN_KERNELS(generic, )
+#if CPU_DISPATCH_X86
+LOADGEN_KERNELS(avx2, CPU_DISPATCH_TARGET_AVX2)
+LOADGEN_KERNELS(avx512, CPU_DISPATCH_TARGET_AVX512)
+#endif
+
+}
+
+
+Xoshiro256x4::Xoshiro256x4(uint64_t seed) {
+    uint64_t state = seed;
+    for (int lane = 0; lane < 4; ++lane) {
+        this->state[lane] = splitmix64(state);
+        this->state[4 + lane] = splitmix64(state);
+        this->state[8 + lane] = splitmix64(state);
+        this->state[12 + lane] = splitmix64(state);
+    }
+}
+
+
+void Xoshiro256x4::fill(uint64_t* out, size_t count) {
+    XoshiroFillKernel kernel = CPU_DISPATCH_SELECT(xoshiro_fill);
+    kernel(this->state, out, count);
+}
+
+
+void Xoshiro256x4::fillUniform(double* out, size_t count) {
+    this->bits.resize(count);
+    this->fill(this->bits.data(), count);
+    UniformKernel kernel = CPU_DISPATCH_SELECT(uniform);
+    kernel(this->bits.data(), out, count);
+}
+
+
+void Xoshiro256x4::fillNormal(double* out, size_t count) {
+    size_t pairs = (count + 1) / 2;
+    this->uniforms.resize(2 * pairs);
+    this->fillUniform(this->uniforms.data(), 2 * pairs);
+
+    BoxMullerKernel kernel = CPU_DISPATCH_SELECT(box_muller);
+    if (count % 2 == 0) {
+        kernel(this->uniforms.data(), out, pairs);
+    } else {
+        this->normals.resize(2 * pairs);
+        kernel(this->uniforms.data(), this->normals.data(), pairs);
+        std::copy(this->normals.begin(), this->normals.begin() + count, out);
+    }
+}
+
+
+FleetLoadGenerator::FleetLoadGenerator(const FleetLoadConfig& config)
+    : settings(config), random(config.seed), capacity(config.cells), bursting(config.cells, 0), cursor(0) {
+    this->random.fillUniform(this->capacity.data(), this->capacity.size());
+    for (double& value : this->capacity) {
+        value = config.minCapacity + value * (config.maxCapacity - config.minCapacity);
+    }
+}
+
+
+void FleetLoadGenerator::next(size_t count, uint32_t* cells, double* x, double* y, double* xVariance, double* yVariance) {
+    // Per measurement: x, the step and burst and outlier draws.
+    const size_t uniformsPer = 5;
+    this->uniforms.resize(uniformsPer * count);
+    this->normals.resize(2 * count);
+    this->random.fillUniform(this->uniforms.data(), this->uniforms.size());
+    this->random.fillNormal(this->normals.data(), this->normals.size());
+
+    const FleetLoadConfig& c = this->settings;
+    for (size_t i = 0; i < count; ++i) {
+        size_t cell = this->cursor;
+        this->cursor = this->cursor + 1 == c.cells ? 0 : this->cursor + 1;
+        const double* u = this->uniforms.data() + uniformsPer * i;
+
+        double& capacity = this->capacity[cell];
+        capacity *= 1.0 - c.fadePerSample;
+        if (u[1] < c.stepProbability) {
+            capacity *= u[2] < 0.5 ? 1.0 - c.stepSize : 1.0 + c.stepSize;
+        }
+
+        unsigned char& burst = this->bursting[cell];
+        burst = burst ? u[3] >= c.burstEndProbability : u[3] < c.burstStartProbability;
+        double scale = burst ? c.burstScale : 1.0;
+        double xStd = c.xStd * scale;
+        double yStd = c.yStd * scale;
+
+        double trueX = c.minX + u[0] * (c.maxX - c.minX);
+        double yError = yStd * this->normals[2 * i + 1];
+        if (u[4] < c.outlierProbability) {
+            yError += (yError < 0 ? -1.0 : 1.0) * c.outlierScale * yStd;
+        }
+
+        cells[i] = static_cast<uint32_t>(cell);
+        x[i] = trueX + xStd * this->normals[2 * i];
+        y[i] = capacity * trueX + yError;
+        xVariance[i] = xStd * xStd;
+        yVariance[i] = yStd * yStd;
+    }
+}
+
+
+double FleetLoadGenerator::trueCapacity(size_t cell) const {
+    return this->capacity[cell];
+}
+
+
+const FleetLoadConfig& FleetLoadGenerator::config() const {
+    return this->settings;
+}
+
+
+LatencySummary summarize_latencies(std::vector<double>& latencies) {
+    LatencySummary summary = {0.0, 0.0, 0.0, 0.0};
+    if (latencies.empty()) {
+        return summary;
+    }
+
+    auto at = [&](double quantile) {
+        size_t rank = std::min(latencies.size() - 1, static_cast<size_t>(quantile * latencies.size()));
+        std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+        return latencies[rank];
+    };
+    summary.p50 = at(0.5);
+    summary.p99 = at(0.99);
+    summary.p999 = at(0.999);
+    summary.max = *std::max_element(latencies.begin(), latencies.end());
+    return summary;
+}
+
+
+size_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * xoshiro256** kept as four independent streams side by side, so filling an array runs the four
+ * state updates in lock step and the compiler can vectorise them.
+ * The fills are built for each instruction set and picked at run time (see helper/cpuDispatch.h).
+ */
+class Xoshiro256x4 {
+    public:
+        explicit Xoshiro256x4(uint64_t seed);
+
+        /**
+         * @brief Fill out with count uniformly distributed 64 bit values
+         */
+        void fill(uint64_t* out, size_t count);
+
+        /**
+         * @brief Fill out with count doubles uniform in [0, 1)
+         */
+        void fillUniform(double* out, size_t count);
+
+        /**
+         * @brief Fill out with count standard normal doubles (Box-Muller over fillUniform, to about 1e-10 relative)
+         */
+        void fillNormal(double* out, size_t count);
+
+    private:
+        uint64_t state[16]; // s0, s1, s2 and s3 of each stream, stream fastest
+        std::vector<uint64_t> bits;
+        std::vector<double> uniforms;
+        std::vector<double> normals;
+};
+
+
+/**
+ * @brief Shape of a synthetic battery fleet, capacity is the slope y = capacity * x each cell is estimating.
+ *
+ * x is the change in state of charge over a window and y the charge counted over it, both measured with noise.
+ */
+struct FleetLoadConfig {
+    size_t cells = 10000;
+    uint64_t seed = 1;
+
+    double minCapacity = 2.0; // Ah, the initial capacity of each cell is uniform in [minCapacity, maxCapacity)
+    double maxCapacity = 5.0;
+    double fadePerSample = 1e-7; // relative capacity lost per sample
+
+    double stepProbability = 1e-5; // chance per sample that a cell's capacity jumps, e.g. a module swap
+    double stepSize = 0.2; // relative size of a jump, up or down
+
+    double minX = 0.05;
+    double maxX = 0.9;
+    double xStd = 1e-3;
+    double yStd = 1e-2;
+
+    double burstStartProbability = 1e-3; // chance per sample that a calm cell's sensors turn noisy
+    double burstEndProbability = 2e-2; // chance per sample that a noisy cell turns calm
+    double burstScale = 10.0; // standard deviation multiplier while noisy, reported in the variances
+
+    double outlierProbability = 1e-4; // chance per sample of a y error the variances don't account for
+    double outlierScale = 50.0; // in standard deviations
+};
+
+
+/**
+ * Produces an endless round robin stream of measurements over a fleet of cells.
+ */
+class FleetLoadGenerator {
+    public:
+        explicit FleetLoadGenerator(const FleetLoadConfig& config);
+
+        /**
+         * @brief Generate the next count measurements, continuing the round robin over the cells
+         *
+         * @param cells set to the cell each measurement is for
+         * @param x, y, xVariance, yVariance caller provided storage for count measurements
+         */
+        void next(size_t count, uint32_t* cells, double* x, double* y, double* xVariance, double* yVariance);
+
+        /**
+         * @brief The capacity a cell currently has
+         */
+        double trueCapacity(size_t cell) const;
+
+        const FleetLoadConfig& config() const;
+
+    private:
+        FleetLoadConfig settings;
+        Xoshiro256x4 random;
+        std::vector<double> capacity;
+        std::vector<unsigned char> bursting;
+        size_t cursor;
+        std::vector<double> uniforms;
+        std::vector<double> normals;
+};
+
+
+/**
+ * @brief Percentiles of a set of latencies
+ */
+struct LatencySummary {
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+/**
+ * @brief Summarise latencies, reordering them
+ */
+LatencySummary summarize_latencies(std::vector<double>& latencies);
+
+/**
+ * @brief Resident set size of this process in bytes, 0 if it can't be read
+ */
+size_t resident_bytes();
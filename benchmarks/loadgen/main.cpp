@@ -0,0 +1,144 @@
+#include "FleetLoadGenerator.h"
+#include <IngestPipeline.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Drives a synthetic battery fleet through construction, update, estimate and variance and reports
+// throughput, latency percentiles and memory per estimator.
+//
+// usage: RecursiveOptimizers_loadgen [cells] [ticks] [vwtls|dvwtls]
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double nanoseconds(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+void construct(std::vector<VarianceWeightedTotalLeastSquares>& fleet, size_t cells) {
+    std::vector<double> nominal(cells, 3.5), ratio(cells, 1.0), forgetting(cells, 0.9999), variance(cells, 100.0);
+    std::vector<EstimatorStatus> statuses(cells);
+    fleet.resize(cells);
+    VarianceWeightedTotalLeastSquares::createBatch(
+        nominal.data(), ratio.data(), forgetting.data(), variance.data(), cells, fleet.data(), statuses.data()
+    );
+}
+
+void construct(std::vector<DualVarianceWeightedTotalLeastSquares>& fleet, size_t cells) {
+    std::vector<double> nominal(cells, 3.5), forgetting(cells, 0.9999), variance(cells, 100.0), ratio(cells, -1.0);
+    std::vector<EstimatorStatus> statuses(cells);
+    fleet.resize(cells);
+    DualVarianceWeightedTotalLeastSquares::createBatch(
+        nominal.data(), forgetting.data(), variance.data(), variance.data(), ratio.data(), cells, fleet.data(), statuses.data()
+    );
+}
+
+void printLatencies(const char* name, std::vector<double>& latencies) {
+    LatencySummary summary = summarize_latencies(latencies);
+    std::cout << name << " latency ns: p50 " << summary.p50 << "  p99 " << summary.p99
+              << "  p999 " << summary.p999 << "  max " << summary.max << "\n";
+}
+
+template <typename Estimator>
+void run(const FleetLoadConfig& config, size_t ticks) {
+    const size_t chunk = 1 << 16;
+    const size_t timeUpdateEvery = 64;
+    const size_t readEvery = 97;
+
+    size_t before = resident_bytes();
+    std::vector<Estimator> fleet;
+    Clock::time_point start = Clock::now();
+    construct(fleet, config.cells);
+    double constructNs = nanoseconds(start, Clock::now());
+    size_t after = resident_bytes();
+
+    FleetLoadGenerator generator(config);
+    std::vector<uint32_t> cells(chunk);
+    std::vector<double> x(chunk), y(chunk), xVariance(chunk), yVariance(chunk);
+    std::vector<double> updateLatencies;
+    std::vector<double> readLatencies;
+
+    size_t total = config.cells * ticks;
+    double updateNs = 0;
+    for (size_t done = 0; done < total;) {
+        size_t count = std::min(chunk, total - done);
+        generator.next(count, cells.data(), x.data(), y.data(), xVariance.data(), yVariance.data());
+
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            IngestRecord record = {cells[i], x[i], y[i], xVariance[i], yVariance[i]};
+            if (i % timeUpdateEvery == 0) {
+                Clock::time_point one = Clock::now();
+                applyIngestRecord(fleet[cells[i]], record);
+                updateLatencies.push_back(nanoseconds(one, Clock::now()));
+            } else {
+                applyIngestRecord(fleet[cells[i]], record);
+            }
+        }
+        updateNs += nanoseconds(begin, Clock::now());
+        done += count;
+    }
+
+    double error = 0;
+    size_t reads = 0;
+    size_t failures = 0;
+    for (size_t cell = 0; cell < config.cells; cell += readEvery) {
+        Clock::time_point begin = Clock::now();
+        EstimatorResult estimate = fleet[cell].tryGetEstimate();
+        EstimatorResult variance = fleet[cell].tryGetVariance();
+        readLatencies.push_back(nanoseconds(begin, Clock::now()));
+
+        failures += !estimate.ok() || !variance.ok();
+        error += std::abs(estimate.value / generator.trueCapacity(cell) - 1.0);
+        ++reads;
+    }
+
+    std::cout << "cells " << config.cells << ", samples " << total << ", sizeof " << sizeof(Estimator) << " bytes\n";
+    std::cout << "construction: " << constructNs / config.cells << " ns per estimator, "
+              << static_cast<double>(after - before) / config.cells << " resident bytes per estimator\n";
+    std::cout << "update: " << total / (updateNs * 1e-9) << " samples/s\n";
+    printLatencies("update", updateLatencies);
+    printLatencies("estimate + variance", readLatencies);
+    std::cout << "mean relative capacity error " << error / reads << ", failed reads " << failures << " of " << reads << "\n";
+}
+
+}
+
+
+int main(int argc, char** argv) {
+    FleetLoadConfig config;
+    size_t ticks = 100;
+    std::string estimator = "dvwtls";
+    if (argc > 1) {
+        config.cells = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        ticks = std::strtoull(argv[2], nullptr, 10);
+    }
+    if (argc > 3) {
+        estimator = argv[3];
+    }
+    if (config.cells == 0) {
+        std::cerr << "cells must be more than 0\n";
+        return 1;
+    }
+
+    if (estimator == "vwtls") {
+        run<VarianceWeightedTotalLeastSquares>(config, ticks);
+    } else if (estimator == "dvwtls") {
+        run<DualVarianceWeightedTotalLeastSquares>(config, ticks);
+    } else {
+        std::cerr << "unknown estimator " << estimator << ", expected vwtls or dvwtls\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+"""Batch bindings against a per sample Python loop.
+
+Run with the built module on the path, e.g.
+    PYTHONPATH=build/python python3 python/bench_bindings.py [--count N]
+
+Uses NumPy arrays when NumPy is installed and array.array otherwise, the bindings take either without copying.
+"""
+import argparse
+import random
+import time
+from array import array
+
+import recursive_optimizers as ro
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+def doubles(values):
+    return np.array(values, dtype=np.float64) if np is not None else array("d", values)
+
+
+def zeros(count, code="d"):
+    if np is not None:
+        return np.zeros(count, dtype={"d": np.float64, "i": np.int32, "B": np.uint8, "q": np.int64}[code])
+    return array(code, bytes(count * array(code).itemsize))
+
+
+def timed(function):
+    start = time.perf_counter()
+    function()
+    return time.perf_counter() - start
+
+
+def report(name, per_sample, batch, count):
+    print(f"{name:<28} per sample {per_sample / count * 1e9:9.1f} ns   batch {batch / count * 1e9:7.1f} ns   "
+          f"speed up {per_sample / batch:7.1f}x")
+
+
+def fleet_update(count, steps, rng):
+    xs = [[rng.uniform(-10.0, 10.0) for _ in range(count)] for _ in range(steps)]
+    ys = [[2.0 * x + rng.gauss(0.0, 0.5) for x in row] for row in xs]
+    y_variance = [0.25] * count
+
+    loop_fleet = ro.VWTLSFleet(count, 1.0)
+    batch_fleet = ro.VWTLSFleet(count, 1.0)
+    batch = [(doubles(x), doubles(y)) for x, y in zip(xs, ys)]
+    batch_y_variance = doubles(y_variance)
+
+    def loop():
+        for x, y in zip(xs, ys):
+            for i in range(count):
+                loop_fleet.update_one(i, x[i], y[i], y_variance[i])
+
+    def batched():
+        for x, y in batch:
+            batch_fleet.update(x, y, batch_y_variance)
+
+    report("VWTLSFleet.update", timed(loop), timed(batched), count * steps)
+
+    estimates = zeros(count)
+    batch_fleet.estimate(estimates)
+    for i in range(count):
+        expected = loop_fleet.estimate_one(i)[0]
+        assert abs(estimates[i] - expected) <= 1e-12 * abs(expected), (i, estimates[i], expected)
+
+
+def series_update(length, rng):
+    x = [rng.uniform(-10.0, 10.0) for _ in range(length)]
+    y = [0.5 * value + rng.gauss(0.0, 0.5) for value in x]
+    x_variance = [0.1] * length
+    y_variance = [0.25] * length
+
+    loop_fleet = ro.DVWTLSFleet(1, 1.0)
+    batch_fleet = ro.DVWTLSFleet(1, 1.0)
+
+    def loop():
+        for i in range(length):
+            loop_fleet.update_one(0, x[i], y[i], x_variance[i], y_variance[i])
+
+    arrays = doubles(x), doubles(y), doubles(x_variance), doubles(y_variance)
+    report("DVWTLSFleet.update_series", timed(loop), timed(lambda: batch_fleet.update_series(0, *arrays)), length)
+
+    expected, batch = loop_fleet.estimate_one(0), batch_fleet.estimate_one(0)
+    assert expected[2] == batch[2] and abs(expected[0] - batch[0]) <= 1e-12 * abs(expected[0]), (expected, batch)
+
+
+def real_roots(count, rng):
+    coefficients = [[rng.uniform(-1.0, 1.0) for _ in range(count)] for _ in range(5)]
+    roots = zeros(4 * count)
+    counts = zeros(count, "B")
+    arrays = [doubles(values) for values in coefficients]
+    batch = timed(lambda: ro.real_roots(*arrays, roots, counts))
+
+    # The per sample comparison still goes through the batch entry point, one quartic at a time.
+    single = [[doubles([values[i]]) for values in coefficients] for i in range(count)]
+    single_roots, single_counts = zeros(4), zeros(1, "B")
+
+    def loop():
+        for i in range(count):
+            ro.real_roots(*single[i], single_roots, single_counts)
+
+    report("real_roots", timed(loop), batch, count)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--count", type=int, default=100000, help="estimators, samples or quartics per benchmark")
+    args = parser.parse_args()
+    rng = random.Random(1)
+
+    print(f"arrays: {'numpy' if np is not None else 'array.array'}")
+    fleet_update(args.count, 4, rng)
+    series_update(args.count, rng)
+    real_roots(args.count, rng)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,684 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "FleetExecutor.h"
+#include "IngestPipeline.h"
+#include "helper/roots.h"
+
+// Python bindings over the batch estimator API, written against the CPython API directly.
+// Arrays are taken through the buffer protocol (NumPy arrays, array.array, memoryview, ...) without copying,
+// and the GIL is released while the estimators run so other Python threads keep going.
+
+namespace {
+
+constexpr size_t chunkBytes = 32 * 1024;
+
+/**
+ * A C contiguous buffer of one element type, released when it goes out of scope.
+ */
+class Buffer {
+    public:
+        Buffer() : acquired(false), count(0) {}
+
+        ~Buffer() {
+            if (this->acquired) {
+                PyBuffer_Release(&this->view);
+            }
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        /**
+         * @brief Acquire object's buffer, setting a Python exception and returning false if it doesn't fit
+         *
+         * @param formats struct module codes accepted for the element type, e.g. "d"
+         * @param itemSize size in bytes every accepted code must have on this platform
+         * @param none whether None is accepted (leaving the buffer empty)
+         */
+        bool acquire(PyObject* object, const char* name, const char* formats, size_t itemSize, bool writable, bool none=false) {
+            if (object == Py_None && none) {
+                return true;
+            }
+            int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+            if (PyObject_GetBuffer(object, &this->view, flags) != 0) {
+                return false;
+            }
+            this->acquired = true;
+
+            // Native byte order and size only, e.g. "d", "=d" or "<d" on a little endian machine.
+            const char* format = this->view.format == nullptr ? "B" : this->view.format;
+            if (format[0] == '@' || format[0] == '=' || (format[0] == '<' && PY_LITTLE_ENDIAN) || (format[0] == '>' && !PY_LITTLE_ENDIAN)) {
+                ++format;
+            }
+            if (std::strlen(format) != 1 || std::strchr(formats, format[0]) == nullptr || static_cast<size_t>(this->view.itemsize) != itemSize) {
+                PyErr_Format(PyExc_TypeError, "%s must be an array of '%s' (got '%s')", name, formats, this->view.format);
+                return false;
+            }
+            this->count = static_cast<size_t>(this->view.len) / itemSize;
+            return true;
+        }
+
+        template <typename T>
+        T* data() const {
+            return this->acquired ? static_cast<T*>(this->view.buf) : nullptr;
+        }
+
+        size_t size() const {
+            return this->count;
+        }
+
+        bool empty() const {
+            return !this->acquired;
+        }
+
+    private:
+        Py_buffer view;
+        bool acquired;
+        size_t count;
+};
+
+bool acquire_doubles(Buffer& buffer, PyObject* object, const char* name, bool writable=false, bool none=false) {
+    return buffer.acquire(object, name, "d", sizeof(double), writable, none);
+}
+
+bool check_length(const Buffer& buffer, const char* name, size_t length) {
+    if (!buffer.empty() && buffer.size() != length) {
+        PyErr_Format(PyExc_ValueError, "%s has %zu elements, expected %zu", name, buffer.size(), length);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Run work with the GIL released, turning a C++ exception into a Python one once it is held again.
+ */
+template <typename Work>
+bool run_without_gil(Work work) {
+    std::string error;
+    PyObject* type = nullptr;
+
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        work();
+    } catch (const std::out_of_range& e) {
+        error = e.what();
+        type = PyExc_IndexError;
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+        type = PyExc_ValueError;
+    } catch (const std::exception& e) {
+        error = e.what();
+        type = PyExc_RuntimeError;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (type != nullptr) {
+        PyErr_SetString(type, error.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+void update_series(VarianceWeightedTotalLeastSquares& estimator, const double* x, const double* y, const double*, const double* yVariance, size_t count) {
+    estimator.update(x, y, yVariance, count);
+}
+
+void update_series(DualVarianceWeightedTotalLeastSquares& estimator, const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count) {
+    estimator.update(x, y, xVariance, yVariance, count);
+}
+
+/**
+ * What differs between the fleet types: names, constructor arguments and whether measurements carry an x variance.
+ */
+template <typename Estimator>
+struct FleetTraits;
+
+template <>
+struct FleetTraits<VarianceWeightedTotalLeastSquares> {
+    static constexpr const char* name = "recursive_optimizers.VWTLSFleet";
+    static constexpr const char* doc =
+        "VWTLSFleet(count, nominal_value=0.0, variance_ratio=1.0, forgetting_factor=1.0, initial_variance=1.0, threads=0)\n\n"
+        "A fleet of VarianceWeightedTotalLeastSquares estimators, measurements are (x, y, y_variance).\n"
+        "threads is the number of threads batch calls use, 0 for the hardware concurrency.";
+    static constexpr bool hasXVariance = false;
+
+    static bool create(PyObject* args, PyObject* kwargs, std::vector<VarianceWeightedTotalLeastSquares>& fleet, unsigned int& threads) {
+        static const char* keywords[] = {"count", "nominal_value", "variance_ratio", "forgetting_factor", "initial_variance", "threads", nullptr};
+        Py_ssize_t count;
+        double nominalValue = 0.0, varianceRatio = 1.0, forgettingFactor = 1.0, initialVariance = 1.0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|ddddI", const_cast<char**>(keywords),
+                &count, &nominalValue, &varianceRatio, &forgettingFactor, &initialVariance, &threads)) {
+            return false;
+        }
+        EstimatorStatus status = VarianceWeightedTotalLeastSquares::checkParameters(varianceRatio, forgettingFactor, initialVariance);
+        if (count < 0 || status != EstimatorStatus::Ok) {
+            PyErr_SetString(PyExc_ValueError, count < 0 ? "count must not be negative" : toString(status));
+            return false;
+        }
+        fleet.assign(count, VarianceWeightedTotalLeastSquares(nominalValue, varianceRatio, forgettingFactor, initialVariance));
+        return true;
+    }
+};
+
+template <>
+struct FleetTraits<DualVarianceWeightedTotalLeastSquares> {
+    static constexpr const char* name = "recursive_optimizers.DVWTLSFleet";
+    static constexpr const char* doc =
+        "DVWTLSFleet(count, nominal_value=0.0, forgetting_factor=1.0, initial_x_variance=100.0, initial_y_variance=100.0, variance_ratio=-1.0, threads=0)\n\n"
+        "A fleet of DualVarianceWeightedTotalLeastSquares estimators, measurements are (x, y, x_variance, y_variance).\n"
+        "threads is the number of threads batch calls use, 0 for the hardware concurrency.";
+    static constexpr bool hasXVariance = true;
+
+    static bool create(PyObject* args, PyObject* kwargs, std::vector<DualVarianceWeightedTotalLeastSquares>& fleet, unsigned int& threads) {
+        static const char* keywords[] = {"count", "nominal_value", "forgetting_factor", "initial_x_variance", "initial_y_variance", "variance_ratio", "threads", nullptr};
+        Py_ssize_t count;
+        double nominalValue = 0.0, forgettingFactor = 1.0, initialXVariance = 100.0, initialYVariance = 100.0, varianceRatio = -1.0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|dddddI", const_cast<char**>(keywords),
+                &count, &nominalValue, &forgettingFactor, &initialXVariance, &initialYVariance, &varianceRatio, &threads)) {
+            return false;
+        }
+        EstimatorStatus status = DualVarianceWeightedTotalLeastSquares::checkParameters(forgettingFactor, initialXVariance, initialYVariance, varianceRatio);
+        if (count < 0 || status != EstimatorStatus::Ok) {
+            PyErr_SetString(PyExc_ValueError, count < 0 ? "count must not be negative" : toString(status));
+            return false;
+        }
+        fleet.assign(count, DualVarianceWeightedTotalLeastSquares(nominalValue, forgettingFactor, initialXVariance, initialYVariance, varianceRatio));
+        return true;
+    }
+};
+
+
+template <typename Estimator>
+struct FleetObject {
+    PyObject_HEAD
+    std::vector<Estimator>* estimators;
+    FleetExecutor* executor;
+    bool busy; // a call is using the fleet, possibly with the GIL released
+};
+
+/**
+ * Holds a fleet for the length of a call, so a call from another Python thread (or __init__) that runs while this one
+ * has the GIL released raises rather than sharing the estimators and the executor's pool. Only touched with the GIL held.
+ */
+template <typename Estimator>
+class FleetGuard {
+    public:
+        explicit FleetGuard(FleetObject<Estimator>* fleet) : fleet(fleet), held(false) {}
+
+        ~FleetGuard() {
+            if (this->held) {
+                this->fleet->busy = false;
+            }
+        }
+
+        FleetGuard(const FleetGuard&) = delete;
+        FleetGuard& operator=(const FleetGuard&) = delete;
+
+        /**
+         * @brief Take the fleet, setting a Python exception and returning false if another call has it
+         *
+         * @param initialised whether the fleet must have been initialised
+         */
+        bool acquire(bool initialised=true) {
+            if (this->fleet->busy) {
+                PyErr_SetString(PyExc_RuntimeError, "fleet is in use by another call");
+                return false;
+            }
+            if (initialised && this->fleet->estimators == nullptr) {
+                PyErr_SetString(PyExc_RuntimeError, "fleet was not initialised");
+                return false;
+            }
+            this->fleet->busy = true;
+            this->held = true;
+            return true;
+        }
+
+    private:
+        FleetObject<Estimator>* fleet;
+        bool held;
+};
+
+/**
+ * Measurement arrays parsed from the leading arguments of a call, x_variance only for fleets that take one.
+ */
+template <typename Estimator>
+struct Measurements {
+    Buffer x, y, xVariance, yVariance;
+
+    bool acquire(PyObject* x, PyObject* y, PyObject* xVariance, PyObject* yVariance) {
+        return acquire_doubles(this->x, x, "x")
+            && acquire_doubles(this->y, y, "y")
+            && (!FleetTraits<Estimator>::hasXVariance || acquire_doubles(this->xVariance, xVariance, "x_variance"))
+            && acquire_doubles(this->yVariance, yVariance, "y_variance");
+    }
+
+    bool checkLength(size_t length) const {
+        return check_length(this->x, "x", length) && check_length(this->y, "y", length)
+            && check_length(this->xVariance, "x_variance", length) && check_length(this->yVariance, "y_variance", length);
+    }
+
+    IngestRecord record(size_t estimatorId, size_t i) const {
+        double xVariance = this->xVariance.empty() ? 0.0 : this->xVariance.template data<double>()[i];
+        return {estimatorId, this->x.template data<double>()[i], this->y.template data<double>()[i], xVariance, this->yVariance.template data<double>()[i]};
+    }
+};
+
+// Split positional arguments (leading..., x, y, [x_variance,] y_variance, trailing...) into items, leading first,
+// then the measurements and then the trailing arguments, of which the first required are mandatory.
+template <typename Estimator>
+bool split_arguments(PyObject* args, const char* function, size_t leading, size_t required, size_t trailing, PyObject** items) {
+    size_t measurements = FleetTraits<Estimator>::hasXVariance ? 4 : 3;
+    size_t given = static_cast<size_t>(PyTuple_GET_SIZE(args));
+    if (given < leading + measurements + required || given > leading + measurements + trailing) {
+        PyErr_Format(PyExc_TypeError, "%s() takes %zu to %zu arguments (%zu given)", function,
+            leading + measurements + required, leading + measurements + trailing, given);
+        return false;
+    }
+    for (size_t i = 0, item = 0; i < leading + 4 + trailing; ++i) {
+        bool xVariance = i == leading + 2;
+        items[i] = (xVariance && measurements == 3) || item >= given ? Py_None : PyTuple_GET_ITEM(args, item++);
+    }
+    return true;
+}
+
+
+template <typename Estimator>
+int fleet_init(PyObject* self, PyObject* args, PyObject* kwargs) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    std::vector<Estimator> estimators;
+    unsigned int threads = 0;
+    if (!guard.acquire(false) || !FleetTraits<Estimator>::create(args, kwargs, estimators, threads)) {
+        return -1;
+    }
+
+    try {
+        FleetExecutor* executor = new FleetExecutor(threads, false, chunkBytes);
+        delete fleet->executor;
+        delete fleet->estimators;
+        fleet->executor = executor;
+        fleet->estimators = new std::vector<Estimator>(std::move(estimators));
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return -1;
+    }
+    return 0;
+}
+
+template <typename Estimator>
+void fleet_dealloc(PyObject* self) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    delete fleet->executor;
+    delete fleet->estimators;
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+template <typename Estimator>
+Py_ssize_t fleet_length(PyObject* self) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    return fleet->estimators == nullptr ? 0 : static_cast<Py_ssize_t>(fleet->estimators->size());
+}
+
+// update(x, y, [x_variance,] y_variance): one measurement per estimator, in parallel.
+template <typename Estimator>
+PyObject* fleet_update(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    PyObject* items[4];
+    Measurements<Estimator> measurements;
+    if (!guard.acquire() || !split_arguments<Estimator>(args, "update", 0, 0, 0, items)
+        || !measurements.acquire(items[0], items[1], items[2], items[3]) || !measurements.checkLength(fleet->estimators->size())) {
+        return nullptr;
+    }
+
+    Estimator* estimators = fleet->estimators->data();
+    WorkStealingPool& pool = fleet->executor->getPool();
+    bool ok = run_without_gil([&]() {
+        pool.parallelFor(fleet->estimators->size(), std::max<size_t>(1, chunkBytes / sizeof(Estimator)), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                applyIngestRecord(estimators[i], measurements.record(i, i));
+            }
+        });
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// update_series(index, x, y, [x_variance,] y_variance): many measurements for one estimator, in order.
+template <typename Estimator>
+PyObject* fleet_update_series(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    PyObject* items[5];
+    Measurements<Estimator> measurements;
+    if (!guard.acquire() || !split_arguments<Estimator>(args, "update_series", 1, 0, 0, items)
+        || !measurements.acquire(items[1], items[2], items[3], items[4]) || !measurements.checkLength(measurements.x.size())) {
+        return nullptr;
+    }
+    Py_ssize_t index = PyNumber_AsSsize_t(items[0], PyExc_IndexError);
+    if (index == -1 && PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (index < 0 || static_cast<size_t>(index) >= fleet->estimators->size()) {
+        PyErr_Format(PyExc_IndexError, "estimator %zd is outside the fleet", index);
+        return nullptr;
+    }
+
+    Estimator& estimator = (*fleet->estimators)[index];
+    bool ok = run_without_gil([&]() {
+        update_series(estimator, measurements.x.template data<double>(), measurements.y.template data<double>(),
+            measurements.xVariance.template data<double>(), measurements.yVariance.template data<double>(), measurements.x.size());
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// update_records(ids, x, y, [x_variance,] y_variance): measurements addressed to estimators by id, applied in
+// array order per estimator. Each thread owns a contiguous slice of the fleet and applies only the records bucketed to it.
+template <typename Estimator>
+PyObject* fleet_update_records(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    PyObject* items[5];
+    Measurements<Estimator> measurements;
+    Buffer ids;
+    if (!guard.acquire() || !split_arguments<Estimator>(args, "update_records", 1, 0, 0, items)
+        || !ids.acquire(items[0], "ids", "qQlLnN", sizeof(uint64_t), false)
+        || !measurements.acquire(items[1], items[2], items[3], items[4]) || !measurements.checkLength(ids.size())) {
+        return nullptr;
+    }
+
+    size_t count = fleet->estimators->size();
+    const uint64_t* estimatorIds = ids.data<uint64_t>();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (estimatorIds[i] >= count) {
+            PyErr_Format(PyExc_IndexError, "estimator %lld is outside the fleet", static_cast<long long>(estimatorIds[i]));
+            return nullptr;
+        }
+    }
+
+    Estimator* estimators = fleet->estimators->data();
+    WorkStealingPool& pool = fleet->executor->getPool();
+    size_t slices = pool.size();
+    bool ok = run_without_gil([&]() {
+        // Bucket the records by slice once (a stable counting sort, so each estimator keeps array order),
+        // rather than every slice scanning every record.
+        std::vector<size_t> offsets(slices + 1, 0);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ++offsets[estimatorIds[i] * slices / count + 1];
+        }
+        for (size_t slice = 0; slice < slices; ++slice) {
+            offsets[slice + 1] += offsets[slice];
+        }
+        std::vector<size_t> order(ids.size());
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            order[next[estimatorIds[i] * slices / count]++] = i;
+        }
+
+        pool.parallelFor(slices, 1, [&](size_t begin, size_t end) {
+            for (size_t k = offsets[begin]; k < offsets[end]; ++k) {
+                size_t i = order[k];
+                applyIngestRecord(estimators[estimatorIds[i]], measurements.record(estimatorIds[i], i));
+            }
+        });
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// update_one(index, x, y, [x_variance,] y_variance): a single measurement, the per sample path batch calls replace.
+template <typename Estimator>
+PyObject* fleet_update_one(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    Py_ssize_t index;
+    IngestRecord record = {0, 0.0, 0.0, 0.0, 0.0};
+    bool parsed = FleetTraits<Estimator>::hasXVariance
+        ? PyArg_ParseTuple(args, "ndddd", &index, &record.x, &record.y, &record.xVariance, &record.yVariance)
+        : PyArg_ParseTuple(args, "nddd", &index, &record.x, &record.y, &record.yVariance);
+    if (!guard.acquire() || !parsed) {
+        return nullptr;
+    }
+    if (index < 0 || static_cast<size_t>(index) >= fleet->estimators->size()) {
+        PyErr_Format(PyExc_IndexError, "estimator %zd is outside the fleet", index);
+        return nullptr;
+    }
+    try {
+        applyIngestRecord((*fleet->estimators)[index], record);
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// estimate_one(index) -> (estimate, variance, status)
+template <typename Estimator>
+PyObject* fleet_estimate_one(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    Py_ssize_t index;
+    if (!guard.acquire() || !PyArg_ParseTuple(args, "n", &index)) {
+        return nullptr;
+    }
+    if (index < 0 || static_cast<size_t>(index) >= fleet->estimators->size()) {
+        PyErr_Format(PyExc_IndexError, "estimator %zd is outside the fleet", index);
+        return nullptr;
+    }
+    // One solve for both, as FleetExecutor::estimate does.
+    EstimatorResult estimate, variance;
+    (*fleet->estimators)[index].tryGetEstimateAndVariance(estimate, variance);
+    EstimatorStatus status = estimate.ok() ? variance.status : estimate.status;
+    return Py_BuildValue("ddi", estimate.value, variance.value, static_cast<int>(status));
+}
+
+bool acquire_results(Buffer& estimates, Buffer& variances, Buffer& statuses, PyObject* estimatesObject, PyObject* variancesObject, PyObject* statusesObject, size_t count) {
+    static_assert(sizeof(EstimatorStatus) == sizeof(int32_t), "statuses are written as 32 bit integers");
+    return acquire_doubles(estimates, estimatesObject, "estimates", true)
+        && acquire_doubles(variances, variancesObject, "variances", true, true)
+        && statuses.acquire(statusesObject, "statuses", "i", sizeof(int32_t), true, true)
+        && check_length(estimates, "estimates", count)
+        && check_length(variances, "variances", count)
+        && check_length(statuses, "statuses", count);
+}
+
+// estimate(estimates, variances=None, statuses=None): fill the caller's arrays, in parallel.
+template <typename Estimator>
+PyObject* fleet_estimate(PyObject* self, PyObject* args, PyObject* kwargs) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    static const char* keywords[] = {"estimates", "variances", "statuses", nullptr};
+    PyObject* estimatesObject;
+    PyObject* variancesObject = Py_None;
+    PyObject* statusesObject = Py_None;
+    Buffer estimates, variances, statuses;
+    if (!guard.acquire() || !PyArg_ParseTupleAndKeywords(args, kwargs, "O|OO", const_cast<char**>(keywords), &estimatesObject, &variancesObject, &statusesObject)
+        || !acquire_results(estimates, variances, statuses, estimatesObject, variancesObject, statusesObject, fleet->estimators->size())) {
+        return nullptr;
+    }
+
+    bool ok = run_without_gil([&]() {
+        fleet->executor->estimate(fleet->estimators->data(), fleet->estimators->size(),
+            estimates.data<double>(), variances.data<double>(), statuses.data<EstimatorStatus>());
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+void update_and_estimate(
+    FleetExecutor& executor, VarianceWeightedTotalLeastSquares* estimators, size_t count,
+    const double* x, const double* y, const double*, const double* yVariance,
+    double* estimates, double* variances, EstimatorStatus* statuses
+) {
+    executor.updateAndEstimate(estimators, count, x, y, yVariance, estimates, variances, statuses);
+}
+
+void update_and_estimate(
+    FleetExecutor& executor, DualVarianceWeightedTotalLeastSquares* estimators, size_t count,
+    const double* x, const double* y, const double* xVariance, const double* yVariance,
+    double* estimates, double* variances, EstimatorStatus* statuses
+) {
+    executor.updateAndEstimate(estimators, count, x, y, xVariance, yVariance, estimates, variances, statuses);
+}
+
+// update_and_estimate(x, y, [x_variance,] y_variance, estimates[, variances[, statuses]]): one tick of a fleet.
+template <typename Estimator>
+PyObject* fleet_update_and_estimate(PyObject* self, PyObject* args) {
+    FleetObject<Estimator>* fleet = reinterpret_cast<FleetObject<Estimator>*>(self);
+    FleetGuard<Estimator> guard(fleet);
+    PyObject* items[7];
+    Measurements<Estimator> measurements;
+    Buffer estimates, variances, statuses;
+    size_t count = fleet->estimators == nullptr ? 0 : fleet->estimators->size();
+    if (!guard.acquire() || !split_arguments<Estimator>(args, "update_and_estimate", 0, 1, 3, items)
+        || !measurements.acquire(items[0], items[1], items[2], items[3]) || !measurements.checkLength(count)
+        || !acquire_results(estimates, variances, statuses, items[4], items[5], items[6], count)) {
+        return nullptr;
+    }
+
+    bool ok = run_without_gil([&]() {
+        update_and_estimate(*fleet->executor, fleet->estimators->data(), count,
+            measurements.x.template data<double>(), measurements.y.template data<double>(),
+            measurements.xVariance.template data<double>(), measurements.yVariance.template data<double>(),
+            estimates.data<double>(), variances.data<double>(), statuses.data<EstimatorStatus>());
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+template <typename Estimator>
+PyObject* make_fleet_type() {
+    static PyMethodDef methods[] = {
+        {"update", reinterpret_cast<PyCFunction>(fleet_update<Estimator>), METH_VARARGS,
+            "Update every estimator with one measurement each, in parallel."},
+        {"update_series", reinterpret_cast<PyCFunction>(fleet_update_series<Estimator>), METH_VARARGS,
+            "Update one estimator with many measurements, in order."},
+        {"update_records", reinterpret_cast<PyCFunction>(fleet_update_records<Estimator>), METH_VARARGS,
+            "Update estimators by id (int64 array), in array order per estimator, in parallel."},
+        {"update_one", reinterpret_cast<PyCFunction>(fleet_update_one<Estimator>), METH_VARARGS,
+            "Update one estimator with one measurement."},
+        {"estimate", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(fleet_estimate<Estimator>)), METH_VARARGS | METH_KEYWORDS,
+            "Write every estimate (and optionally variance and int32 status) into the given arrays, in parallel."},
+        {"estimate_one", reinterpret_cast<PyCFunction>(fleet_estimate_one<Estimator>), METH_VARARGS,
+            "Return (estimate, variance, status) of one estimator."},
+        {"update_and_estimate", reinterpret_cast<PyCFunction>(fleet_update_and_estimate<Estimator>), METH_VARARGS,
+            "update followed by estimate in a single parallel pass."},
+        {nullptr, nullptr, 0, nullptr}
+    };
+    static PyType_Slot slots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+        {Py_tp_init, reinterpret_cast<void*>(fleet_init<Estimator>)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(fleet_dealloc<Estimator>)},
+        {Py_tp_methods, methods},
+        {Py_sq_length, reinterpret_cast<void*>(fleet_length<Estimator>)},
+        {Py_tp_doc, const_cast<char*>(FleetTraits<Estimator>::doc)},
+        {0, nullptr}
+    };
+    static PyType_Spec spec = {
+        FleetTraits<Estimator>::name, sizeof(FleetObject<Estimator>), 0, Py_TPFLAGS_DEFAULT, slots
+    };
+    return PyType_FromSpec(&spec);
+}
+
+
+// real_roots(a, b, c, d, e, roots, counts): roots of every quartic, 4 per quartic into roots and the number found into counts (uint8).
+PyObject* real_roots(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"a", "b", "c", "d", "e", "roots", "counts", nullptr};
+    PyObject* objects[7];
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOOOOO", const_cast<char**>(keywords),
+            &objects[0], &objects[1], &objects[2], &objects[3], &objects[4], &objects[5], &objects[6])) {
+        return nullptr;
+    }
+
+    Buffer coefficients[5];
+    Buffer roots, counts;
+    for (int i = 0; i < 5; ++i) {
+        if (!acquire_doubles(coefficients[i], objects[i], keywords[i]) || !check_length(coefficients[i], keywords[i], coefficients[0].size())) {
+            return nullptr;
+        }
+    }
+    size_t count = coefficients[0].size();
+    if (!acquire_doubles(roots, objects[5], "roots", true) || !counts.acquire(objects[6], "counts", "B", 1, true)
+        || !check_length(roots, "roots", 4 * count) || !check_length(counts, "counts", count)) {
+        return nullptr;
+    }
+
+    bool ok = run_without_gil([&]() {
+        calculate_real_roots_batch(
+            coefficients[0].data<double>(), coefficients[1].data<double>(), coefficients[2].data<double>(),
+            coefficients[3].data<double>(), coefficients[4].data<double>(), count, roots.data<double>(), counts.data<unsigned char>()
+        );
+    });
+    if (!ok) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// status_name(status) -> description of an EstimatorStatus code
+PyObject* status_name(PyObject*, PyObject* args) {
+    int status;
+    if (!PyArg_ParseTuple(args, "i", &status)) {
+        return nullptr;
+    }
+    if (status < 0 || status > static_cast<int>(EstimatorStatus::NotFinite)) {
+        PyErr_Format(PyExc_ValueError, "%d is not an estimator status", status);
+        return nullptr;
+    }
+    return PyUnicode_FromString(toString(static_cast<EstimatorStatus>(status)));
+}
+
+PyMethodDef moduleMethods[] = {
+    {"real_roots", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(real_roots)), METH_VARARGS | METH_KEYWORDS,
+        "real_roots(a, b, c, d, e, roots, counts)\n\nReal roots of a[i] x^4 + ... + e[i] for every i, written 4 per quartic into roots "
+        "(float64, 4 * len(a)) and the number found into counts (uint8, len(a))."},
+    {"status_name", status_name, METH_VARARGS, "Description of an estimator status code."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef moduleDefinition = {
+    PyModuleDef_HEAD_INIT, "recursive_optimizers",
+    "Batch, zero copy bindings over the recursive estimators. Arrays are float64 unless noted and are never copied.",
+    -1, moduleMethods, nullptr, nullptr, nullptr, nullptr
+};
+
+}
+
+
+PyMODINIT_FUNC PyInit_recursive_optimizers() {
+    PyObject* module = PyModule_Create(&moduleDefinition);
+    if (module == nullptr) {
+        return nullptr;
+    }
+
+    PyObject* types[2] = {make_fleet_type<VarianceWeightedTotalLeastSquares>(), make_fleet_type<DualVarianceWeightedTotalLeastSquares>()};
+    const char* names[2] = {"VWTLSFleet", "DVWTLSFleet"};
+    for (int i = 0; i < 2; ++i) {
+        if (types[i] == nullptr || PyModule_AddObject(module, names[i], types[i]) != 0) {
+            Py_XDECREF(types[i]);
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }
+    return module;
+}
@@ -0,0 +1,296 @@
+"""Tests of the Python bindings, with the stdlib only.
+
+Run with the built module on the path, e.g.
+    PYTHONPATH=build/python python3 -m unittest python/test_bindings.py
+"""
+import math
+import threading
+import unittest
+from array import array
+
+import recursive_optimizers as ro
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+def doubles(values):
+    return array("d", values)
+
+
+def zeros(count, code="d"):
+    return array(code, bytes(count * array(code).itemsize))
+
+
+class Reference:
+    """The recursive statistics and closed forms of the C++ estimators, with the variance ratio fixed at 1 for DVWTLS."""
+
+    def __init__(self, dual, nominal_value, forgetting_factor, initial_x_variance, initial_y_variance):
+        self.dual = dual
+        self.forgetting_factor = forgetting_factor
+        self.c = [1 / initial_y_variance, nominal_value / initial_y_variance, nominal_value ** 2 / initial_y_variance]
+        if dual:
+            self.c += [1 / initial_x_variance, nominal_value / initial_x_variance, nominal_value ** 2 / initial_x_variance]
+
+    def update(self, x, y, x_variance, y_variance):
+        terms = [x * x / y_variance, x * y / y_variance, y * y / y_variance]
+        if self.dual:
+            terms += [x * x / x_variance, x * y / x_variance, y * y / x_variance]
+        self.c = [self.forgetting_factor * c + term for c, term in zip(self.c, terms)]
+
+    def estimate(self):
+        if not self.dual:
+            # wtls_estimate and wtls_estimate_variance with a variance ratio of 1.
+            c1, c2, c3 = self.c
+            root = math.sqrt((c1 - c3) ** 2 + 4 * c2 * c2)
+            estimate = (c3 - c1 + root) / (2 * c2)
+            return estimate, (1 + estimate * estimate) ** 2 / root
+
+        # Newton on the stationary point quartic from the unweighted total least squares estimate, then the Hessian.
+        c1, c2, c3, c4, c5, c6 = self.c
+        quartic = [c5, 2 * c4 - c1 - c6, 3 * c2 - 3 * c5, c1 - 2 * c3 + c6, -c2]
+        estimate = (c3 + c6 - c1 - c4 + math.sqrt((c1 + c4 - c3 - c6) ** 2 + 4 * (c2 + c5) ** 2)) / (2 * (c2 + c5))
+        for _ in range(50):
+            value = derivative = 0.0
+            for coefficient in quartic:
+                derivative = derivative * estimate + value
+                value = value * estimate + coefficient
+            estimate -= value / derivative
+        e2 = estimate * estimate
+        top = (-2 * c5 * e2 * e2 * estimate + (3 * c3 - 6 * c4 + 3 * c6) * e2 * e2 + (-12 * c2 + 16 * c5) * e2 * estimate
+               + (-8 * c1 + 10 * c3 + 6 * c4 - 8 * c6) * e2 + (12 * c2 - 6 * c5) * estimate + c1 - 2 * c3 + c6)
+        return estimate, (e2 + 1) ** 4 / top
+
+
+def measurements(count, tick):
+    """One noisy measurement of y = w x per estimator, each estimator with its own slope w."""
+    x = [1.0 + 0.1 * ((i + tick) % 7) for i in range(count)]
+    y = [(0.5 + 0.25 * i) * x[i] + 0.01 * (((i + 3) * (tick + 5)) % 7 - 3) for i in range(count)]
+    x_variance = [0.01 * (1 + (i + tick) % 3) for i in range(count)]
+    y_variance = [0.02 * (1 + (i * tick) % 2) for i in range(count)]
+    return x, y, x_variance, y_variance
+
+
+class RootsTest(unittest.TestCase):
+    def test_real_roots_match_known_roots(self):
+        # (x - 1)(x - 2)(x + 3)(x - 4), x^4 + 1, 2 (x^2 - 9)(x^2 + 1) and the cubic (x - 1)(x + 2)(x - 5).
+        a = doubles([1.0, 1.0, 2.0, 0.0])
+        b = doubles([-4.0, 0.0, 0.0, 1.0])
+        c = doubles([-7.0, 0.0, -16.0, -4.0])
+        d = doubles([34.0, 0.0, 0.0, -7.0])
+        e = doubles([-24.0, 1.0, -18.0, 10.0])
+        roots = zeros(16)
+        counts = zeros(4, "B")
+        ro.real_roots(a, b, c, d, e, roots, counts)
+
+        expected = [[-3.0, 1.0, 2.0, 4.0], [], [-3.0, 3.0], [-2.0, 1.0, 5.0]]
+        self.assertEqual(list(counts), [len(found) for found in expected])
+        for i, found in enumerate(expected):
+            for root, want in zip(sorted(roots[4 * i:4 * i + counts[i]]), found):
+                self.assertAlmostEqual(root, want, places=12)
+
+    def test_real_roots_checks_lengths(self):
+        one = doubles([1.0])
+        with self.assertRaises(ValueError):
+            ro.real_roots(one, one, one, one, doubles([1.0, 2.0]), zeros(4), zeros(1, "B"))
+        with self.assertRaises(ValueError):
+            ro.real_roots(one, one, one, one, one, zeros(3), zeros(1, "B"))
+        with self.assertRaises(TypeError):
+            ro.real_roots(one, one, one, one, one, zeros(4), zeros(1, "i"))
+
+
+class StatusTest(unittest.TestCase):
+    def test_status_name(self):
+        self.assertEqual(ro.status_name(0), "Ok")
+        self.assertEqual(ro.status_name(6), "All roots are complex.")
+        with self.assertRaises(ValueError):
+            ro.status_name(-1)
+        with self.assertRaises(ValueError):
+            ro.status_name(9)
+
+
+class FleetTest(unittest.TestCase):
+    count = 9
+    ticks = 12
+
+    def fleets(self, **kwargs):
+        """A VWTLS and a DVWTLS fleet with the same prior, and a reference estimator per estimator of each."""
+        vwtls = ro.VWTLSFleet(self.count, 1.0, 1.0, 0.98, 10.0, **kwargs)
+        dvwtls = ro.DVWTLSFleet(self.count, 1.0, 0.98, 10.0, 10.0, 1.0, **kwargs)
+        references = {
+            vwtls: [Reference(False, 1.0, 0.98, 10.0, 10.0) for _ in range(self.count)],
+            dvwtls: [Reference(True, 1.0, 0.98, 10.0, 10.0) for _ in range(self.count)],
+        }
+        return references
+
+    @staticmethod
+    def arguments(fleet, x, y, x_variance, y_variance):
+        if isinstance(fleet, ro.DVWTLSFleet):
+            return doubles(x), doubles(y), doubles(x_variance), doubles(y_variance)
+        return doubles(x), doubles(y), doubles(y_variance)
+
+    def test_update_and_estimate_match_reference(self):
+        for fleet, references in self.fleets(threads=3).items():
+            for tick in range(self.ticks):
+                x, y, x_variance, y_variance = measurements(self.count, tick)
+                fleet.update(*self.arguments(fleet, x, y, x_variance, y_variance))
+                for i, reference in enumerate(references):
+                    # VWTLS takes x to have the y variance scaled by the variance ratio of 1.
+                    reference.update(x[i], y[i], x_variance[i] if reference.dual else y_variance[i], y_variance[i])
+
+            estimates, variances, statuses = zeros(self.count), zeros(self.count), zeros(self.count, "i")
+            fleet.estimate(estimates, variances, statuses)
+            for i, reference in enumerate(references):
+                estimate, variance = reference.estimate()
+                self.assertEqual(statuses[i], 0)
+                self.assertAlmostEqual(estimates[i], estimate, delta=1e-10 * abs(estimate))
+                self.assertAlmostEqual(variances[i], variance, delta=1e-8 * variance)
+                self.assertEqual(fleet.estimate_one(i), (estimates[i], variances[i], 0))
+
+    def test_batch_calls_match_one_at_a_time(self):
+        for kind in (ro.VWTLSFleet, ro.DVWTLSFleet):
+            series = kind(self.count, 1.0, threads=1)
+            single = kind(self.count, 1.0, threads=1)
+            combined = kind(self.count, 1.0, threads=2)
+            columns = [[] for _ in range(4)]
+            estimates, variances = zeros(self.count), zeros(self.count)
+            for tick in range(self.ticks):
+                tick_measurements = measurements(self.count, tick)
+                for column, values in zip(columns, tick_measurements):
+                    column.append(values)
+                for i in range(self.count):
+                    single.update_one(i, *[values[i] for values in self.arguments(single, *tick_measurements)])
+                combined.update_and_estimate(*self.arguments(combined, *tick_measurements), estimates, variances)
+
+            for i in range(self.count):
+                series.update_series(i, *self.arguments(series, *[[tick[i] for tick in column] for column in columns]))
+                estimate, variance, status = single.estimate_one(i)
+                self.assertEqual(status, 0)
+                self.assertEqual((estimates[i], variances[i]), (estimate, variance))
+                # update_series weights by precision, so only rounding differs.
+                self.assertAlmostEqual(series.estimate_one(i)[0], estimate, delta=1e-12 * abs(estimate))
+
+    def test_rejects_wrong_types_and_lengths(self):
+        fleet = ro.DVWTLSFleet(4)
+        right = doubles([1.0] * 4)
+        with self.assertRaises(TypeError):
+            fleet.update(array("f", [1.0] * 4), right, right, right)
+        with self.assertRaises(ValueError):
+            fleet.update(right, right, right, doubles([1.0] * 3))
+        with self.assertRaises(TypeError):
+            fleet.update(right, right, right)
+        with self.assertRaises(TypeError):
+            fleet.update_records(array("i", [0]), doubles([1.0]), doubles([1.0]), doubles([1.0]), doubles([1.0]))
+        with self.assertRaises(IndexError):
+            fleet.update_series(4, right, right, right, right)
+        with self.assertRaises(TypeError):
+            fleet.estimate(zeros(4), zeros(4), zeros(4, "d"))
+        with self.assertRaises(ValueError):
+            fleet.estimate(zeros(5))
+        # Outputs must be writable and contiguous, as they are written in place.
+        with self.assertRaises(BufferError):
+            fleet.estimate(bytes(32))
+        with self.assertRaises(BufferError):
+            fleet.estimate(memoryview(zeros(8))[::2])
+        with self.assertRaises(ValueError):
+            ro.DVWTLSFleet(4, forgetting_factor=1.5)
+
+    def test_results_are_written_into_the_callers_buffer(self):
+        fleet = ro.VWTLSFleet(4, 2.0)
+        storage = doubles([-1.0] * 8)
+        fleet.estimate(memoryview(storage)[2:6])
+        self.assertEqual(list(storage[:2]) + list(storage[6:]), [-1.0] * 4)
+        for estimate in storage[2:6]:
+            self.assertAlmostEqual(estimate, 2.0, places=12)
+
+        # Inputs are read in place too, a change to the array is seen by the next call.
+        x = doubles([1.0] * 4)
+        y = doubles([2.0] * 4)
+        variances = doubles([1e-4] * 4)
+        fleet.update(x, y, variances)
+        y[0] = 8.0
+        fleet.update(x, y, variances)
+        fleet.estimate(memoryview(storage)[2:6])
+        self.assertGreater(storage[2], storage[3])
+
+    @unittest.skipIf(np is None, "NumPy is not installed")
+    def test_numpy_arrays(self):
+        fleet = ro.DVWTLSFleet(16, 1.0, threads=2)
+        x = np.linspace(1.0, 2.0, 16)
+        variances = np.full(16, 1e-3)
+        fleet.update(x, 3.0 * x, variances, variances)
+        estimates = np.zeros(24)
+        statuses = np.zeros(16, dtype=np.int32)
+        fleet.estimate(estimates[4:20], None, statuses)
+        np.testing.assert_allclose(estimates[4:20], 3.0, rtol=1e-3)
+        self.assertFalse(estimates[:4].any() or estimates[20:].any())
+        self.assertFalse(statuses.any())
+        with self.assertRaises(TypeError):
+            fleet.estimate(np.zeros(16, dtype=np.float32))
+        # NumPy reports a strided array as a ValueError rather than a BufferError.
+        with self.assertRaises(ValueError):
+            fleet.estimate(np.zeros(32)[::2])
+
+    def test_update_records_matches_one_at_a_time(self):
+        count = 37
+        batch = ro.DVWTLSFleet(count, 1.0, threads=4)
+        single = ro.DVWTLSFleet(count, 1.0, threads=1)
+
+        # Several records per estimator, interleaved, so the order within an estimator matters.
+        ids = array("q", [(i * 7) % count for i in range(300)])
+        x = doubles([1.0 + 0.01 * i for i in range(300)])
+        y = doubles([2.0 * x[i] + 0.001 * (i % 5) for i in range(300)])
+        x_variance = doubles([0.01 + 0.001 * (i % 3) for i in range(300)])
+        y_variance = doubles([0.02] * 300)
+
+        batch.update_records(ids, x, y, x_variance, y_variance)
+        for i in range(300):
+            single.update_one(ids[i], x[i], y[i], x_variance[i], y_variance[i])
+
+        for i in range(count):
+            self.assertEqual(batch.estimate_one(i), single.estimate_one(i))
+
+    def test_update_records_rejects_unknown_ids(self):
+        fleet = ro.VWTLSFleet(4)
+        with self.assertRaises(IndexError):
+            fleet.update_records(array("q", [4]), doubles([1.0]), doubles([1.0]), doubles([1.0]))
+
+    def test_concurrent_calls_raise(self):
+        fleet = ro.DVWTLSFleet(1, 1.0, threads=1)
+        length = 2_000_000
+        x = doubles([1.0 + 1e-6 * i for i in range(length)])
+        y = doubles([2.0 * v for v in x])
+        variances = doubles([0.01] * length)
+
+        # A long update_series releases the GIL, anything else on the fleet meanwhile must raise rather than race.
+        # Retried as the other thread may finish before this one gets the GIL.
+        raised = False
+        for _ in range(20):
+            worker = threading.Thread(target=fleet.update_series, args=(0, x, y, variances, variances))
+            worker.start()
+            while worker.is_alive() and not raised:
+                try:
+                    fleet.estimate_one(0)
+                    continue
+                except RuntimeError as error:
+                    message = str(error)
+                try:
+                    fleet.__init__(1)
+                except RuntimeError:
+                    raised = True
+            worker.join()
+            if raised:
+                break
+        self.assertTrue(raised)
+        self.assertIn("in use", message)
+
+        # Neither call changed the fleet, which is usable again.
+        self.assertEqual(len(fleet), 1)
+        estimate, variance, status = fleet.estimate_one(0)
+        self.assertAlmostEqual(estimate, 2.0, places=6)
+
+
+if __name__ == "__main__":
+    unittest.main()
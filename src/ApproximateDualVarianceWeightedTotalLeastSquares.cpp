@@ -0,0 +1,66 @@
+#include "ApproximateDualVarianceWeightedTotalLeastSquares.h"
+
+
+ApproximateDualVarianceWeightedTotalLeastSquares::ApproximateDualVarianceWeightedTotalLeastSquares(double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance, double varianceRatio)
+    : DualVarianceWeightedTotalLeastSquares(nominalValue, forgettingFactor, initialXVariance, initialYVariance, varianceRatio),
+      newtonSteps(3) {
+}
+
+
+EstimatorStatus ApproximateDualVarianceWeightedTotalLeastSquares::tryCreate(ApproximateDualVarianceWeightedTotalLeastSquares& out,
+            double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance, double varianceRatio) {
+    EstimatorStatus status = DualVarianceWeightedTotalLeastSquares::tryCreate(
+        out, nominalValue, forgettingFactor, initialXVariance, initialYVariance, varianceRatio
+    );
+    if (status == EstimatorStatus::Ok) {
+        out.newtonSteps = 3;
+    }
+    return status;
+}
+
+
+void ApproximateDualVarianceWeightedTotalLeastSquares::setNewtonSteps(int newtonSteps) {
+    if (newtonSteps < 0) {
+        throw std::invalid_argument( "Newton Steps must not be negative got " + std::to_string(newtonSteps) );
+    }
+    this->newtonSteps = newtonSteps;
+}
+
+
+int ApproximateDualVarianceWeightedTotalLeastSquares::getNewtonSteps() const {
+    return this->newtonSteps;
+}
+
+
+double ApproximateDualVarianceWeightedTotalLeastSquares::getEstimateUncorrected() const {
+    return dual_wtls_approximate_estimate(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, this->newtonSteps);
+}
+
+
+double ApproximateDualVarianceWeightedTotalLeastSquares::getVariance() {
+    return this->getVarianceAt(this->getEstimateUncorrected());
+}
+
+
+double ApproximateDualVarianceWeightedTotalLeastSquares::getEstimate() {
+    return this->correctEstimate(this->getEstimateUncorrected());
+}
+
+
+EstimatorResult ApproximateDualVarianceWeightedTotalLeastSquares::tryGetEstimate() {
+    return this->estimateResult(EstimatorStatus::Ok, this->getEstimateUncorrected());
+}
+
+
+EstimatorResult ApproximateDualVarianceWeightedTotalLeastSquares::tryGetVariance() {
+    return this->varianceResult(EstimatorStatus::Ok, this->getEstimateUncorrected());
+}
+
+
+void ApproximateDualVarianceWeightedTotalLeastSquares::tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance) {
+    double uncorrected = this->getEstimateUncorrected();
+    estimate = this->estimateResult(EstimatorStatus::Ok, uncorrected);
+    variance = this->varianceResult(EstimatorStatus::Ok, uncorrected);
+}
\ No newline at end of file
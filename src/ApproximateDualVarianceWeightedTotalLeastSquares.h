@@ -0,0 +1,115 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include "helper/wtls.h"
+#include "EstimatorStatus.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+/**
+ * Estimates the weight W as Y=WX with the same statistics and merit function as DualVarianceWeightedTotalLeastSquares,
+ * but solves for the estimate approximately (AWTLS) in a fixed handful of operations, see dual_wtls_approximate_estimate.
+ *
+ * For cells updated at rates where solving the quartic on every estimate is too slow. The estimate matches
+ * DualVarianceWeightedTotalLeastSquares to near rounding once the x and y variances are close to the proportion
+ * given by the variance ratio, and can land on a different stationary point when they are far from it.
+ * The statistics and their updates are DualVarianceWeightedTotalLeastSquares's own, only the solve differs.
+ *
+* Gregory L. Plett,
+* Recursive approximate weighted total least squares estimation of battery cell total capacity,
+* Journal of Power Sources,
+* Volume 196, Issue 4,
+* 2011,
+* Pages 2319-2331,
+* ISSN 0378-7753,
+* https://doi.org/10.1016/j.jpowsour.2010.09.048
+*/
+class ApproximateDualVarianceWeightedTotalLeastSquares : private DualVarianceWeightedTotalLeastSquares {
+    public:
+        /**
+         * @brief Constructor for ApproximateDualVarianceWeightedTotalLeastSquares
+         *
+         * @param nominalValue Initial estimate of the weight
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         * @param initialXVariance Variance of a hypothetical (imaginary) measurement of x when x = 1 and y = nominalValue.
+         * @param initialYVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         * @param varianceRatio The average relative uncertainty between x and y values, the approximation is exact when
+         *                      every measurement has this ratio. By default this class uses the ratio of the first x and y variance found.
+         */
+        ApproximateDualVarianceWeightedTotalLeastSquares(
+            double nominalValue=0.0, double forgettingFactor=1.0,
+            double initialXVariance=100.0, double initialYVariance=100.0,
+            double varianceRatio=-1
+        );
+
+        using DualVarianceWeightedTotalLeastSquares::checkParameters;
+
+        /**
+         * @brief Non-throwing constructor, out is only written when the parameters are valid
+         *
+         * @return EstimatorStatus::Ok on success, otherwise the reason the parameters were rejected
+         */
+        static EstimatorStatus tryCreate(
+            ApproximateDualVarianceWeightedTotalLeastSquares& out,
+            double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance,
+            double varianceRatio
+        );
+
+        using DualVarianceWeightedTotalLeastSquares::update;
+        using DualVarianceWeightedTotalLeastSquares::updatePrecision;
+
+        /**
+         * @brief Set how many Newton steps refine the closed form starting point, 3 by default
+         *
+         * Each step roughly squares the relative error, 0 gives the closed form alone.
+         */
+        void setNewtonSteps(int newtonSteps);
+
+        /**
+         * @brief Get how many Newton steps refine the closed form starting point
+         */
+        int getNewtonSteps() const;
+
+        /**
+         * @brief Get the current variance of the weight estimate
+         *
+         * @return Estimated variance of the weight
+         */
+        double getVariance();
+
+        /**
+         * @brief Get the current estimate
+         *
+         * @return Current estimate
+         */
+        double getEstimate();
+
+        /**
+         * @brief Get the current estimate without throwing
+         *
+         * @return The estimate, or the last good estimate and the reason the estimate is unusable
+         */
+        EstimatorResult tryGetEstimate();
+
+        /**
+         * @brief Get the current variance of the weight estimate without throwing
+         *
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        EstimatorResult tryGetVariance();
+
+        /**
+         * @brief Get the current estimate and its variance without throwing, solving once for both
+         */
+        void tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance);
+
+    private:
+        int newtonSteps;
+
+        /**
+         * @brief Get the current estimate without correction for varianceRatio
+         */
+        double getEstimateUncorrected() const;
+};
\ No newline at end of file
@@ -0,0 +1,437 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "helper/journal.h"
+#include "helper/WorkStealingPool.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+
+// Words of an estimator that reads may write without changing its statistics, see CheckpointJournal.
+template <typename Estimator>
+uint64_t checkpointIgnoredWords(const Estimator*) {
+    return 0;
+}
+
+inline uint64_t checkpointIgnoredWords(const VarianceWeightedTotalLeastSquares*) {
+    return VarianceWeightedTotalLeastSquares::resultCacheWords();
+}
+
+inline uint64_t checkpointIgnoredWords(const DualVarianceWeightedTotalLeastSquares*) {
+    return DualVarianceWeightedTotalLeastSquares::resultCacheWords();
+}
+
+
+/**
+ * Crash recovery for a large fleet of estimators, where the cost of a checkpoint follows the number of
+ * estimators updated since the last one rather than the size of the fleet.
+ *
+ * The journal keeps two files: path + ".base", a full snapshot, and path + ".journal", an append only list of
+ * records. Each checkpoint appends one record holding only the estimators that changed since the previous
+ * checkpoint, each as a bit mask of the 64 bit words that changed and the XOR of the old and new word as a
+ * varint. Statistics that moved a little share their sign, exponent and leading mantissa bits with the old
+ * value, so the XOR is mostly leading zeros and encodes in a few bytes.
+ *
+ * Once the journal outgrows the snapshot by compactionRatio the fleet is written as a new snapshot and the
+ * journal is restarted. Every record carries a checksum, so a record torn by a crash is dropped on recovery
+ * along with anything after it.
+ *
+ * Only the statistics are compared: the last good estimate and variance that the try getters cache
+ * (see checkpointIgnoredWords) are left out of the journal, so reading an idle estimator doesn't get it journaled.
+ * Recovered estimators hold the cached results of the last snapshot, which only matter if their next solve fails.
+ *
+ * Because XOR deltas commute, recover replays the records in parallel.
+ *
+ * Estimator must be trivially copyable, e.g. VarianceWeightedTotalLeastSquares or
+ * DualVarianceWeightedTotalLeastSquares. Snapshots are in native byte order. Not thread safe.
+ */
+template <typename Estimator>
+class CheckpointJournal {
+    public:
+        /**
+         * @brief Constructor for CheckpointJournal, starts a new snapshot of the fleet
+         *
+         * @param path Path the ".base" and ".journal" files are named after
+         * @param fleet The estimators to checkpoint
+         * @param count Number of estimators in the fleet
+         * @param compactionRatio Compact once the journal is this many times the size of the snapshot, 0 never compacts
+         * @param sync Whether to fsync every checkpoint, turning this off trades durability on power loss for speed
+         */
+        CheckpointJournal(const std::string& path, const Estimator* fleet, size_t count, double compactionRatio=1.0, bool sync=true);
+
+        CheckpointJournal(const CheckpointJournal&) = delete;
+        CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+
+        ~CheckpointJournal();
+
+        /**
+         * @brief Append the estimators that changed since the last checkpoint to the journal
+         *
+         * @param fleet The estimators, the same count as the constructor
+         * @return Number of estimators written
+         */
+        size_t checkpoint(const Estimator* fleet);
+
+        /**
+         * @brief Append the estimators that changed since the last checkpoint, only looking at the given candidates
+         *
+         * Use this when the caller already knows which estimators it updated, so the checkpoint doesn't scan the fleet.
+         * Estimators that changed but are not candidates are picked up by a later checkpoint.
+         *
+         * @param fleet The estimators, the same count as the constructor
+         * @param candidates Indices of the estimators that may have changed, in any order
+         * @param candidateCount Number of candidates
+         * @return Number of estimators written
+         */
+        size_t checkpoint(const Estimator* fleet, const size_t* candidates, size_t candidateCount);
+
+        /**
+         * @brief Write the whole fleet as a new snapshot and restart the journal
+         */
+        void compact(const Estimator* fleet);
+
+        /**
+         * @brief Size of the journal file in bytes
+         */
+        size_t journalBytes() const;
+
+        /**
+         * @brief Size of the snapshot file in bytes
+         */
+        size_t snapshotBytes() const;
+
+        /**
+         * @brief Restore a fleet from its last snapshot and journal
+         *
+         * @param path Path the journal was created with
+         * @param fleet Set to the state at the last complete checkpoint
+         * @param count Number of estimators in the fleet, must match the snapshot
+         * @param threads maximum number of threads to replay with, 0 uses the hardware concurrency
+         * @return Number of journal records replayed
+         */
+        static size_t recover(const std::string& path, Estimator* fleet, size_t count, unsigned int threads=0);
+
+    private:
+        static_assert(std::is_trivially_copyable<Estimator>::value, "Estimator must be trivially copyable to be journaled");
+        static_assert(sizeof(Estimator) % sizeof(uint64_t) == 0, "Estimator must be a whole number of 64 bit words");
+        static_assert(sizeof(Estimator) / sizeof(uint64_t) <= 64, "Estimator must fit in a 64 bit word mask");
+
+        static constexpr size_t words = sizeof(Estimator) / sizeof(uint64_t);
+        static constexpr uint64_t baseMagic = 0x455341424b504352ull; // "RCPKBASE"
+        static constexpr uint64_t journalMagic = 0x4c4e524a4b504352ull; // "RCPKJRNL"
+        static constexpr uint64_t formatVersion = 1;
+        static constexpr size_t headerBytes = 5 * sizeof(uint64_t);
+        static constexpr size_t recordHeaderBytes = 2 * sizeof(uint64_t);
+
+        std::string basePath;
+        std::string journalPath;
+        size_t count;
+        double compactionRatio;
+        bool sync;
+        int journal;
+        uint64_t generation;
+        size_t journalSize;
+        size_t snapshotSize;
+        std::vector<uint64_t> shadow; // fleet as of the last checkpoint
+        uint64_t ignoredWords;
+
+        bool encode(const Estimator* fleet, size_t index, size_t& previous, std::vector<unsigned char>& payload);
+        void append(const Estimator* fleet, const std::vector<unsigned char>& payload);
+
+        static void putHeader(std::vector<unsigned char>& out, uint64_t magic, size_t count, uint64_t generation);
+        static bool getHeader(const unsigned char*& data, const unsigned char* end, uint64_t magic, size_t count, uint64_t& generation);
+        static void replay(const unsigned char* payload, size_t size, uint64_t* image, size_t count);
+};
+
+
+template <typename Estimator>
+CheckpointJournal<Estimator>::CheckpointJournal(const std::string& path, const Estimator* fleet, size_t count, double compactionRatio, bool sync)
+    : basePath(path + ".base"), journalPath(path + ".journal"), count(count), compactionRatio(compactionRatio),
+      sync(sync), journal(-1), generation(0), journalSize(0), snapshotSize(0),
+      ignoredWords(checkpointIgnoredWords(static_cast<const Estimator*>(nullptr))) {
+    if (count == 0) {
+        throw std::invalid_argument( "Count must grater then 0 got " + std::to_string(count) );
+    }
+    if (!(compactionRatio >= 0)) {
+        throw std::invalid_argument( "Compaction Ratio must not be negative got " + std::to_string(compactionRatio) );
+    }
+
+    // Carry on from the previous generation so a stale journal can never be replayed over the new snapshot.
+    bool exists = false;
+    std::vector<unsigned char> previous = read_file(this->basePath, &exists);
+    const unsigned char* data = previous.data();
+    uint64_t previousGeneration;
+    if (exists && getHeader(data, data + previous.size(), baseMagic, count, previousGeneration)) {
+        this->generation = previousGeneration;
+    }
+
+    this->compact(fleet);
+}
+
+
+template <typename Estimator>
+CheckpointJournal<Estimator>::~CheckpointJournal() {
+    if (this->journal >= 0) {
+        close(this->journal);
+    }
+}
+
+
+template <typename Estimator>
+void CheckpointJournal<Estimator>::putHeader(std::vector<unsigned char>& out, uint64_t magic, size_t count, uint64_t generation) {
+    put_fixed64(out, magic);
+    put_fixed64(out, formatVersion);
+    put_fixed64(out, sizeof(Estimator));
+    put_fixed64(out, count);
+    put_fixed64(out, generation);
+}
+
+
+template <typename Estimator>
+bool CheckpointJournal<Estimator>::getHeader(const unsigned char*& data, const unsigned char* end, uint64_t magic, size_t count, uint64_t& generation) {
+    uint64_t fields[4];
+    for (uint64_t& field : fields) {
+        if (!get_fixed64(data, end, field)) {
+            return false;
+        }
+    }
+    if (!get_fixed64(data, end, generation)) {
+        return false;
+    }
+    return fields[0] == magic && fields[1] == formatVersion && fields[2] == sizeof(Estimator) && fields[3] == count;
+}
+
+
+template <typename Estimator>
+void CheckpointJournal<Estimator>::compact(const Estimator* fleet) {
+    ++this->generation;
+    this->shadow.resize(this->count * words);
+    std::memcpy(this->shadow.data(), fleet, this->count * sizeof(Estimator));
+
+    std::vector<unsigned char> base;
+    base.reserve(headerBytes + this->count * sizeof(Estimator) + sizeof(uint64_t));
+    putHeader(base, baseMagic, this->count, this->generation);
+    const unsigned char* image = reinterpret_cast<const unsigned char*>(this->shadow.data());
+    base.insert(base.end(), image, image + this->count * sizeof(Estimator));
+    put_fixed64(base, checksum_64(base.data(), base.size()));
+    write_file_atomically(this->basePath, base, this->sync);
+    this->snapshotSize = base.size();
+
+    // The new snapshot is in place before the old journal goes, a crash in between leaves a journal
+    // from the previous generation which recover ignores.
+    std::vector<unsigned char> header;
+    putHeader(header, journalMagic, this->count, this->generation);
+    write_file_atomically(this->journalPath, header, this->sync);
+    this->journalSize = header.size();
+
+    if (this->journal >= 0) {
+        close(this->journal);
+    }
+    this->journal = open(this->journalPath.c_str(), O_WRONLY | O_APPEND);
+    if (this->journal < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + this->journalPath);
+    }
+}
+
+
+template <typename Estimator>
+bool CheckpointJournal<Estimator>::encode(const Estimator* fleet, size_t index, size_t& previous, std::vector<unsigned char>& payload) {
+    uint64_t* old = this->shadow.data() + index * words;
+    uint64_t current[words];
+    std::memcpy(current, fleet + index, sizeof(Estimator));
+    for (size_t w = 0; w < words; ++w) {
+        if (this->ignoredWords & (uint64_t(1) << w)) {
+            current[w] = old[w];
+        }
+    }
+    if (std::memcmp(old, current, sizeof(Estimator)) == 0) {
+        return false;
+    }
+
+    put_varint(payload, index - previous);
+    put_word_delta(payload, old, current, words);
+    std::memcpy(old, current, sizeof(Estimator));
+    previous = index;
+    return true;
+}
+
+
+template <typename Estimator>
+void CheckpointJournal<Estimator>::append(const Estimator* fleet, const std::vector<unsigned char>& payload) {
+    std::vector<unsigned char> record;
+    record.reserve(recordHeaderBytes + payload.size());
+    put_fixed64(record, payload.size());
+    put_fixed64(record, checksum_64(payload.data(), payload.size()));
+    record.insert(record.end(), payload.begin(), payload.end());
+    append_to_file(this->journal, record, this->sync);
+    this->journalSize += record.size();
+
+    if (this->compactionRatio > 0 && this->journalSize > this->compactionRatio * this->snapshotSize) {
+        this->compact(fleet);
+    }
+}
+
+
+template <typename Estimator>
+size_t CheckpointJournal<Estimator>::checkpoint(const Estimator* fleet) {
+    std::vector<unsigned char> payload;
+    size_t changed = 0;
+    size_t previous = 0;
+    for (size_t i = 0; i < this->count; ++i) {
+        changed += this->encode(fleet, i, previous, payload);
+    }
+
+    if (changed > 0) {
+        this->append(fleet, payload);
+    }
+    return changed;
+}
+
+
+template <typename Estimator>
+size_t CheckpointJournal<Estimator>::checkpoint(const Estimator* fleet, const size_t* candidates, size_t candidateCount) {
+    // Entries are delta coded by index, so they have to go out in ascending order.
+    std::vector<size_t> sorted(candidates, candidates + candidateCount);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (!sorted.empty() && sorted.back() >= this->count) {
+        throw std::out_of_range( "Candidate " + std::to_string(sorted.back()) + " is outside the fleet" );
+    }
+
+    std::vector<unsigned char> payload;
+    size_t changed = 0;
+    size_t previous = 0;
+    for (size_t index : sorted) {
+        changed += this->encode(fleet, index, previous, payload);
+    }
+
+    if (changed > 0) {
+        this->append(fleet, payload);
+    }
+    return changed;
+}
+
+
+template <typename Estimator>
+size_t CheckpointJournal<Estimator>::journalBytes() const {
+    return this->journalSize;
+}
+
+
+template <typename Estimator>
+size_t CheckpointJournal<Estimator>::snapshotBytes() const {
+    return this->snapshotSize;
+}
+
+
+template <typename Estimator>
+void CheckpointJournal<Estimator>::replay(const unsigned char* payload, size_t size, uint64_t* image, size_t count) {
+    const unsigned char* end = payload + size;
+    uint64_t index = 0;
+    while (payload < end) {
+        uint64_t skip;
+        uint64_t mask;
+        if (!get_varint(payload, end, skip) || !get_varint(payload, end, mask) || skip >= count - index) {
+            throw std::invalid_argument( "Corrupt checkpoint journal record" );
+        }
+
+        index += skip;
+
+        uint64_t* estimator = image + index * words;
+        for (size_t w = 0; w < words; ++w) {
+            if (mask & (uint64_t(1) << w)) {
+                uint64_t delta;
+                if (!get_varint(payload, end, delta)) {
+                    throw std::invalid_argument( "Corrupt checkpoint journal record" );
+                }
+                // Records are applied concurrently, XOR commutes so the order they land in doesn't matter.
+                __atomic_fetch_xor(estimator + w, delta, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+
+template <typename Estimator>
+size_t CheckpointJournal<Estimator>::recover(const std::string& path, Estimator* fleet, size_t count, unsigned int threads) {
+    std::string basePath = path + ".base";
+    std::vector<unsigned char> base = read_file(basePath, nullptr);
+
+    const unsigned char* data = base.data();
+    const unsigned char* end = data + base.size();
+    uint64_t generation;
+    if (!getHeader(data, end, baseMagic, count, generation)) {
+        throw std::invalid_argument( "Checkpoint snapshot " + basePath + " does not match the fleet" );
+    }
+    uint64_t checksum;
+    const unsigned char* trailer = end - sizeof(uint64_t);
+    if (base.size() != headerBytes + count * sizeof(Estimator) + sizeof(uint64_t)
+        || !get_fixed64(trailer, end, checksum)
+        || checksum != checksum_64(base.data(), base.size() - sizeof(uint64_t))) {
+        throw std::invalid_argument( "Checkpoint snapshot " + basePath + " is corrupt" );
+    }
+
+    std::vector<uint64_t> image(count * words);
+    std::memcpy(image.data(), data, count * sizeof(Estimator));
+
+    bool exists = false;
+    std::vector<unsigned char> journal = read_file(path + ".journal", &exists);
+    data = journal.data();
+    end = data + journal.size();
+    uint64_t journalGeneration;
+
+    // Find where each record starts, the journal is only usable up to the first torn record.
+    struct Record {
+        const unsigned char* payload;
+        size_t size;
+        uint64_t checksum;
+    };
+    std::vector<Record> records;
+    if (exists && getHeader(data, end, journalMagic, count, journalGeneration) && journalGeneration == generation) {
+        while (true) {
+            uint64_t size;
+            Record record;
+            if (!get_fixed64(data, end, size) || !get_fixed64(data, end, record.checksum)
+                || size > static_cast<uint64_t>(end - data)) {
+                break;
+            }
+            record.payload = data;
+            record.size = size;
+            records.push_back(record);
+            data += size;
+        }
+    }
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    WorkStealingPool pool(static_cast<unsigned int>(std::min<size_t>(threads, std::max<size_t>(1, records.size()))));
+
+    std::vector<unsigned char> valid(records.size());
+    pool.parallelFor(records.size(), 1, [&](size_t begin, size_t stop) {
+        for (size_t i = begin; i < stop; ++i) {
+            valid[i] = checksum_64(records[i].payload, records[i].size) == records[i].checksum;
+        }
+    });
+    size_t replayed = std::find(valid.begin(), valid.end(), 0) - valid.begin();
+
+    pool.parallelFor(replayed, 1, [&](size_t begin, size_t stop) {
+        for (size_t i = begin; i < stop; ++i) {
+            replay(records[i].payload, records[i].size, image.data(), count);
+        }
+    });
+
+    // Estimator is trivially copyable (checked above) but has constructors, so copy through void * to say that is intended.
+    std::memcpy(static_cast<void*>(fleet), image.data(), count * sizeof(Estimator));
+    return replayed;
+}
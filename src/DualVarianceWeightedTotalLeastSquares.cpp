@@ -1,34 +1,98 @@
 #include "DualVarianceWeightedTotalLeastSquares.h"
+#include <algorithm>
 
 
 
 
 DualVarianceWeightedTotalLeastSquares::DualVarianceWeightedTotalLeastSquares(double nominalValue, double forgettingFactor, 
             double initialXVariance, double initialYVariance, double varianceRatio) {
-    if (forgettingFactor > 1 || forgettingFactor <= 0) {
-        throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+    switch (checkParameters(forgettingFactor, initialXVariance, initialYVariance, varianceRatio)) {
+        case EstimatorStatus::InvalidForgettingFactor:
+            throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+        case EstimatorStatus::InvalidInitialXVariance:
+            throw std::invalid_argument( "Initial X Variance must grater then 0 got " + std::to_string(initialXVariance) );
+        case EstimatorStatus::InvalidInitialYVariance:
+            throw std::invalid_argument( "Initial Y Variance must grater then 0 got " + std::to_string(initialYVariance) );
+        case EstimatorStatus::InvalidVarianceRatio:
+            throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+        default:
+            break;
     }
 
-    
-    this->forgettingFactor = forgettingFactor;
+    this->initialise(nominalValue, forgettingFactor, initialXVariance, initialYVariance, varianceRatio);
+}
+
+
+EstimatorStatus DualVarianceWeightedTotalLeastSquares::checkParameters(double forgettingFactor, 
+            double initialXVariance, double initialYVariance, double varianceRatio) {
+    if (forgettingFactor > 1 || forgettingFactor <= 0) {
+        return EstimatorStatus::InvalidForgettingFactor;
+    }
 
     if (initialXVariance <= 0) {
-        throw std::invalid_argument( "Initial X Variance must grater then 0 got " + std::to_string(initialXVariance) );
+        return EstimatorStatus::InvalidInitialXVariance;
     }
 
     if (initialYVariance <= 0) {
-        throw std::invalid_argument( "Initial Y Variance must grater then 0 got " + std::to_string(initialYVariance) );
+        return EstimatorStatus::InvalidInitialYVariance;
     }
 
-    if (varianceRatio != -1) {
-        if (varianceRatio <= 0) {
-            throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+    if (varianceRatio != -1 && varianceRatio <= 0) {
+        return EstimatorStatus::InvalidVarianceRatio;
+    }
+
+    return EstimatorStatus::Ok;
+}
+
+
+EstimatorStatus DualVarianceWeightedTotalLeastSquares::tryCreate(DualVarianceWeightedTotalLeastSquares& out,
+            double nominalValue, double forgettingFactor, 
+            double initialXVariance, double initialYVariance, double varianceRatio) {
+    EstimatorStatus status = checkParameters(forgettingFactor, initialXVariance, initialYVariance, varianceRatio);
+    if (status == EstimatorStatus::Ok) {
+        out.initialise(nominalValue, forgettingFactor, initialXVariance, initialYVariance, varianceRatio);
+    }
+    return status;
+}
+
+
+size_t DualVarianceWeightedTotalLeastSquares::createBatch(
+            const double* nominalValues, const double* forgettingFactors,
+            const double* initialXVariances, const double* initialYVariances,
+            const double* varianceRatios, size_t count,
+            DualVarianceWeightedTotalLeastSquares* out, EstimatorStatus* statuses) {
+    size_t created = 0;
+    for (size_t i = 0; i < count; ++i) {
+        statuses[i] = tryCreate(
+            out[i], nominalValues[i], forgettingFactors[i],
+            initialXVariances[i], initialYVariances[i], varianceRatios[i]
+        );
+        if (statuses[i] == EstimatorStatus::Ok) {
+            ++created;
         }
-    
+    }
+    return created;
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::initialise(double nominalValue, double forgettingFactor, 
+            double initialXVariance, double initialYVariance, double varianceRatio) {
+    this->forgettingFactor = forgettingFactor;
+    this->lastEstimate = nominalValue;
+    this->lastVariance = std::numeric_limits<double>::quiet_NaN();
+    this->quarticMethod = QuarticMethod::NBS;
+
+    if (varianceRatio != -1) {
         this->varianceRatio = varianceRatio;
         this->hasVarianceRatio = true;
+        this->inverseVarianceRatioSquared = 1 / (varianceRatio * varianceRatio);
 
         nominalValue = this->varianceRatio * nominalValue;
+    } else {
+        // Set by the first update
+        this->varianceRatio = 1.0;
+        this->hasVarianceRatio = false;
+        this->inverseVarianceRatioSquared = 1.0;
     }
 
     this->c1 = 1 / initialYVariance;
@@ -38,24 +102,13 @@ DualVarianceWeightedTotalLeastSquares::DualVarianceWeightedTotalLeastSquares(dou
     this->c4 = 1 / initialXVariance;
     this->c5 = nominalValue / initialXVariance;
     this->c6 = nominalValue * nominalValue / initialXVariance;
-    
-    
 }
 
 
 
 void DualVarianceWeightedTotalLeastSquares::update(double x, double y, double xVariance, double yVariance) {
     if (!this->hasVarianceRatio) {
-        // Asumes a value 
-        this->varianceRatio = std::sqrt(xVariance) / std::sqrt(yVariance);
-        this->hasVarianceRatio = true;
-
-        this->c1 /= this->varianceRatio * this->varianceRatio;
-        this->c2 /= this->varianceRatio;
-        // c3 is not affected because they cancle out
-        // c4 is not affected because it has no y factor
-        this->c5 *= this->varianceRatio;
-        this->c6 *= this->varianceRatio * this->varianceRatio;
+        this->setVarianceRatioFrom(xVariance, yVariance);
     }
     
 
@@ -74,79 +127,280 @@ void DualVarianceWeightedTotalLeastSquares::update(double x, double y, double xV
 }
 
 
-double DualVarianceWeightedTotalLeastSquares::getEstimateMerit(double estimate) {
-    
-    double estimateSq = estimate * estimate;
-    double top = this->c4 * estimateSq * estimateSq + 
-                -2 * this->c5 * estimateSq * estimate +
-                (this->c1 + this->c6) * estimateSq +
-                -2 * this->c2 * estimate + 
-                this->c3;
-    
-    double bottom = estimateSq + 1;
+void DualVarianceWeightedTotalLeastSquares::updatePrecision(double x, double y, double xPrecision, double yPrecision) {
+    if (!this->hasVarianceRatio) {
+        this->setVarianceRatioFromPrecision(xPrecision, yPrecision);
+    }
+
+    double correctedY = y * this->varianceRatio;
+    double yScale = yPrecision * this->inverseVarianceRatioSquared;
 
-    return top / (bottom * bottom);
+    this->c1 = this->forgettingFactor * this->c1 + x * x * yScale;
+    this->c2 = this->forgettingFactor * this->c2 + x * correctedY * yScale;
+    this->c3 = this->forgettingFactor * this->c3 + correctedY * correctedY * yScale;
+
+    this->c4 = this->forgettingFactor * this->c4 + x * x * xPrecision;
+    this->c5 = this->forgettingFactor * this->c5 + x * correctedY * xPrecision;
+    this->c6 = this->forgettingFactor * this->c6 + correctedY * correctedY * xPrecision;
 }
 
 
+void DualVarianceWeightedTotalLeastSquares::update(
+    const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count
+) {
+    for (size_t i = 0; i < count; ++i) {
+        this->updatePrecision(x[i], y[i], 1 / xVariance[i], 1 / yVariance[i]);
+    }
+}
 
-double DualVarianceWeightedTotalLeastSquares::getEstimateUncorrected() {
-    double a = this->c5;
-    double b = 2 * this->c4 - this->c1 - this->c6;
-    double c = 3 * this->c2 - 3 * this->c5;
-    double d = this->c1 - 2 * this->c3 + this->c6;
-    double e = -this->c2;
-    
-    std::vector<double> roots = calculate_real_roots(a,b,c,d,e);
-
-    int bestRootPos = -1;
-    double bestMerit;
-    for (int i = 0; i < roots.size(); ++i) {
-        double end = a * roots[i] * roots[i] * roots[i] * roots[i] + 
-                     b * roots[i] * roots[i] * roots[i] +
-                     c * roots[i] * roots[i] +
-                     d * roots[i] + e;
-        
-        if (bestRootPos == -1) {
-            bestRootPos = i;
-            bestMerit = this->getEstimateMerit(roots[i]);
-        } else {
-            double merit = this->getEstimateMerit(roots[i]);
-            if (merit <= bestMerit) {
-                bestRootPos = i;
-                bestMerit = merit;
-            }
-        }
+
+void DualVarianceWeightedTotalLeastSquares::updatePrecision(
+    const double* x, const double* y, const double* xPrecision, const double* yPrecision, size_t count
+) {
+    if (count == 0) {
+        return;
+    }
+    if (!this->hasVarianceRatio) {
+        this->setVarianceRatioFromPrecision(xPrecision[0], yPrecision[0]);
+    }
+
+    // Work on locals so the compiler can keep the statistics in registers across the loop.
+    double forgettingFactor = this->forgettingFactor;
+    double varianceRatio = this->varianceRatio;
+    double inverseVarianceRatioSquared = this->inverseVarianceRatioSquared;
+    double c1 = this->c1, c2 = this->c2, c3 = this->c3;
+    double c4 = this->c4, c5 = this->c5, c6 = this->c6;
+
+    for (size_t i = 0; i < count; ++i) {
+        double correctedY = y[i] * varianceRatio;
+        double yScale = yPrecision[i] * inverseVarianceRatioSquared;
+        double xx = x[i] * x[i];
+        double xy = x[i] * correctedY;
+        double yy = correctedY * correctedY;
+
+        c1 = forgettingFactor * c1 + xx * yScale;
+        c2 = forgettingFactor * c2 + xy * yScale;
+        c3 = forgettingFactor * c3 + yy * yScale;
+
+        c4 = forgettingFactor * c4 + xx * xPrecision[i];
+        c5 = forgettingFactor * c5 + xy * xPrecision[i];
+        c6 = forgettingFactor * c6 + yy * xPrecision[i];
     }
 
-    if (bestRootPos == -1) {
+    this->c1 = c1;
+    this->c2 = c2;
+    this->c3 = c3;
+    this->c4 = c4;
+    this->c5 = c5;
+    this->c6 = c6;
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::setVarianceRatioFromPrecision(double xPrecision, double yPrecision) {
+    // sqrt(xVariance) / sqrt(yVariance) without forming the variances.
+    this->setVarianceRatio(std::sqrt(yPrecision) / std::sqrt(xPrecision));
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::setVarianceRatioFrom(double xVariance, double yVariance) {
+    // Asumes a value 
+    this->setVarianceRatio(std::sqrt(xVariance) / std::sqrt(yVariance));
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::setVarianceRatio(double varianceRatio) {
+    this->varianceRatio = varianceRatio;
+    this->hasVarianceRatio = true;
+    this->inverseVarianceRatioSquared = 1 / (varianceRatio * varianceRatio);
+
+    this->c1 /= this->varianceRatio * this->varianceRatio;
+    this->c2 /= this->varianceRatio;
+    // c3 is not affected because they cancle out
+    // c4 is not affected because it has no y factor
+    this->c5 *= this->varianceRatio;
+    this->c6 *= this->varianceRatio * this->varianceRatio;
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::updateDecayed(double decay, double weight, double x, double y, double xVariance, double yVariance) {
+    if (!this->hasVarianceRatio) {
+        this->setVarianceRatioFrom(xVariance, yVariance);
+    }
+
+    double correctedY = y * this->varianceRatio;
+    double yScale = weight / (yVariance * this->varianceRatio * this->varianceRatio);
+    double xScale = weight / xVariance;
+
+    this->c1 = decay * this->c1 + x * x * yScale;
+    this->c2 = decay * this->c2 + x * correctedY * yScale;
+    this->c3 = decay * this->c3 + correctedY * correctedY * yScale;
+
+    this->c4 = decay * this->c4 + x * x * xScale;
+    this->c5 = decay * this->c5 + x * correctedY * xScale;
+    this->c6 = decay * this->c6 + correctedY * correctedY * xScale;
+}
+
+
+DualVarianceWeightedTotalLeastSquares DualVarianceWeightedTotalLeastSquares::partial() const {
+    DualVarianceWeightedTotalLeastSquares partial = *this;
+    partial.c1 = 0.0;
+    partial.c2 = 0.0;
+    partial.c3 = 0.0;
+    partial.c4 = 0.0;
+    partial.c5 = 0.0;
+    partial.c6 = 0.0;
+    return partial;
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::merge(const DualVarianceWeightedTotalLeastSquares& other, double steps, double otherSteps) {
+    if (other.forgettingFactor != this->forgettingFactor) {
+        throw std::invalid_argument( "Can't merge Forgetting Factor " + std::to_string(other.forgettingFactor) + " into " + std::to_string(this->forgettingFactor) );
+    }
+
+    if (!this->hasVarianceRatio && other.hasVarianceRatio) {
+        this->setVarianceRatio(other.varianceRatio);
+    }
+
+    // Once per merge, so the logarithm isn't worth keeping.
+    double log2ForgettingFactor = std::log2(this->forgettingFactor);
+    double thisDecay = forgetting_decay(this->forgettingFactor, log2ForgettingFactor, steps);
+    double otherDecay = forgetting_decay(this->forgettingFactor, log2ForgettingFactor, otherSteps);
+
+    // c1 scales with 1/ratio^2, c2 with 1/ratio, c3 and c4 don't, c5 with ratio and c6 with ratio^2.
+    double scale = other.varianceRatio / this->varianceRatio;
+    double scaleSq = scale * scale;
+
+    this->c1 = thisDecay * this->c1 + otherDecay * other.c1 * scaleSq;
+    this->c2 = thisDecay * this->c2 + otherDecay * other.c2 * scale;
+    this->c3 = thisDecay * this->c3 + otherDecay * other.c3;
+    this->c4 = thisDecay * this->c4 + otherDecay * other.c4;
+    this->c5 = thisDecay * this->c5 + otherDecay * other.c5 / scale;
+    this->c6 = thisDecay * this->c6 + otherDecay * other.c6 / scaleSq;
+}
+
+
+double DualVarianceWeightedTotalLeastSquares::getForgettingFactor() const {
+    return this->forgettingFactor;
+}
+
+
+double DualVarianceWeightedTotalLeastSquares::getEstimateUncorrected() {
+    double estimate;
+    if (this->solveUncorrected(estimate) != EstimatorStatus::Ok) {
         throw std::domain_error("All roots are complex.");
     }
+    return estimate;
+}
 
 
-    return roots[bestRootPos];
+EstimatorStatus DualVarianceWeightedTotalLeastSquares::solveUncorrected(double& estimate) {
+    return dual_wtls_estimate(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate, this->quarticMethod);
 }
 
 
 
 double DualVarianceWeightedTotalLeastSquares::getVariance() {
-    double estimate = this->getEstimateUncorrected();
-    double estimateSq = estimate * estimate;
+    return this->getVarianceAt(this->getEstimateUncorrected());
+}
+
 
-    double top = -2 * this->c5 * estimateSq * estimateSq * estimate + 
-                (3 * this->c3 - 6 * this->c4 + 3 * this->c6) * estimateSq * estimateSq +
-                (-12 * this->c2 + 16 * this->c5) * estimateSq * estimate +
-                (-8 * this->c1 + 10 * this->c3 + 6 * this->c4 - 8 * this->c6) * estimateSq +
-                (12 * this->c2 - 6 * this->c5) * estimate +
-                this->c1 - 2 * this->c3 + this->c6;
+double DualVarianceWeightedTotalLeastSquares::getVarianceAt(double estimate) {
+    // Correcting the variance by the varianceRatio
+    return this->varianceRatio * this->varianceRatio * dual_wtls_variance(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate);
+}
 
-    double bottom = estimateSq + 1;
 
-    double hessian = 2 * top / (bottom * bottom * bottom * bottom);
-    //hessian = hessian / (this->varianceRatio * this->varianceRatio); // Correcting the hassian by the varianceRatio
-    return 2.0 * this->varianceRatio * this->varianceRatio / hessian;
+double DualVarianceWeightedTotalLeastSquares::correctEstimate(double estimate) const {
+    return estimate / this->varianceRatio;
 }
 
+
 double DualVarianceWeightedTotalLeastSquares::getEstimate() {
-    return this->getEstimateUncorrected() / this->varianceRatio;
+    this->lastEstimate = this->correctEstimate(this->getEstimateUncorrected());
+    return this->lastEstimate;
+}
+
+
+EstimatorResult DualVarianceWeightedTotalLeastSquares::estimateResult(EstimatorStatus status, double estimate) {
+    if (status != EstimatorStatus::Ok) {
+        return {this->lastEstimate, status};
+    }
+
+    estimate = this->correctEstimate(estimate);
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate, EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult DualVarianceWeightedTotalLeastSquares::varianceResult(EstimatorStatus status, double estimate) {
+    if (status != EstimatorStatus::Ok) {
+        return {this->lastVariance, status};
+    }
+
+    double variance = this->getVarianceAt(estimate);
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance, EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult DualVarianceWeightedTotalLeastSquares::tryGetEstimate() {
+    double estimate;
+    EstimatorStatus status = this->solveUncorrected(estimate);
+    return this->estimateResult(status, estimate);
+}
+
+
+EstimatorResult DualVarianceWeightedTotalLeastSquares::tryGetVariance() {
+    double estimate;
+    EstimatorStatus status = this->solveUncorrected(estimate);
+    return this->varianceResult(status, estimate);
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance) {
+    double uncorrected;
+    EstimatorStatus status = this->solveUncorrected(uncorrected);
+    estimate = this->estimateResult(status, uncorrected);
+    variance = this->varianceResult(status, uncorrected);
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::getQuarticCoefficients(double* coefficients) const {
+    coefficients[0] = dual_wtls_quartic_a(this->c5);
+    coefficients[1] = dual_wtls_quartic_b(this->c1, this->c4, this->c6);
+    coefficients[2] = dual_wtls_quartic_c(this->c2, this->c5);
+    coefficients[3] = dual_wtls_quartic_d(this->c1, this->c3, this->c6);
+    coefficients[4] = dual_wtls_quartic_e(this->c2);
+}
+
+
+void DualVarianceWeightedTotalLeastSquares::setQuarticMethod(QuarticMethod method) {
+    this->quarticMethod = method;
+}
+
+
+QuarticMethod DualVarianceWeightedTotalLeastSquares::getQuarticMethod() const {
+    return this->quarticMethod;
+}
+
+
+uint64_t DualVarianceWeightedTotalLeastSquares::resultCacheWords() {
+    // offsetof isn't allowed on private members of every estimator, so measure the fields of an instance.
+    DualVarianceWeightedTotalLeastSquares probe;
+    const char* base = reinterpret_cast<const char*>(&probe);
+    size_t estimateWord = (reinterpret_cast<const char*>(&probe.lastEstimate) - base) / sizeof(uint64_t);
+    size_t varianceWord = (reinterpret_cast<const char*>(&probe.lastVariance) - base) / sizeof(uint64_t);
+    return (uint64_t(1) << estimateWord) | (uint64_t(1) << varianceWord);
 }
\ No newline at end of file
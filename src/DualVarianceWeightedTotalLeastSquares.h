@@ -1,10 +1,14 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <limits>
 #include <optional>
 #include <stdexcept>
 #include "helper/roots.h"
+#include "helper/wtls.h"
+#include "EstimatorStatus.h"
+#include "helper/fastMath.h"
 #include <iostream>
 
 /**
@@ -46,6 +50,46 @@ class DualVarianceWeightedTotalLeastSquares {
             double varianceRatio=-1
         );
 
+        /**
+         * @brief Check constructor parameters without throwing
+         * 
+         * @return EstimatorStatus::Ok if the constructor would accept the parameters, otherwise the reason it would throw
+         */
+        static EstimatorStatus checkParameters(
+            double forgettingFactor, double initialXVariance,
+            double initialYVariance, double varianceRatio
+        );
+
+        /**
+         * @brief Non-throwing constructor, out is only written when the parameters are valid
+         * 
+         * @return EstimatorStatus::Ok on success, otherwise the reason the parameters were rejected
+         */
+        static EstimatorStatus tryCreate(
+            DualVarianceWeightedTotalLeastSquares& out,
+            double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance,
+            double varianceRatio
+        );
+
+        /**
+         * @brief Construct many estimators from parameter arrays without throwing
+         * 
+         * Entries with invalid parameters are left untouched in out and have their reason written to statuses.
+         * A varianceRatio of -1 means the ratio is taken from the first update, as in the constructor.
+         * 
+         * @param count number of entries in every array
+         * @param out caller provided storage for count estimators
+         * @param statuses caller provided storage for count statuses
+         * @return number of estimators successfully created
+         */
+        static size_t createBatch(
+            const double* nominalValues, const double* forgettingFactors,
+            const double* initialXVariances, const double* initialYVariances,
+            const double* varianceRatios, size_t count,
+            DualVarianceWeightedTotalLeastSquares* out, EstimatorStatus* statuses
+        );
+
         /**
          * @brief Update with a new measurement
          * 
@@ -56,6 +100,71 @@ class DualVarianceWeightedTotalLeastSquares {
          */
         void update(double x, double y, double xVariance, double yVariance);
 
+        /**
+         * @brief Update with count measurements, in array order, taking one reciprocal of each variance
+         */
+        void update(const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance), avoiding every division
+         * 
+         * Equivalent to update(x, y, 1 / xPrecision, 1 / yPrecision) up to rounding.
+         * A precision can also be any precomputed weight, it need not come from a variance.
+         * 
+         * @param x measurement for first variable
+         * @param y measurement for second variable
+         * @param xPrecision Precision (1 / variance) of the x measurement (must be more than 0)
+         * @param yPrecision Precision (1 / variance) of the y measurement (must be more than 0)
+         */
+        void updatePrecision(double x, double y, double xPrecision, double yPrecision);
+
+        /**
+         * @brief Update with count precision weighted measurements, in array order
+         */
+        void updatePrecision(const double* x, const double* y, const double* xPrecision, const double* yPrecision, size_t count);
+
+        /**
+         * @brief Update with a new measurement, decaying the statistics by decay instead of the forgetting factor
+         * 
+         * The building block of time stamped updates (see TimestampedEstimator), which decay by the elapsed time
+         * and weight a late measurement by the forgetting it would have had if it arrived in order.
+         * 
+         * @param decay factor the statistics are multiplied by before adding the measurement (0 < decay <= 1)
+         * @param weight factor the measurement is multiplied by (0 < weight <= 1)
+         * @param x measurement for first variable
+         * @param y measurement for second variable
+         * @param xVariance Variance (uncertainty) of the x measurement (must be more than 0)
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more than 0)
+         */
+        void updateDecayed(double decay, double weight, double x, double y, double xVariance, double yVariance);
+
+        /**
+         * @brief Get an estimator with the same parameters and no statistics, to accumulate part of a stream in
+         * 
+         * Merging the partial back in (see merge) gives the same statistics as updating this estimator directly.
+         */
+        DualVarianceWeightedTotalLeastSquares partial() const;
+
+        /**
+         * @brief Add the statistics of another estimator into this one
+         * 
+         * other is taken to cover the measurements after this one's, so this one's statistics are aged by the steps
+         * other has forgotten over. otherSteps ages other as well, e.g. to align two partials by time.
+         * Statistics gathered under a different variance ratio are rescaled to this one's ratio, if this estimator has no
+         * ratio yet it takes the other's.
+         * The other estimator should come from partial(), otherwise its prior is counted as a measurement.
+         * 
+         * @param other estimator with the same forgetting factor
+         * @param steps forgetting steps other took since partial(), i.e. its number of updates
+         * @param otherSteps forgetting steps to age other by before adding it
+         */
+        void merge(const DualVarianceWeightedTotalLeastSquares& other, double steps, double otherSteps=0.0);
+
+        /**
+         * @brief Get the factor the statistics are multiplied by on every update
+         */
+        double getForgettingFactor() const;
+
          /**
          * @brief Get the current variance of the weight estimate
          * 
@@ -70,7 +179,56 @@ class DualVarianceWeightedTotalLeastSquares {
          */
         double getEstimate();
 
-    private:
+        /**
+         * @brief Get the current estimate without throwing
+         * 
+         * @return The estimate, or the last good estimate and the reason no estimate could be found
+         */
+        EstimatorResult tryGetEstimate();
+
+        /**
+         * @brief Get the current variance of the weight estimate without throwing
+         * 
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason no variance could be found
+         */
+        EstimatorResult tryGetVariance();
+
+        /**
+         * @brief Get the current estimate and its variance without throwing, solving the quartic once for both
+         * 
+         * @param estimate set to the estimate, or the last good estimate and the reason no estimate could be found
+         * @param variance set to the variance, or the last good variance (NaN if there has been none) and the reason no variance could be found
+         */
+        void tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance);
+
+        /**
+         * @brief Get the coefficients of the quartic getEstimate solves, e.g. to sample for calibrate_quartic_method
+         * 
+         * @param coefficients caller provided storage for a, b, c, d and e of a x^4 + b x^3 + c x^2 + d x + e
+         */
+        void getQuarticCoefficients(double* coefficients) const;
+
+        /**
+         * @brief Set the algorithm getEstimate solves the quartic with, e.g. the one calibrate_quartic_method picks
+         * 
+         * @param method quartic solver for this estimator only, QuarticMethod::NBS by default
+         */
+        void setQuarticMethod(QuarticMethod method);
+
+        /**
+         * @brief Get the algorithm getEstimate solves the quartic with
+         */
+        QuarticMethod getQuarticMethod() const;
+
+        /**
+         * @brief Mask of the 64 bit words of an estimator that only hold the last good estimate and variance
+         * 
+         * The try getters write these words, so byte level change tracking (e.g. CheckpointJournal) skips them
+         * to keep reads from marking an estimator as changed.
+         */
+        static uint64_t resultCacheWords();
+
+    protected:
         double forgettingFactor;
         double c1;
         double c2;
@@ -78,21 +236,60 @@ class DualVarianceWeightedTotalLeastSquares {
         double c4;
         double c5;
         double c6;
-        double varianceRatio;
-        bool hasVarianceRatio;
 
         /**
-         * @brief Get the value of the merit function at a certain estimate
-         * 
-         * @return value of the merit function
+         * @brief Correct an estimate of the rescaled statistics, e.g. from a different solve, for varianceRatio
          */
-        double getEstimateMerit(double estimate); 
-        
+        double correctEstimate(double estimate) const;
+
+        /**
+         * @brief Get the variance at an uncorrected estimate
+         */
+        double getVarianceAt(double estimate);
+
+        /**
+         * @brief Result of an uncorrected estimate found with status, recording it as the last good estimate when usable
+         */
+        EstimatorResult estimateResult(EstimatorStatus status, double estimate);
+
+        /**
+         * @brief Result of the variance at an uncorrected estimate found with status, recording it as the last good variance when usable
+         */
+        EstimatorResult varianceResult(EstimatorStatus status, double estimate);
+
+    private:
+        double varianceRatio;
+        bool hasVarianceRatio;
+        QuarticMethod quarticMethod; // fits in the padding after hasVarianceRatio
+        double inverseVarianceRatioSquared; // 1 / varianceRatio^2, so precision updates need no division
+        double lastEstimate;
+        double lastVariance;
+
+        void initialise(
+            double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance,
+            double varianceRatio
+        );
+
+        void setVarianceRatioFrom(double xVariance, double yVariance);
+
+        void setVarianceRatioFromPrecision(double xPrecision, double yPrecision);
+
+        void setVarianceRatio(double varianceRatio);
+
         /**
          * @brief Get the current estimate without correction for varianceRatio
          * 
          * @return Current estimate
          */
         double getEstimateUncorrected();
+
+        /**
+         * @brief Non-throwing core of getEstimateUncorrected
+         * 
+         * @param estimate set to the uncorrected estimate when the return is EstimatorStatus::Ok
+         * @return reason for failure or EstimatorStatus::Ok
+         */
+        EstimatorStatus solveUncorrected(double& estimate);
         
 };
\ No newline at end of file
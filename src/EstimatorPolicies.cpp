@@ -0,0 +1,17 @@
+#include "EstimatorPolicies.h"
+
+
+RuntimeForgetting::RuntimeForgetting(double forgettingFactor) {
+    if (forgettingFactor > 1 || forgettingFactor <= 0) {
+        throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+    }
+    this->forgettingFactor = forgettingFactor;
+}
+
+
+RuntimeVarianceRatio::RuntimeVarianceRatio(double varianceRatio) {
+    if (varianceRatio <= 0) {
+        throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+    }
+    this->varianceRatio = varianceRatio;
+}
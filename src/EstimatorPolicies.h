@@ -0,0 +1,92 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+
+/*
+Policies for the Static* estimators, which fix the forgetting factor and variance ratio at compile time
+when they are known at build time so the compiler can drop multiplies by one and fold constants.
+
+Forgetting policies provide factor(), variance ratio policies provide ratio().
+The constant policies are empty, so they add nothing to the size of the estimator.
+Ratios are given as Numerator / Denominator because C++14 has no floating point template parameters.
+*/
+
+
+/**
+ * Forgetting factor of exactly 1, old measurements are never forgotten.
+ */
+struct NoForgetting {
+    static constexpr double factor() {
+        return 1.0;
+    }
+};
+
+/**
+ * Forgetting factor fixed at compile time to Numerator / Denominator.
+ */
+template <unsigned long Numerator, unsigned long Denominator>
+struct ConstantForgetting {
+    static_assert(Numerator > 0 && Numerator <= Denominator, "Forgetting Factor must be in the range 0 to 1 (exluding zero)");
+
+    static constexpr double factor() {
+        return (double) Numerator / (double) Denominator;
+    }
+};
+
+/**
+ * Forgetting factor chosen at run time, as in the non-static estimators.
+ */
+class RuntimeForgetting {
+    public:
+        /**
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         */
+        RuntimeForgetting(double forgettingFactor=1.0);
+
+        double factor() const {
+            return this->forgettingFactor;
+        }
+
+    private:
+        double forgettingFactor;
+};
+
+
+/**
+ * Variance ratio of exactly 1.
+ */
+struct UnitVarianceRatio {
+    static constexpr double ratio() {
+        return 1.0;
+    }
+};
+
+/**
+ * Variance ratio fixed at compile time to Numerator / Denominator.
+ */
+template <unsigned long Numerator, unsigned long Denominator>
+struct ConstantVarianceRatio {
+    static_assert(Numerator > 0 && Denominator > 0, "Variance Ratio must grater then 0");
+
+    static constexpr double ratio() {
+        return (double) Numerator / (double) Denominator;
+    }
+};
+
+/**
+ * Variance ratio chosen at run time, as in the non-static estimators.
+ */
+class RuntimeVarianceRatio {
+    public:
+        /**
+         * @param varianceRatio Ratio of x to y measurement standard deviation (must be more than 0)
+         */
+        RuntimeVarianceRatio(double varianceRatio=1.0);
+
+        double ratio() const {
+            return this->varianceRatio;
+        }
+
+    private:
+        double varianceRatio;
+};
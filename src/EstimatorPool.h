@@ -0,0 +1,443 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EstimatorStatus.h"
+
+/**
+ * Stable reference to an estimator in an EstimatorPool.
+ *
+ * Stays valid while the estimator lives, across compaction, and is rejected once the estimator is destroyed
+ * even if its slot has been reused since.
+ */
+struct EstimatorHandle {
+    uint32_t slot;
+    uint32_t generation;
+
+    bool operator==(const EstimatorHandle& other) const {
+        return this->slot == other.slot && this->generation == other.generation;
+    }
+
+    bool operator!=(const EstimatorHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Handle that never refers to an estimator, e.g. for entries createBatch couldn't create.
+ */
+constexpr EstimatorHandle invalidEstimatorHandle = {std::numeric_limits<uint32_t>::max(), 0};
+
+
+/**
+ * A pool owning estimators that are created and destroyed all the time, e.g. cells joining and leaving a fleet.
+ *
+ * Estimators are stored by value in one dense array instead of being allocated one by one. Destroying one
+ * leaves a hole the next create fills, so create and destroy are O(1) and never allocate once the pool has
+ * grown, and compact moves the live estimators together (keeping their order) so they can be updated
+ * sequentially: after compact, data() to data() + size() are exactly the live estimators, e.g. to hand
+ * to FleetExecutor.
+ *
+ * Estimators are addressed by EstimatorHandle, a slot in an indirection table plus the generation of the slot,
+ * which is bumped when the estimator is destroyed so stale handles are caught rather than reaching whatever
+ * estimator took the slot over.
+ *
+ * Estimator must be copy assignable, e.g. VarianceWeightedTotalLeastSquares or DualVarianceWeightedTotalLeastSquares.
+ * Not thread safe.
+ */
+template <typename Estimator>
+class EstimatorPool {
+    public:
+        /**
+         * @brief Constructor for EstimatorPool
+         *
+         * @param capacity Number of estimators to reserve space for
+         */
+        explicit EstimatorPool(size_t capacity=0);
+
+        /**
+         * @brief Add an estimator to the pool
+         *
+         * @return Handle to the new estimator
+         */
+        EstimatorHandle create(const Estimator& estimator = Estimator());
+
+        /**
+         * @brief Create estimators from parameter arrays with Estimator::tryCreate, without throwing
+         *
+         * Entries with invalid parameters get invalidEstimatorHandle and have their reason written to statuses.
+         * e.g. createBatch(count, handles, statuses, nominalValues, varianceRatios, forgettingFactors, initialVariances)
+         * for VarianceWeightedTotalLeastSquares.
+         *
+         * @param count number of entries in every array
+         * @param handles caller provided storage for count handles
+         * @param statuses caller provided storage for count statuses, may be null
+         * @param parameters one array per argument of Estimator::tryCreate after the estimator
+         * @return number of estimators created
+         */
+        template <typename... Parameters>
+        size_t createBatch(size_t count, EstimatorHandle* handles, EstimatorStatus* statuses, const Parameters*... parameters);
+
+        /**
+         * @brief Remove an estimator from the pool, invalidating every handle to it
+         */
+        void destroy(EstimatorHandle handle);
+
+        /**
+         * @brief Remove many estimators, skipping handles that are already invalid
+         *
+         * @return number of estimators destroyed
+         */
+        size_t destroyBatch(const EstimatorHandle* handles, size_t count);
+
+        /**
+         * @brief Whether a handle refers to a live estimator
+         */
+        bool contains(EstimatorHandle handle) const;
+
+        /**
+         * @brief Access an estimator, throwing std::out_of_range for a stale handle
+         *
+         * The reference is invalidated by the next create or compact.
+         */
+        Estimator& get(EstimatorHandle handle);
+
+        const Estimator& get(EstimatorHandle handle) const;
+
+        /**
+         * @brief Access an estimator, null for a stale handle
+         */
+        Estimator* tryGet(EstimatorHandle handle);
+
+        /**
+         * @brief Update an estimator with a new measurement
+         *
+         * @param handle estimator to update
+         * @param measurement arguments forwarded to Estimator::update
+         */
+        template <typename... Args>
+        void update(EstimatorHandle handle, Args... measurement);
+
+        /**
+         * @brief Update count estimators with one measurement each, in array order
+         *
+         * @param handles estimators to update, all must be live
+         * @param measurements one array per argument of Estimator::update
+         */
+        template <typename... Measurements>
+        void updateBatch(const EstimatorHandle* handles, size_t count, const Measurements*... measurements);
+
+        /**
+         * @brief Call function(handle, estimator) for every live estimator, in storage order
+         */
+        template <typename Function>
+        void forEach(Function function);
+
+        /**
+         * @brief Move the live estimators to the front of the storage, keeping their order, and release the holes
+         *
+         * Handles stay valid, storage indices and references don't.
+         */
+        void compact();
+
+        /**
+         * @brief Compact if more than maxHoleFraction of the storage is holes
+         *
+         * @return whether the pool was compacted
+         */
+        bool compactIfFragmented(double maxHoleFraction=0.25);
+
+        /**
+         * @brief Number of live estimators
+         */
+        size_t size() const;
+
+        /**
+         * @brief Number of estimators the storage holds, live or holes. Equal to size() after compact
+         */
+        size_t storageSize() const;
+
+        /**
+         * @brief Number of holes destroyed estimators have left in the storage
+         */
+        size_t holeCount() const;
+
+        /**
+         * @brief The storage, storageSize() estimators of which those at holes are left over from destroyed ones
+         */
+        Estimator* data();
+
+        const Estimator* data() const;
+
+        /**
+         * @brief Position of an estimator in the storage, until the next compact
+         */
+        size_t storageIndex(EstimatorHandle handle) const;
+
+        /**
+         * @brief Handle of the estimator at a position in the storage, invalidEstimatorHandle for a hole
+         */
+        EstimatorHandle handleAt(size_t index) const;
+
+    private:
+        static constexpr uint32_t noSlot = std::numeric_limits<uint32_t>::max();
+
+        struct Slot {
+            uint32_t index; // position in estimators while live, next free slot otherwise
+            uint32_t generation;
+        };
+
+        std::vector<Estimator> estimators;
+        std::vector<uint32_t> owners; // slot of each storage position, noSlot for a hole
+        std::vector<Slot> slots;
+        std::vector<uint32_t> holes;
+        uint32_t freeSlot; // head of the list of free slots threaded through Slot::index
+
+        uint32_t allocateSlot(uint32_t index);
+        uint32_t checkedIndex(EstimatorHandle handle) const;
+};
+
+
+template <typename Estimator>
+constexpr uint32_t EstimatorPool<Estimator>::noSlot;
+
+
+template <typename Estimator>
+EstimatorPool<Estimator>::EstimatorPool(size_t capacity) : freeSlot(noSlot) {
+    this->estimators.reserve(capacity);
+    this->owners.reserve(capacity);
+    this->slots.reserve(capacity);
+}
+
+
+template <typename Estimator>
+uint32_t EstimatorPool<Estimator>::allocateSlot(uint32_t index) {
+    uint32_t slot = this->freeSlot;
+    if (slot != noSlot) {
+        this->freeSlot = this->slots[slot].index;
+        this->slots[slot].index = index;
+        return slot;
+    }
+
+    if (this->slots.size() >= noSlot) {
+        throw std::length_error( "EstimatorPool can't hold more than " + std::to_string(noSlot) + " estimators" );
+    }
+    this->slots.push_back({index, 0});
+    return static_cast<uint32_t>(this->slots.size() - 1);
+}
+
+
+template <typename Estimator>
+EstimatorHandle EstimatorPool<Estimator>::create(const Estimator& estimator) {
+    uint32_t index;
+    if (!this->holes.empty()) {
+        index = this->holes.back();
+        this->holes.pop_back();
+        this->estimators[index] = estimator;
+    } else {
+        index = static_cast<uint32_t>(this->estimators.size());
+        this->estimators.push_back(estimator);
+        this->owners.push_back(noSlot);
+    }
+
+    uint32_t slot = this->allocateSlot(index);
+    this->owners[index] = slot;
+    return {slot, this->slots[slot].generation};
+}
+
+
+template <typename Estimator>
+template <typename... Parameters>
+size_t EstimatorPool<Estimator>::createBatch(size_t count, EstimatorHandle* handles, EstimatorStatus* statuses, const Parameters*... parameters) {
+    this->estimators.reserve(this->estimators.size() + count);
+    this->owners.reserve(this->owners.size() + count);
+
+    size_t created = 0;
+    Estimator estimator;
+    for (size_t i = 0; i < count; ++i) {
+        EstimatorStatus status = Estimator::tryCreate(estimator, parameters[i]...);
+        if (statuses != nullptr) {
+            statuses[i] = status;
+        }
+        if (status == EstimatorStatus::Ok) {
+            handles[i] = this->create(estimator);
+            ++created;
+        } else {
+            handles[i] = invalidEstimatorHandle;
+        }
+    }
+    return created;
+}
+
+
+template <typename Estimator>
+inline bool EstimatorPool<Estimator>::contains(EstimatorHandle handle) const {
+    // Destroying bumps the generation, so a free slot never matches a handle given out before.
+    return handle.slot < this->slots.size() && this->slots[handle.slot].generation == handle.generation;
+}
+
+
+template <typename Estimator>
+inline uint32_t EstimatorPool<Estimator>::checkedIndex(EstimatorHandle handle) const {
+    if (!this->contains(handle)) {
+        throw std::out_of_range( "Estimator handle " + std::to_string(handle.slot) + ":" + std::to_string(handle.generation) + " is stale or invalid" );
+    }
+    return this->slots[handle.slot].index;
+}
+
+
+template <typename Estimator>
+void EstimatorPool<Estimator>::destroy(EstimatorHandle handle) {
+    uint32_t index = this->checkedIndex(handle);
+    this->owners[index] = noSlot;
+    this->holes.push_back(index);
+
+    Slot& slot = this->slots[handle.slot];
+    ++slot.generation;
+    slot.index = this->freeSlot;
+    this->freeSlot = handle.slot;
+}
+
+
+template <typename Estimator>
+size_t EstimatorPool<Estimator>::destroyBatch(const EstimatorHandle* handles, size_t count) {
+    size_t destroyed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (this->contains(handles[i])) {
+            this->destroy(handles[i]);
+            ++destroyed;
+        }
+    }
+    return destroyed;
+}
+
+
+template <typename Estimator>
+inline Estimator& EstimatorPool<Estimator>::get(EstimatorHandle handle) {
+    return this->estimators[this->checkedIndex(handle)];
+}
+
+
+template <typename Estimator>
+inline const Estimator& EstimatorPool<Estimator>::get(EstimatorHandle handle) const {
+    return this->estimators[this->checkedIndex(handle)];
+}
+
+
+template <typename Estimator>
+inline Estimator* EstimatorPool<Estimator>::tryGet(EstimatorHandle handle) {
+    return this->contains(handle) ? &this->estimators[this->slots[handle.slot].index] : nullptr;
+}
+
+
+template <typename Estimator>
+template <typename... Args>
+inline void EstimatorPool<Estimator>::update(EstimatorHandle handle, Args... measurement) {
+    this->get(handle).update(measurement...);
+}
+
+
+template <typename Estimator>
+template <typename... Measurements>
+void EstimatorPool<Estimator>::updateBatch(const EstimatorHandle* handles, size_t count, const Measurements*... measurements) {
+    for (size_t i = 0; i < count; ++i) {
+        this->estimators[this->checkedIndex(handles[i])].update(measurements[i]...);
+    }
+}
+
+
+template <typename Estimator>
+template <typename Function>
+void EstimatorPool<Estimator>::forEach(Function function) {
+    for (size_t i = 0; i < this->estimators.size(); ++i) {
+        uint32_t slot = this->owners[i];
+        if (slot != noSlot) {
+            function(EstimatorHandle{slot, this->slots[slot].generation}, this->estimators[i]);
+        }
+    }
+}
+
+
+template <typename Estimator>
+void EstimatorPool<Estimator>::compact() {
+    if (this->holes.empty()) {
+        return;
+    }
+
+    size_t live = 0;
+    for (size_t i = 0; i < this->estimators.size(); ++i) {
+        uint32_t slot = this->owners[i];
+        if (slot == noSlot) {
+            continue;
+        }
+        if (live != i) {
+            this->estimators[live] = this->estimators[i];
+            this->owners[live] = slot;
+            this->slots[slot].index = static_cast<uint32_t>(live);
+        }
+        ++live;
+    }
+
+    // Truncate without needing a default constructor.
+    this->estimators.erase(this->estimators.begin() + live, this->estimators.end());
+    this->owners.resize(live);
+    this->holes.clear();
+}
+
+
+template <typename Estimator>
+bool EstimatorPool<Estimator>::compactIfFragmented(double maxHoleFraction) {
+    if (this->holes.size() <= maxHoleFraction * this->estimators.size()) {
+        return false;
+    }
+    this->compact();
+    return true;
+}
+
+
+template <typename Estimator>
+inline size_t EstimatorPool<Estimator>::size() const {
+    return this->estimators.size() - this->holes.size();
+}
+
+
+template <typename Estimator>
+inline size_t EstimatorPool<Estimator>::storageSize() const {
+    return this->estimators.size();
+}
+
+
+template <typename Estimator>
+inline size_t EstimatorPool<Estimator>::holeCount() const {
+    return this->holes.size();
+}
+
+
+template <typename Estimator>
+inline Estimator* EstimatorPool<Estimator>::data() {
+    return this->estimators.data();
+}
+
+
+template <typename Estimator>
+inline const Estimator* EstimatorPool<Estimator>::data() const {
+    return this->estimators.data();
+}
+
+
+template <typename Estimator>
+inline size_t EstimatorPool<Estimator>::storageIndex(EstimatorHandle handle) const {
+    return this->checkedIndex(handle);
+}
+
+
+template <typename Estimator>
+inline EstimatorHandle EstimatorPool<Estimator>::handleAt(size_t index) const {
+    if (index >= this->owners.size()) {
+        throw std::out_of_range( "Storage index " + std::to_string(index) + " is out of range" );
+    }
+    uint32_t slot = this->owners[index];
+    return slot == noSlot ? invalidEstimatorHandle : EstimatorHandle{slot, this->slots[slot].generation};
+}
@@ -0,0 +1,26 @@
+#include "EstimatorStatus.h"
+
+
+const char* toString(EstimatorStatus status) {
+    switch (status) {
+        case EstimatorStatus::Ok:
+            return "Ok";
+        case EstimatorStatus::InvalidForgettingFactor:
+            return "Forgetting Factor must be in the range 0 to 1 (exluding zero)";
+        case EstimatorStatus::InvalidInitialVariance:
+            return "Initial Variance must grater then 0";
+        case EstimatorStatus::InvalidInitialXVariance:
+            return "Initial X Variance must grater then 0";
+        case EstimatorStatus::InvalidInitialYVariance:
+            return "Initial Y Variance must grater then 0";
+        case EstimatorStatus::InvalidVarianceRatio:
+            return "Variance Ratio must grater then 0";
+        case EstimatorStatus::NoRealRoot:
+            return "All roots are complex.";
+        case EstimatorStatus::NonPositiveVariance:
+            return "Variance is not positive (the merit function is not at a minimum).";
+        case EstimatorStatus::NotFinite:
+            return "Result is not finite.";
+    }
+    return "Unknown status";
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @brief Reason codes reported by the non-throwing (try*) estimator API.
+ *
+ * The throwing API reports the same conditions as exceptions; the try* API returns them so that
+ * a burst of degenerate estimators in a large loop does not pay for exception unwinding.
+ */
+enum class EstimatorStatus {
+    Ok = 0,
+    InvalidForgettingFactor,
+    InvalidInitialVariance,
+    InvalidInitialXVariance,
+    InvalidInitialYVariance,
+    InvalidVarianceRatio,
+    NoRealRoot,
+    NonPositiveVariance,
+    NotFinite
+};
+
+/**
+ * @brief Get a static, human readable description of a status (never allocates)
+ *
+ * @param status status to describe
+ * @return null terminated description
+ */
+const char* toString(EstimatorStatus status);
+
+/**
+ * @brief Result of a non-throwing estimate or variance query.
+ *
+ * When status is not Ok, value holds the last good value the estimator produced
+ * (or its best prior value if it has never produced one) so callers can carry on with it.
+ */
+struct EstimatorResult {
+    double value;
+    EstimatorStatus status;
+
+    bool ok() const {
+        return this->status == EstimatorStatus::Ok;
+    }
+};
@@ -0,0 +1,368 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include "EstimatorStatus.h"
+#include "helper/fixedPoint.h"
+
+/**
+ * VarianceWeightedTotalLeastSquares in integer arithmetic only, for microcontrollers without a floating point unit.
+ *
+ * Measurements, parameters and results are Q format FixedPoint values. The three recursive statistics are kept as
+ * mantissas with a shared power of two exponent that is renormalised after every update, so they keep their
+ * precision as they grow or are forgotten and never saturate; only the products of a single measurement
+ * (x * precision and y * precision) and the results are limited to the range of the Q format.
+ *
+ * The closed form estimate uses whichever of its two algebraically equal forms avoids cancellation, an integer
+ * square root and Newton reciprocals instead of division, so update and getEstimate compile to integer
+ * multiplies, shifts and adds. It has no time stamped updates or merging.
+ *
+ * @tparam Storage int16_t, int32_t or (where the compiler has 128 bit integers) int64_t
+ * @tparam FractionBits number of fraction bits of the Q format
+ */
+template <typename Storage=int32_t, int FractionBits=16>
+class FixedPointVarianceWeightedTotalLeastSquares {
+    public:
+        typedef FixedPoint<Storage, FractionBits> Fixed;
+
+        /**
+         * @brief Result of a non-throwing estimate or variance query, value is 0 when the status is not Ok
+         */
+        struct Result {
+            Fixed value;
+            EstimatorStatus status;
+
+            bool ok() const {
+                return this->status == EstimatorStatus::Ok;
+            }
+        };
+
+        /**
+         * @brief Constructor for FixedPointVarianceWeightedTotalLeastSquares
+         *
+         * @param nominalValue Initial estimate of the weight
+         * @param varianceRatio Ratio of output measurement variance to input measurement variance of x over y
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         * @param initialVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         */
+        FixedPointVarianceWeightedTotalLeastSquares(
+            Fixed nominalValue=Fixed(), Fixed varianceRatio=Fixed::one(),
+            Fixed forgettingFactor=Fixed::one(), Fixed initialVariance=Fixed::one()
+        );
+
+        /**
+         * @brief Check constructor parameters without throwing
+         *
+         * Besides the checks of VarianceWeightedTotalLeastSquares, the squared variance ratio and the reciprocal of the
+         * initial variance must be representable in the Q format.
+         *
+         * @return EstimatorStatus::Ok if the constructor would accept the parameters, otherwise the reason it would throw
+         */
+        static EstimatorStatus checkParameters(Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance);
+
+        /**
+         * @brief Non-throwing constructor, out is only written when the parameters are valid
+         */
+        static EstimatorStatus tryCreate(
+            FixedPointVarianceWeightedTotalLeastSquares& out,
+            Fixed nominalValue, Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance
+        );
+
+        /**
+         * @brief Update with a new measurement
+         *
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void update(Fixed x, Fixed y, Fixed yVariance);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance), skipping the reciprocal
+         */
+        void updatePrecision(Fixed x, Fixed y, Fixed yPrecision);
+
+        /**
+         * @brief Get the current estimate, saturated if it is out of the range of the Q format
+         */
+        Fixed getEstimate() const;
+
+        /**
+         * @brief Get the current variance of the weight estimate, saturated if it is out of the range of the Q format
+         */
+        Fixed getVariance() const;
+
+        /**
+         * @brief Get the current estimate without throwing, NotFinite when it saturated
+         */
+        Result tryGetEstimate() const;
+
+        /**
+         * @brief Get the current variance without throwing, NotFinite when it or its terms saturated
+         */
+        Result tryGetVariance() const;
+
+    private:
+        typedef typename Fixed::Wide Wide;
+
+        static constexpr int bits = Fixed::bits;
+
+        // Statistics are c = mantissa * 2^(exponent - FractionBits), with the largest mantissa kept in [2^(bits - 4), 2^(bits - 3)).
+        Storage c1;
+        Storage c2;
+        Storage c3;
+        int exponent;
+        Fixed forgettingFactor;
+        Fixed varianceRatioSquared;
+
+        void initialise(Fixed nominalValue, Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance);
+
+        void fold(Fixed decay, Wide xx, Wide xy, Wide yy);
+
+        void rescale(int shift);
+
+        Fixed estimate(bool& saturated) const;
+
+        Fixed variance(Fixed estimate, bool& saturated) const;
+};
+
+
+template <typename Storage, int FractionBits>
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::FixedPointVarianceWeightedTotalLeastSquares(
+    Fixed nominalValue, Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance
+) {
+    switch (checkParameters(varianceRatio, forgettingFactor, initialVariance)) {
+        case EstimatorStatus::InvalidForgettingFactor:
+            throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor.toDouble()) );
+        case EstimatorStatus::InvalidVarianceRatio:
+            throw std::invalid_argument( "Variance Ratio must grater then 0 and its square representable got " + std::to_string(varianceRatio.toDouble()) );
+        case EstimatorStatus::InvalidInitialVariance:
+            throw std::invalid_argument( "Initial Variance must grater then 0 and its reciprocal representable got " + std::to_string(initialVariance.toDouble()) );
+        default:
+            break;
+    }
+
+    this->initialise(nominalValue, varianceRatio, forgettingFactor, initialVariance);
+}
+
+
+template <typename Storage, int FractionBits>
+EstimatorStatus FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::checkParameters(
+    Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance
+) {
+    if (forgettingFactor > Fixed::one() || forgettingFactor <= Fixed()) {
+        return EstimatorStatus::InvalidForgettingFactor;
+    }
+
+    Fixed varianceRatioSquared = varianceRatio * varianceRatio;
+    if (varianceRatio <= Fixed() || varianceRatioSquared == Fixed() || varianceRatioSquared.isSaturated()) {
+        return EstimatorStatus::InvalidVarianceRatio;
+    }
+
+    if (initialVariance <= Fixed() || fixed_reciprocal(initialVariance).isSaturated()) {
+        return EstimatorStatus::InvalidInitialVariance;
+    }
+
+    return EstimatorStatus::Ok;
+}
+
+
+template <typename Storage, int FractionBits>
+EstimatorStatus FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::tryCreate(
+    FixedPointVarianceWeightedTotalLeastSquares& out,
+    Fixed nominalValue, Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance
+) {
+    EstimatorStatus status = checkParameters(varianceRatio, forgettingFactor, initialVariance);
+    if (status == EstimatorStatus::Ok) {
+        out.initialise(nominalValue, varianceRatio, forgettingFactor, initialVariance);
+    }
+    return status;
+}
+
+
+template <typename Storage, int FractionBits>
+void FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::initialise(
+    Fixed nominalValue, Fixed varianceRatio, Fixed forgettingFactor, Fixed initialVariance
+) {
+    this->forgettingFactor = forgettingFactor;
+    this->varianceRatioSquared = varianceRatio * varianceRatio;
+    this->c1 = 0;
+    this->c2 = 0;
+    this->c3 = 0;
+    this->exponent = -FractionBits;
+
+    // The prior is a measurement of nominalValue at x = 1.
+    this->updatePrecision(Fixed::one(), nominalValue, fixed_reciprocal(initialVariance));
+}
+
+
+template <typename Storage, int FractionBits>
+inline void FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::update(Fixed x, Fixed y, Fixed yVariance) {
+    this->updatePrecision(x, y, fixed_reciprocal(yVariance));
+}
+
+
+template <typename Storage, int FractionBits>
+inline void FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::updatePrecision(Fixed x, Fixed y, Fixed yPrecision) {
+    Fixed xWeighted = x * yPrecision;
+    Fixed yWeighted = y * yPrecision;
+    // Products with 2 * FractionBits fraction bits, rounded into the statistics by fold.
+    this->fold(
+        this->forgettingFactor,
+        static_cast<Wide>(x.raw()) * xWeighted.raw(),
+        static_cast<Wide>(y.raw()) * xWeighted.raw(),
+        static_cast<Wide>(y.raw()) * yWeighted.raw()
+    );
+}
+
+
+template <typename Storage, int FractionBits>
+void FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::rescale(int shift) {
+    this->c1 = static_cast<Storage>(fixed_round_shift<Wide>(this->c1, shift));
+    this->c2 = static_cast<Storage>(fixed_round_shift<Wide>(this->c2, shift));
+    this->c3 = static_cast<Storage>(fixed_round_shift<Wide>(this->c3, shift));
+    this->exponent += shift;
+}
+
+
+template <typename Storage, int FractionBits>
+void FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::fold(Fixed decay, Wide xx, Wide xy, Wide yy) {
+    typedef typename FixedPointTraits<Storage>::UnsignedWide UnsignedWide;
+    const int headroom = bits - 3;
+
+    // Raise the exponent until the new terms fit below the headroom, so the sum can't overflow.
+    UnsignedWide largest = static_cast<UnsignedWide>(xx) | static_cast<UnsignedWide>(xy < 0 ? -xy : xy) | static_cast<UnsignedWide>(yy);
+    int termShift = FractionBits + this->exponent;
+    int excess = fixed_bit_length(largest) - termShift - headroom;
+    if (excess > 0) {
+        this->rescale(excess);
+        termShift += excess;
+    }
+
+    Wide decayRaw = decay.raw();
+    Wide c1 = fixed_round_shift<Wide>(decayRaw * this->c1, FractionBits) + fixed_round_shift<Wide>(xx, termShift);
+    Wide c2 = fixed_round_shift<Wide>(decayRaw * this->c2, FractionBits) + fixed_round_shift<Wide>(xy, termShift);
+    Wide c3 = fixed_round_shift<Wide>(decayRaw * this->c3, FractionBits) + fixed_round_shift<Wide>(yy, termShift);
+    this->c1 = static_cast<Storage>(c1);
+    this->c2 = static_cast<Storage>(c2);
+    this->c3 = static_cast<Storage>(c3);
+
+    // Renormalise so the largest mantissa is back in [2^(bits - 4), 2^(bits - 3)), without going below
+    // an exponent of -FractionBits where new terms would have to be shifted left.
+    Storage magnitude = static_cast<Storage>(this->c1 | (this->c2 < 0 ? -this->c2 : this->c2) | this->c3);
+    int shift = fixed_bit_length(static_cast<UnsignedWide>(magnitude)) - headroom;
+    if (magnitude == 0) {
+        shift = 0;
+    } else if (this->exponent + shift < -FractionBits) {
+        shift = -FractionBits - this->exponent;
+    }
+    if (shift != 0) {
+        this->rescale(shift);
+    }
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Fixed
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::estimate(bool& saturated) const {
+    typedef typename FixedPointTraits<Storage>::UnsignedWide UnsignedWide;
+    Wide varianceRatioSquared = this->varianceRatioSquared.raw();
+    if (this->c2 == 0) {
+        return Fixed();
+    }
+
+    // The estimate is unchanged by scaling every statistic, so work on the mantissas with 2^FractionBits folded in:
+    // a = c1 - r^2 c3, b = r^2 c2 and g = c2.
+    Wide a = static_cast<Wide>(this->c1) * (Wide(1) << FractionBits) - varianceRatioSquared * this->c3;
+    Wide b = varianceRatioSquared * this->c2;
+    Wide g = static_cast<Wide>(this->c2) * (Wide(1) << FractionBits);
+
+    // Scale down so the square root's argument fits.
+    UnsignedWide largest = static_cast<UnsignedWide>(a < 0 ? -a : a) | static_cast<UnsignedWide>(b < 0 ? -b : b) | static_cast<UnsignedWide>(g < 0 ? -g : g);
+    int shift = fixed_bit_length(largest) - (bits - 3);
+    if (shift > 0) {
+        a = fixed_round_shift<Wide>(a, shift);
+        b = fixed_round_shift<Wide>(b, shift);
+        g = fixed_round_shift<Wide>(g, shift);
+    }
+    Wide root = static_cast<Wide>(fixed_integer_sqrt<UnsignedWide>(static_cast<UnsignedWide>(a * a + 4 * g * b)));
+
+    // (-a + root) / (2 b) and 2 g / (a + root) are the same root of b k^2 + a k - g, take the one without cancellation.
+    Storage raw = a >= 0
+        ? fixed_divide<Storage>(2 * g, a + root, FractionBits, saturated)
+        : fixed_divide<Storage>(root - a, 2 * b, FractionBits, saturated);
+    return Fixed::fromRaw(raw);
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Fixed
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::variance(Fixed estimate, bool& saturated) const {
+    // wtls_variance grouped by statistic: 2 bottom^3 / (c1 p1 + c2 p2 + c3 p3), where each p is a polynomial
+    // in the estimate and the variance ratio that stays within the Q format for reasonable estimates.
+    Fixed r2 = this->varianceRatioSquared;
+    Fixed r4 = r2 * r2;
+    Fixed r2k = r2 * estimate;
+    Fixed k2 = estimate * estimate;
+    Fixed k3 = k2 * estimate;
+    Fixed two = Fixed::fromInteger(2);
+
+    Fixed p1 = two - Fixed::fromInteger(6) * (r2 * k2);
+    Fixed p2 = Fixed::fromInteger(12) * r2k - Fixed::fromInteger(4) * (r4 * k3);
+    Fixed p3 = Fixed::fromInteger(6) * (r4 * k2) - two * r2;
+    Fixed bottom = r2 * k2 + Fixed::one();
+    Fixed bottomCubed = bottom * bottom * bottom;
+    if (r4.isSaturated() || k3.isSaturated() || p1.isSaturated() || p2.isSaturated() || p3.isSaturated() || bottomCubed.isSaturated()) {
+        saturated = true;
+    }
+
+    // top = top mantissa * 2^(exponent - 2 FractionBits), so 2 bottom^3 / top needs 2^(2 FractionBits - exponent).
+    Wide top = static_cast<Wide>(this->c1) * p1.raw() + static_cast<Wide>(this->c2) * p2.raw() + static_cast<Wide>(this->c3) * p3.raw();
+    if (top <= 0) {
+        return Fixed();
+    }
+    return Fixed::fromRaw(fixed_divide<Storage>(2 * static_cast<Wide>(bottomCubed.raw()), top, 2 * FractionBits - this->exponent, saturated));
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Fixed
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::getEstimate() const {
+    bool saturated = false;
+    return this->estimate(saturated);
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Fixed
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::getVariance() const {
+    bool saturated = false;
+    return this->variance(this->estimate(saturated), saturated);
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Result
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::tryGetEstimate() const {
+    bool saturated = false;
+    Fixed estimate = this->estimate(saturated);
+    if (saturated) {
+        return {Fixed(), EstimatorStatus::NotFinite};
+    }
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+template <typename Storage, int FractionBits>
+typename FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::Result
+FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits>::tryGetVariance() const {
+    bool saturated = false;
+    Fixed variance = this->variance(this->estimate(saturated), saturated);
+    if (saturated) {
+        return {Fixed(), EstimatorStatus::NotFinite};
+    }
+    if (variance <= Fixed()) {
+        return {Fixed(), EstimatorStatus::NonPositiveVariance};
+    }
+    return {variance, EstimatorStatus::Ok};
+}
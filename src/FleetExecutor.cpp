@@ -0,0 +1,39 @@
+#include "FleetExecutor.h"
+
+
+FleetExecutor::FleetExecutor(unsigned int threads, bool pinThreads, size_t chunkBytes)
+    : pool(threads, pinThreads), chunkBytes(chunkBytes) {
+}
+
+
+void FleetExecutor::updateAndEstimate(
+    VarianceWeightedTotalLeastSquares* estimators, size_t count,
+    const double* x, const double* y, const double* yVariance,
+    double* estimates, double* variances, EstimatorStatus* statuses
+) {
+    this->pool.parallelFor(count, this->chunkSize<VarianceWeightedTotalLeastSquares>(), [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            estimators[i].update(x[i], y[i], yVariance[i]);
+            estimateOne(estimators[i], i, estimates, variances, statuses);
+        }
+    });
+}
+
+
+void FleetExecutor::updateAndEstimate(
+    DualVarianceWeightedTotalLeastSquares* estimators, size_t count,
+    const double* x, const double* y, const double* xVariance, const double* yVariance,
+    double* estimates, double* variances, EstimatorStatus* statuses
+) {
+    this->pool.parallelFor(count, this->chunkSize<DualVarianceWeightedTotalLeastSquares>(), [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            estimators[i].update(x[i], y[i], xVariance[i], yVariance[i]);
+            estimateOne(estimators[i], i, estimates, variances, statuses);
+        }
+    });
+}
+
+
+WorkStealingPool& FleetExecutor::getPool() {
+    return this->pool;
+}
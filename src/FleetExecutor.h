@@ -0,0 +1,114 @@
+#pragma once
+#include "helper/WorkStealingPool.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+#include "EstimatorStatus.h"
+
+/**
+ * Updates and evaluates large fleets of estimators in parallel.
+ *
+ * The fleet is split into chunks sized to fit in cache and scheduled on a WorkStealingPool,
+ * so estimators that take the slow paths of the root solver (three real roots, Newton exhaustion)
+ * don't hold up the other threads. Results are written into caller provided arrays indexed like the fleet,
+ * using the non-throwing API so one degenerate estimator can't abort a tick.
+ */
+class FleetExecutor {
+    public:
+        /**
+         * @brief Constructor for FleetExecutor
+         * 
+         * @param threads Total number of threads including the caller, 0 uses the hardware concurrency
+         * @param pinThreads Pin worker threads to CPUs, filling one NUMA node before the next (off by default, like WorkStealingPool)
+         * @param chunkBytes Approximate number of bytes of estimators handed to a thread at a time
+         */
+        FleetExecutor(unsigned int threads=0, bool pinThreads=false, size_t chunkBytes=32 * 1024);
+
+        /**
+         * @brief Update every estimator with one measurement each, then estimate
+         * 
+         * @param estimators fleet of count estimators
+         * @param x, y, yVariance count measurements, one per estimator
+         * @param estimates written with each estimate (or last good estimate)
+         * @param variances written with each variance (or last good variance), may be null to skip the variance
+         * @param statuses written with each estimate's status (or the variance's if it failed), may be null
+         */
+        void updateAndEstimate(
+            VarianceWeightedTotalLeastSquares* estimators, size_t count,
+            const double* x, const double* y, const double* yVariance,
+            double* estimates, double* variances, EstimatorStatus* statuses
+        );
+
+        /**
+         * @brief Update every estimator with one measurement each, then estimate
+         * 
+         * @param estimators fleet of count estimators
+         * @param x, y, xVariance, yVariance count measurements, one per estimator
+         * @param estimates written with each estimate (or last good estimate)
+         * @param variances written with each variance (or last good variance), may be null to skip the variance
+         * @param statuses written with each estimate's status (or the variance's if it failed), may be null
+         */
+        void updateAndEstimate(
+            DualVarianceWeightedTotalLeastSquares* estimators, size_t count,
+            const double* x, const double* y, const double* xVariance, const double* yVariance,
+            double* estimates, double* variances, EstimatorStatus* statuses
+        );
+
+        /**
+         * @brief Estimate every estimator without updating it
+         */
+        template <typename Estimator>
+        void estimate(Estimator* estimators, size_t count, double* estimates, double* variances, EstimatorStatus* statuses);
+
+        /**
+         * @brief Pool the executor schedules on, to share it with other parallel work
+         */
+        WorkStealingPool& getPool();
+
+    private:
+        WorkStealingPool pool;
+        size_t chunkBytes;
+
+        template <typename Estimator>
+        size_t chunkSize() const;
+
+        template <typename Estimator>
+        static void estimateOne(Estimator& estimator, size_t i, double* estimates, double* variances, EstimatorStatus* statuses);
+};
+
+
+template <typename Estimator>
+size_t FleetExecutor::chunkSize() const {
+    return std::max<size_t>(1, this->chunkBytes / sizeof(Estimator));
+}
+
+
+template <typename Estimator>
+void FleetExecutor::estimateOne(Estimator& estimator, size_t i, double* estimates, double* variances, EstimatorStatus* statuses) {
+    EstimatorResult estimate;
+    EstimatorStatus status;
+    if (variances != nullptr) {
+        // One solve for both.
+        EstimatorResult variance;
+        estimator.tryGetEstimateAndVariance(estimate, variance);
+        variances[i] = variance.value;
+        status = estimate.status == EstimatorStatus::Ok ? variance.status : estimate.status;
+    } else {
+        estimate = estimator.tryGetEstimate();
+        status = estimate.status;
+    }
+    estimates[i] = estimate.value;
+
+    if (statuses != nullptr) {
+        statuses[i] = status;
+    }
+}
+
+
+template <typename Estimator>
+void FleetExecutor::estimate(Estimator* estimators, size_t count, double* estimates, double* variances, EstimatorStatus* statuses) {
+    this->pool.parallelFor(count, this->chunkSize<Estimator>(), [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            estimateOne(estimators[i], i, estimates, variances, statuses);
+        }
+    });
+}
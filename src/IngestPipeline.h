@@ -0,0 +1,273 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "helper/SpscRing.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+/**
+ * @brief One measurement addressed to one estimator of a fleet.
+ */
+struct IngestRecord {
+    size_t estimatorId;
+    double x;
+    double y;
+    double xVariance; // ignored by VarianceWeightedTotalLeastSquares
+    double yVariance;
+};
+
+inline void applyIngestRecord(VarianceWeightedTotalLeastSquares& estimator, const IngestRecord& record) {
+    estimator.update(record.x, record.y, record.yVariance);
+}
+
+inline void applyIngestRecord(DualVarianceWeightedTotalLeastSquares& estimator, const IngestRecord& record) {
+    estimator.update(record.x, record.y, record.xVariance, record.yVariance);
+}
+
+
+/**
+ * Routes measurements from many reader threads to shard owner threads that apply them to a fleet of estimators.
+ *
+ * The fleet is split into contiguous slices, one per shard, and only the shard's own thread ever updates its slice.
+ * Every producer has a private single producer single consumer ring to every shard, so the hot path is lock free:
+ * a producer writes into a ring only it pushes to, and a shard drains rings only it pops from, applying records in batches.
+ * When a ring is full, push waits (back-pressure) instead of dropping or growing.
+ *
+ * Records from one producer to one estimator are applied in the order they were pushed;
+ * records from different producers to the same estimator are applied in no particular order.
+ *
+ * The estimators must not be touched by other threads between start() and stop().
+ * Estimator must be usable with an applyIngestRecord overload.
+ */
+template <typename Estimator>
+class IngestPipeline {
+    public:
+        /**
+         * Handle a single reader thread uses to submit records, not thread safe.
+         */
+        class Producer {
+            public:
+                /**
+                 * @brief Submit a record if its shard's ring has space
+                 * 
+                 * Throws std::out_of_range if the record's estimator is outside the fleet.
+                 * 
+                 * @return false if the shard is backed up
+                 */
+                bool tryPush(const IngestRecord& record);
+
+                /**
+                 * @brief Submit a record, waiting while its shard is backed up
+                 * 
+                 * Throws std::out_of_range if the record's estimator is outside the fleet.
+                 */
+                void push(const IngestRecord& record);
+
+            private:
+                friend class IngestPipeline;
+
+                SpscRing<IngestRecord>& ringFor(const IngestRecord& record);
+
+                const IngestPipeline* pipeline;
+                std::vector<std::unique_ptr<SpscRing<IngestRecord>>> rings; // one per shard
+        };
+
+        /**
+         * @brief Constructor for IngestPipeline
+         * 
+         * @param estimators fleet of count estimators, owned by the caller
+         * @param shards Number of shard owner threads (must be more than 0)
+         * @param producers Number of producer handles (must be more than 0)
+         * @param ringCapacity Capacity of each producer to shard ring
+         * @param batchSize Maximum number of records a shard takes from a ring at a time
+         */
+        IngestPipeline(
+            Estimator* estimators, size_t count,
+            unsigned int shards, unsigned int producers,
+            size_t ringCapacity=4096, size_t batchSize=256
+        );
+
+        ~IngestPipeline();
+
+        IngestPipeline(const IngestPipeline&) = delete;
+        IngestPipeline& operator=(const IngestPipeline&) = delete;
+
+        /**
+         * @brief Get the handle for one producer thread
+         */
+        Producer& getProducer(unsigned int producer);
+
+        /**
+         * @brief Start the shard owner threads
+         */
+        void start();
+
+        /**
+         * @brief Apply every record already pushed, then stop the shard owner threads
+         * 
+         * Producers must have finished pushing before this is called.
+         */
+        void stop();
+
+        /**
+         * @brief Shard that owns an estimator
+         */
+        unsigned int shardOf(size_t estimatorId) const;
+
+        /**
+         * @brief Number of records applied so far
+         */
+        unsigned long long getAppliedCount() const;
+
+    private:
+        Estimator* estimators;
+        size_t count;
+        size_t sliceSize;
+        size_t batchSize;
+        std::vector<Producer> producers;
+        std::vector<std::thread> shards;
+        std::atomic<bool> running;
+        std::atomic<unsigned long long> applied;
+
+        void shardLoop(unsigned int shard);
+        size_t drain(unsigned int shard, std::vector<IngestRecord>& batch);
+};
+
+
+template <typename Estimator>
+SpscRing<IngestRecord>& IngestPipeline<Estimator>::Producer::ringFor(const IngestRecord& record) {
+    if (record.estimatorId >= this->pipeline->count) {
+        throw std::out_of_range( "Estimator " + std::to_string(record.estimatorId) + " is outside the fleet" );
+    }
+    return *this->rings[this->pipeline->shardOf(record.estimatorId)];
+}
+
+
+template <typename Estimator>
+bool IngestPipeline<Estimator>::Producer::tryPush(const IngestRecord& record) {
+    return this->ringFor(record).tryPush(record);
+}
+
+
+template <typename Estimator>
+void IngestPipeline<Estimator>::Producer::push(const IngestRecord& record) {
+    SpscRing<IngestRecord>& ring = this->ringFor(record);
+    while (!ring.tryPush(record)) {
+        std::this_thread::yield();
+    }
+}
+
+
+template <typename Estimator>
+IngestPipeline<Estimator>::IngestPipeline(
+    Estimator* estimators, size_t count,
+    unsigned int shards, unsigned int producers,
+    size_t ringCapacity, size_t batchSize
+) : estimators(estimators), count(count), batchSize(batchSize), running(false), applied(0) {
+    if (shards == 0) {
+        throw std::invalid_argument( "Shards must grater then 0 got " + std::to_string(shards) );
+    }
+    if (producers == 0) {
+        throw std::invalid_argument( "Producers must grater then 0 got " + std::to_string(producers) );
+    }
+    if (batchSize == 0) {
+        throw std::invalid_argument( "Batch Size must grater then 0 got " + std::to_string(batchSize) );
+    }
+
+    this->sliceSize = std::max<size_t>(1, (count + shards - 1) / shards);
+    this->producers.resize(producers);
+    for (Producer& producer : this->producers) {
+        producer.pipeline = this;
+        for (unsigned int shard = 0; shard < shards; ++shard) {
+            producer.rings.emplace_back(new SpscRing<IngestRecord>(ringCapacity));
+        }
+    }
+    this->shards.resize(shards);
+}
+
+
+template <typename Estimator>
+IngestPipeline<Estimator>::~IngestPipeline() {
+    this->stop();
+}
+
+
+template <typename Estimator>
+typename IngestPipeline<Estimator>::Producer& IngestPipeline<Estimator>::getProducer(unsigned int producer) {
+    return this->producers.at(producer);
+}
+
+
+template <typename Estimator>
+void IngestPipeline<Estimator>::start() {
+    if (this->running.exchange(true)) {
+        return;
+    }
+    for (unsigned int shard = 0; shard < this->shards.size(); ++shard) {
+        this->shards[shard] = std::thread(&IngestPipeline::shardLoop, this, shard);
+    }
+}
+
+
+template <typename Estimator>
+void IngestPipeline<Estimator>::stop() {
+    if (!this->running.exchange(false)) {
+        return;
+    }
+    for (std::thread& shard : this->shards) {
+        shard.join();
+    }
+}
+
+
+template <typename Estimator>
+unsigned int IngestPipeline<Estimator>::shardOf(size_t estimatorId) const {
+    return estimatorId / this->sliceSize;
+}
+
+
+template <typename Estimator>
+unsigned long long IngestPipeline<Estimator>::getAppliedCount() const {
+    return this->applied.load(std::memory_order_relaxed);
+}
+
+
+template <typename Estimator>
+size_t IngestPipeline<Estimator>::drain(unsigned int shard, std::vector<IngestRecord>& batch) {
+    size_t total = 0;
+    for (Producer& producer : this->producers) {
+        size_t taken = producer.rings[shard]->popBatch(batch.data(), this->batchSize);
+        for (size_t i = 0; i < taken; ++i) {
+            // Ids were checked against the fleet when pushed.
+            applyIngestRecord(this->estimators[batch[i].estimatorId], batch[i]);
+        }
+        total += taken;
+    }
+
+    if (total > 0) {
+        this->applied.fetch_add(total, std::memory_order_relaxed);
+    }
+    return total;
+}
+
+
+template <typename Estimator>
+void IngestPipeline<Estimator>::shardLoop(unsigned int shard) {
+    std::vector<IngestRecord> batch(this->batchSize);
+    unsigned int idle = 0;
+    while (this->running.load(std::memory_order_acquire)) {
+        if (this->drain(shard, batch) > 0) {
+            idle = 0;
+        } else if (++idle > 64) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Producers have stopped, apply whatever is left.
+    while (this->drain(shard, batch) > 0) {
+    }
+}
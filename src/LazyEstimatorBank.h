@@ -0,0 +1,251 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "EstimatorStatus.h"
+#include "helper/WorkStealingPool.h"
+
+/**
+ * A bank of estimators where updates only fold the measurement into the estimator's statistics
+ * and the expensive estimate and variance are computed on demand.
+ *
+ * Results are memoised per cell until the cell's next update, so cells that are updated often
+ * but read rarely never pay for the quartic/closed form solve or the Hessian.
+ * Cells that have been updated since they were last evaluated can be brought up to date together
+ * with recomputeDirty, which only touches changed cells and spreads them across threads.
+ *
+ * Estimator must provide update(...), tryGetEstimate(), tryGetVariance() and tryGetEstimateAndVariance(...),
+ * e.g. VarianceWeightedTotalLeastSquares or DualVarianceWeightedTotalLeastSquares.
+ *
+ * Not thread safe, except that recomputeDirty uses threads internally.
+ */
+template <typename Estimator>
+class LazyEstimatorBank {
+    public:
+        /**
+         * @brief Constructor for LazyEstimatorBank
+         *
+         * @param count Number of cells in the bank
+         * @param prototype Estimator every cell starts as
+         */
+        LazyEstimatorBank(size_t count, const Estimator& prototype = Estimator());
+
+        /**
+         * @brief Constructor for LazyEstimatorBank from already constructed estimators
+         *
+         * @param estimators One estimator per cell
+         */
+        explicit LazyEstimatorBank(std::vector<Estimator> estimators);
+
+        /**
+         * @brief Update a cell with a new measurement, only the statistics are updated
+         *
+         * @param cell index of the cell to update
+         * @param measurement arguments forwarded to Estimator::update
+         */
+        template <typename... Args>
+        void update(size_t cell, Args... measurement);
+
+        /**
+         * @brief Get the estimate of a cell, computing it if the cell has changed since it was last computed
+         *
+         * @return The estimate, or the last good estimate and the reason no estimate could be found
+         */
+        EstimatorResult getEstimate(size_t cell);
+
+        /**
+         * @brief Get the variance of a cell, computing it if the cell has changed since it was last computed
+         *
+         * @return The variance, or the last good variance and the reason no variance could be found
+         */
+        EstimatorResult getVariance(size_t cell);
+
+        /**
+         * @brief Compute the estimate and variance of every cell updated since it was last fully computed
+         *
+         * @param threads maximum number of threads to use, 0 uses the hardware concurrency
+         */
+        void recomputeDirty(unsigned int threads=0);
+
+        /**
+         * @brief Compute the estimate and variance of every cell updated since it was last fully computed
+         *
+         * @param pool pool to schedule the dirty cells on
+         */
+        void recomputeDirty(WorkStealingPool& pool);
+
+        /**
+         * @brief Whether a cell has been updated since its estimate and variance were both computed
+         */
+        bool isDirty(size_t cell) const;
+
+        /**
+         * @brief Number of cells updated since they were last fully computed
+         */
+        size_t dirtyCount() const;
+
+        /**
+         * @brief Number of cells in the bank
+         */
+        size_t size() const;
+
+        /**
+         * @brief Read only access to the estimator of a cell
+         */
+        const Estimator& getEstimator(size_t cell) const;
+
+    private:
+        struct Cache {
+            EstimatorResult estimate;
+            EstimatorResult variance;
+            bool hasEstimate;
+            bool hasVariance;
+            bool queued;
+        };
+
+        // Don't spawn a thread for less work than this.
+        static constexpr size_t minCellsPerThread = 256;
+
+        std::vector<Estimator> estimators;
+        std::vector<Cache> cache;
+        std::vector<size_t> dirty;
+
+        void recomputeRange(size_t begin, size_t end);
+};
+
+
+template <typename Estimator>
+LazyEstimatorBank<Estimator>::LazyEstimatorBank(size_t count, const Estimator& prototype)
+    : LazyEstimatorBank(std::vector<Estimator>(count, prototype)) {
+}
+
+
+template <typename Estimator>
+LazyEstimatorBank<Estimator>::LazyEstimatorBank(std::vector<Estimator> estimators)
+    : estimators(std::move(estimators)) {
+    Cache empty = {};
+    this->cache.assign(this->estimators.size(), empty);
+
+    // Every cell starts unevaluated.
+    this->dirty.reserve(this->estimators.size());
+    for (size_t i = 0; i < this->estimators.size(); ++i) {
+        this->cache[i].queued = true;
+        this->dirty.push_back(i);
+    }
+}
+
+
+template <typename Estimator>
+template <typename... Args>
+void LazyEstimatorBank<Estimator>::update(size_t cell, Args... measurement) {
+    this->estimators[cell].update(measurement...);
+
+    Cache& entry = this->cache[cell];
+    entry.hasEstimate = false;
+    entry.hasVariance = false;
+    if (!entry.queued) {
+        entry.queued = true;
+        this->dirty.push_back(cell);
+    }
+}
+
+
+template <typename Estimator>
+EstimatorResult LazyEstimatorBank<Estimator>::getEstimate(size_t cell) {
+    Cache& entry = this->cache[cell];
+    if (!entry.hasEstimate) {
+        entry.estimate = this->estimators[cell].tryGetEstimate();
+        entry.hasEstimate = true;
+    }
+    return entry.estimate;
+}
+
+
+template <typename Estimator>
+EstimatorResult LazyEstimatorBank<Estimator>::getVariance(size_t cell) {
+    Cache& entry = this->cache[cell];
+    if (!entry.hasVariance) {
+        entry.variance = this->estimators[cell].tryGetVariance();
+        entry.hasVariance = true;
+    }
+    return entry.variance;
+}
+
+
+template <typename Estimator>
+void LazyEstimatorBank<Estimator>::recomputeRange(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        size_t cell = this->dirty[i];
+        Cache& entry = this->cache[cell];
+        if (!entry.hasEstimate && !entry.hasVariance) {
+            // One solve for both.
+            this->estimators[cell].tryGetEstimateAndVariance(entry.estimate, entry.variance);
+            entry.hasEstimate = true;
+            entry.hasVariance = true;
+        } else {
+            this->getEstimate(cell);
+            this->getVariance(cell);
+        }
+        entry.queued = false;
+    }
+}
+
+
+template <typename Estimator>
+void LazyEstimatorBank<Estimator>::recomputeDirty(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    size_t count = this->dirty.size();
+    size_t workers = std::min<size_t>(threads, std::max<size_t>(1, count / minCellsPerThread));
+
+    if (workers <= 1) {
+        this->recomputeRange(0, count);
+        this->dirty.clear();
+        return;
+    }
+
+    // Each dirty cell appears once in the list, so the threads never share a cell.
+    WorkStealingPool pool(static_cast<unsigned int>(workers));
+    this->recomputeDirty(pool);
+}
+
+
+template <typename Estimator>
+void LazyEstimatorBank<Estimator>::recomputeDirty(WorkStealingPool& pool) {
+    pool.parallelFor(this->dirty.size(), minCellsPerThread, [this](size_t begin, size_t end) {
+        this->recomputeRange(begin, end);
+    });
+    this->dirty.clear();
+}
+
+
+template <typename Estimator>
+bool LazyEstimatorBank<Estimator>::isDirty(size_t cell) const {
+    return !(this->cache[cell].hasEstimate && this->cache[cell].hasVariance);
+}
+
+
+template <typename Estimator>
+size_t LazyEstimatorBank<Estimator>::dirtyCount() const {
+    size_t count = 0;
+    for (size_t cell : this->dirty) {
+        if (this->isDirty(cell)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+template <typename Estimator>
+size_t LazyEstimatorBank<Estimator>::size() const {
+    return this->estimators.size();
+}
+
+
+template <typename Estimator>
+const Estimator& LazyEstimatorBank<Estimator>::getEstimator(size_t cell) const {
+    return this->estimators[cell];
+}
@@ -0,0 +1,300 @@
+#include "MultiForgettingVarianceWeightedTotalLeastSquares.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "helper/cpuDispatch.h"
+
+
+namespace {
+
+// Scores each hypothesis on the measurement with the estimate it had before it, then folds the measurement in.
+// The scores need a square root and a logarithm per hypothesis so they are kept out of the statistics loop,
+// which then vectorises across hypotheses.
+CPU_DISPATCH_INLINE void multi_forgetting_update_body(
+    const double* forgettingFactor, double scoreForgettingFactor, double varianceRatioSquared,
+    double x, double y, double yPrecision,
+    double* c1, double* c2, double* c3, double* score, size_t count
+) {
+    double halfPrecision = 0.5 * yPrecision;
+    for (size_t k = 0; k < count; ++k) {
+        double estimate = wtls_estimate(c1[k], c2[k], c3[k], varianceRatioSquared);
+        double spread = 1 + varianceRatioSquared * estimate * estimate;
+        double residual = y - estimate * x;
+        score[k] = scoreForgettingFactor * score[k] - 0.5 * std::log(spread) - halfPrecision * residual * residual / spread;
+    }
+
+    // Computed once for every hypothesis.
+    double xWeighted = x * yPrecision;
+    double xx = x * xWeighted;
+    double xy = y * xWeighted;
+    double yy = y * y * yPrecision;
+    for (size_t k = 0; k < count; ++k) {
+        c1[k] = forgettingFactor[k] * c1[k] + xx;
+        c2[k] = forgettingFactor[k] * c2[k] + xy;
+        c3[k] = forgettingFactor[k] * c3[k] + yy;
+    }
+}
+
+typedef void (*MultiForgettingUpdateKernel)(
+    const double*, double, double, double, double, double, double*, double*, double*, double*, size_t
+);
+
+#define MULTI_FORGETTING_UPDATE_KERNELS(suffix, target) \
+    target void multi_forgetting_update_##suffix( \
+        const double* forgettingFactor, double scoreForgettingFactor, double varianceRatioSquared, \
+        double x, double y, double yPrecision, \
+        double* c1, double* c2, double* c3, double* score, size_t count \
+    ) { \
+        multi_forgetting_update_body( \
+            forgettingFactor, scoreForgettingFactor, varianceRatioSquared, x, y, yPrecision, c1, c2, c3, score, count \
+        ); \
+    }
+
+MULTI_FORGETTING_UPDATE_KERNELS(generic, )
+#if CPU_DISPATCH_X86
+MULTI_FORGETTING_UPDATE_KERNELS(avx2, CPU_DISPATCH_TARGET_AVX2)
+MULTI_FORGETTING_UPDATE_KERNELS(avx512, CPU_DISPATCH_TARGET_AVX512)
+#endif
+
+}
+
+
+MultiForgettingVarianceWeightedTotalLeastSquares::MultiForgettingVarianceWeightedTotalLeastSquares(
+            const std::vector<double>& forgettingFactors, double nominalValue, double varianceRatio,
+            double initialVariance, double scoreForgettingFactor) {
+    if (forgettingFactors.empty()) {
+        throw std::invalid_argument( "Forgetting Factors must have at least one hypothesis" );
+    }
+    for (double forgettingFactor : forgettingFactors) {
+        switch (VarianceWeightedTotalLeastSquares::checkParameters(varianceRatio, forgettingFactor, initialVariance)) {
+            case EstimatorStatus::InvalidForgettingFactor:
+                throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+            case EstimatorStatus::InvalidVarianceRatio:
+                throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+            case EstimatorStatus::InvalidInitialVariance:
+                throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(initialVariance) );
+            default:
+                break;
+        }
+    }
+    if (scoreForgettingFactor > 1 || scoreForgettingFactor <= 0) {
+        throw std::invalid_argument( "Score Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(scoreForgettingFactor) );
+    }
+
+    size_t count = forgettingFactors.size();
+    this->varianceRatioSquared = varianceRatio * varianceRatio;
+    this->scoreForgettingFactor = scoreForgettingFactor;
+    this->forgettingFactor = forgettingFactors;
+
+    // Same prior as VarianceWeightedTotalLeastSquares.
+    this->c1.assign(count, 1 / initialVariance);
+    this->c2.assign(count, nominalValue / initialVariance);
+    this->c3.assign(count, (nominalValue * nominalValue) / initialVariance);
+
+    this->score.assign(count, 0.0);
+    this->lastEstimate.assign(count, nominalValue);
+    this->lastVariance.assign(count, std::numeric_limits<double>::quiet_NaN());
+    this->lastBlendedEstimate = nominalValue;
+    this->lastBlendedVariance = std::numeric_limits<double>::quiet_NaN();
+    this->sharedVarianceRatioSquared.assign(count, this->varianceRatioSquared);
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::update(double x, double y, double yVariance) {
+    // Don't check input because it would massivly slow down this.
+    this->fold(x, y, 1 / yVariance);
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::updatePrecision(double x, double y, double yPrecision) {
+    this->fold(x, y, yPrecision);
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::fold(double x, double y, double yPrecision) {
+    MultiForgettingUpdateKernel kernel = CPU_DISPATCH_SELECT(multi_forgetting_update);
+    kernel(
+        this->forgettingFactor.data(), this->scoreForgettingFactor, this->varianceRatioSquared, x, y, yPrecision,
+        this->c1.data(), this->c2.data(), this->c3.data(), this->score.data(), this->c1.size()
+    );
+}
+
+
+double MultiForgettingVarianceWeightedTotalLeastSquares::getEstimate(size_t hypothesis) {
+    return wtls_estimate(this->c1[hypothesis], this->c2[hypothesis], this->c3[hypothesis], this->varianceRatioSquared);
+}
+
+
+double MultiForgettingVarianceWeightedTotalLeastSquares::getVariance(size_t hypothesis) {
+    double estimate, variance;
+    wtls_estimate_variance(this->c1[hypothesis], this->c2[hypothesis], this->c3[hypothesis], this->varianceRatioSquared, estimate, variance);
+    return variance;
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetEstimate(size_t hypothesis) {
+    double estimate = this->getEstimate(hypothesis);
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate[hypothesis], EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate[hypothesis] = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetVariance(size_t hypothesis) {
+    double variance = this->getVariance(hypothesis);
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance[hypothesis], EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance[hypothesis], EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance[hypothesis] = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::getEstimates(double* estimates, double* variances, EstimatorStatus* statuses) {
+    size_t count = this->c1.size();
+    wtls_estimate_batch(
+        this->c1.data(), this->c2.data(), this->c3.data(), this->sharedVarianceRatioSquared.data(),
+        count, estimates, variances
+    );
+
+    for (size_t k = 0; k < count; ++k) {
+        EstimatorStatus status = EstimatorStatus::Ok;
+        if (std::isfinite(estimates[k])) {
+            this->lastEstimate[k] = estimates[k];
+        } else {
+            estimates[k] = this->lastEstimate[k];
+            status = EstimatorStatus::NotFinite;
+        }
+
+        if (variances != nullptr) {
+            EstimatorStatus varianceStatus = EstimatorStatus::Ok;
+            if (!std::isfinite(variances[k])) {
+                varianceStatus = EstimatorStatus::NotFinite;
+            } else if (variances[k] <= 0) {
+                varianceStatus = EstimatorStatus::NonPositiveVariance;
+            }
+            if (varianceStatus == EstimatorStatus::Ok) {
+                this->lastVariance[k] = variances[k];
+            }
+            variances[k] = this->lastVariance[k];
+            if (status == EstimatorStatus::Ok) {
+                status = varianceStatus;
+            }
+        }
+
+        if (statuses != nullptr) {
+            statuses[k] = status;
+        }
+    }
+}
+
+
+size_t MultiForgettingVarianceWeightedTotalLeastSquares::bestHypothesis() const {
+    size_t best = 0;
+    for (size_t k = 1; k < this->score.size(); ++k) {
+        // A NaN score never wins.
+        if (this->score[k] > this->score[best] || std::isnan(this->score[best])) {
+            best = k;
+        }
+    }
+    return best;
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetSelectedEstimate() {
+    return this->tryGetEstimate(this->bestHypothesis());
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetSelectedVariance() {
+    return this->tryGetVariance(this->bestHypothesis());
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::getWeights(double* weights) const {
+    // Relative to the best score so the exponentials can't overflow.
+    double best = this->score[this->bestHypothesis()];
+    double total = 0.0;
+    for (size_t k = 0; k < this->score.size(); ++k) {
+        weights[k] = std::isnan(this->score[k]) ? 0.0 : std::exp(this->score[k] - best);
+        total += weights[k];
+    }
+    for (size_t k = 0; k < this->score.size(); ++k) {
+        weights[k] /= total;
+    }
+}
+
+
+void MultiForgettingVarianceWeightedTotalLeastSquares::blend(bool withVariance, double& estimate, double& variance, double& weight) {
+    size_t count = this->c1.size();
+    this->estimates.resize(count);
+    this->variances.resize(count);
+    this->statuses.resize(count);
+    this->weights.resize(count);
+    this->getEstimates(this->estimates.data(), withVariance ? this->variances.data() : nullptr, this->statuses.data());
+    this->getWeights(this->weights.data());
+
+    double weightedEstimates = 0.0;
+    double weightedSecondMoments = 0.0;
+    weight = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        if (this->statuses[k] != EstimatorStatus::Ok) {
+            continue;
+        }
+        weight += this->weights[k];
+        weightedEstimates += this->weights[k] * this->estimates[k];
+        if (withVariance) {
+            weightedSecondMoments += this->weights[k] * (this->variances[k] + this->estimates[k] * this->estimates[k]);
+        }
+    }
+
+    estimate = weightedEstimates / weight;
+    variance = weightedSecondMoments / weight - estimate * estimate;
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetBlendedEstimate() {
+    double estimate, variance, weight;
+    this->blend(false, estimate, variance, weight);
+    if (weight <= 0 || !std::isfinite(estimate)) {
+        return {this->lastBlendedEstimate, EstimatorStatus::NotFinite};
+    }
+
+    this->lastBlendedEstimate = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult MultiForgettingVarianceWeightedTotalLeastSquares::tryGetBlendedVariance() {
+    double estimate, variance, weight;
+    this->blend(true, estimate, variance, weight);
+    if (weight <= 0 || !std::isfinite(variance)) {
+        return {this->lastBlendedVariance, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastBlendedVariance, EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastBlendedVariance = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+double MultiForgettingVarianceWeightedTotalLeastSquares::getScore(size_t hypothesis) const {
+    return this->score[hypothesis];
+}
+
+
+double MultiForgettingVarianceWeightedTotalLeastSquares::getForgettingFactor(size_t hypothesis) const {
+    return this->forgettingFactor[hypothesis];
+}
+
+
+size_t MultiForgettingVarianceWeightedTotalLeastSquares::hypotheses() const {
+    return this->c1.size();
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "EstimatorStatus.h"
+#include "helper/wtls.h"
+
+/**
+ * Several VarianceWeightedTotalLeastSquares hypotheses with different forgetting factors fed one input stream,
+ * e.g. to hedge between a fast tracking and a low noise estimate of the same cell.
+ *
+ * Each hypothesis gives the same result as its own VarianceWeightedTotalLeastSquares with that forgetting factor,
+ * but the measurement's contribution (x^2, x y and y^2 over the variance) is computed once per update rather than
+ * once per hypothesis, and the statistics are stored as arrays so updates vectorise across hypotheses.
+ *
+ * Before each measurement is added, every hypothesis is scored by how likely it found the measurement: the log
+ * density of y given its estimate w, with the total least squares residual variance yVariance (1 + varianceRatio^2 w^2),
+ * summed over measurements with a score forgetting factor so the ranking can change when the data does.
+ * The best scoring hypothesis can be selected, or all blended with weights proportional to exp(score).
+ */
+class MultiForgettingVarianceWeightedTotalLeastSquares {
+    public:
+        /**
+         * @brief Constructor for MultiForgettingVarianceWeightedTotalLeastSquares
+         *
+         * @param forgettingFactors Forgetting factor of each hypothesis (0 < f <= 1)
+         * @param nominalValue Initial estimate of the weight
+         * @param varianceRatio Ratio of output measurement variance to input measurement variance of x over y
+         * @param initialVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         * @param scoreForgettingFactor Factor to reduce the influence of older measurements on the scores (0 < f <= 1)
+         */
+        MultiForgettingVarianceWeightedTotalLeastSquares(
+            const std::vector<double>& forgettingFactors, double nominalValue=0.0, double varianceRatio=1.0,
+            double initialVariance=1.0, double scoreForgettingFactor=1.0
+        );
+
+        /**
+         * @brief Score every hypothesis on a new measurement, then update every hypothesis with it
+         *
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void update(double x, double y, double yVariance);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance)
+         */
+        void updatePrecision(double x, double y, double yPrecision);
+
+        /**
+         * @brief Get the current estimate of a hypothesis
+         */
+        double getEstimate(size_t hypothesis);
+
+        /**
+         * @brief Get the current variance of a hypothesis's weight estimate
+         */
+        double getVariance(size_t hypothesis);
+
+        /**
+         * @brief Get the current estimate of a hypothesis without throwing
+         *
+         * @return The estimate, or the last good estimate and the reason the estimate is unusable
+         */
+        EstimatorResult tryGetEstimate(size_t hypothesis);
+
+        /**
+         * @brief Get the current variance of a hypothesis's weight estimate without throwing
+         *
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        EstimatorResult tryGetVariance(size_t hypothesis);
+
+        /**
+         * @brief Estimate every hypothesis at once, with the same results as tryGetEstimate and tryGetVariance
+         *
+         * @param estimates caller provided storage for one estimate per hypothesis
+         * @param variances caller provided storage for one variance per hypothesis, may be null to skip them
+         * @param statuses caller provided storage for one status per hypothesis, may be null.
+         *                 The estimate's status, or the variance's when the estimate is Ok and variances are requested.
+         */
+        void getEstimates(double* estimates, double* variances, EstimatorStatus* statuses);
+
+        /**
+         * @brief Hypothesis with the highest score, the first one on a tie
+         */
+        size_t bestHypothesis() const;
+
+        /**
+         * @brief Get the estimate of the best hypothesis without throwing
+         */
+        EstimatorResult tryGetSelectedEstimate();
+
+        /**
+         * @brief Get the variance of the best hypothesis without throwing
+         */
+        EstimatorResult tryGetSelectedVariance();
+
+        /**
+         * @brief Get the blend of every hypothesis's estimate, weighted by getWeights, without throwing
+         *
+         * Hypotheses without a usable estimate are left out and the other weights renormalised.
+         *
+         * @return The blended estimate, or the last good one and the reason when no hypothesis has an estimate
+         */
+        EstimatorResult tryGetBlendedEstimate();
+
+        /**
+         * @brief Get the variance of the blended estimate without throwing
+         *
+         * The variance of the mixture: the weighted variances plus the spread of the estimates around their blend.
+         * Hypotheses without a usable estimate and variance are left out and the other weights renormalised.
+         */
+        EstimatorResult tryGetBlendedVariance();
+
+        /**
+         * @brief Weight of each hypothesis, exp(score) normalised to sum to 1
+         *
+         * @param weights caller provided storage for one weight per hypothesis
+         */
+        void getWeights(double* weights) const;
+
+        /**
+         * @brief Get the score of a hypothesis, the forgotten sum of the log densities of the measurements it predicted
+         *
+         * Only differences between hypotheses are meaningful, terms shared by every hypothesis are left out.
+         */
+        double getScore(size_t hypothesis) const;
+
+        /**
+         * @brief Get the forgetting factor of a hypothesis
+         */
+        double getForgettingFactor(size_t hypothesis) const;
+
+        /**
+         * @brief Number of hypotheses
+         */
+        size_t hypotheses() const;
+
+    private:
+        double varianceRatioSquared;
+        double scoreForgettingFactor;
+        std::vector<double> forgettingFactor;
+        std::vector<double> c1;
+        std::vector<double> c2;
+        std::vector<double> c3;
+        std::vector<double> score;
+        std::vector<double> lastEstimate;
+        std::vector<double> lastVariance;
+        double lastBlendedEstimate;
+        double lastBlendedVariance;
+
+        // Scratch space for getEstimates and the blends.
+        std::vector<double> sharedVarianceRatioSquared;
+        std::vector<double> estimates;
+        std::vector<double> variances;
+        std::vector<EstimatorStatus> statuses;
+        std::vector<double> weights;
+
+        void fold(double x, double y, double yPrecision);
+
+        void blend(bool withVariance, double& estimate, double& variance, double& weight);
+};
@@ -0,0 +1,124 @@
+#include "MultiInputWeightedRecursiveLeastSquares.h"
+
+
+MultiInputWeightedRecursiveLeastSquares::MultiInputWeightedRecursiveLeastSquares(
+    size_t inputs, double nominalValue, double forgettingFactor, double initialVariance
+) {
+    if (inputs == 0) {
+        throw std::invalid_argument( "Inputs must grater then 0 got 0" );
+    }
+    if (forgettingFactor > 1 || forgettingFactor <= 0) {
+        throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+    }
+    if (initialVariance <= 0) {
+        throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(initialVariance) );
+    }
+
+    this->inputCount = inputs;
+    this->forgettingFactor = forgettingFactor;
+    this->inverseForgettingFactor = 1 / forgettingFactor;
+    this->weights.assign(inputs, nominalValue);
+    this->covariance.assign(inputs * inputs, 0.0);
+    for (size_t i = 0; i < inputs; ++i) {
+        this->covariance[i * inputs + i] = initialVariance;
+    }
+    this->gain.assign(inputs, 0.0);
+    this->lastEstimate.assign(inputs, nominalValue);
+    this->lastVariance.assign(inputs, std::numeric_limits<double>::quiet_NaN());
+}
+
+
+void MultiInputWeightedRecursiveLeastSquares::update(const double* x, double y, double yVariance) {
+    this->updatePrecision(x, y, 1 / yVariance);
+}
+
+
+void MultiInputWeightedRecursiveLeastSquares::updatePrecision(const double* x, double y, double yPrecision) {
+    size_t n = this->inputCount;
+    double* P = this->covariance.data();
+    double* Px = this->gain.data();
+    double* w = this->weights.data();
+
+    // P x (P is symmetric so also x' P), x' P x and the prediction error.
+    double xPx = 0.0;
+    double error = y;
+    for (size_t i = 0; i < n; ++i) {
+        const double* row = P + i * n;
+        double sum = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            sum += row[j] * x[j];
+        }
+        Px[i] = sum;
+        xPx += x[i] * sum;
+        error -= x[i] * w[i];
+    }
+
+    // k = P x yPrecision / (f + yPrecision x' P x), written to avoid dividing by yPrecision.
+    double scale = yPrecision / (this->forgettingFactor + yPrecision * xPx);
+    for (size_t i = 0; i < n; ++i) {
+        w[i] += scale * Px[i] * error;
+    }
+
+    // P = (P - k x' P) / f, the rank one downdate keeps P symmetric.
+    for (size_t i = 0; i < n; ++i) {
+        double* row = P + i * n;
+        double ki = scale * Px[i];
+        for (size_t j = 0; j < n; ++j) {
+            row[j] = (row[j] - ki * Px[j]) * this->inverseForgettingFactor;
+        }
+    }
+}
+
+
+double MultiInputWeightedRecursiveLeastSquares::getEstimate(size_t input) const {
+    return this->weights[input];
+}
+
+
+void MultiInputWeightedRecursiveLeastSquares::getEstimates(double* estimates) const {
+    for (size_t i = 0; i < this->inputCount; ++i) {
+        estimates[i] = this->weights[i];
+    }
+}
+
+
+double MultiInputWeightedRecursiveLeastSquares::getVariance(size_t input) const {
+    return this->covariance[input * this->inputCount + input];
+}
+
+
+void MultiInputWeightedRecursiveLeastSquares::getCovariance(double* covariance) const {
+    for (size_t i = 0; i < this->inputCount * this->inputCount; ++i) {
+        covariance[i] = this->covariance[i];
+    }
+}
+
+
+EstimatorResult MultiInputWeightedRecursiveLeastSquares::tryGetEstimate(size_t input) {
+    double estimate = this->getEstimate(input);
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate[input], EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate[input] = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult MultiInputWeightedRecursiveLeastSquares::tryGetVariance(size_t input) {
+    double variance = this->getVariance(input);
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance[input], EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance[input], EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance[input] = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+size_t MultiInputWeightedRecursiveLeastSquares::inputs() const {
+    return this->inputCount;
+}
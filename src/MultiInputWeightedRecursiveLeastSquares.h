@@ -0,0 +1,96 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "EstimatorStatus.h"
+
+/**
+ * Weighted recursive least squares for several inputs, estimating the weights W in y = W . x with only y taken to have noise.
+ * The multi input form of WeightedRecursiveLeastSquares, with the same update / getEstimate / getVariance interface.
+ *
+ * Keeps the weights and their covariance P rather than the information statistics, so each update is O(inputs^2)
+ * with no matrix inversion: k = P x / (f / yPrecision + x' P x), W += k (y - x' W), P = (P - k x' P) / f.
+ */
+class MultiInputWeightedRecursiveLeastSquares {
+    public:
+        /**
+         * @brief Constructor for MultiInputWeightedRecursiveLeastSquares
+         *
+         * @param inputs Number of inputs (must be more then 0)
+         * @param nominalValue Initial estimate of every weight
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         * @param initialVariance Initial variance of every weight, with no initial covariance between them
+         */
+        MultiInputWeightedRecursiveLeastSquares(
+            size_t inputs, double nominalValue=0.0, double forgettingFactor=1.0, double initialVariance=1.0
+        );
+
+        /**
+         * @brief Update with a new measurement
+         *
+         * @param x mesurement of every input
+         * @param y mesurement of the output
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void update(const double* x, double y, double yVariance);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance)
+         */
+        void updatePrecision(const double* x, double y, double yPrecision);
+
+        /**
+         * @brief Get the current estimate of one input's weight
+         */
+        double getEstimate(size_t input) const;
+
+        /**
+         * @brief Copy every weight estimate
+         *
+         * @param estimates caller provided storage for one estimate per input
+         */
+        void getEstimates(double* estimates) const;
+
+        /**
+         * @brief Get the current variance of one input's weight estimate
+         */
+        double getVariance(size_t input) const;
+
+        /**
+         * @brief Copy the covariance of the weight estimates
+         *
+         * @param covariance caller provided storage for inputs * inputs values, row major
+         */
+        void getCovariance(double* covariance) const;
+
+        /**
+         * @brief Get the current estimate of one input's weight without throwing
+         *
+         * @return The estimate, or the last good estimate and the reason the estimate is unusable
+         */
+        EstimatorResult tryGetEstimate(size_t input);
+
+        /**
+         * @brief Get the current variance of one input's weight estimate without throwing
+         *
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        EstimatorResult tryGetVariance(size_t input);
+
+        /**
+         * @brief Get the number of inputs
+         */
+        size_t inputs() const;
+
+    private:
+        size_t inputCount;
+        double forgettingFactor;
+        double inverseForgettingFactor;
+        std::vector<double> weights;
+        std::vector<double> covariance; // inputs * inputs, row major
+        std::vector<double> gain; // scratch for P x
+        std::vector<double> lastEstimate;
+        std::vector<double> lastVariance;
+};
@@ -0,0 +1,290 @@
+#include "MultiOutputDualVarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+#include "helper/cpuDispatch.h"
+
+
+namespace {
+
+// Per output part of DualVarianceWeightedTotalLeastSquares::update, with no dependency between outputs.
+template <bool WeightIsVariance>
+CPU_DISPATCH_INLINE void multi_output_update_body(
+    double forgettingFactor, double x, double xPrecision, const double* y, const double* yWeight,
+    const double* varianceRatio, const double* inverseVarianceRatioSquared,
+    double* c1, double* c2, double* c3, double* c5, double* c6, size_t count
+) {
+    double xx = x * x;
+    double xWeighted = x * xPrecision;
+    for (size_t k = 0; k < count; ++k) {
+        double yPrecision = WeightIsVariance ? 1 / yWeight[k] : yWeight[k];
+        double correctedY = y[k] * varianceRatio[k];
+        double yScale = yPrecision * inverseVarianceRatioSquared[k];
+
+        c1[k] = forgettingFactor * c1[k] + xx * yScale;
+        c2[k] = forgettingFactor * c2[k] + x * correctedY * yScale;
+        c3[k] = forgettingFactor * c3[k] + correctedY * correctedY * yScale;
+        c5[k] = forgettingFactor * c5[k] + xWeighted * correctedY;
+        c6[k] = forgettingFactor * c6[k] + correctedY * correctedY * xPrecision;
+    }
+}
+
+typedef void (*MultiOutputUpdateKernel)(
+    double, double, double, const double*, const double*, const double*, const double*,
+    double*, double*, double*, double*, double*, size_t
+);
+
+#define MULTI_OUTPUT_UPDATE_KERNELS(suffix, target) \
+    target void multi_output_update_variance_##suffix( \
+        double forgettingFactor, double x, double xPrecision, const double* y, const double* yVariance, \
+        const double* varianceRatio, const double* inverseVarianceRatioSquared, \
+        double* c1, double* c2, double* c3, double* c5, double* c6, size_t count \
+    ) { \
+        multi_output_update_body<true>( \
+            forgettingFactor, x, xPrecision, y, yVariance, varianceRatio, inverseVarianceRatioSquared, c1, c2, c3, c5, c6, count \
+        ); \
+    } \
+    target void multi_output_update_precision_##suffix( \
+        double forgettingFactor, double x, double xPrecision, const double* y, const double* yPrecision, \
+        const double* varianceRatio, const double* inverseVarianceRatioSquared, \
+        double* c1, double* c2, double* c3, double* c5, double* c6, size_t count \
+    ) { \
+        multi_output_update_body<false>( \
+            forgettingFactor, x, xPrecision, y, yPrecision, varianceRatio, inverseVarianceRatioSquared, c1, c2, c3, c5, c6, count \
+        ); \
+    }
+
+MULTI_OUTPUT_UPDATE_KERNELS(generic, )
+#if CPU_DISPATCH_X86
+MULTI_OUTPUT_UPDATE_KERNELS(avx2, CPU_DISPATCH_TARGET_AVX2)
+MULTI_OUTPUT_UPDATE_KERNELS(avx512, CPU_DISPATCH_TARGET_AVX512)
+#endif
+
+}
+
+
+MultiOutputDualVarianceWeightedTotalLeastSquares::MultiOutputDualVarianceWeightedTotalLeastSquares(
+            size_t outputs, double nominalValue, double forgettingFactor,
+            double initialXVariance, double initialYVariance, double varianceRatio) {
+    switch (DualVarianceWeightedTotalLeastSquares::checkParameters(forgettingFactor, initialXVariance, initialYVariance, varianceRatio)) {
+        case EstimatorStatus::InvalidForgettingFactor:
+            throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+        case EstimatorStatus::InvalidInitialXVariance:
+            throw std::invalid_argument( "Initial X Variance must grater then 0 got " + std::to_string(initialXVariance) );
+        case EstimatorStatus::InvalidInitialYVariance:
+            throw std::invalid_argument( "Initial Y Variance must grater then 0 got " + std::to_string(initialYVariance) );
+        case EstimatorStatus::InvalidVarianceRatio:
+            throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+        default:
+            break;
+    }
+
+    this->forgettingFactor = forgettingFactor;
+    this->lastEstimate.assign(outputs, nominalValue);
+    this->lastVariance.assign(outputs, std::numeric_limits<double>::quiet_NaN());
+
+    // Same prior as DualVarianceWeightedTotalLeastSquares, without a ratio it is set by each output's first update.
+    if (varianceRatio != -1) {
+        this->varianceRatio.assign(outputs, varianceRatio);
+        this->inverseVarianceRatioSquared.assign(outputs, 1 / (varianceRatio * varianceRatio));
+        this->hasVarianceRatio.assign(outputs, 1);
+        this->outputsWithoutRatio = 0;
+
+        nominalValue = varianceRatio * nominalValue;
+    } else {
+        this->varianceRatio.assign(outputs, 1.0);
+        this->inverseVarianceRatioSquared.assign(outputs, 1.0);
+        this->hasVarianceRatio.assign(outputs, 0);
+        this->outputsWithoutRatio = outputs;
+    }
+
+    this->c1.assign(outputs, 1 / initialYVariance);
+    this->c2.assign(outputs, nominalValue / initialYVariance);
+    this->c3.assign(outputs, nominalValue * nominalValue / initialYVariance);
+
+    this->c4 = 1 / initialXVariance;
+    this->c5.assign(outputs, nominalValue / initialXVariance);
+    this->c6.assign(outputs, nominalValue * nominalValue / initialXVariance);
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::setVarianceRatio(size_t output, double varianceRatio) {
+    this->varianceRatio[output] = varianceRatio;
+    this->inverseVarianceRatioSquared[output] = 1 / (varianceRatio * varianceRatio);
+    this->hasVarianceRatio[output] = 1;
+    --this->outputsWithoutRatio;
+
+    this->c1[output] /= varianceRatio * varianceRatio;
+    this->c2[output] /= varianceRatio;
+    this->c5[output] *= varianceRatio;
+    this->c6[output] *= varianceRatio * varianceRatio;
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::setVarianceRatiosFrom(double xVariance, const double* yVariance) {
+    for (size_t k = 0; k < this->c1.size(); ++k) {
+        if (!this->hasVarianceRatio[k]) {
+            this->setVarianceRatio(k, std::sqrt(xVariance) / std::sqrt(yVariance[k]));
+        }
+    }
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::setVarianceRatiosFromPrecision(double xPrecision, const double* yPrecision) {
+    for (size_t k = 0; k < this->c1.size(); ++k) {
+        if (!this->hasVarianceRatio[k]) {
+            this->setVarianceRatio(k, std::sqrt(yPrecision[k]) / std::sqrt(xPrecision));
+        }
+    }
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::update(double x, double xVariance, const double* y, const double* yVariance) {
+    if (this->outputsWithoutRatio > 0) {
+        this->setVarianceRatiosFrom(xVariance, yVariance);
+    }
+
+    double xPrecision = 1 / xVariance;
+    this->c4 = this->forgettingFactor * this->c4 + x * x * xPrecision;
+
+    MultiOutputUpdateKernel kernel = CPU_DISPATCH_SELECT(multi_output_update_variance);
+    kernel(
+        this->forgettingFactor, x, xPrecision, y, yVariance,
+        this->varianceRatio.data(), this->inverseVarianceRatioSquared.data(),
+        this->c1.data(), this->c2.data(), this->c3.data(), this->c5.data(), this->c6.data(), this->c1.size()
+    );
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::updatePrecision(double x, double xPrecision, const double* y, const double* yPrecision) {
+    if (this->outputsWithoutRatio > 0) {
+        this->setVarianceRatiosFromPrecision(xPrecision, yPrecision);
+    }
+
+    this->c4 = this->forgettingFactor * this->c4 + x * x * xPrecision;
+
+    MultiOutputUpdateKernel kernel = CPU_DISPATCH_SELECT(multi_output_update_precision);
+    kernel(
+        this->forgettingFactor, x, xPrecision, y, yPrecision,
+        this->varianceRatio.data(), this->inverseVarianceRatioSquared.data(),
+        this->c1.data(), this->c2.data(), this->c3.data(), this->c5.data(), this->c6.data(), this->c1.size()
+    );
+}
+
+
+EstimatorStatus MultiOutputDualVarianceWeightedTotalLeastSquares::solveUncorrected(size_t output, double& estimate) {
+    return dual_wtls_estimate(
+        this->c1[output], this->c2[output], this->c3[output], this->c4, this->c5[output], this->c6[output], estimate
+    );
+}
+
+
+double MultiOutputDualVarianceWeightedTotalLeastSquares::getEstimate(size_t output) {
+    double estimate;
+    if (this->solveUncorrected(output, estimate) != EstimatorStatus::Ok) {
+        throw std::domain_error("All roots are complex.");
+    }
+    this->lastEstimate[output] = estimate / this->varianceRatio[output];
+    return this->lastEstimate[output];
+}
+
+
+double MultiOutputDualVarianceWeightedTotalLeastSquares::getVariance(size_t output) {
+    double estimate;
+    if (this->solveUncorrected(output, estimate) != EstimatorStatus::Ok) {
+        throw std::domain_error("All roots are complex.");
+    }
+    return this->varianceRatio[output] * this->varianceRatio[output] * dual_wtls_variance(
+        this->c1[output], this->c2[output], this->c3[output], this->c4, this->c5[output], this->c6[output], estimate
+    );
+}
+
+
+EstimatorResult MultiOutputDualVarianceWeightedTotalLeastSquares::tryGetEstimate(size_t output) {
+    double estimate;
+    EstimatorStatus status = this->solveUncorrected(output, estimate);
+    if (status != EstimatorStatus::Ok) {
+        return {this->lastEstimate[output], status};
+    }
+
+    estimate /= this->varianceRatio[output];
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate[output], EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate[output] = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult MultiOutputDualVarianceWeightedTotalLeastSquares::tryGetVariance(size_t output) {
+    double estimate;
+    EstimatorStatus status = this->solveUncorrected(output, estimate);
+    if (status != EstimatorStatus::Ok) {
+        return {this->lastVariance[output], status};
+    }
+
+    double variance = this->varianceRatio[output] * this->varianceRatio[output] * dual_wtls_variance(
+        this->c1[output], this->c2[output], this->c3[output], this->c4, this->c5[output], this->c6[output], estimate
+    );
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance[output], EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance[output], EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance[output] = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+void MultiOutputDualVarianceWeightedTotalLeastSquares::getEstimates(double* estimates, double* variances, EstimatorStatus* statuses) {
+    size_t count = this->c1.size();
+    this->sharedC4.assign(count, this->c4);
+    this->uncorrectedEstimates.resize(count);
+    this->uncorrectedVariances.resize(count);
+    this->solveStatuses.resize(count);
+
+    dual_wtls_estimate_batch(
+        this->c1.data(), this->c2.data(), this->c3.data(), this->sharedC4.data(), this->c5.data(), this->c6.data(),
+        count, this->uncorrectedEstimates.data(), variances == nullptr ? nullptr : this->uncorrectedVariances.data(),
+        this->solveStatuses.data()
+    );
+
+    for (size_t k = 0; k < count; ++k) {
+        EstimatorStatus status = this->solveStatuses[k];
+        double estimate = this->uncorrectedEstimates[k] / this->varianceRatio[k];
+        if (status == EstimatorStatus::Ok && !std::isfinite(estimate)) {
+            status = EstimatorStatus::NotFinite;
+        }
+        if (status == EstimatorStatus::Ok) {
+            this->lastEstimate[k] = estimate;
+        }
+        estimates[k] = this->lastEstimate[k];
+
+        if (variances != nullptr) {
+            EstimatorStatus varianceStatus = this->solveStatuses[k];
+            double variance = this->varianceRatio[k] * this->varianceRatio[k] * this->uncorrectedVariances[k];
+            if (varianceStatus == EstimatorStatus::Ok && !std::isfinite(variance)) {
+                varianceStatus = EstimatorStatus::NotFinite;
+            } else if (varianceStatus == EstimatorStatus::Ok && variance <= 0) {
+                varianceStatus = EstimatorStatus::NonPositiveVariance;
+            }
+            if (varianceStatus == EstimatorStatus::Ok) {
+                this->lastVariance[k] = variance;
+            }
+            variances[k] = this->lastVariance[k];
+            if (status == EstimatorStatus::Ok) {
+                status = varianceStatus;
+            }
+        }
+
+        if (statuses != nullptr) {
+            statuses[k] = status;
+        }
+    }
+}
+
+
+size_t MultiOutputDualVarianceWeightedTotalLeastSquares::outputs() const {
+    return this->c1.size();
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "EstimatorStatus.h"
+#include "helper/wtls.h"
+
+/**
+ * Many DualVarianceWeightedTotalLeastSquares estimates Y_k = W_k X sharing one input stream X,
+ * e.g. one current measurement driving the voltages of every cell in a pack.
+ * 
+ * Each output gives the same result as its own DualVarianceWeightedTotalLeastSquares fed (x, y_k, xVariance, yVariance_k),
+ * but the x only statistic (c4) and the x weighting are computed once per update rather than once per output,
+ * and the per output statistics are stored as arrays so updates and estimates vectorise across outputs.
+ */
+class MultiOutputDualVarianceWeightedTotalLeastSquares {
+    public:
+        /**
+         * @brief Constructor for MultiOutputDualVarianceWeightedTotalLeastSquares
+         * 
+         * @param outputs number of outputs Y_k
+         * @param nominalValue Initial estimate of every weight
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         * @param initialXVariance Variance of a hypothetical (imaginary) measurement of x when x = 1 and y = nominalValue.
+         * @param initialYVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         * @param varianceRatio Ratio of x to y standard deviation for every output, -1 takes each output's ratio from its first measurement.
+         */
+        MultiOutputDualVarianceWeightedTotalLeastSquares(
+            size_t outputs, double nominalValue=0, double forgettingFactor=1,
+            double initialXVariance=100, double initialYVariance=100,
+            double varianceRatio=-1
+        );
+
+        /**
+         * @brief Update every output with a new measurement
+         * 
+         * @param x measurement of the shared input
+         * @param xVariance Variance (uncertainty) of the x measurement (must be more than 0)
+         * @param y one measurement per output
+         * @param yVariance Variance (uncertainty) of each y measurement (must be more than 0)
+         */
+        void update(double x, double xVariance, const double* y, const double* yVariance);
+
+        /**
+         * @brief Update every output with a new measurement weighted by precision (1 / variance), avoiding every division
+         * 
+         * @param x measurement of the shared input
+         * @param xPrecision Precision (1 / variance) of the x measurement (must be more than 0)
+         * @param y one measurement per output
+         * @param yPrecision Precision (1 / variance) of each y measurement (must be more than 0)
+         */
+        void updatePrecision(double x, double xPrecision, const double* y, const double* yPrecision);
+
+        /**
+         * @brief Get the current estimate of an output
+         * 
+         * @return Current estimate
+         */
+        double getEstimate(size_t output);
+
+        /**
+         * @brief Get the current variance of an output's weight estimate
+         * 
+         * @return Estimated variance of the weight
+         */
+        double getVariance(size_t output);
+
+        /**
+         * @brief Get the current estimate of an output without throwing
+         * 
+         * @return The estimate, or the last good estimate and the reason no estimate could be found
+         */
+        EstimatorResult tryGetEstimate(size_t output);
+
+        /**
+         * @brief Get the current variance of an output's weight estimate without throwing
+         * 
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason no variance could be found
+         */
+        EstimatorResult tryGetVariance(size_t output);
+
+        /**
+         * @brief Estimate every output at once, with the same results as tryGetEstimate and tryGetVariance
+         * 
+         * @param estimates caller provided storage for one estimate per output
+         * @param variances caller provided storage for one variance per output, may be null to skip them
+         * @param statuses caller provided storage for one status per output, may be null.
+         *                 The estimate's status, or the variance's when the estimate is Ok and variances are requested.
+         */
+        void getEstimates(double* estimates, double* variances, EstimatorStatus* statuses);
+
+        /**
+         * @brief Number of outputs
+         */
+        size_t outputs() const;
+
+    private:
+        double forgettingFactor;
+        double c4; // x only, shared by every output
+        std::vector<double> c1;
+        std::vector<double> c2;
+        std::vector<double> c3;
+        std::vector<double> c5;
+        std::vector<double> c6;
+        std::vector<double> varianceRatio;
+        std::vector<double> inverseVarianceRatioSquared;
+        std::vector<char> hasVarianceRatio;
+        size_t outputsWithoutRatio;
+        std::vector<double> lastEstimate;
+        std::vector<double> lastVariance;
+
+        // Scratch space for getEstimates.
+        std::vector<double> sharedC4;
+        std::vector<double> uncorrectedEstimates;
+        std::vector<double> uncorrectedVariances;
+        std::vector<EstimatorStatus> solveStatuses;
+
+        void setVarianceRatiosFrom(double xVariance, const double* yVariance);
+
+        void setVarianceRatiosFromPrecision(double xPrecision, const double* yPrecision);
+
+        void setVarianceRatio(size_t output, double varianceRatio);
+
+        EstimatorStatus solveUncorrected(size_t output, double& estimate);
+};
@@ -0,0 +1,31 @@
+#include "ParallelAccumulate.h"
+
+
+VarianceWeightedTotalLeastSquares parallelAccumulate(
+    const VarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* yVariance, size_t count,
+    WorkStealingPool& pool, size_t blockSize
+) {
+    return parallelAccumulate(initial, count, blockSize, pool,
+        [=](VarianceWeightedTotalLeastSquares& partial, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                partial.update(x[i], y[i], yVariance[i]);
+            }
+        }
+    );
+}
+
+
+DualVarianceWeightedTotalLeastSquares parallelAccumulate(
+    const DualVarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count,
+    WorkStealingPool& pool, size_t blockSize
+) {
+    return parallelAccumulate(initial, count, blockSize, pool,
+        [=](DualVarianceWeightedTotalLeastSquares& partial, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                partial.update(x[i], y[i], xVariance[i], yVariance[i]);
+            }
+        }
+    );
+}
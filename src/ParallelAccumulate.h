@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include "helper/WorkStealingPool.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+
+/**
+ * @brief Accumulate one long stream into an estimator using every thread of a pool
+ * 
+ * The stream is cut into fixed size blocks, each block is accumulated into its own partial() estimator,
+ * and the partials are merged pairwise in a fixed binary tree over block order before being merged into initial.
+ * The floating point operations only depend on count and blockSize, so the result is identical for any number of threads.
+ * 
+ * @param initial estimator the stream is added to
+ * @param count number of measurements in the stream
+ * @param blockSize number of measurements per block (must be more than 0)
+ * @param apply called as apply(partial, begin, end) to update partial with measurements [begin, end) in order, one update each
+ * @return initial updated with the whole stream
+ */
+template <typename Estimator, typename Apply>
+Estimator parallelAccumulate(const Estimator& initial, size_t count, size_t blockSize, WorkStealingPool& pool, Apply apply) {
+    if (blockSize == 0) {
+        throw std::invalid_argument( "Block Size must grater then 0 got " + std::to_string(blockSize) );
+    }
+
+    Estimator result = initial;
+    if (count == 0) {
+        return result;
+    }
+
+    size_t blocks = (count + blockSize - 1) / blockSize;
+    std::vector<Estimator> partials(blocks, initial.partial());
+
+    pool.parallelFor(blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block) {
+            size_t first = block * blockSize;
+            apply(partials[block], first, std::min(count, first + blockSize));
+        }
+    });
+
+    for (size_t stride = 1; stride < blocks; stride *= 2) {
+        size_t pairs = (blocks + 2 * stride - 1) / (2 * stride);
+        pool.parallelFor(pairs, 1, [&](size_t begin, size_t end) {
+            for (size_t pair = begin; pair < end; ++pair) {
+                size_t left = pair * 2 * stride;
+                size_t right = left + stride;
+                if (right < blocks) {
+                    // The right partial covers blocks right to right + stride, every one of its measurements is a step.
+                    size_t steps = std::min(count, (right + stride) * blockSize) - right * blockSize;
+                    partials[left].merge(partials[right], static_cast<double>(steps));
+                }
+            }
+        });
+    }
+
+    result.merge(partials[0], static_cast<double>(count));
+    return result;
+}
+
+
+/**
+ * @brief Accumulate measurement arrays into an estimator using every thread of a pool, see the generic parallelAccumulate
+ */
+VarianceWeightedTotalLeastSquares parallelAccumulate(
+    const VarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* yVariance, size_t count,
+    WorkStealingPool& pool, size_t blockSize=1 << 16
+);
+
+/**
+ * @brief Accumulate measurement arrays into an estimator using every thread of a pool, see the generic parallelAccumulate
+ */
+DualVarianceWeightedTotalLeastSquares parallelAccumulate(
+    const DualVarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count,
+    WorkStealingPool& pool, size_t blockSize=1 << 16
+);
@@ -0,0 +1,31 @@
+#include "ParallelTrajectory.h"
+
+
+VarianceWeightedTotalLeastSquares parallelTrajectory(
+    const VarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* yVariance, size_t count,
+    EstimatorResult* estimates, EstimatorResult* variances,
+    WorkStealingPool& pool, size_t blockSize
+) {
+    return parallelTrajectory(initial, count, blockSize, pool,
+        [=](VarianceWeightedTotalLeastSquares& estimator, size_t i) {
+            estimator.update(x[i], y[i], yVariance[i]);
+        },
+        estimates, variances
+    );
+}
+
+
+DualVarianceWeightedTotalLeastSquares parallelTrajectory(
+    const DualVarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count,
+    EstimatorResult* estimates, EstimatorResult* variances,
+    WorkStealingPool& pool, size_t blockSize
+) {
+    return parallelTrajectory(initial, count, blockSize, pool,
+        [=](DualVarianceWeightedTotalLeastSquares& estimator, size_t i) {
+            estimator.update(x[i], y[i], xVariance[i], yVariance[i]);
+        },
+        estimates, variances
+    );
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include "EstimatorStatus.h"
+#include "helper/WorkStealingPool.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+
+/**
+ * @brief Get the estimate and variance after every measurement of one long stream using every thread of a pool
+ * 
+ * The statistics follow the linear recurrence c_t = forgettingFactor * c_{t-1} + g_t, so the state before any
+ * measurement can be found with a blocked scan instead of a serial replay:
+ * the stream is cut into fixed size blocks and each block is accumulated into its own partial() estimator in parallel,
+ * the partials are merged in block order to give the state at the start of every block,
+ * and then every block is replayed from its start state in parallel, solving for the estimate and variance after each measurement.
+ * Solving dominates, so the trajectory costs about as much as parallelAccumulate plus count / threads solves.
+ * 
+ * The floating point operations only depend on count and blockSize, so the result is identical for any number of threads.
+ * It matches a serial replay to rounding, except that a step that fails reports the last good value from its own block
+ * (or from before the stream if its block has none yet).
+ * 
+ * @param initial estimator the stream is added to
+ * @param count number of measurements in the stream
+ * @param blockSize number of measurements per block (must be more than 0)
+ * @param apply called as apply(estimator, i) to update estimator with measurement i, in one update
+ * @param estimates caller provided storage for count estimates, entry i is the estimate after measurement i
+ * @param variances caller provided storage for count variances, may be null to skip them
+ * @return initial updated with the whole stream
+ */
+template <typename Estimator, typename Apply>
+Estimator parallelTrajectory(
+    const Estimator& initial, size_t count, size_t blockSize, WorkStealingPool& pool, Apply apply,
+    EstimatorResult* estimates, EstimatorResult* variances
+) {
+    if (blockSize == 0) {
+        throw std::invalid_argument( "Block Size must grater then 0 got " + std::to_string(blockSize) );
+    }
+
+    Estimator result = initial;
+    if (count == 0) {
+        return result;
+    }
+
+    size_t blocks = (count + blockSize - 1) / blockSize;
+    std::vector<Estimator> partials(blocks, initial.partial());
+
+    pool.parallelFor(blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block) {
+            size_t last = std::min(count, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < last; ++i) {
+                apply(partials[block], i);
+            }
+        }
+    });
+
+    // There are few blocks, so the scan over them is serial.
+    std::vector<Estimator> starts;
+    starts.reserve(blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        starts.push_back(result);
+        size_t first = block * blockSize;
+        result.merge(partials[block], static_cast<double>(std::min(count, first + blockSize) - first));
+    }
+
+    pool.parallelFor(blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block) {
+            Estimator estimator = starts[block];
+            size_t last = std::min(count, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < last; ++i) {
+                apply(estimator, i);
+                if (variances != nullptr) {
+                    estimator.tryGetEstimateAndVariance(estimates[i], variances[i]);
+                } else {
+                    estimates[i] = estimator.tryGetEstimate();
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+
+/**
+ * @brief Estimate trajectory of measurement arrays using every thread of a pool, see the generic parallelTrajectory
+ */
+VarianceWeightedTotalLeastSquares parallelTrajectory(
+    const VarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* yVariance, size_t count,
+    EstimatorResult* estimates, EstimatorResult* variances,
+    WorkStealingPool& pool, size_t blockSize=1 << 14
+);
+
+/**
+ * @brief Estimate trajectory of measurement arrays using every thread of a pool, see the generic parallelTrajectory
+ */
+DualVarianceWeightedTotalLeastSquares parallelTrajectory(
+    const DualVarianceWeightedTotalLeastSquares& initial,
+    const double* x, const double* y, const double* xVariance, const double* yVariance, size_t count,
+    EstimatorResult* estimates, EstimatorResult* variances,
+    WorkStealingPool& pool, size_t blockSize=1 << 14
+);
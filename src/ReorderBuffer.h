@@ -0,0 +1,257 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TimestampedEstimator.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+
+/**
+ * @brief One time stamped measurement addressed to one estimator of a fleet.
+ */
+struct TimestampedRecord {
+    size_t estimatorId;
+    double timestamp;
+    double x;
+    double y;
+    double xVariance; // ignored by VarianceWeightedTotalLeastSquares
+    double yVariance;
+};
+
+// A plain estimator forgets by release order, which is time stamp order for everything within the window.
+// A measurement too late for the window is applied when it arrives, as update always has.
+inline void applyTimestampedRecord(VarianceWeightedTotalLeastSquares& estimator, const TimestampedRecord& record) {
+    estimator.update(record.x, record.y, record.yVariance);
+}
+
+inline void applyTimestampedRecord(DualVarianceWeightedTotalLeastSquares& estimator, const TimestampedRecord& record) {
+    estimator.update(record.x, record.y, record.xVariance, record.yVariance);
+}
+
+// A TimestampedEstimator forgets by the time stamps, and a measurement too late for the window is still
+// added exactly, weighted by the forgetting it would have had if it arrived in order.
+inline void applyTimestampedRecord(TimestampedEstimator<VarianceWeightedTotalLeastSquares>& estimator, const TimestampedRecord& record) {
+    estimator.updateAt(record.timestamp, record.x, record.y, record.yVariance);
+}
+
+inline void applyTimestampedRecord(TimestampedEstimator<DualVarianceWeightedTotalLeastSquares>& estimator, const TimestampedRecord& record) {
+    estimator.updateAt(record.timestamp, record.x, record.y, record.xVariance, record.yVariance);
+}
+
+
+/**
+ * Holds back measurements for a fleet of estimators for a lateness window and releases them in time stamp order.
+ *
+ * A measurement is released once a measurement at least window newer has been pushed (or advance is called
+ * with a time at least window after it), so anything that arrives less than window late is put back in order.
+ * Measurements with equal time stamps are released in the order they were pushed.
+ *
+ * Pending measurements live in a binary heap allocated once at construction. When it is full the oldest
+ * measurement, pending or incoming, is released early to make room, so push never allocates.
+ *
+ * Not thread safe. Estimator must be usable with an applyTimestampedRecord overload, which decides whether forgetting
+ * follows the time stamps (TimestampedEstimator) or the release order (a plain estimator).
+ */
+template <typename Estimator>
+class ReorderBuffer {
+    public:
+        /**
+         * @brief Constructor for ReorderBuffer
+         *
+         * @param estimators The fleet measurements are released into, must outlive the buffer
+         * @param count Number of estimators in the fleet
+         * @param window How late a measurement may arrive and still be put in order (must not be negative)
+         * @param capacity Maximum number of pending measurements (must be more than 0)
+         */
+        ReorderBuffer(Estimator* estimators, size_t count, double window, size_t capacity);
+
+        /**
+         * @brief Add a measurement, releasing everything that is now more than window older than the newest
+         *
+         * @return Number of measurements released into the estimators
+         */
+        size_t push(const TimestampedRecord& record);
+
+        /**
+         * @brief Release every pending measurement at least window older than now, e.g. when the stream goes quiet
+         *
+         * @return Number of measurements released
+         */
+        size_t advance(double now);
+
+        /**
+         * @brief Release every pending measurement
+         *
+         * @return Number of measurements released
+         */
+        size_t flush();
+
+        /**
+         * @brief Number of measurements waiting to be released
+         */
+        size_t pending() const;
+
+        /**
+         * @brief Number of measurements released so far
+         */
+        uint64_t released() const;
+
+        /**
+         * @brief Number of measurements that arrived older than a measurement already released
+         */
+        uint64_t late() const;
+
+        /**
+         * @brief Number of measurements released before their window was up because the buffer was full
+         */
+        uint64_t overflowed() const;
+
+    private:
+        struct Pending {
+            TimestampedRecord record;
+            uint64_t sequence; // push order, breaks ties between equal time stamps
+        };
+
+        // std heap functions build a max heap, so "less" means released later.
+        struct ReleasedLater {
+            bool operator()(const Pending& a, const Pending& b) const {
+                if (a.record.timestamp != b.record.timestamp) {
+                    return a.record.timestamp > b.record.timestamp;
+                }
+                return a.sequence > b.sequence;
+            }
+        };
+
+        Estimator* estimators;
+        size_t count;
+        double window;
+        size_t capacity;
+
+        std::vector<Pending> heap;
+        uint64_t sequence;
+        double newest; // newest time stamp pushed
+        double watermark; // newest time stamp released
+        uint64_t releasedCount;
+        uint64_t lateCount;
+        uint64_t overflowCount;
+
+        void apply(const TimestampedRecord& record);
+        void releaseOldest();
+        size_t releaseUntil(double cutoff);
+};
+
+
+template <typename Estimator>
+ReorderBuffer<Estimator>::ReorderBuffer(Estimator* estimators, size_t count, double window, size_t capacity)
+    : estimators(estimators), count(count), window(window), capacity(capacity),
+      sequence(0), newest(-INFINITY), watermark(-INFINITY), releasedCount(0), lateCount(0), overflowCount(0) {
+    if (!(window >= 0)) {
+        throw std::invalid_argument( "Window must not be negative got " + std::to_string(window) );
+    }
+    if (capacity == 0) {
+        throw std::invalid_argument( "Capacity must grater then 0 got " + std::to_string(capacity) );
+    }
+    this->heap.reserve(capacity);
+}
+
+
+template <typename Estimator>
+void ReorderBuffer<Estimator>::apply(const TimestampedRecord& record) {
+    applyTimestampedRecord(this->estimators[record.estimatorId], record);
+    ++this->releasedCount;
+}
+
+
+template <typename Estimator>
+void ReorderBuffer<Estimator>::releaseOldest() {
+    std::pop_heap(this->heap.begin(), this->heap.end(), ReleasedLater());
+    const TimestampedRecord& record = this->heap.back().record;
+    this->watermark = std::max(this->watermark, record.timestamp);
+    this->apply(record);
+    this->heap.pop_back();
+}
+
+
+template <typename Estimator>
+size_t ReorderBuffer<Estimator>::releaseUntil(double cutoff) {
+    size_t released = 0;
+    while (!this->heap.empty() && this->heap.front().record.timestamp <= cutoff) {
+        this->releaseOldest();
+        ++released;
+    }
+    return released;
+}
+
+
+template <typename Estimator>
+size_t ReorderBuffer<Estimator>::push(const TimestampedRecord& record) {
+    if (record.estimatorId >= this->count) {
+        throw std::out_of_range( "Estimator " + std::to_string(record.estimatorId) + " is outside the fleet" );
+    }
+
+    if (record.timestamp < this->watermark) {
+        // Too late to put in order; a TimestampedEstimator still weights it exactly.
+        ++this->lateCount;
+        this->apply(record);
+        return 1;
+    }
+
+    size_t released = 0;
+    if (this->heap.size() == this->capacity) {
+        if (record.timestamp < this->heap.front().record.timestamp) {
+            // The incoming measurement is the oldest, so it is the one to release early.
+            this->watermark = std::max(this->watermark, record.timestamp);
+            this->apply(record);
+            ++this->overflowCount;
+            return 1;
+        }
+        this->releaseOldest();
+        ++this->overflowCount;
+        ++released;
+    }
+
+    this->heap.push_back({record, this->sequence++});
+    std::push_heap(this->heap.begin(), this->heap.end(), ReleasedLater());
+
+    this->newest = std::max(this->newest, record.timestamp);
+    return released + this->releaseUntil(this->newest - this->window);
+}
+
+
+template <typename Estimator>
+size_t ReorderBuffer<Estimator>::advance(double now) {
+    return this->releaseUntil(now - this->window);
+}
+
+
+template <typename Estimator>
+size_t ReorderBuffer<Estimator>::flush() {
+    return this->releaseUntil(INFINITY);
+}
+
+
+template <typename Estimator>
+size_t ReorderBuffer<Estimator>::pending() const {
+    return this->heap.size();
+}
+
+
+template <typename Estimator>
+uint64_t ReorderBuffer<Estimator>::released() const {
+    return this->releasedCount;
+}
+
+
+template <typename Estimator>
+uint64_t ReorderBuffer<Estimator>::late() const {
+    return this->lateCount;
+}
+
+
+template <typename Estimator>
+uint64_t ReorderBuffer<Estimator>::overflowed() const {
+    return this->overflowCount;
+}
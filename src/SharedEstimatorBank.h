@@ -0,0 +1,356 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <thread>
+#include "EstimatorStatus.h"
+#include "VarianceWeightedTotalLeastSquares.h"
+#include "DualVarianceWeightedTotalLeastSquares.h"
+#include "helper/SharedMemoryRegion.h"
+
+
+/**
+ * @brief Identifies the estimator type stored in a shared bank so a reader can't map it as the wrong type
+ *
+ * revision names the estimator's field layout and must be bumped whenever a field is added, removed or moved,
+ * so a reader built against a different layout rejects the bank instead of misreading it. The size checks
+ * catch most such changes at compile time.
+ */
+template <typename Estimator>
+struct SharedEstimatorKind;
+
+template <>
+struct SharedEstimatorKind<VarianceWeightedTotalLeastSquares> {
+    static constexpr uint32_t value = 1;
+    // forgettingFactor, varianceRatioSquared, c1, c2, c3, lastEstimate, lastVariance
+    static constexpr uint32_t revision = 1;
+    static_assert(sizeof(VarianceWeightedTotalLeastSquares) == 7 * sizeof(double), "Layout changed, bump revision");
+};
+
+template <>
+struct SharedEstimatorKind<DualVarianceWeightedTotalLeastSquares> {
+    static constexpr uint32_t value = 2;
+    // forgettingFactor, c1..c6, varianceRatio, hasVarianceRatio, quarticMethod, inverseVarianceRatioSquared,
+    // lastEstimate, lastVariance
+    static constexpr uint32_t revision = 1;
+    static_assert(sizeof(DualVarianceWeightedTotalLeastSquares) == 12 * sizeof(double), "Layout changed, bump revision");
+};
+
+
+/**
+ * A bank of estimators that lives in a named POSIX shared memory segment.
+ *
+ * One process creates the bank and updates it, any number of other processes open it by name and read it
+ * without copying through a socket or pipe. Each slot is guarded by a sequence lock: the writer never waits
+ * for readers, and a reader retries if the slot changed while it was being copied, so a reader always sees
+ * a state that existed between two updates.
+ *
+ * The writer publishes each slot's estimate and variance with publish, so readers don't need to solve the
+ * estimate themselves; they can also copy the whole estimator out of a slot and compute locally.
+ *
+ * Only one thread (in one process) may write. Readers are wait free with respect to each other.
+ */
+template <typename Estimator>
+class SharedEstimatorBank {
+    public:
+        /**
+         * @brief Create a bank, replacing any segment already using the name (writer)
+         *
+         * @param name POSIX shared memory name, e.g. "/cell-capacity"
+         * @param count Number of slots in the bank
+         * @param prototype Estimator every slot starts as
+         */
+        SharedEstimatorBank(const std::string& name, size_t count, const Estimator& prototype = Estimator());
+
+        /**
+         * @brief Open an existing bank read only (reader)
+         *
+         * @param name POSIX shared memory name the writer created the bank with
+         */
+        explicit SharedEstimatorBank(const std::string& name);
+
+        SharedEstimatorBank(const SharedEstimatorBank&) = delete;
+        SharedEstimatorBank& operator=(const SharedEstimatorBank&) = delete;
+
+        /**
+         * @brief Update a slot with a new measurement (writer only)
+         *
+         * @param slot index of the slot to update
+         * @param measurement arguments forwarded to Estimator::update
+         */
+        template <typename... Args>
+        void update(size_t slot, Args... measurement);
+
+        /**
+         * @brief Compute and publish the estimate and variance of a slot for readers (writer only)
+         */
+        void publish(size_t slot);
+
+        /**
+         * @brief Compute and publish the estimate and variance of every slot (writer only)
+         */
+        void publishAll();
+
+        /**
+         * @brief Copy a consistent snapshot of a slot
+         *
+         * @param slot index of the slot to read
+         * @param state set to a copy of the slot's estimator
+         * @param estimate if not null, set to the published estimate
+         * @param variance if not null, set to the published variance
+         */
+        void read(size_t slot, Estimator& state, EstimatorResult* estimate=nullptr, EstimatorResult* variance=nullptr) const;
+
+        /**
+         * @brief Get the last published estimate of a slot
+         */
+        EstimatorResult readEstimate(size_t slot) const;
+
+        /**
+         * @brief Get the last published variance of a slot
+         */
+        EstimatorResult readVariance(size_t slot) const;
+
+        /**
+         * @brief Number of slots in the bank
+         */
+        size_t size() const;
+
+        /**
+         * @brief Whether this process created the bank and may update it
+         */
+        bool writable() const;
+
+    private:
+        static_assert(std::is_trivially_copyable<Estimator>::value, "Estimator must be trivially copyable to live in shared memory");
+        static_assert(ATOMIC_INT_LOCK_FREE == 2, "Shared sequence counters must be lock free");
+
+        static constexpr uint64_t magic = 0x4b4e41424d485352ull; // "RSHMBANK"
+        static constexpr uint32_t layoutVersion = 2;
+        static constexpr size_t cacheLine = 64;
+
+        struct Header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t kind;
+            uint32_t revision; // SharedEstimatorKind<Estimator>::revision
+            uint32_t reserved;
+            uint64_t estimatorSize;
+            uint64_t slotStride;
+            uint64_t count;
+            char padding[cacheLine - 48];
+        };
+
+        // Every slot starts on its own cache line so the writer of one slot never invalidates a reader of another.
+        struct Slot {
+            std::atomic<uint32_t> sequence; // odd while the writer is changing the slot
+            EstimatorResult estimate;
+            EstimatorResult variance;
+            Estimator estimator;
+        };
+
+        static constexpr size_t slotStride = (sizeof(Slot) + cacheLine - 1) / cacheLine * cacheLine;
+
+        std::unique_ptr<SharedMemoryRegion> region;
+        Header* header;
+        char* slots;
+        size_t slotCount;
+
+        Slot* slotAt(size_t slot) const;
+        void checkWritable() const;
+        void beginWrite(Slot* entry);
+        void endWrite(Slot* entry);
+};
+
+
+template <typename Estimator>
+SharedEstimatorBank<Estimator>::SharedEstimatorBank(const std::string& name, size_t count, const Estimator& prototype)
+    : region(new SharedMemoryRegion(name, sizeof(Header) + count * slotStride)), slotCount(count) {
+    if (count == 0) {
+        throw std::invalid_argument( "Count must grater then 0 got " + std::to_string(count) );
+    }
+
+    this->header = static_cast<Header*>(this->region->data());
+    this->slots = static_cast<char*>(this->region->data()) + sizeof(Header);
+
+    for (size_t i = 0; i < count; ++i) {
+        Slot* entry = new (this->slots + i * slotStride) Slot;
+        entry->sequence.store(0, std::memory_order_relaxed);
+        entry->estimate = {0, EstimatorStatus::Ok};
+        entry->variance = {0, EstimatorStatus::Ok};
+        std::memcpy(&entry->estimator, &prototype, sizeof(Estimator));
+        this->publish(i);
+    }
+
+    this->header->version = layoutVersion;
+    this->header->kind = SharedEstimatorKind<Estimator>::value;
+    this->header->revision = SharedEstimatorKind<Estimator>::revision;
+    this->header->reserved = 0;
+    this->header->estimatorSize = sizeof(Estimator);
+    this->header->slotStride = slotStride;
+    this->header->count = count;
+    // The magic is written last so a reader that opens a half built segment rejects it.
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = magic;
+}
+
+
+template <typename Estimator>
+SharedEstimatorBank<Estimator>::SharedEstimatorBank(const std::string& name)
+    : region(new SharedMemoryRegion(name)) {
+    if (this->region->size() < sizeof(Header)) {
+        throw std::invalid_argument( "Shared memory " + name + " is too small to be an estimator bank" );
+    }
+
+    this->header = static_cast<Header*>(this->region->data());
+    this->slots = static_cast<char*>(this->region->data()) + sizeof(Header);
+
+    if (this->header->magic != magic || this->header->version != layoutVersion) {
+        throw std::invalid_argument( "Shared memory " + name + " is not an estimator bank" );
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (this->header->kind != SharedEstimatorKind<Estimator>::value
+        || this->header->revision != SharedEstimatorKind<Estimator>::revision
+        || this->header->estimatorSize != sizeof(Estimator)
+        || this->header->slotStride != slotStride) {
+        throw std::invalid_argument( "Shared memory " + name + " holds a different estimator type or layout" );
+    }
+    // Divide rather than multiply, a corrupt count could overflow count * slotStride.
+    if (this->header->count > (this->region->size() - sizeof(Header)) / slotStride) {
+        throw std::invalid_argument( "Shared memory " + name + " is smaller than its header says" );
+    }
+    this->slotCount = this->header->count;
+}
+
+
+template <typename Estimator>
+typename SharedEstimatorBank<Estimator>::Slot* SharedEstimatorBank<Estimator>::slotAt(size_t slot) const {
+    return reinterpret_cast<Slot*>(this->slots + slot * slotStride);
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::checkWritable() const {
+    if (!this->region->writable()) {
+        throw std::logic_error( "Shared estimator bank " + this->region->name() + " is mapped read only" );
+    }
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::beginWrite(Slot* entry) {
+    uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+    entry->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::endWrite(Slot* entry) {
+    uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+    entry->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+
+template <typename Estimator>
+template <typename... Args>
+void SharedEstimatorBank<Estimator>::update(size_t slot, Args... measurement) {
+    this->checkWritable();
+    Slot* entry = this->slotAt(slot);
+    this->beginWrite(entry);
+    entry->estimator.update(measurement...);
+    this->endWrite(entry);
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::publish(size_t slot) {
+    this->checkWritable();
+    Slot* entry = this->slotAt(slot);
+
+    // Solve outside the write section so readers are only held off for the copy.
+    Estimator estimator = entry->estimator;
+    EstimatorResult estimate = estimator.tryGetEstimate();
+    EstimatorResult variance = estimator.tryGetVariance();
+
+    this->beginWrite(entry);
+    entry->estimator = estimator; // keeps the last good estimate and variance the solve remembered
+    entry->estimate = estimate;
+    entry->variance = variance;
+    this->endWrite(entry);
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::publishAll() {
+    for (size_t i = 0; i < this->slotCount; ++i) {
+        this->publish(i);
+    }
+}
+
+
+template <typename Estimator>
+void SharedEstimatorBank<Estimator>::read(size_t slot, Estimator& state, EstimatorResult* estimate, EstimatorResult* variance) const {
+    const Slot* entry = this->slotAt(slot);
+    EstimatorResult publishedEstimate;
+    EstimatorResult publishedVariance;
+
+    while (true) {
+        uint32_t before = entry->sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::memcpy(&state, &entry->estimator, sizeof(Estimator));
+        std::memcpy(&publishedEstimate, &entry->estimate, sizeof(EstimatorResult));
+        std::memcpy(&publishedVariance, &entry->variance, sizeof(EstimatorResult));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry->sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+
+    if (estimate != nullptr) {
+        *estimate = publishedEstimate;
+    }
+    if (variance != nullptr) {
+        *variance = publishedVariance;
+    }
+}
+
+
+template <typename Estimator>
+EstimatorResult SharedEstimatorBank<Estimator>::readEstimate(size_t slot) const {
+    Estimator state;
+    EstimatorResult estimate;
+    this->read(slot, state, &estimate);
+    return estimate;
+}
+
+
+template <typename Estimator>
+EstimatorResult SharedEstimatorBank<Estimator>::readVariance(size_t slot) const {
+    Estimator state;
+    EstimatorResult variance;
+    this->read(slot, state, nullptr, &variance);
+    return variance;
+}
+
+
+template <typename Estimator>
+size_t SharedEstimatorBank<Estimator>::size() const {
+    return this->slotCount;
+}
+
+
+template <typename Estimator>
+bool SharedEstimatorBank<Estimator>::writable() const {
+    return this->region->writable();
+}
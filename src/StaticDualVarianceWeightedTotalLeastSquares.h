@@ -0,0 +1,182 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include "EstimatorPolicies.h"
+#include "EstimatorStatus.h"
+#include "helper/wtls.h"
+
+/**
+ * DualVarianceWeightedTotalLeastSquares with the forgetting factor and variance ratio supplied by compile time policies.
+ * 
+ * The variance ratio must be known up front (it is not taken from the first update), which lets the update fold the
+ * ratio into constants and skip the first update check. With NoForgetting the update drops its six multiplies.
+ * Constant policies take no space, so StaticDualVarianceWeightedTotalLeastSquares<> is just the six recursive statistics.
+ * It has no time stamped updates or merging, and the try* functions carry no last good value
+ * (value is NaN on failure) to keep the object small.
+ * 
+ * @tparam Forgetting NoForgetting, ConstantForgetting<N, D> or RuntimeForgetting
+ * @tparam VarianceRatio UnitVarianceRatio, ConstantVarianceRatio<N, D> or RuntimeVarianceRatio
+ */
+template <typename Forgetting=NoForgetting, typename VarianceRatio=UnitVarianceRatio>
+class StaticDualVarianceWeightedTotalLeastSquares : private Forgetting, private VarianceRatio {
+    public:
+        /**
+         * @brief Constructor for StaticDualVarianceWeightedTotalLeastSquares
+         * 
+         * @param nominalValue Initial estimate of the weight
+         * @param initialXVariance Variance of a hypothetical (imaginary) measurement of x when x = 1 and y = nominalValue.
+         * @param initialYVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         * @param forgetting Forgetting policy, only needed for RuntimeForgetting
+         * @param varianceRatio Variance ratio policy, only needed for RuntimeVarianceRatio
+         */
+        StaticDualVarianceWeightedTotalLeastSquares(
+            double nominalValue=0.0, double initialXVariance=100.0, double initialYVariance=100.0,
+            Forgetting forgetting=Forgetting(), VarianceRatio varianceRatio=VarianceRatio()
+        );
+
+        /**
+         * @brief Update with a new measurement
+         * 
+         * @param x measurement for first variable
+         * @param y measurement for second variable
+         * @param xVariance Variance (uncertainty) of the x measurement (must be more than 0)
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more than 0)
+         */
+        void update(double x, double y, double xVariance, double yVariance);
+
+        /**
+         * @brief Get the current variance of the weight estimate
+         */
+        double getVariance() const;
+
+        /**
+         * @brief Get the current estimate
+         */
+        double getEstimate() const;
+
+        /**
+         * @brief Get the current estimate without throwing, value is NaN when the status is not Ok
+         */
+        EstimatorResult tryGetEstimate() const;
+
+        /**
+         * @brief Get the current variance without throwing, value is NaN when the status is not Ok
+         */
+        EstimatorResult tryGetVariance() const;
+
+    private:
+        double c1;
+        double c2;
+        double c3;
+        double c4;
+        double c5;
+        double c6;
+
+        double getEstimateUncorrected() const;
+};
+
+
+template <typename Forgetting, typename VarianceRatio>
+StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::StaticDualVarianceWeightedTotalLeastSquares(
+    double nominalValue, double initialXVariance, double initialYVariance,
+    Forgetting forgetting, VarianceRatio varianceRatio
+) : Forgetting(forgetting), VarianceRatio(varianceRatio) {
+    if (initialXVariance <= 0) {
+        throw std::invalid_argument( "Initial X Variance must grater then 0 got " + std::to_string(initialXVariance) );
+    }
+
+    if (initialYVariance <= 0) {
+        throw std::invalid_argument( "Initial Y Variance must grater then 0 got " + std::to_string(initialYVariance) );
+    }
+
+    nominalValue = this->VarianceRatio::ratio() * nominalValue;
+
+    this->c1 = 1 / initialYVariance;
+    this->c2 = nominalValue / initialYVariance;
+    this->c3 = nominalValue * nominalValue / initialYVariance;
+
+    this->c4 = 1 / initialXVariance;
+    this->c5 = nominalValue / initialXVariance;
+    this->c6 = nominalValue * nominalValue / initialXVariance;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+inline void StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::update(double x, double y, double xVariance, double yVariance) {
+    // Multiplying by a constant 1.0 is exact, so the compiler removes it for NoForgetting and UnitVarianceRatio.
+    double forgettingFactor = this->Forgetting::factor();
+    double varianceRatio = this->VarianceRatio::ratio();
+
+    double correctedY = y * varianceRatio;
+    double yBottom = yVariance * (varianceRatio * varianceRatio);
+
+    this->c1 = forgettingFactor * this->c1 + x * x / yBottom;
+    this->c2 = forgettingFactor * this->c2 + x * correctedY / yBottom;
+    this->c3 = forgettingFactor * this->c3 + correctedY * correctedY / yBottom;
+
+    this->c4 = forgettingFactor * this->c4 + x * x / xVariance;
+    this->c5 = forgettingFactor * this->c5 + x * correctedY / xVariance;
+    this->c6 = forgettingFactor * this->c6 + correctedY * correctedY / xVariance;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+double StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::getEstimateUncorrected() const {
+    double estimate;
+    if (dual_wtls_estimate(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate) != EstimatorStatus::Ok) {
+        throw std::domain_error("All roots are complex.");
+    }
+    return estimate;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+double StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::getEstimate() const {
+    return this->getEstimateUncorrected() / this->VarianceRatio::ratio();
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+double StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::getVariance() const {
+    double varianceRatio = this->VarianceRatio::ratio();
+    return varianceRatio * varianceRatio * dual_wtls_variance(
+        this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, this->getEstimateUncorrected()
+    );
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+EstimatorResult StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::tryGetEstimate() const {
+    double estimate;
+    EstimatorStatus status = dual_wtls_estimate(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate);
+    if (status != EstimatorStatus::Ok) {
+        return {NAN, status};
+    }
+
+    estimate /= this->VarianceRatio::ratio();
+    if (!std::isfinite(estimate)) {
+        return {NAN, EstimatorStatus::NotFinite};
+    }
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+EstimatorResult StaticDualVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::tryGetVariance() const {
+    double estimate;
+    EstimatorStatus status = dual_wtls_estimate(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate);
+    if (status != EstimatorStatus::Ok) {
+        return {NAN, status};
+    }
+
+    double varianceRatio = this->VarianceRatio::ratio();
+    double variance = varianceRatio * varianceRatio * dual_wtls_variance(this->c1, this->c2, this->c3, this->c4, this->c5, this->c6, estimate);
+    if (!std::isfinite(variance)) {
+        return {NAN, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {NAN, EstimatorStatus::NonPositiveVariance};
+    }
+    return {variance, EstimatorStatus::Ok};
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include "EstimatorPolicies.h"
+#include "EstimatorStatus.h"
+#include "helper/wtls.h"
+
+/**
+ * VarianceWeightedTotalLeastSquares with the forgetting factor and variance ratio supplied by compile time policies.
+ * 
+ * With NoForgetting the update drops its three multiplies, and with a constant variance ratio the constants in
+ * getEstimate and getVariance are folded at compile time. Constant policies take no space, so
+ * StaticVarianceWeightedTotalLeastSquares<> is just the three recursive statistics.
+ * It has no time stamped updates or merging, and the try* functions carry no last good value
+ * (value is NaN on failure) to keep the object small.
+ * 
+ * @tparam Forgetting NoForgetting, ConstantForgetting<N, D> or RuntimeForgetting
+ * @tparam VarianceRatio UnitVarianceRatio, ConstantVarianceRatio<N, D> or RuntimeVarianceRatio
+ */
+template <typename Forgetting=NoForgetting, typename VarianceRatio=UnitVarianceRatio>
+class StaticVarianceWeightedTotalLeastSquares : private Forgetting, private VarianceRatio {
+    public:
+        /**
+         * @brief Constructor for StaticVarianceWeightedTotalLeastSquares
+         * 
+         * @param nominalValue Initial estimate of the weight
+         * @param initialVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         * @param forgetting Forgetting policy, only needed for RuntimeForgetting
+         * @param varianceRatio Variance ratio policy, only needed for RuntimeVarianceRatio
+         */
+        StaticVarianceWeightedTotalLeastSquares(
+            double nominalValue=0.0, double initialVariance=1.0,
+            Forgetting forgetting=Forgetting(), VarianceRatio varianceRatio=VarianceRatio()
+        );
+
+        /**
+         * @brief Update with a new measurement
+         * 
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void update(double x, double y, double yVariance);
+
+        /**
+         * @brief Get the current variance of the weight estimate
+         */
+        double getVariance() const;
+
+        /**
+         * @brief Get the current estimate
+         */
+        double getEstimate() const;
+
+        /**
+         * @brief Get the current estimate without throwing, value is NaN when the status is not Ok
+         */
+        EstimatorResult tryGetEstimate() const;
+
+        /**
+         * @brief Get the current variance without throwing, value is NaN when the status is not Ok
+         */
+        EstimatorResult tryGetVariance() const;
+
+    private:
+        double c1;
+        double c2;
+        double c3;
+
+        double varianceRatioSquared() const;
+};
+
+
+template <typename Forgetting, typename VarianceRatio>
+StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::StaticVarianceWeightedTotalLeastSquares(
+    double nominalValue, double initialVariance, Forgetting forgetting, VarianceRatio varianceRatio
+) : Forgetting(forgetting), VarianceRatio(varianceRatio) {
+    if (initialVariance <= 0) {
+        throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(initialVariance) );
+    }
+
+    this->c1 = 1 / initialVariance;
+    this->c2 = nominalValue / initialVariance;
+    this->c3 = (nominalValue * nominalValue) / initialVariance;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+inline double StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::varianceRatioSquared() const {
+    return this->VarianceRatio::ratio() * this->VarianceRatio::ratio();
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+inline void StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::update(double x, double y, double yVariance) {
+    // Multiplying by a constant 1.0 is exact, so the compiler removes it for NoForgetting.
+    double forgettingFactor = this->Forgetting::factor();
+    this->c1 = forgettingFactor * this->c1 + x * x / yVariance;
+    this->c2 = forgettingFactor * this->c2 + x * y / yVariance;
+    this->c3 = forgettingFactor * this->c3 + y * y / yVariance;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+inline double StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::getEstimate() const {
+    return wtls_estimate(this->c1, this->c2, this->c3, this->varianceRatioSquared());
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+inline double StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::getVariance() const {
+    double estimate, variance;
+    wtls_estimate_variance(this->c1, this->c2, this->c3, this->varianceRatioSquared(), estimate, variance);
+    return variance;
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+EstimatorResult StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::tryGetEstimate() const {
+    double estimate = this->getEstimate();
+    if (!std::isfinite(estimate)) {
+        return {NAN, EstimatorStatus::NotFinite};
+    }
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+template <typename Forgetting, typename VarianceRatio>
+EstimatorResult StaticVarianceWeightedTotalLeastSquares<Forgetting, VarianceRatio>::tryGetVariance() const {
+    double variance = this->getVariance();
+    if (!std::isfinite(variance)) {
+        return {NAN, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {NAN, EstimatorStatus::NonPositiveVariance};
+    }
+    return {variance, EstimatorStatus::Ok};
+}
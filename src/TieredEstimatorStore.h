@@ -0,0 +1,346 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "EstimatorStatus.h"
+#include "helper/journal.h"
+
+
+/**
+ * A store for a very large number of estimators, most of which are idle, that keeps only the recently used
+ * ones as full estimators.
+ *
+ * Hot estimators live in a dense arena and are updated in place. Cold estimators are kept as the difference
+ * from the prototype every estimator starts as (see put_packed_word_delta), packed back to back in one byte arena:
+ * a mask of the 64 bit words that differ from the prototype and a mask of those stored raw, then each remaining
+ * word as the XOR with the prototype's word or with one of the packedMaxBack words before it in the same estimator
+ * (statistics often share sign and exponent), whichever is shortest, behind a header byte giving its length,
+ * trailing zero bytes and which word it was taken against. The forgetting factor, variance ratio and every other
+ * parameter shared with the prototype cost nothing, a statistic never costs more than its 8 bytes, an estimator
+ * that was never updated shares one encoding, and the encoding is lossless so a promoted estimator is bit for bit
+ * what was demoted.
+ *
+ * Updating or reading a cold estimator promotes it transparently. Call tick once per period of your choice
+ * and demoteIdle to send estimators that haven't been used for a number of ticks back to the cold tier.
+ *
+ * Estimator must be trivially copyable, e.g. VarianceWeightedTotalLeastSquares or
+ * DualVarianceWeightedTotalLeastSquares. Not thread safe.
+ */
+template <typename Estimator>
+class TieredEstimatorStore {
+    public:
+        /**
+         * @brief Constructor for TieredEstimatorStore, every estimator starts cold
+         *
+         * @param count Number of estimators in the store
+         * @param prototype Estimator every one starts as
+         */
+        TieredEstimatorStore(size_t count, const Estimator& prototype = Estimator());
+
+        /**
+         * @brief Update an estimator with a new measurement, promoting it if it is cold
+         *
+         * @param id index of the estimator to update
+         * @param measurement arguments forwarded to Estimator::update
+         */
+        template <typename... Args>
+        void update(size_t id, Args... measurement);
+
+        /**
+         * @brief Get the estimate of an estimator, promoting it if it is cold
+         */
+        EstimatorResult getEstimate(size_t id);
+
+        /**
+         * @brief Get the variance of an estimator, promoting it if it is cold
+         */
+        EstimatorResult getVariance(size_t id);
+
+        /**
+         * @brief Access an estimator, promoting it if it is cold
+         *
+         * The reference is invalidated by the next promotion or demotion.
+         */
+        Estimator& get(size_t id);
+
+        /**
+         * @brief Copy of an estimator that leaves it in whichever tier it is in
+         */
+        Estimator peek(size_t id) const;
+
+        /**
+         * @brief Whether an estimator is currently hot
+         */
+        bool isHot(size_t id) const;
+
+        /**
+         * @brief Advance the clock demoteIdle measures idleness with
+         */
+        void tick();
+
+        /**
+         * @brief Demote every hot estimator that hasn't been used for at least idleTicks ticks
+         *
+         * @return Number of estimators demoted
+         */
+        size_t demoteIdle(unsigned long idleTicks);
+
+        /**
+         * @brief Demote an estimator if it is hot
+         */
+        void demote(size_t id);
+
+        /**
+         * @brief Rewrite the cold arena without the encodings of estimators promoted since it was last compacted
+         */
+        void compactCold();
+
+        /**
+         * @brief Number of estimators in the store
+         */
+        size_t size() const;
+
+        /**
+         * @brief Number of hot estimators
+         */
+        size_t hotCount() const;
+
+        /**
+         * @brief Bytes of heap memory held by the store
+         */
+        size_t memoryBytes() const;
+
+    private:
+        static_assert(std::is_trivially_copyable<Estimator>::value, "Estimator must be trivially copyable to be encoded");
+        static_assert(sizeof(Estimator) % sizeof(uint64_t) == 0, "Estimator must be a whole number of 64 bit words");
+        static_assert(sizeof(Estimator) / sizeof(uint64_t) <= 64, "Estimator must fit in a 64 bit word mask");
+
+        static constexpr size_t words = sizeof(Estimator) / sizeof(uint64_t);
+        static constexpr uint64_t hotFlag = uint64_t(1) << 63;
+        static constexpr size_t minGarbageToCompact = 1 << 16;
+
+        uint64_t prototype[words];
+        // Per estimator: hotFlag | hot slot, or the offset of its encoding in cold.
+        std::vector<uint64_t> location;
+
+        std::vector<Estimator> hot;
+        std::vector<size_t> hotOwner; // estimator id of each hot slot
+        std::vector<unsigned long> hotLastUsed; // tick each hot slot was last used
+
+        std::vector<unsigned char> cold; // offset 0 holds the shared encoding of an unchanged estimator
+        size_t coldGarbage;
+        unsigned long clock;
+
+        size_t promote(size_t id);
+        void decode(uint64_t offset, uint64_t* state, const unsigned char** end) const;
+        uint64_t encode(const Estimator& estimator);
+};
+
+
+template <typename Estimator>
+TieredEstimatorStore<Estimator>::TieredEstimatorStore(size_t count, const Estimator& prototype)
+    : location(count, 0), coldGarbage(0), clock(0) {
+    std::memcpy(this->prototype, &prototype, sizeof(Estimator));
+    put_packed_word_delta(this->cold, this->prototype, this->prototype, words);
+}
+
+
+template <typename Estimator>
+void TieredEstimatorStore<Estimator>::decode(uint64_t offset, uint64_t* state, const unsigned char** end) const {
+    std::memcpy(state, this->prototype, sizeof(Estimator));
+    const unsigned char* data = this->cold.data() + offset;
+    if (!get_packed_word_delta(data, this->cold.data() + this->cold.size(), state, words)) {
+        throw std::logic_error( "Corrupt cold estimator encoding at " + std::to_string(offset) );
+    }
+    if (end != nullptr) {
+        *end = data;
+    }
+}
+
+
+template <typename Estimator>
+uint64_t TieredEstimatorStore<Estimator>::encode(const Estimator& estimator) {
+    uint64_t state[words];
+    std::memcpy(state, &estimator, sizeof(Estimator));
+    if (std::memcmp(state, this->prototype, sizeof(Estimator)) == 0) {
+        return 0;
+    }
+
+    uint64_t offset = this->cold.size();
+    put_packed_word_delta(this->cold, this->prototype, state, words);
+    return offset;
+}
+
+
+template <typename Estimator>
+size_t TieredEstimatorStore<Estimator>::promote(size_t id) {
+    uint64_t where = this->location[id];
+    if (where & hotFlag) {
+        size_t slot = where & ~hotFlag;
+        this->hotLastUsed[slot] = this->clock;
+        return slot;
+    }
+
+    uint64_t state[words];
+    const unsigned char* end;
+    this->decode(where, state, &end);
+    if (where != 0) {
+        this->coldGarbage += end - (this->cold.data() + where);
+    }
+
+    size_t slot = this->hot.size();
+    this->hot.emplace_back();
+    std::memcpy(&this->hot.back(), state, sizeof(Estimator));
+    this->hotOwner.push_back(id);
+    this->hotLastUsed.push_back(this->clock);
+    this->location[id] = hotFlag | slot;
+    return slot;
+}
+
+
+template <typename Estimator>
+template <typename... Args>
+void TieredEstimatorStore<Estimator>::update(size_t id, Args... measurement) {
+    this->hot[this->promote(id)].update(measurement...);
+}
+
+
+template <typename Estimator>
+EstimatorResult TieredEstimatorStore<Estimator>::getEstimate(size_t id) {
+    return this->hot[this->promote(id)].tryGetEstimate();
+}
+
+
+template <typename Estimator>
+EstimatorResult TieredEstimatorStore<Estimator>::getVariance(size_t id) {
+    return this->hot[this->promote(id)].tryGetVariance();
+}
+
+
+template <typename Estimator>
+Estimator& TieredEstimatorStore<Estimator>::get(size_t id) {
+    return this->hot[this->promote(id)];
+}
+
+
+template <typename Estimator>
+Estimator TieredEstimatorStore<Estimator>::peek(size_t id) const {
+    uint64_t where = this->location[id];
+    if (where & hotFlag) {
+        return this->hot[where & ~hotFlag];
+    }
+
+    uint64_t state[words];
+    this->decode(where, state, nullptr);
+    Estimator estimator;
+    std::memcpy(&estimator, state, sizeof(Estimator));
+    return estimator;
+}
+
+
+template <typename Estimator>
+bool TieredEstimatorStore<Estimator>::isHot(size_t id) const {
+    return (this->location[id] & hotFlag) != 0;
+}
+
+
+template <typename Estimator>
+void TieredEstimatorStore<Estimator>::tick() {
+    ++this->clock;
+}
+
+
+template <typename Estimator>
+void TieredEstimatorStore<Estimator>::demote(size_t id) {
+    uint64_t where = this->location[id];
+    if (!(where & hotFlag)) {
+        return;
+    }
+    size_t slot = where & ~hotFlag;
+    this->location[id] = this->encode(this->hot[slot]);
+
+    // Keep the arena dense by moving the last hot estimator into the hole.
+    size_t last = this->hot.size() - 1;
+    if (slot != last) {
+        this->hot[slot] = this->hot[last];
+        this->hotOwner[slot] = this->hotOwner[last];
+        this->hotLastUsed[slot] = this->hotLastUsed[last];
+        this->location[this->hotOwner[slot]] = hotFlag | slot;
+    }
+    this->hot.pop_back();
+    this->hotOwner.pop_back();
+    this->hotLastUsed.pop_back();
+}
+
+
+template <typename Estimator>
+size_t TieredEstimatorStore<Estimator>::demoteIdle(unsigned long idleTicks) {
+    size_t demoted = 0;
+    // Walk backwards so the estimator moved into a hole has already been looked at.
+    for (size_t slot = this->hot.size(); slot-- > 0;) {
+        if (this->clock - this->hotLastUsed[slot] >= idleTicks) {
+            this->demote(this->hotOwner[slot]);
+            ++demoted;
+        }
+    }
+
+    // Hand memory back after a burst of activity has died down.
+    if (this->hot.size() < this->hot.capacity() / 4) {
+        this->hot.shrink_to_fit();
+        this->hotOwner.shrink_to_fit();
+        this->hotLastUsed.shrink_to_fit();
+    }
+    if (this->coldGarbage > minGarbageToCompact && this->coldGarbage > this->cold.size() / 2) {
+        this->compactCold();
+    }
+    return demoted;
+}
+
+
+template <typename Estimator>
+void TieredEstimatorStore<Estimator>::compactCold() {
+    std::vector<unsigned char> compacted;
+    compacted.reserve(this->cold.size() - this->coldGarbage);
+    put_packed_word_delta(compacted, this->prototype, this->prototype, words);
+
+    for (uint64_t& where : this->location) {
+        if ((where & hotFlag) || where == 0) {
+            continue;
+        }
+        const unsigned char* begin = this->cold.data() + where;
+        const unsigned char* end;
+        uint64_t state[words];
+        this->decode(where, state, &end);
+        where = compacted.size();
+        compacted.insert(compacted.end(), begin, end);
+    }
+
+    this->cold.swap(compacted);
+    this->cold.shrink_to_fit();
+    this->coldGarbage = 0;
+}
+
+
+template <typename Estimator>
+size_t TieredEstimatorStore<Estimator>::size() const {
+    return this->location.size();
+}
+
+
+template <typename Estimator>
+size_t TieredEstimatorStore<Estimator>::hotCount() const {
+    return this->hot.size();
+}
+
+
+template <typename Estimator>
+size_t TieredEstimatorStore<Estimator>::memoryBytes() const {
+    return this->location.capacity() * sizeof(uint64_t)
+        + this->hot.capacity() * sizeof(Estimator)
+        + this->hotOwner.capacity() * sizeof(size_t)
+        + this->hotLastUsed.capacity() * sizeof(unsigned long)
+        + this->cold.capacity();
+}
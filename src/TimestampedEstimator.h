@@ -0,0 +1,273 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "EstimatorStatus.h"
+#include "helper/fastMath.h"
+
+
+/**
+ * Adds time stamped updates to an estimator, forgetting by elapsed time rather than by sample count.
+ *
+ * The statistics are decayed by forgettingFactor^(dt / samplePeriod) where dt is the time since the newest measurement,
+ * so bursts and drop outs age the history by wall clock time. The first time stamped measurement is treated as one
+ * sample period after the prior. A measurement older than the newest one is added exactly as if it had arrived in order,
+ * weighted by forgettingFactor^(age / samplePeriod).
+ *
+ * The time stamp state lives here rather than in the estimator, so estimators that are only updated in sequence don't
+ * carry it. Once wrapped, update through updateAt only, otherwise merge can't tell how far the statistics were aged.
+ *
+ * Estimator must provide updateDecayed, getForgettingFactor, partial and merge(other, steps, otherSteps), as
+ * VarianceWeightedTotalLeastSquares and DualVarianceWeightedTotalLeastSquares do.
+ */
+template <typename Estimator>
+class TimestampedEstimator {
+    public:
+        /**
+         * @brief Constructor for TimestampedEstimator
+         *
+         * @param estimator Estimator to update, copied
+         * @param samplePeriod Nominal time between measurements over which the forgetting factor is applied once (must be more than 0)
+         */
+        explicit TimestampedEstimator(const Estimator& estimator=Estimator(), double samplePeriod=1.0);
+
+        /**
+         * @brief Update with a new time stamped measurement
+         *
+         * @param timestamp time of the measurement, in the same units as the sample period
+         * @param measurement the measurement and its variances, as taken by Estimator::update
+         */
+        template <typename... Measurement>
+        void updateAt(double timestamp, Measurement... measurement);
+
+        /**
+         * @brief Update with count time stamped measurements, in array order
+         */
+        void updateAt(const double* timestamps, const double* x, const double* y, const double* yVariance, size_t count);
+
+        /**
+         * @brief Update with count time stamped measurements with x variances, in array order
+         */
+        void updateAt(
+            const double* timestamps, const double* x, const double* y,
+            const double* xVariance, const double* yVariance, size_t count
+        );
+
+        /**
+         * @brief Get an estimator with the same parameters and no statistics or time stamps, to accumulate part of a stream in
+         */
+        TimestampedEstimator partial() const;
+
+        /**
+         * @brief Add the statistics of another time stamped estimator into this one
+         *
+         * When both have time stamps each side is aged to the newer of the two last time stamps, so partials can be
+         * merged in any order. The prior is aged from the first time stamp of the estimator holding it, so merge
+         * partials that hold earlier measurements than it together before merging them in.
+         *
+         * @param other estimator from partial() with the same sample period
+         */
+        void merge(const TimestampedEstimator& other);
+
+        /**
+         * @brief Set the time over which the forgetting factor is applied once by updateAt
+         *
+         * @param samplePeriod nominal time between measurements (must be more than 0), 1 by default
+         */
+        void setSamplePeriod(double samplePeriod);
+
+        /**
+         * @brief Get the time over which the forgetting factor is applied once by updateAt
+         */
+        double getSamplePeriod() const;
+
+        /**
+         * @brief Get the wrapped estimator, e.g. to read other results from it
+         */
+        Estimator& getEstimator();
+
+        /**
+         * @brief Get the wrapped estimator, e.g. to read other results from it
+         */
+        const Estimator& getEstimator() const;
+
+        /**
+         * @brief Get the current estimate, see Estimator::getEstimate
+         */
+        double getEstimate();
+
+        /**
+         * @brief Get the current variance of the estimate, see Estimator::getVariance
+         */
+        double getVariance();
+
+        /**
+         * @brief Get the current estimate without throwing, see Estimator::tryGetEstimate
+         */
+        EstimatorResult tryGetEstimate();
+
+        /**
+         * @brief Get the current variance of the estimate without throwing, see Estimator::tryGetVariance
+         */
+        EstimatorResult tryGetVariance();
+
+        /**
+         * @brief Get the current estimate and its variance without throwing, see Estimator::tryGetEstimateAndVariance
+         */
+        void tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance);
+
+    private:
+        Estimator estimator;
+        double samplePeriod;
+        double log2ForgettingFactor;
+        double firstTimestamp; // NaN before the first updateAt
+        double lastTimestamp; // NaN before the first updateAt
+};
+
+
+template <typename Estimator>
+TimestampedEstimator<Estimator>::TimestampedEstimator(const Estimator& estimator, double samplePeriod)
+    : estimator(estimator),
+      log2ForgettingFactor(std::log2(estimator.getForgettingFactor())),
+      firstTimestamp(std::numeric_limits<double>::quiet_NaN()),
+      lastTimestamp(std::numeric_limits<double>::quiet_NaN()) {
+    this->setSamplePeriod(samplePeriod);
+}
+
+
+template <typename Estimator>
+template <typename... Measurement>
+void TimestampedEstimator<Estimator>::updateAt(double timestamp, Measurement... measurement) {
+    double forgettingFactor = this->estimator.getForgettingFactor();
+
+    if (std::isnan(this->lastTimestamp)) {
+        this->estimator.updateDecayed(forgettingFactor, 1.0, measurement...);
+        this->firstTimestamp = timestamp;
+        this->lastTimestamp = timestamp;
+        return;
+    }
+
+    double steps = (timestamp - this->lastTimestamp) / this->samplePeriod;
+    if (steps >= 0) {
+        this->estimator.updateDecayed(forgetting_decay(forgettingFactor, this->log2ForgettingFactor, steps), 1.0, measurement...);
+        this->lastTimestamp = timestamp;
+    } else {
+        // Late measurement, the history is already aged past it so age the measurement instead.
+        this->estimator.updateDecayed(1.0, forgetting_decay(forgettingFactor, this->log2ForgettingFactor, -steps), measurement...);
+    }
+}
+
+
+template <typename Estimator>
+void TimestampedEstimator<Estimator>::updateAt(const double* timestamps, const double* x, const double* y, const double* yVariance, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        this->updateAt(timestamps[i], x[i], y[i], yVariance[i]);
+    }
+}
+
+
+template <typename Estimator>
+void TimestampedEstimator<Estimator>::updateAt(
+            const double* timestamps, const double* x, const double* y,
+            const double* xVariance, const double* yVariance, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        this->updateAt(timestamps[i], x[i], y[i], xVariance[i], yVariance[i]);
+    }
+}
+
+
+template <typename Estimator>
+TimestampedEstimator<Estimator> TimestampedEstimator<Estimator>::partial() const {
+    return TimestampedEstimator(this->estimator.partial(), this->samplePeriod);
+}
+
+
+template <typename Estimator>
+void TimestampedEstimator<Estimator>::merge(const TimestampedEstimator& other) {
+    if (other.samplePeriod != this->samplePeriod) {
+        throw std::invalid_argument( "Can't merge Sample Period " + std::to_string(other.samplePeriod) + " into " + std::to_string(this->samplePeriod) );
+    }
+
+    if (std::isnan(other.lastTimestamp)) {
+        // other has no updates, so there is nothing to age.
+        this->estimator.merge(other.estimator, 0.0);
+        return;
+    }
+
+    if (std::isnan(this->lastTimestamp)) {
+        // Age this by every step other's updates took, as its first updateAt would have.
+        this->estimator.merge(other.estimator, 1.0 + (other.lastTimestamp - other.firstTimestamp) / this->samplePeriod);
+        this->firstTimestamp = other.firstTimestamp;
+        this->lastTimestamp = other.lastTimestamp;
+        return;
+    }
+
+    double newest = std::max(this->lastTimestamp, other.lastTimestamp);
+    this->estimator.merge(
+        other.estimator,
+        (newest - this->lastTimestamp) / this->samplePeriod,
+        (newest - other.lastTimestamp) / this->samplePeriod
+    );
+    this->firstTimestamp = std::min(this->firstTimestamp, other.firstTimestamp);
+    this->lastTimestamp = newest;
+}
+
+
+template <typename Estimator>
+void TimestampedEstimator<Estimator>::setSamplePeriod(double samplePeriod) {
+    if (!(samplePeriod > 0)) {
+        throw std::invalid_argument( "Sample Period must grater then 0 got " + std::to_string(samplePeriod) );
+    }
+    this->samplePeriod = samplePeriod;
+}
+
+
+template <typename Estimator>
+double TimestampedEstimator<Estimator>::getSamplePeriod() const {
+    return this->samplePeriod;
+}
+
+
+template <typename Estimator>
+Estimator& TimestampedEstimator<Estimator>::getEstimator() {
+    return this->estimator;
+}
+
+
+template <typename Estimator>
+const Estimator& TimestampedEstimator<Estimator>::getEstimator() const {
+    return this->estimator;
+}
+
+
+template <typename Estimator>
+double TimestampedEstimator<Estimator>::getEstimate() {
+    return this->estimator.getEstimate();
+}
+
+
+template <typename Estimator>
+double TimestampedEstimator<Estimator>::getVariance() {
+    return this->estimator.getVariance();
+}
+
+
+template <typename Estimator>
+EstimatorResult TimestampedEstimator<Estimator>::tryGetEstimate() {
+    return this->estimator.tryGetEstimate();
+}
+
+
+template <typename Estimator>
+EstimatorResult TimestampedEstimator<Estimator>::tryGetVariance() {
+    return this->estimator.tryGetVariance();
+}
+
+
+template <typename Estimator>
+void TimestampedEstimator<Estimator>::tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance) {
+    this->estimator.tryGetEstimateAndVariance(estimate, variance);
+}
@@ -1,26 +1,85 @@
 #include "VarianceWeightedTotalLeastSquares.h"
+#include <algorithm>
 
 
 VarianceWeightedTotalLeastSquares::VarianceWeightedTotalLeastSquares (
     double nominalValue, double varianceRatio,
     double forgettingFactor, double yVariance
 ) {
-    if (forgettingFactor > 1 || forgettingFactor <= 0) {
-        throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+    switch (checkParameters(varianceRatio, forgettingFactor, yVariance)) {
+        case EstimatorStatus::InvalidForgettingFactor:
+            throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+        case EstimatorStatus::InvalidVarianceRatio:
+            throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+        case EstimatorStatus::InvalidInitialVariance:
+            throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(yVariance) );
+        default:
+            break;
     }
 
-    this->forgettingFactor = forgettingFactor;
+    this->initialise(nominalValue, varianceRatio, forgettingFactor, yVariance);
+}
+
+
+EstimatorStatus VarianceWeightedTotalLeastSquares::checkParameters(
+    double varianceRatio, double forgettingFactor, double yVariance
+) {
+    if (forgettingFactor > 1 || forgettingFactor <= 0) {
+        return EstimatorStatus::InvalidForgettingFactor;
+    }
 
     if (varianceRatio <= 0) {
-        throw std::invalid_argument( "Variance Ratio must grater then 0 got " + std::to_string(varianceRatio) );
+        return EstimatorStatus::InvalidVarianceRatio;
     }
 
-    this->varianceRatioSquared = varianceRatio * varianceRatio;
+    if (yVariance <= 0) {
+        return EstimatorStatus::InvalidInitialVariance;
+    }
 
+    return EstimatorStatus::Ok;
+}
 
-    if (yVariance <= 0) {
-        throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(yVariance) );
+
+EstimatorStatus VarianceWeightedTotalLeastSquares::tryCreate(
+    VarianceWeightedTotalLeastSquares& out,
+    double nominalValue, double varianceRatio,
+    double forgettingFactor, double yVariance
+) {
+    EstimatorStatus status = checkParameters(varianceRatio, forgettingFactor, yVariance);
+    if (status == EstimatorStatus::Ok) {
+        out.initialise(nominalValue, varianceRatio, forgettingFactor, yVariance);
+    }
+    return status;
+}
+
+
+size_t VarianceWeightedTotalLeastSquares::createBatch(
+    const double* nominalValues, const double* varianceRatios,
+    const double* forgettingFactors, const double* initialVariances,
+    size_t count, VarianceWeightedTotalLeastSquares* out, EstimatorStatus* statuses
+) {
+    size_t created = 0;
+    for (size_t i = 0; i < count; ++i) {
+        statuses[i] = tryCreate(
+            out[i], nominalValues[i], varianceRatios[i],
+            forgettingFactors[i], initialVariances[i]
+        );
+        if (statuses[i] == EstimatorStatus::Ok) {
+            ++created;
+        }
     }
+    return created;
+}
+
+
+void VarianceWeightedTotalLeastSquares::initialise(
+    double nominalValue, double varianceRatio,
+    double forgettingFactor, double yVariance
+) {
+    this->forgettingFactor = forgettingFactor;
+    this->varianceRatioSquared = varianceRatio * varianceRatio;
+    this->lastEstimate = nominalValue;
+    this->lastVariance = std::numeric_limits<double>::quiet_NaN();
 
     // You can't get this yVariance
     this->c1 = 1 / yVariance;
@@ -38,31 +97,147 @@ void VarianceWeightedTotalLeastSquares::update(double x, double y, double yVaria
 }
 
 
-double VarianceWeightedTotalLeastSquares:: getEstimate() {
-    if (this->varianceRatioSquared == 0 || this->c2 == 0) {
-        return 0.0;
+void VarianceWeightedTotalLeastSquares::updatePrecision(double x, double y, double yPrecision) {
+    this->c1 = this->forgettingFactor * this->c1 + x * x * yPrecision;
+    this->c2 = this->forgettingFactor * this->c2 + x * y * yPrecision;
+    this->c3 = this->forgettingFactor * this->c3 + y * y * yPrecision;
+}
+
+
+void VarianceWeightedTotalLeastSquares::update(const double* x, const double* y, const double* yVariance, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        this->updatePrecision(x[i], y[i], 1 / yVariance[i]);
+    }
+}
+
+
+void VarianceWeightedTotalLeastSquares::updatePrecision(const double* x, const double* y, const double* yPrecision, size_t count) {
+    // Work on locals so the compiler can keep the statistics in registers across the loop.
+    double forgettingFactor = this->forgettingFactor;
+    double c1 = this->c1;
+    double c2 = this->c2;
+    double c3 = this->c3;
+
+    for (size_t i = 0; i < count; ++i) {
+        double xWeighted = x[i] * yPrecision[i];
+        c1 = forgettingFactor * c1 + x[i] * xWeighted;
+        c2 = forgettingFactor * c2 + y[i] * xWeighted;
+        c3 = forgettingFactor * c3 + y[i] * y[i] * yPrecision[i];
+    }
+
+    this->c1 = c1;
+    this->c2 = c2;
+    this->c3 = c3;
+}
+
+
+void VarianceWeightedTotalLeastSquares::updateDecayed(double decay, double weight, double x, double y, double yVariance) {
+    double scale = weight / yVariance;
+    this->c1 = decay * this->c1 + x * x * scale;
+    this->c2 = decay * this->c2 + x * y * scale;
+    this->c3 = decay * this->c3 + y * y * scale;
+}
+
+
+VarianceWeightedTotalLeastSquares VarianceWeightedTotalLeastSquares::partial() const {
+    VarianceWeightedTotalLeastSquares partial = *this;
+    partial.c1 = 0.0;
+    partial.c2 = 0.0;
+    partial.c3 = 0.0;
+    return partial;
+}
+
+
+void VarianceWeightedTotalLeastSquares::merge(const VarianceWeightedTotalLeastSquares& other, double steps, double otherSteps) {
+    if (other.forgettingFactor != this->forgettingFactor) {
+        throw std::invalid_argument( "Can't merge Forgetting Factor " + std::to_string(other.forgettingFactor) + " into " + std::to_string(this->forgettingFactor) );
     }
-    
-    double top_left = -this->c1 + this->varianceRatioSquared * this->c3;
-    double top_right_inner = (this->c1 - this->varianceRatioSquared * this->c3);
-    double top_right = std::sqrt(top_right_inner * top_right_inner + 4 * this->varianceRatioSquared * this->c2 * this->c2);
 
-    return (top_left + top_right) / (2 * this->varianceRatioSquared * this->c2);
+    // Once per merge, so the logarithm isn't worth keeping.
+    double log2ForgettingFactor = std::log2(this->forgettingFactor);
+    double thisDecay = forgetting_decay(this->forgettingFactor, log2ForgettingFactor, steps);
+    double otherDecay = forgetting_decay(this->forgettingFactor, log2ForgettingFactor, otherSteps);
+
+    this->c1 = thisDecay * this->c1 + otherDecay * other.c1;
+    this->c2 = thisDecay * this->c2 + otherDecay * other.c2;
+    this->c3 = thisDecay * this->c3 + otherDecay * other.c3;
+}
+
+
+double VarianceWeightedTotalLeastSquares::getForgettingFactor() const {
+    return this->forgettingFactor;
+}
+
+
+double VarianceWeightedTotalLeastSquares:: getEstimate() {
+    return wtls_estimate(this->c1, this->c2, this->c3, this->varianceRatioSquared);
 }
 
 
 double VarianceWeightedTotalLeastSquares:: getVariance() {
-    // TODO rewrite this based on page 6/2034 of http://mocha-java.uccs.edu/dossier/RESEARCH/2011jps-.pdf
+    double estimate, variance;
+    wtls_estimate_variance(this->c1, this->c2, this->c3, this->varianceRatioSquared, estimate, variance);
+    return variance;
+}
+
+
+EstimatorResult VarianceWeightedTotalLeastSquares::tryGetEstimate() {
     double estimate = this->getEstimate();
-    
-    double bottom = (estimate * estimate * this->varianceRatioSquared + 1);
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate, EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult VarianceWeightedTotalLeastSquares::tryGetVariance() {
+    double variance = this->getVariance();
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance, EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance = variance;
+    return {variance, EstimatorStatus::Ok};
+}
+
+
+void VarianceWeightedTotalLeastSquares::getEstimateAndVariance(double& estimate, double& variance) {
+    wtls_estimate_variance(this->c1, this->c2, this->c3, this->varianceRatioSquared, estimate, variance);
+}
+
+
+void VarianceWeightedTotalLeastSquares::tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance) {
+    double estimateValue, varianceValue;
+    this->getEstimateAndVariance(estimateValue, varianceValue);
+
+    if (!std::isfinite(estimateValue)) {
+        estimate = {this->lastEstimate, EstimatorStatus::NotFinite};
+    } else {
+        this->lastEstimate = estimateValue;
+        estimate = {estimateValue, EstimatorStatus::Ok};
+    }
+
+    if (!std::isfinite(varianceValue)) {
+        variance = {this->lastVariance, EstimatorStatus::NotFinite};
+    } else if (varianceValue <= 0) {
+        variance = {this->lastVariance, EstimatorStatus::NonPositiveVariance};
+    } else {
+        this->lastVariance = varianceValue;
+        variance = {varianceValue, EstimatorStatus::Ok};
+    }
+}
 
-    double top = (-4.0 * this->varianceRatioSquared * this->varianceRatioSquared * this->c2) * estimate * estimate * estimate
-           + 6.0 * this->varianceRatioSquared * this->varianceRatioSquared * this->c3 * estimate * estimate
-           + (-6.0 * this->c1 + 12.0 * this->c2) * this->varianceRatioSquared * estimate
-           + 2.0 * (this->c1 - this->varianceRatioSquared * this->c3);
 
-    double hessian = top / (bottom * bottom * bottom);
-    
-    return 2 / hessian;
+uint64_t VarianceWeightedTotalLeastSquares::resultCacheWords() {
+    // offsetof isn't allowed on private members of every estimator, so measure the fields of an instance.
+    VarianceWeightedTotalLeastSquares probe;
+    const char* base = reinterpret_cast<const char*>(&probe);
+    size_t estimateWord = (reinterpret_cast<const char*>(&probe.lastEstimate) - base) / sizeof(uint64_t);
+    size_t varianceWord = (reinterpret_cast<const char*>(&probe.lastVariance) - base) / sizeof(uint64_t);
+    return (uint64_t(1) << estimateWord) | (uint64_t(1) << varianceWord);
 }
@@ -1,7 +1,12 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <stdexcept>
+#include <limits>
+#include "EstimatorStatus.h"
+#include "helper/fastMath.h"
+#include "helper/wtls.h"
 
 /*
 Estmates the weight W as Y=WX by doing weighted total least sqears, where Y and X are a list of mesurements recusivly.
@@ -35,6 +40,42 @@ class VarianceWeightedTotalLeastSquares {
             double forgettingFactor=1.0, double initialVariance=1.0
         );
 
+        /**
+         * @brief Check constructor parameters without throwing
+         * 
+         * @return EstimatorStatus::Ok if the constructor would accept the parameters, otherwise the reason it would throw
+         */
+        static EstimatorStatus checkParameters(
+            double varianceRatio, double forgettingFactor, double initialVariance
+        );
+
+        /**
+         * @brief Non-throwing constructor, out is only written when the parameters are valid
+         * 
+         * @return EstimatorStatus::Ok on success, otherwise the reason the parameters were rejected
+         */
+        static EstimatorStatus tryCreate(
+            VarianceWeightedTotalLeastSquares& out,
+            double nominalValue, double varianceRatio,
+            double forgettingFactor, double initialVariance
+        );
+
+        /**
+         * @brief Construct many estimators from parameter arrays without throwing
+         * 
+         * Entries with invalid parameters are left untouched in out and have their reason written to statuses.
+         * 
+         * @param count number of entries in every array
+         * @param out caller provided storage for count estimators
+         * @param statuses caller provided storage for count statuses
+         * @return number of estimators successfully created
+         */
+        static size_t createBatch(
+            const double* nominalValues, const double* varianceRatios,
+            const double* forgettingFactors, const double* initialVariances,
+            size_t count, VarianceWeightedTotalLeastSquares* out, EstimatorStatus* statuses
+        );
+
         /**
          * @brief Update with a new measurement
          * 
@@ -44,7 +85,67 @@ class VarianceWeightedTotalLeastSquares {
          */
         void update(double x, double y, double yVariance);
 
-        
+        /**
+         * @brief Update with count measurements, in array order, taking one reciprocal of each variance
+         */
+        void update(const double* x, const double* y, const double* yVariance, size_t count);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance), avoiding every division
+         * 
+         * Equivalent to update(x, y, 1 / yPrecision) up to rounding.
+         * A precision can also be any precomputed weight, it need not come from a variance.
+         * 
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yPrecision Precision (1 / variance) of the y measurement (must be more then 0)
+         */
+        void updatePrecision(double x, double y, double yPrecision);
+
+        /**
+         * @brief Update with count precision weighted measurements, in array order
+         */
+        void updatePrecision(const double* x, const double* y, const double* yPrecision, size_t count);
+
+        /**
+         * @brief Update with a new measurement, decaying the statistics by decay instead of the forgetting factor
+         * 
+         * The building block of time stamped updates (see TimestampedEstimator), which decay by the elapsed time
+         * and weight a late measurement by the forgetting it would have had if it arrived in order.
+         * 
+         * @param decay factor the statistics are multiplied by before adding the measurement (0 < decay <= 1)
+         * @param weight factor the measurement is multiplied by (0 < weight <= 1)
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void updateDecayed(double decay, double weight, double x, double y, double yVariance);
+
+        /**
+         * @brief Get an estimator with the same parameters and no statistics, to accumulate part of a stream in
+         * 
+         * Merging the partial back in (see merge) gives the same statistics as updating this estimator directly.
+         */
+        VarianceWeightedTotalLeastSquares partial() const;
+
+        /**
+         * @brief Add the statistics of another estimator into this one
+         * 
+         * other is taken to cover the measurements after this one's, so this one's statistics are aged by the steps
+         * other has forgotten over. otherSteps ages other as well, e.g. to align two partials by time.
+         * The other estimator should come from partial(), otherwise its prior is counted as a measurement.
+         * 
+         * @param other estimator with the same forgetting factor
+         * @param steps forgetting steps other took since partial(), i.e. its number of updates
+         * @param otherSteps forgetting steps to age other by before adding it
+         */
+        void merge(const VarianceWeightedTotalLeastSquares& other, double steps, double otherSteps=0.0);
+
+        /**
+         * @brief Get the factor the statistics are multiplied by on every update
+         */
+        double getForgettingFactor() const;
+
         /**
          * @brief Get the current variance of the weight estimate
          * 
@@ -59,11 +160,55 @@ class VarianceWeightedTotalLeastSquares {
          */
         double getEstimate();
 
+        /**
+         * @brief Get the current estimate without throwing
+         * 
+         * @return The estimate, or the last good estimate and the reason the estimate is unusable
+         */
+        EstimatorResult tryGetEstimate();
+
+        /**
+         * @brief Get the current variance of the weight estimate without throwing
+         * 
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        EstimatorResult tryGetVariance();
+
+        /**
+         * @brief Get the current estimate and its variance in one evaluation (see wtls_estimate_variance)
+         *
+         * Same values as getEstimate and getVariance, for the cost of one of them.
+         */
+        void getEstimateAndVariance(double& estimate, double& variance);
+
+        /**
+         * @brief Get the current estimate and its variance in one evaluation without throwing
+         *
+         * @param estimate set to the estimate, or the last good estimate and the reason the estimate is unusable
+         * @param variance set to the variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        void tryGetEstimateAndVariance(EstimatorResult& estimate, EstimatorResult& variance);
+
+        /**
+         * @brief Mask of the 64 bit words of an estimator that only hold the last good estimate and variance
+         * 
+         * The try getters write these words, so byte level change tracking (e.g. CheckpointJournal) skips them
+         * to keep reads from marking an estimator as changed.
+         */
+        static uint64_t resultCacheWords();
+
     private:
         double forgettingFactor;
         double varianceRatioSquared; // because it is allways used as sqeared
         double c1;
         double c2;
         double c3;
+        double lastEstimate;
+        double lastVariance;
+
+        void initialise(
+            double nominalValue, double varianceRatio,
+            double forgettingFactor, double initialVariance
+        );
         
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "WeightedRecursiveLeastSquares.h"
+
+
+WeightedRecursiveLeastSquares::WeightedRecursiveLeastSquares(
+    double nominalValue, double forgettingFactor, double initialVariance
+) {
+    switch (checkParameters(forgettingFactor, initialVariance)) {
+        case EstimatorStatus::InvalidForgettingFactor:
+            throw std::invalid_argument( "Forgetting Factor must be in the range 0 to 1 (exluding zero) got " + std::to_string(forgettingFactor) );
+        case EstimatorStatus::InvalidInitialVariance:
+            throw std::invalid_argument( "Initial Variance must grater then 0 got " + std::to_string(initialVariance) );
+        default:
+            break;
+    }
+
+    this->initialise(nominalValue, forgettingFactor, initialVariance);
+}
+
+
+EstimatorStatus WeightedRecursiveLeastSquares::checkParameters(double forgettingFactor, double initialVariance) {
+    if (forgettingFactor > 1 || forgettingFactor <= 0) {
+        return EstimatorStatus::InvalidForgettingFactor;
+    }
+
+    if (initialVariance <= 0) {
+        return EstimatorStatus::InvalidInitialVariance;
+    }
+
+    return EstimatorStatus::Ok;
+}
+
+
+EstimatorStatus WeightedRecursiveLeastSquares::tryCreate(
+    WeightedRecursiveLeastSquares& out,
+    double nominalValue, double forgettingFactor, double initialVariance
+) {
+    EstimatorStatus status = checkParameters(forgettingFactor, initialVariance);
+    if (status == EstimatorStatus::Ok) {
+        out.initialise(nominalValue, forgettingFactor, initialVariance);
+    }
+    return status;
+}
+
+
+size_t WeightedRecursiveLeastSquares::createBatch(
+    const double* nominalValues, const double* forgettingFactors, const double* initialVariances,
+    size_t count, WeightedRecursiveLeastSquares* out, EstimatorStatus* statuses
+) {
+    size_t created = 0;
+    for (size_t i = 0; i < count; ++i) {
+        statuses[i] = tryCreate(out[i], nominalValues[i], forgettingFactors[i], initialVariances[i]);
+        if (statuses[i] == EstimatorStatus::Ok) {
+            ++created;
+        }
+    }
+    return created;
+}
+
+
+void WeightedRecursiveLeastSquares::initialise(double nominalValue, double forgettingFactor, double initialVariance) {
+    this->forgettingFactor = forgettingFactor;
+    this->lastEstimate = nominalValue;
+    this->lastVariance = std::numeric_limits<double>::quiet_NaN();
+
+    // Same prior as VarianceWeightedTotalLeastSquares
+    this->c1 = 1 / initialVariance;
+    this->c2 = nominalValue / initialVariance;
+}
+
+
+void WeightedRecursiveLeastSquares::update(double x, double y, double yVariance) {
+    this->c1 = this->forgettingFactor * this->c1 + x * x / yVariance;
+    this->c2 = this->forgettingFactor * this->c2 + x * y / yVariance;
+}
+
+
+void WeightedRecursiveLeastSquares::updatePrecision(double x, double y, double yPrecision) {
+    double xWeighted = x * yPrecision;
+    this->c1 = this->forgettingFactor * this->c1 + x * xWeighted;
+    this->c2 = this->forgettingFactor * this->c2 + y * xWeighted;
+}
+
+
+void WeightedRecursiveLeastSquares::update(const double* x, const double* y, const double* yVariance, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        this->updatePrecision(x[i], y[i], 1 / yVariance[i]);
+    }
+}
+
+
+void WeightedRecursiveLeastSquares::updatePrecision(const double* x, const double* y, const double* yPrecision, size_t count) {
+    // Work on locals so the compiler can keep the statistics in registers across the loop.
+    double forgettingFactor = this->forgettingFactor;
+    double c1 = this->c1;
+    double c2 = this->c2;
+
+    for (size_t i = 0; i < count; ++i) {
+        double xWeighted = x[i] * yPrecision[i];
+        c1 = forgettingFactor * c1 + x[i] * xWeighted;
+        c2 = forgettingFactor * c2 + y[i] * xWeighted;
+    }
+
+    this->c1 = c1;
+    this->c2 = c2;
+}
+
+
+double WeightedRecursiveLeastSquares::getVariance() {
+    return wrls_variance(this->c1);
+}
+
+
+double WeightedRecursiveLeastSquares::getEstimate() {
+    return wrls_estimate(this->c1, this->c2);
+}
+
+
+EstimatorResult WeightedRecursiveLeastSquares::tryGetEstimate() {
+    double estimate = this->getEstimate();
+    if (!std::isfinite(estimate)) {
+        return {this->lastEstimate, EstimatorStatus::NotFinite};
+    }
+
+    this->lastEstimate = estimate;
+    return {estimate, EstimatorStatus::Ok};
+}
+
+
+EstimatorResult WeightedRecursiveLeastSquares::tryGetVariance() {
+    double variance = this->getVariance();
+    if (!std::isfinite(variance)) {
+        return {this->lastVariance, EstimatorStatus::NotFinite};
+    }
+    if (variance <= 0) {
+        return {this->lastVariance, EstimatorStatus::NonPositiveVariance};
+    }
+
+    this->lastVariance = variance;
+    return {variance, EstimatorStatus::Ok};
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include <limits>
+#include "EstimatorStatus.h"
+#include "helper/wrls.h"
+
+/*
+Estmates the weight W as Y=WX by doing weighted recursive least sqears, where only Y is taken to have noise.
+Same interface as VarianceWeightedTotalLeastSquares, as a baseline to compare the total least squares estimators against:
+it is cheaper, but biased towards zero when X is noisy.
+*/
+
+class WeightedRecursiveLeastSquares {
+    public:
+        /**
+         * @brief Constructor for WeightedRecursiveLeastSquares
+         *
+         * @param nominalValue Initial estimate of the weight
+         * @param forgettingFactor Factor to reduce influence of older measurements (0 < f <= 1)
+         * @param initialVariance Variance of a hypothetical (imaginary) measurement of y when x = 1 and y = nominalValue.
+         */
+        WeightedRecursiveLeastSquares(
+            double nominalValue=0.0, double forgettingFactor=1.0, double initialVariance=1.0
+        );
+
+        /**
+         * @brief Check constructor parameters without throwing
+         *
+         * @return EstimatorStatus::Ok if the constructor would accept the parameters, otherwise the reason it would throw
+         */
+        static EstimatorStatus checkParameters(double forgettingFactor, double initialVariance);
+
+        /**
+         * @brief Non-throwing constructor, out is only written when the parameters are valid
+         *
+         * @return EstimatorStatus::Ok on success, otherwise the reason the parameters were rejected
+         */
+        static EstimatorStatus tryCreate(
+            WeightedRecursiveLeastSquares& out,
+            double nominalValue, double forgettingFactor, double initialVariance
+        );
+
+        /**
+         * @brief Construct many estimators from parameter arrays without throwing
+         *
+         * Entries with invalid parameters are left untouched in out and have their reason written to statuses.
+         *
+         * @return number of estimators successfully created
+         */
+        static size_t createBatch(
+            const double* nominalValues, const double* forgettingFactors, const double* initialVariances,
+            size_t count, WeightedRecursiveLeastSquares* out, EstimatorStatus* statuses
+        );
+
+        /**
+         * @brief Update with a new measurement
+         *
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yVariance Variance (uncertainty) of the y measurement (must be more then 0)
+         */
+        void update(double x, double y, double yVariance);
+
+        /**
+         * @brief Update with count measurements, in array order, taking one reciprocal of each variance
+         */
+        void update(const double* x, const double* y, const double* yVariance, size_t count);
+
+        /**
+         * @brief Update with a new measurement weighted by precision (1 / variance), avoiding every division
+         *
+         * @param x mesurement for first variabile
+         * @param y mesurement for second variabile
+         * @param yPrecision Precision (1 / variance) of the y measurement (must be more then 0)
+         */
+        void updatePrecision(double x, double y, double yPrecision);
+
+        /**
+         * @brief Update with count precision weighted measurements, in array order
+         */
+        void updatePrecision(const double* x, const double* y, const double* yPrecision, size_t count);
+
+        /**
+         * @brief Get the current variance of the weight estimate
+         */
+        double getVariance();
+
+        /**
+         * @brief Get the current estimate
+         */
+        double getEstimate();
+
+        /**
+         * @brief Get the current estimate without throwing
+         *
+         * @return The estimate, or the last good estimate and the reason the estimate is unusable
+         */
+        EstimatorResult tryGetEstimate();
+
+        /**
+         * @brief Get the current variance of the weight estimate without throwing
+         *
+         * @return The variance, or the last good variance (NaN if there has been none) and the reason the variance is unusable
+         */
+        EstimatorResult tryGetVariance();
+
+    private:
+        double forgettingFactor;
+        double c1;
+        double c2;
+        double lastEstimate;
+        double lastVariance;
+
+        void initialise(double nominalValue, double forgettingFactor, double initialVariance);
+};
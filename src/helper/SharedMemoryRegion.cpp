@@ -0,0 +1,87 @@
+#include "SharedMemoryRegion.h"
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& name, size_t size)
+    : regionName(name), address(nullptr), regionSize(size), owner(true) {
+    // Replace any object left behind by a crashed owner rather than inheriting its layout.
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        int error = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+    }
+    this->address = mapped;
+}
+
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& name)
+    : regionName(name), address(nullptr), regionSize(0), owner(false) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + name);
+    }
+    this->regionSize = static_cast<size_t>(status.st_size);
+
+    void* mapped = mmap(nullptr, this->regionSize, PROT_READ, MAP_SHARED, fd, 0);
+    int error = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+    }
+    this->address = mapped;
+}
+
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    munmap(this->address, this->regionSize);
+    if (this->owner) {
+        shm_unlink(this->regionName.c_str());
+    }
+}
+
+
+void* SharedMemoryRegion::data() const {
+    return this->address;
+}
+
+
+size_t SharedMemoryRegion::size() const {
+    return this->regionSize;
+}
+
+
+bool SharedMemoryRegion::writable() const {
+    return this->owner;
+}
+
+
+const std::string& SharedMemoryRegion::name() const {
+    return this->regionName;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+
+/**
+ * A POSIX shared memory object (shm_open) mapped into this process.
+ *
+ * The creator maps it read write and unlinks the name when destroyed; processes that still have it mapped keep
+ * their mapping. Everyone else maps it read only.
+ */
+class SharedMemoryRegion {
+    public:
+        /**
+         * @brief Create (or replace) a shared memory object and map it read write
+         * 
+         * @param name POSIX shared memory name, e.g. "/battery-estimates"
+         * @param size size in bytes
+         */
+        SharedMemoryRegion(const std::string& name, size_t size);
+
+        /**
+         * @brief Map an existing shared memory object read only
+         * 
+         * @param name POSIX shared memory name
+         */
+        explicit SharedMemoryRegion(const std::string& name);
+
+        SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+        SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+        ~SharedMemoryRegion();
+
+        void* data() const;
+
+        size_t size() const;
+
+        bool writable() const;
+
+        const std::string& name() const;
+
+    private:
+        std::string regionName;
+        void* address;
+        size_t regionSize;
+        bool owner;
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+
+/**
+ * Bounded lock-free single producer single consumer ring buffer.
+ *
+ * Exactly one thread may push and exactly one (other) thread may pop.
+ * The producer and consumer indices live on separate cache lines and each side caches the other's index,
+ * so in steady state a push or pop touches no shared cache line except the slot itself.
+ */
+template <typename T>
+class SpscRing {
+    public:
+        /**
+         * @brief Constructor for SpscRing
+         * 
+         * @param capacity Number of slots, rounded up to a power of two (must be more than 0)
+         */
+        explicit SpscRing(size_t capacity);
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /**
+         * @brief Push an item if there is space (producer only)
+         * 
+         * @return false if the ring is full
+         */
+        bool tryPush(const T& item);
+
+        /**
+         * @brief Pop an item if there is one (consumer only)
+         * 
+         * @return false if the ring is empty
+         */
+        bool tryPop(T& item);
+
+        /**
+         * @brief Pop up to maxItems items at once (consumer only)
+         * 
+         * @return number of items written to out
+         */
+        size_t popBatch(T* out, size_t maxItems);
+
+        /**
+         * @brief Whether the ring looks empty, exact only when called by the consumer with the producer idle
+         */
+        bool empty() const;
+
+        size_t capacity() const;
+
+    private:
+        std::vector<T> slots;
+        size_t mask;
+
+        // Padding keeps the consumer's and producer's indices on separate cache lines.
+        char padding0[64];
+        std::atomic<size_t> head; // next slot to pop, written by the consumer
+        size_t cachedTail;
+        char padding1[64];
+        std::atomic<size_t> tail; // next slot to push, written by the producer
+        size_t cachedHead;
+        char padding2[64];
+};
+
+
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity) : head(0), cachedTail(0), tail(0), cachedHead(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument( "Capacity must grater then 0 got " + std::to_string(capacity) );
+    }
+
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    this->slots.resize(size);
+    this->mask = size - 1;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPush(const T& item) {
+    size_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - this->cachedHead > this->mask) {
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        if (tail - this->cachedHead > this->mask) {
+            return false;
+        }
+    }
+
+    this->slots[tail & this->mask] = item;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPop(T& item) {
+    return this->popBatch(&item, 1) == 1;
+}
+
+
+template <typename T>
+size_t SpscRing<T>::popBatch(T* out, size_t maxItems) {
+    size_t head = this->head.load(std::memory_order_relaxed);
+    if (this->cachedTail - head < maxItems) {
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+    }
+
+    size_t available = this->cachedTail - head;
+    size_t count = (available < maxItems) ? available : maxItems;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = this->slots[(head + i) & this->mask];
+    }
+
+    if (count > 0) {
+        this->head.store(head + count, std::memory_order_release);
+    }
+    return count;
+}
+
+
+template <typename T>
+bool SpscRing<T>::empty() const {
+    return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+}
+
+
+template <typename T>
+size_t SpscRing<T>::capacity() const {
+    return this->slots.size();
+}
@@ -0,0 +1,161 @@
+#include "WorkStealingPool.h"
+#include "numa.h"
+#include <algorithm>
+
+
+WorkStealingPool::WorkStealingPool(unsigned int threads, bool pinThreads)
+    : generation(0), busy(0), stopping(false), count(0), chunkSize(1), task(nullptr) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<int> nodes;
+    std::vector<int> cpus = numa_cpu_order(&nodes);
+
+    this->ranges = std::vector<Range>(threads);
+    this->victims.resize(threads);
+    for (unsigned int id = 0; id < threads; ++id) {
+        // Thread id runs on cpus[id % cpus.size()] when pinned, look for work on the same node first.
+        int node = nodes[id % nodes.size()];
+        for (unsigned int offset = 1; offset < threads; ++offset) {
+            unsigned int victim = (id + offset) % threads;
+            if (nodes[victim % nodes.size()] == node) {
+                this->victims[id].push_back(victim);
+            }
+        }
+        for (unsigned int offset = 1; offset < threads; ++offset) {
+            unsigned int victim = (id + offset) % threads;
+            if (nodes[victim % nodes.size()] != node) {
+                this->victims[id].push_back(victim);
+            }
+        }
+    }
+
+    // The caller is thread 0 and is never pinned.
+    this->workers.reserve(threads - 1);
+    for (unsigned int id = 1; id < threads; ++id) {
+        this->workers.emplace_back(&WorkStealingPool::workerLoop, this, id);
+        if (pinThreads) {
+            pin_thread_to_cpu(this->workers.back(), cpus[id % cpus.size()]);
+        }
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+
+unsigned int WorkStealingPool::size() const {
+    return this->ranges.size();
+}
+
+
+void WorkStealingPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    chunkSize = std::max<size_t>(1, chunkSize);
+
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+    size_t threads = this->ranges.size();
+    if (threads == 1 || chunks == 1) {
+        task(0, count);
+        return;
+    }
+
+    // Contiguous runs of chunks so each thread mostly walks memory in order.
+    for (size_t id = 0; id < threads; ++id) {
+        this->ranges[id].next.store(chunks * id / threads, std::memory_order_relaxed);
+        this->ranges[id].end = chunks * (id + 1) / threads;
+    }
+
+    this->count = count;
+    this->chunkSize = chunkSize;
+    this->task = &task;
+    this->error = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->busy = this->workers.size();
+        ++this->generation;
+    }
+    this->wake.notify_all();
+
+    this->runChunks(0);
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [this] { return this->busy == 0; });
+    }
+    this->task = nullptr;
+
+    if (this->error) {
+        std::rethrow_exception(this->error);
+    }
+}
+
+
+void WorkStealingPool::workerLoop(unsigned int id) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this, seen] { return this->stopping || this->generation != seen; });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+        }
+
+        this->runChunks(id);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            last = --this->busy == 0;
+        }
+        if (last) {
+            this->done.notify_one();
+        }
+    }
+}
+
+
+void WorkStealingPool::runChunks(unsigned int id) {
+    while (this->runChunk(this->ranges[id])) {
+    }
+
+    for (unsigned int victim : this->victims[id]) {
+        while (this->runChunk(this->ranges[victim])) {
+        }
+    }
+}
+
+
+bool WorkStealingPool::runChunk(Range& range) {
+    // Over claiming past the end is harmless, next only grows until the next loop resets it.
+    size_t chunk = range.next.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= range.end) {
+        return false;
+    }
+
+    size_t begin = chunk * this->chunkSize;
+    size_t end = std::min(this->count, begin + this->chunkSize);
+    try {
+        (*this->task)(begin, end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(this->errorMutex);
+        if (!this->error) {
+            this->error = std::current_exception();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Fixed size thread pool that runs data parallel loops with work stealing.
+ *
+ * parallelFor splits the iteration space into chunks and gives each thread a contiguous run of them.
+ * A thread that finishes its own run steals chunks from the others, preferring threads on the same NUMA node,
+ * so uneven chunk costs (e.g. estimators that need extra Newton iterations) do not leave threads idle.
+ * Claiming a chunk is a single atomic increment, there are no locks on the hot path.
+ *
+ * The calling thread takes part in every loop, so a pool of size 1 runs everything inline.
+ * Only one parallelFor may run at a time.
+ */
+class WorkStealingPool {
+    public:
+        /**
+         * @brief Constructor for WorkStealingPool
+         * 
+         * @param threads Total number of threads including the caller, 0 uses the hardware concurrency
+         * @param pinThreads Pin worker threads to CPUs, filling one NUMA node before the next
+         */
+        WorkStealingPool(unsigned int threads=0, bool pinThreads=false);
+
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /**
+         * @brief Run task(begin, end) over [0, count) in chunks and wait for it to finish
+         * 
+         * If a task throws, the remaining chunks are still run and the first exception is rethrown here.
+         * 
+         * @param count size of the iteration space
+         * @param chunkSize number of iterations claimed at a time (must be more than 0)
+         * @param task function called with each chunk's half open range
+         */
+        void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& task);
+
+        /**
+         * @brief Number of threads, including the calling thread
+         */
+        unsigned int size() const;
+
+    private:
+        // Each thread's run of chunks, padded so threads claiming chunks don't share a cache line.
+        // The vector's storage is only aligned to 16 bytes, so a 64 byte Range would straddle two lines;
+        // two lines of padding keep neighbouring next counters 128 bytes apart wherever the array starts.
+        struct Range {
+            std::atomic<size_t> next;
+            size_t end;
+            char padding[128 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<Range> ranges;
+        // Order in which each thread visits the others when stealing.
+        std::vector<std::vector<unsigned int>> victims;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        unsigned long generation;
+        unsigned int busy;
+        bool stopping;
+
+        size_t count;
+        size_t chunkSize;
+        const std::function<void(size_t, size_t)>* task;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        void workerLoop(unsigned int id);
+        void runChunks(unsigned int id);
+        bool runChunk(Range& range);
+};
@@ -0,0 +1,727 @@
+#include "accuracy.h"
+#include "wtls.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+#if defined(__SIZEOF_FLOAT128__)
+const ReferenceReal referenceEpsilon = std::ldexp(1.0, -112);
+#else
+const ReferenceReal referenceEpsilon = LDBL_EPSILON;
+#endif
+
+// Furthest a double root may be from a reference root (relative above 1, absolute below) and still match it.
+constexpr double matchTolerance = 1e-6;
+constexpr int maxDegree = 4;
+constexpr int maxRootIterations = 500;
+
+inline double scale_of(double x) {
+    return std::max(1.0, std::fabs(x));
+}
+
+inline ReferenceReal reference_abs(ReferenceReal x) {
+    return x < 0 ? -x : x;
+}
+
+// Long double square root refined by Newton steps, which only need arithmetic.
+ReferenceReal reference_sqrt(ReferenceReal value) {
+    if (!(value > 0)) {
+        return value == 0 ? value : ReferenceReal(std::numeric_limits<double>::quiet_NaN());
+    }
+    ReferenceReal root = std::sqrt(static_cast<long double>(value));
+    for (int i = 0; i < 2; ++i) {
+        root = (root + value / root) / 2;
+    }
+    return root;
+}
+
+ReferenceReal evaluate(const ReferenceReal* coefficients, int degree, ReferenceReal x) {
+    ReferenceReal value = coefficients[0];
+    for (int i = 1; i <= degree; ++i) {
+        value = value * x + coefficients[i];
+    }
+    return value;
+}
+
+// Sum of the absolute terms, how much the value can move when each coefficient is rounded.
+ReferenceReal evaluate_magnitude(const ReferenceReal* coefficients, int degree, ReferenceReal x) {
+    ReferenceReal size = reference_abs(x);
+    ReferenceReal value = reference_abs(coefficients[0]);
+    for (int i = 1; i <= degree; ++i) {
+        value = value * size + reference_abs(coefficients[i]);
+    }
+    return value;
+}
+
+ReferenceReal bracketed_root(
+    const ReferenceReal* coefficients, const ReferenceReal* derivative, int degree,
+    ReferenceReal low, ReferenceReal high
+) {
+    bool lowNegative = evaluate(coefficients, degree, low) < 0;
+    ReferenceReal x = (low + high) / 2;
+    for (int i = 0; i < maxRootIterations; ++i) {
+        ReferenceReal value = evaluate(coefficients, degree, x);
+        if (value == 0) {
+            break;
+        }
+        if ((value < 0) == lowNegative) {
+            low = x;
+        } else {
+            high = x;
+        }
+
+        ReferenceReal slope = evaluate(derivative, degree - 1, x);
+        ReferenceReal next = slope != 0 ? x - value / slope : (low + high) / 2;
+        if (!(next > low && next < high)) {
+            next = (low + high) / 2;
+        }
+        bool converged = reference_abs(next - x) <= referenceEpsilon * reference_abs(x)
+            || high - low <= referenceEpsilon * (reference_abs(low) + reference_abs(high));
+        x = next;
+        if (converged) {
+            break;
+        }
+    }
+    return x;
+}
+
+size_t real_roots(const ReferenceReal* coefficients, int degree, ReferenceReal* roots, bool* required) {
+    while (degree > 0 && coefficients[0] == 0) {
+        ++coefficients;
+        --degree;
+    }
+    if (degree <= 0) {
+        return 0;
+    }
+
+    ReferenceReal derivative[maxDegree];
+    for (int i = 0; i < degree; ++i) {
+        derivative[i] = coefficients[i] * (degree - i);
+    }
+
+    if (degree == 1) {
+        roots[0] = -coefficients[1] / coefficients[0];
+        if (required != nullptr) {
+            required[0] = true;
+        }
+        return 1;
+    }
+
+    // Every root lies within the Cauchy bound, and between consecutive stationary points there is at most one.
+    ReferenceReal bound = 0;
+    for (int i = 1; i <= degree; ++i) {
+        bound = std::max(bound, reference_abs(coefficients[i] / coefficients[0]));
+    }
+    bound += 1;
+
+    ReferenceReal points[maxDegree + 1];
+    size_t pointCount = 0;
+    points[pointCount++] = -bound;
+    pointCount += real_roots(derivative, degree - 1, points + pointCount, nullptr);
+    points[pointCount++] = bound;
+
+    ReferenceReal values[maxDegree + 1];
+    for (size_t i = 0; i < pointCount; ++i) {
+        values[i] = evaluate(coefficients, degree, points[i]);
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < pointCount; ++i) {
+        bool interior = i > 0 && i + 1 < pointCount;
+        if (interior) {
+            // A stationary point within rounding of 0 is a double root, or close enough to one that rounding
+            // the coefficients to double could make it one.
+            ReferenceReal magnitude = evaluate_magnitude(coefficients, degree, points[i]);
+            bool crossesBefore = (values[i - 1] < 0) != (values[i] < 0) && values[i - 1] != 0;
+            bool crossesAfter = (values[i + 1] < 0) != (values[i] < 0) && values[i + 1] != 0;
+            if (values[i] == 0 || (!crossesBefore && !crossesAfter && reference_abs(values[i]) <= 4 * DBL_EPSILON * magnitude)) {
+                roots[found] = points[i];
+                if (required != nullptr) {
+                    required[found] = false;
+                }
+                ++found;
+            }
+        }
+
+        if (i + 1 < pointCount && values[i] != 0 && values[i + 1] != 0 && (values[i] < 0) != (values[i + 1] < 0)) {
+            ReferenceReal root = bracketed_root(coefficients, derivative, degree, points[i], points[i + 1]);
+            roots[found] = root;
+            if (required != nullptr) {
+                // How far rounding the coefficients to double can move the root.
+                ReferenceReal slope = reference_abs(evaluate(derivative, degree - 1, root));
+                ReferenceReal movement = DBL_EPSILON * evaluate_magnitude(coefficients, degree, root);
+                required[found] = movement <= matchTolerance * scale_of(static_cast<double>(root)) * slope;
+            }
+            ++found;
+        }
+    }
+    return found;
+}
+
+/**
+ * Add the errors of the roots a double solver found to errors, and count roots that match no reference root
+ * or reference roots that were required but not found.
+ */
+void compare_roots(
+    const double* roots, size_t count, const ReferenceReal* reference, const bool* required, size_t referenceCount,
+    std::vector<double>& errors, size_t& failures
+) {
+    for (size_t i = 0; i < count; ++i) {
+        double nearest = std::numeric_limits<double>::infinity();
+        size_t nearestIndex = 0;
+        for (size_t j = 0; j < referenceCount; ++j) {
+            double distance = std::fabs(roots[i] - static_cast<double>(reference[j])) / scale_of(static_cast<double>(reference[j]));
+            if (distance < nearest) {
+                nearest = distance;
+                nearestIndex = j;
+            }
+        }
+        if (nearest <= matchTolerance) {
+            errors.push_back(ulp_error(roots[i], reference[nearestIndex]));
+        } else {
+            ++failures;
+        }
+    }
+
+    for (size_t j = 0; j < referenceCount; ++j) {
+        if (!required[j]) {
+            continue;
+        }
+        double scale = scale_of(static_cast<double>(reference[j]));
+        bool matched = false;
+        for (size_t i = 0; i < count && !matched; ++i) {
+            matched = std::fabs(roots[i] - static_cast<double>(reference[j])) / scale <= matchTolerance;
+        }
+        if (!matched) {
+            ++failures;
+        }
+    }
+}
+
+// Time whole passes over a sample, repeating until they have run for at least a millisecond.
+template <typename Pass>
+double nanoseconds_per_call(size_t count, Pass pass) {
+    double sink = 0.0;
+    size_t calls = 0;
+    std::chrono::steady_clock::duration elapsed(0);
+    do {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sink += pass();
+        elapsed += std::chrono::steady_clock::now() - start;
+        calls += count;
+    } while (count > 0 && elapsed < std::chrono::milliseconds(1));
+
+    volatile double keep = sink;
+    (void) keep;
+    return calls == 0 ? 0.0 : std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+template <typename Solver>
+AccuracyReport measure_root_accuracy(const PolynomialSample& sample, int degree, Solver solver) {
+    const std::vector<double>* columns[5] = {&sample.a, &sample.b, &sample.c, &sample.d, &sample.e};
+    size_t count = sample.a.size();
+
+    std::vector<double> errors;
+    size_t failures = 0;
+    double coefficients[maxDegree + 1];
+    double roots[maxDegree];
+    ReferenceReal reference[maxDegree];
+    bool required[maxDegree];
+
+    for (size_t i = 0; i < count; ++i) {
+        for (int k = 0; k <= degree; ++k) {
+            coefficients[k] = (*columns[k])[i];
+        }
+        size_t referenceCount = reference_real_roots(coefficients, degree, reference, required);
+        size_t found = solver(coefficients, roots);
+        compare_roots(roots, found, reference, required, referenceCount, errors, failures);
+    }
+
+    AccuracyReport report;
+    report.error = summarize_ulp_errors(errors, failures);
+    report.nanosecondsPerCall = nanoseconds_per_call(count, [&]() {
+        double sink = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            for (int k = 0; k <= degree; ++k) {
+                coefficients[k] = (*columns[k])[i];
+            }
+            size_t found = solver(coefficients, roots);
+            sink += found > 0 ? roots[0] : 0.0;
+        }
+        return sink;
+    });
+    return report;
+}
+
+// Reference versions of the closed forms in wtls.h, written out again in ReferenceReal.
+
+ReferenceReal reference_wtls_estimate(ReferenceReal c1, ReferenceReal c2, ReferenceReal c3, ReferenceReal ratioSq) {
+    if (ratioSq == 0 || c2 == 0) {
+        return 0;
+    }
+    ReferenceReal inner = c1 - ratioSq * c3;
+    return (-inner + reference_sqrt(inner * inner + 4 * ratioSq * c2 * c2)) / (2 * ratioSq * c2);
+}
+
+// 2 / Hessian of the merit function, what wtls_variance and wtls_estimate_variance compute.
+ReferenceReal reference_wtls_variance(ReferenceReal c1, ReferenceReal c2, ReferenceReal c3, ReferenceReal ratioSq, ReferenceReal estimate) {
+    ReferenceReal bottom = estimate * estimate * ratioSq + 1;
+    ReferenceReal top = -4 * ratioSq * ratioSq * c2 * estimate * estimate * estimate
+        + (6 * ratioSq * c3 - 6 * c1) * ratioSq * estimate * estimate
+        + 12 * ratioSq * c2 * estimate
+        + 2 * (c1 - ratioSq * c3);
+    return 2 * (bottom * bottom * bottom) / top;
+}
+
+ReferenceReal reference_dual_wtls_merit(const ReferenceReal* c, ReferenceReal estimate) {
+    ReferenceReal estimateSq = estimate * estimate;
+    ReferenceReal top = c[3] * estimateSq * estimateSq - 2 * c[4] * estimateSq * estimate
+        + (c[0] + c[5]) * estimateSq - 2 * c[1] * estimate + c[2];
+    ReferenceReal bottom = estimateSq + 1;
+    return top / (bottom * bottom);
+}
+
+ReferenceReal reference_dual_wtls_variance(const ReferenceReal* c, ReferenceReal estimate) {
+    ReferenceReal estimateSq = estimate * estimate;
+    ReferenceReal top = -2 * c[4] * estimateSq * estimateSq * estimate
+        + (3 * c[2] - 6 * c[3] + 3 * c[5]) * estimateSq * estimateSq
+        + (-12 * c[1] + 16 * c[4]) * estimateSq * estimate
+        + (-8 * c[0] + 10 * c[2] + 6 * c[3] - 8 * c[5]) * estimateSq
+        + (12 * c[1] - 6 * c[4]) * estimate
+        + c[0] - 2 * c[2] + c[5];
+    ReferenceReal bottom = estimateSq + 1;
+    return 2 * (bottom * bottom * bottom * bottom) / (2 * top);
+}
+
+// The stationary point quartic with its coefficients formed exactly, then the root of lowest merit.
+bool reference_dual_wtls_estimate(const ReferenceReal* c, ReferenceReal& estimate) {
+    ReferenceReal quartic[5] = {c[4], 2 * c[3] - c[0] - c[5], 3 * c[1] - 3 * c[4], c[0] - 2 * c[2] + c[5], -c[1]};
+    ReferenceReal roots[maxDegree];
+    size_t rootCount = real_roots(quartic, 4, roots, nullptr);
+
+    ReferenceReal bestMerit = 0;
+    for (size_t r = 0; r < rootCount; ++r) {
+        ReferenceReal merit = reference_dual_wtls_merit(c, roots[r]);
+        if (r == 0 || merit <= bestMerit) {
+            estimate = roots[r];
+            bestMerit = merit;
+        }
+    }
+    return rootCount > 0;
+}
+
+// Compare a double result against a reference, a failure if only one of them exists.
+void compare_value(double value, bool valueExists, ReferenceReal reference, bool referenceExists, std::vector<double>& errors, size_t& failures) {
+    if (valueExists != referenceExists) {
+        ++failures;
+    } else if (referenceExists) {
+        errors.push_back(ulp_error(value, reference));
+    }
+}
+
+class SampleRandom {
+    public:
+        explicit SampleRandom(uint64_t seed) : engine(seed) {}
+
+        double uniform(double low, double high) {
+            return std::uniform_real_distribution<double>(low, high)(this->engine);
+        }
+
+        double logUniform(double lowExponent, double highExponent) {
+            return std::pow(10.0, this->uniform(lowExponent, highExponent));
+        }
+
+        double sign() {
+            return this->engine() & 1 ? 1.0 : -1.0;
+        }
+
+        bool coin() {
+            return (this->engine() & 1) != 0;
+        }
+
+        double normal(double deviation) {
+            return std::normal_distribution<double>(0.0, deviation)(this->engine);
+        }
+
+    private:
+        std::mt19937_64 engine;
+};
+
+// Multiply a polynomial, highest power first, by (x - root).
+void multiply_root(std::vector<double>& polynomial, double root) {
+    polynomial.push_back(0.0);
+    for (size_t i = polynomial.size() - 1; i > 0; --i) {
+        polynomial[i] -= root * polynomial[i - 1];
+    }
+}
+
+// Multiply a polynomial by (x - re - i im)(x - re + i im).
+void multiply_complex_pair(std::vector<double>& polynomial, double re, double im) {
+    std::vector<double> result(polynomial.size() + 2, 0.0);
+    for (size_t i = 0; i < polynomial.size(); ++i) {
+        result[i] += polynomial[i];
+        result[i + 1] -= 2 * re * polynomial[i];
+        result[i + 2] += (re * re + im * im) * polynomial[i];
+    }
+    polynomial.swap(result);
+}
+
+std::vector<double> random_polynomial(SampleRandom& random, int degree) {
+    std::vector<double> polynomial(1, random.sign() * random.logUniform(-2, 2));
+    int remaining = degree;
+    if (degree >= 2 && random.coin()) {
+        multiply_complex_pair(polynomial, random.uniform(-10, 10), random.uniform(0.1, 10));
+        remaining -= 2;
+    }
+    for (int i = 0; i < remaining; ++i) {
+        multiply_root(polynomial, random.uniform(-10, 10));
+    }
+    return polynomial;
+}
+
+std::vector<double> sample_polynomial(SampleRandom& random, AccuracyCase accuracyCase, int degree) {
+    switch (accuracyCase) {
+        case AccuracyCase::Random:
+            return random_polynomial(random, degree);
+        case AccuracyCase::ClusteredRoots: {
+            std::vector<double> polynomial(1, random.sign() * random.logUniform(-2, 2));
+            int cluster = (degree >= 3 && random.coin()) ? 3 : 2;
+            double center = random.uniform(-10, 10);
+            double spread = random.logUniform(-9, -3);
+            for (int i = 0; i < cluster; ++i) {
+                multiply_root(polynomial, center * (1 + i * spread));
+            }
+            for (int i = cluster; i < degree; ++i) {
+                multiply_root(polynomial, random.uniform(-10, 10));
+            }
+            return polynomial;
+        }
+        case AccuracyCase::WideScale: {
+            std::vector<double> polynomial(1, random.sign() * random.logUniform(-2, 2));
+            for (int i = 0; i < degree; ++i) {
+                multiply_root(polynomial, random.sign() * random.logUniform(-6, 6));
+            }
+            return polynomial;
+        }
+        case AccuracyCase::NearDegenerate: {
+            // (epsilon x + 1) q(x): a tiny leading coefficient and one root near -1 / epsilon.
+            std::vector<double> polynomial = random_polynomial(random, degree - 1);
+            double epsilon = random.sign() * random.logUniform(-10, -4);
+            polynomial.push_back(0.0);
+            for (size_t i = polynomial.size() - 1; i > 0; --i) {
+                polynomial[i] += epsilon * polynomial[i - 1];
+            }
+            polynomial[0] *= epsilon;
+            return polynomial;
+        }
+    }
+    throw std::invalid_argument( "Unknown accuracy case" );
+}
+
+}
+
+
+const char* toString(AccuracyCase accuracyCase) {
+    switch (accuracyCase) {
+        case AccuracyCase::Random:
+            return "Random";
+        case AccuracyCase::ClusteredRoots:
+            return "ClusteredRoots";
+        case AccuracyCase::WideScale:
+            return "WideScale";
+        case AccuracyCase::NearDegenerate:
+            return "NearDegenerate";
+    }
+    return "Unknown";
+}
+
+
+double ulp_error(double value, ReferenceReal reference) {
+    if (!std::isfinite(value)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double size = std::max(std::fabs(static_cast<double>(reference)), DBL_MIN);
+    double ulp = std::nextafter(size, std::numeric_limits<double>::infinity()) - size;
+    return static_cast<double>(reference_abs(value - reference) / ulp);
+}
+
+
+UlpSummary summarize_ulp_errors(std::vector<double>& errors, size_t failures) {
+    UlpSummary summary = {errors.size(), failures, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (errors.empty()) {
+        return summary;
+    }
+    std::sort(errors.begin(), errors.end());
+
+    double total = 0.0;
+    for (double error : errors) {
+        total += error;
+    }
+    size_t last = errors.size() - 1;
+    summary.max = errors[last];
+    summary.mean = total / errors.size();
+    summary.p50 = errors[last / 2];
+    summary.p99 = errors[last * 99 / 100];
+    summary.p999 = errors[last * 999 / 1000];
+    return summary;
+}
+
+
+size_t reference_real_roots(const double* coefficients, int degree, ReferenceReal* roots, bool* required) {
+    if (degree < 0 || degree > maxDegree) {
+        throw std::invalid_argument( "Degree must be between 0 and 4 got " + std::to_string(degree) );
+    }
+    ReferenceReal exact[maxDegree + 1];
+    for (int i = 0; i <= degree; ++i) {
+        exact[i] = coefficients[i];
+    }
+    return real_roots(exact, degree, roots, required);
+}
+
+
+PolynomialSample generate_polynomials(AccuracyCase accuracyCase, int degree, size_t count, uint64_t seed) {
+    if (degree < 2 || degree > maxDegree) {
+        throw std::invalid_argument( "Degree must be between 2 and 4 got " + std::to_string(degree) );
+    }
+
+    PolynomialSample sample;
+    sample.degree = degree;
+    std::vector<double>* columns[5] = {&sample.a, &sample.b, &sample.c, &sample.d, &sample.e};
+    SampleRandom random(seed);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<double> polynomial = sample_polynomial(random, accuracyCase, degree);
+        for (int k = 0; k <= degree; ++k) {
+            columns[k]->push_back(polynomial[k]);
+        }
+    }
+    return sample;
+}
+
+
+StatisticsSample generate_statistics(AccuracyCase accuracyCase, size_t count, uint64_t seed) {
+    StatisticsSample sample;
+    SampleRandom random(seed);
+    for (size_t i = 0; i < count; ++i) {
+        double slope = random.sign() * random.uniform(0.1, 10);
+        double ratioSq = random.logUniform(-1, 1);
+        double xScale = 1.0;
+        double noise = 0.1;
+        int measurements = 20;
+        double xSpread = 10.0;
+
+        switch (accuracyCase) {
+            case AccuracyCase::Random:
+                break;
+            case AccuracyCase::ClusteredRoots:
+                noise = 1e-9;
+                break;
+            case AccuracyCase::WideScale:
+                slope = random.sign() * random.logUniform(-6, 6);
+                ratioSq = random.logUniform(-6, 6);
+                xScale = random.logUniform(-3, 3);
+                break;
+            case AccuracyCase::NearDegenerate:
+                measurements = 2;
+                xSpread = random.logUniform(-10, -6);
+                break;
+        }
+
+        double yVariance = 0.01 * random.logUniform(-1, 1);
+        double xVariance = yVariance * ratioSq;
+        double c[6] = {0, 0, 0, 0, 0, 0};
+        for (int m = 0; m < measurements; ++m) {
+            double x = xScale * (1 + random.uniform(0, xSpread));
+            double y = slope * x + noise * std::fabs(slope * x) * random.normal(1.0);
+            c[0] += x * x / yVariance;
+            c[1] += x * y / yVariance;
+            c[2] += y * y / yVariance;
+            c[3] += x * x / xVariance;
+            c[4] += x * y / xVariance;
+            c[5] += y * y / xVariance;
+        }
+
+        sample.c1.push_back(c[0]);
+        sample.c2.push_back(c[1]);
+        sample.c3.push_back(c[2]);
+        sample.c4.push_back(c[3]);
+        sample.c5.push_back(c[4]);
+        sample.c6.push_back(c[5]);
+        sample.varianceRatioSquared.push_back(ratioSq);
+    }
+    return sample;
+}
+
+
+AccuracyReport measure_quadratic_accuracy(const PolynomialSample& sample) {
+    return measure_root_accuracy(sample, 2, [](const double* p, double* roots) {
+        return calculate_real_roots(p[0], p[1], p[2], roots);
+    });
+}
+
+
+AccuracyReport measure_cubic_accuracy(const PolynomialSample& sample) {
+    return measure_root_accuracy(sample, 3, [](const double* p, double* roots) {
+        return calculate_real_roots(p[0], p[1], p[2], p[3], roots);
+    });
+}
+
+
+AccuracyReport measure_quartic_accuracy(QuarticMethod method, const PolynomialSample& sample) {
+    return measure_root_accuracy(sample, 4, [method](const double* p, double* roots) {
+        return calculate_real_roots(method, p[0], p[1], p[2], p[3], p[4], roots);
+    });
+}
+
+
+EstimatorAccuracyReport measure_wtls_accuracy(const StatisticsSample& sample) {
+    size_t count = sample.c1.size();
+    std::vector<double> estimateErrors;
+    std::vector<double> varianceErrors;
+    size_t estimateFailures = 0;
+    size_t varianceFailures = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double c1 = sample.c1[i], c2 = sample.c2[i], c3 = sample.c3[i], ratioSq = sample.varianceRatioSquared[i];
+        double estimate = wtls_estimate(c1, c2, c3, ratioSq);
+        double variance = wtls_variance(c1, c2, c3, ratioSq, estimate);
+
+        ReferenceReal referenceEstimate = reference_wtls_estimate(c1, c2, c3, ratioSq);
+        ReferenceReal referenceVariance = reference_wtls_variance(c1, c2, c3, ratioSq, referenceEstimate);
+        compare_value(estimate, std::isfinite(estimate), referenceEstimate, true, estimateErrors, estimateFailures);
+        compare_value(variance, std::isfinite(variance), referenceVariance, true, varianceErrors, varianceFailures);
+    }
+
+    EstimatorAccuracyReport report;
+    report.estimate = summarize_ulp_errors(estimateErrors, estimateFailures);
+    report.variance = summarize_ulp_errors(varianceErrors, varianceFailures);
+    report.nanosecondsPerCall = nanoseconds_per_call(count, [&]() {
+        double sink = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double estimate = wtls_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i]);
+            sink += wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i], estimate);
+        }
+        return sink;
+    });
+    return report;
+}
+
+
+EstimatorAccuracyReport measure_wtls_estimate_variance_accuracy(const StatisticsSample& sample) {
+    size_t count = sample.c1.size();
+    std::vector<double> estimateErrors;
+    std::vector<double> varianceErrors;
+    size_t estimateFailures = 0;
+    size_t varianceFailures = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double c1 = sample.c1[i], c2 = sample.c2[i], c3 = sample.c3[i], ratioSq = sample.varianceRatioSquared[i];
+        double estimate, variance;
+        wtls_estimate_variance(c1, c2, c3, ratioSq, estimate, variance);
+
+        ReferenceReal referenceEstimate = reference_wtls_estimate(c1, c2, c3, ratioSq);
+        ReferenceReal referenceVariance = reference_wtls_variance(c1, c2, c3, ratioSq, referenceEstimate);
+        compare_value(estimate, std::isfinite(estimate), referenceEstimate, true, estimateErrors, estimateFailures);
+        compare_value(variance, std::isfinite(variance), referenceVariance, true, varianceErrors, varianceFailures);
+    }
+
+    EstimatorAccuracyReport report;
+    report.estimate = summarize_ulp_errors(estimateErrors, estimateFailures);
+    report.variance = summarize_ulp_errors(varianceErrors, varianceFailures);
+    report.nanosecondsPerCall = nanoseconds_per_call(count, [&]() {
+        double sink = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double estimate, variance;
+            wtls_estimate_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.varianceRatioSquared[i], estimate, variance);
+            sink += variance;
+        }
+        return sink;
+    });
+    return report;
+}
+
+
+EstimatorAccuracyReport measure_dual_wtls_accuracy(const StatisticsSample& sample) {
+    size_t count = sample.c1.size();
+    std::vector<double> estimateErrors;
+    std::vector<double> varianceErrors;
+    size_t estimateFailures = 0;
+    size_t varianceFailures = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double c1 = sample.c1[i], c2 = sample.c2[i], c3 = sample.c3[i];
+        double c4 = sample.c4[i], c5 = sample.c5[i], c6 = sample.c6[i];
+        double estimate = 0.0;
+        bool found = dual_wtls_estimate(c1, c2, c3, c4, c5, c6, estimate) == EstimatorStatus::Ok;
+        double variance = found ? dual_wtls_variance(c1, c2, c3, c4, c5, c6, estimate) : 0.0;
+
+        ReferenceReal c[6] = {c1, c2, c3, c4, c5, c6};
+        ReferenceReal referenceEstimate = 0;
+        bool referenceFound = reference_dual_wtls_estimate(c, referenceEstimate);
+        ReferenceReal referenceVariance = referenceFound ? reference_dual_wtls_variance(c, referenceEstimate) : ReferenceReal(0);
+
+        compare_value(estimate, found && std::isfinite(estimate), referenceEstimate, referenceFound, estimateErrors, estimateFailures);
+        compare_value(variance, found && std::isfinite(variance), referenceVariance, referenceFound, varianceErrors, varianceFailures);
+    }
+
+    EstimatorAccuracyReport report;
+    report.estimate = summarize_ulp_errors(estimateErrors, estimateFailures);
+    report.variance = summarize_ulp_errors(varianceErrors, varianceFailures);
+    report.nanosecondsPerCall = nanoseconds_per_call(count, [&]() {
+        double sink = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double estimate = 0.0;
+            if (dual_wtls_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate) == EstimatorStatus::Ok) {
+                sink += dual_wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate);
+            }
+        }
+        return sink;
+    });
+    return report;
+}
+
+
+EstimatorAccuracyReport measure_dual_wtls_approximate_accuracy(const StatisticsSample& sample, int newtonSteps) {
+    size_t count = sample.c1.size();
+    std::vector<double> estimateErrors;
+    std::vector<double> varianceErrors;
+    size_t estimateFailures = 0;
+    size_t varianceFailures = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double c1 = sample.c1[i], c2 = sample.c2[i], c3 = sample.c3[i];
+        double c4 = sample.c4[i], c5 = sample.c5[i], c6 = sample.c6[i];
+        double estimate = dual_wtls_approximate_estimate(c1, c2, c3, c4, c5, c6, newtonSteps);
+        double variance = dual_wtls_variance(c1, c2, c3, c4, c5, c6, estimate);
+
+        ReferenceReal c[6] = {c1, c2, c3, c4, c5, c6};
+        ReferenceReal referenceEstimate = 0;
+        bool referenceFound = reference_dual_wtls_estimate(c, referenceEstimate);
+        ReferenceReal referenceVariance = referenceFound ? reference_dual_wtls_variance(c, referenceEstimate) : ReferenceReal(0);
+
+        // Without a real root the approximation still returns a number, it is only wrong where the exact solve isn't.
+        if (referenceFound) {
+            compare_value(estimate, std::isfinite(estimate), referenceEstimate, true, estimateErrors, estimateFailures);
+            compare_value(variance, std::isfinite(variance), referenceVariance, true, varianceErrors, varianceFailures);
+        }
+    }
+
+    EstimatorAccuracyReport report;
+    report.estimate = summarize_ulp_errors(estimateErrors, estimateFailures);
+    report.variance = summarize_ulp_errors(varianceErrors, varianceFailures);
+    report.nanosecondsPerCall = nanoseconds_per_call(count, [&]() {
+        double sink = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double estimate = dual_wtls_approximate_estimate(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], newtonSteps);
+            sink += dual_wtls_variance(sample.c1[i], sample.c2[i], sample.c3[i], sample.c4[i], sample.c5[i], sample.c6[i], estimate);
+        }
+        return sink;
+    });
+    return report;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "roots.h"
+
+// Differential accuracy harness: the double precision solvers and estimator closed forms measured against
+// references computed in higher precision, so a faster approximation can be accepted or rejected on
+// measured error as well as speed.
+
+
+/**
+ * Precision the references are computed in: __float128 (113 bit mantissa) where the compiler has it,
+ * long double otherwise. Only arithmetic is used, so no quad precision math library is needed.
+ */
+#if defined(__SIZEOF_FLOAT128__)
+typedef __float128 ReferenceReal;
+#else
+typedef long double ReferenceReal;
+#endif
+
+/**
+ * Families of inputs the harness samples, from benign to adversarial.
+ */
+enum class AccuracyCase {
+    Random = 0,     // well separated roots of moderate size / a noisy line with a moderate slope
+    ClusteredRoots, // two or three roots a relative 1e-9 to 1e-3 apart / a nearly perfect fit
+    WideScale,      // roots from 1e-6 to 1e6 in size / slopes and variance ratios from 1e-6 to 1e6
+    NearDegenerate  // a tiny leading coefficient, i.e. one huge root / two measurements with almost the same x
+};
+
+constexpr size_t accuracyCaseCount = 4;
+
+/**
+ * @brief Get a static name for an accuracy case
+ */
+const char* toString(AccuracyCase accuracyCase);
+
+/**
+ * Distribution of errors in units in the last place over a sample.
+ */
+struct UlpSummary {
+    size_t samples;  // number of errors measured
+    size_t failures; // missed or spurious roots, or a result that was not a number where the reference was
+    double max;
+    double mean;
+    double p50;
+    double p99;
+    double p999;
+};
+
+/**
+ * Accuracy and speed of a root solver over a sample.
+ */
+struct AccuracyReport {
+    UlpSummary error;
+    double nanosecondsPerCall;
+};
+
+/**
+ * Accuracy of an estimate and its variance, and speed of computing both, over a sample of statistics.
+ */
+struct EstimatorAccuracyReport {
+    UlpSummary estimate;
+    UlpSummary variance;
+    double nanosecondsPerCall;
+};
+
+/**
+ * Polynomials a x^4 + b x^3 + c x^2 + d x + e, only a to c are filled for quadratics and a to d for cubics.
+ */
+struct PolynomialSample {
+    int degree;
+    std::vector<double> a, b, c, d, e;
+};
+
+/**
+ * Recursive statistics c1 to c6 as the estimators hold them, with the squared variance ratio for
+ * VarianceWeightedTotalLeastSquares (DualVarianceWeightedTotalLeastSquares works in ratio scaled units).
+ */
+struct StatisticsSample {
+    std::vector<double> c1, c2, c3, c4, c5, c6, varianceRatioSquared;
+};
+
+/**
+ * Distance from value to reference in units in the last place of reference as a double
+ * (taken at the smallest normal double for references nearer 0). Infinite if value is not finite.
+ */
+double ulp_error(double value, ReferenceReal reference);
+
+/**
+ * Summarise a set of errors, sorting them in place.
+ */
+UlpSummary summarize_ulp_errors(std::vector<double>& errors, size_t failures=0);
+
+/**
+ * Real roots of a polynomial in ReferenceReal precision, by isolating each root between the stationary points
+ * (found recursively from the derivative) and bisection safeguarded Newton iteration.
+ *
+ * Roots a double solver can't be expected to resolve, i.e. double roots and roots whose position moves by more
+ * than a relative 1e-6 when the coefficients are rounded to double, are marked as not required.
+ *
+ * @param coefficients degree + 1 coefficients, highest power first (leading zeros lower the degree)
+ * @param roots caller provided storage for degree roots, set in ascending order
+ * @param required caller provided storage for degree flags, may be null
+ * @return number of real roots found
+ */
+size_t reference_real_roots(const double* coefficients, int degree, ReferenceReal* roots, bool* required);
+
+/**
+ * Sample polynomials of a degree (2 to 4) from an accuracy case, the same for a given seed.
+ */
+PolynomialSample generate_polynomials(AccuracyCase accuracyCase, int degree, size_t count, uint64_t seed);
+
+/**
+ * Sample estimator statistics from an accuracy case, the same for a given seed.
+ */
+StatisticsSample generate_statistics(AccuracyCase accuracyCase, size_t count, uint64_t seed);
+
+/**
+ * Error of calculate_real_roots(a, b, c, roots) over a sample of quadratics.
+ */
+AccuracyReport measure_quadratic_accuracy(const PolynomialSample& sample);
+
+/**
+ * Error of calculate_real_roots(a, b, c, d, roots) over a sample of cubics.
+ */
+AccuracyReport measure_cubic_accuracy(const PolynomialSample& sample);
+
+/**
+ * Error of calculate_real_roots(method, a, b, c, d, e, roots) over a sample of quartics.
+ */
+AccuracyReport measure_quartic_accuracy(QuarticMethod method, const PolynomialSample& sample);
+
+/**
+ * Error of wtls_estimate and wtls_variance over a sample of statistics.
+ */
+EstimatorAccuracyReport measure_wtls_accuracy(const StatisticsSample& sample);
+
+/**
+ * Error of wtls_estimate_variance over a sample of statistics, its variance against the exact 2 / Hessian.
+ */
+EstimatorAccuracyReport measure_wtls_estimate_variance_accuracy(const StatisticsSample& sample);
+
+/**
+ * Error of dual_wtls_estimate and dual_wtls_variance over a sample of statistics.
+ */
+EstimatorAccuracyReport measure_dual_wtls_accuracy(const StatisticsSample& sample);
+
+/**
+ * Error of dual_wtls_approximate_estimate and dual_wtls_variance at it over a sample of statistics,
+ * against the same reference as measure_dual_wtls_accuracy.
+ */
+EstimatorAccuracyReport measure_dual_wtls_approximate_accuracy(const StatisticsSample& sample, int newtonSteps);
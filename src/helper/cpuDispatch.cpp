@@ -0,0 +1,78 @@
+#include "cpuDispatch.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+IsaLevel detect() {
+#if CPU_DISPATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return IsaLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return IsaLevel::AVX2;
+    }
+#endif
+    return IsaLevel::Generic;
+}
+
+IsaLevel initialLevel() {
+    IsaLevel level = detected_isa_level();
+
+    const char* requested = std::getenv("RECURSIVE_OPTIMIZERS_ISA");
+    if (requested == nullptr) {
+        return level;
+    }
+
+    // An unknown name or a level the CPU lacks leaves the detected level, an override should never crash the fleet.
+    const IsaLevel levels[] = {IsaLevel::Generic, IsaLevel::AVX2, IsaLevel::AVX512};
+    for (IsaLevel candidate : levels) {
+        if (std::strcmp(requested, toString(candidate)) == 0 && candidate < level) {
+            return candidate;
+        }
+    }
+    return level;
+}
+
+std::atomic<int>& currentLevel() {
+    static std::atomic<int> level(static_cast<int>(initialLevel()));
+    return level;
+}
+
+}
+
+
+const char* toString(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::Generic:
+            return "generic";
+        case IsaLevel::AVX2:
+            return "avx2";
+        case IsaLevel::AVX512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+
+IsaLevel detected_isa_level() {
+    static const IsaLevel level = detect();
+    return level;
+}
+
+
+IsaLevel active_isa_level() {
+    return static_cast<IsaLevel>(currentLevel().load(std::memory_order_relaxed));
+}
+
+
+void set_isa_level(IsaLevel level) {
+    if (level > detected_isa_level()) {
+        throw std::invalid_argument( std::string("ISA level ") + toString(level) + " is not supported by this CPU" );
+    }
+    currentLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+}
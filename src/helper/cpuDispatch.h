@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+Run time selection between builds of a kernel for different instruction sets, so a single binary can use
+AVX2/AVX-512 where the CPU has them while the rest of the library is built with generic flags.
+
+A kernel is written once as an always inline body and instantiated as name_generic plus, on x86, name_avx2 and
+name_avx512 under the CPU_DISPATCH_TARGET_* attributes, then each call picks one with CPU_DISPATCH_SELECT(name).
+On anything other than x86 every level runs the generic build (NEON is part of the aarch64 baseline,
+so the generic build already uses it).
+
+The level is detected from the CPU on first use and can be lowered with the environment variable
+RECURSIVE_OPTIMIZERS_ISA (generic, avx2 or avx512), e.g. to rule out a vectorised kernel when chasing a difference.
+Builds for different levels may round differently because the wider targets contract multiply adds into FMAs.
+*/
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_DISPATCH_X86 1
+#define CPU_DISPATCH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define CPU_DISPATCH_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#else
+#define CPU_DISPATCH_X86 0
+#endif
+
+#define CPU_DISPATCH_INLINE inline __attribute__((always_inline))
+
+
+/**
+ * Instruction set levels a kernel can be built for, in increasing order.
+ */
+enum class IsaLevel {
+    Generic = 0,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief Get a static name for a level, the same names RECURSIVE_OPTIMIZERS_ISA accepts
+ */
+const char* toString(IsaLevel level);
+
+/**
+ * @brief Highest level the CPU supports
+ */
+IsaLevel detected_isa_level();
+
+/**
+ * @brief Level kernels currently run at, the detected level lowered by RECURSIVE_OPTIMIZERS_ISA if it is set
+ */
+IsaLevel active_isa_level();
+
+/**
+ * @brief Change the level kernels run at, e.g. to benchmark each level in one process
+ * 
+ * @param level level to use, must not be above detected_isa_level()
+ */
+void set_isa_level(IsaLevel level);
+
+/**
+ * @brief Pick the build of a kernel for a level
+ */
+template <typename Kernel>
+inline Kernel select_kernel(IsaLevel level, Kernel generic, Kernel avx2, Kernel avx512) {
+    switch (level) {
+        case IsaLevel::AVX512:
+            return avx512;
+        case IsaLevel::AVX2:
+            return avx2;
+        default:
+            return generic;
+    }
+}
+
+
+#if CPU_DISPATCH_X86
+#define CPU_DISPATCH_SELECT(name) select_kernel(active_isa_level(), name##_generic, name##_avx2, name##_avx512)
+#else
+#define CPU_DISPATCH_SELECT(name) name##_generic
+#endif
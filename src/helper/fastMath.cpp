@@ -0,0 +1,65 @@
+#include "fastMath.h"
+
+
+double fast_exp2(double x) {
+    if (x < -1022.0) {
+        return 0.0;
+    }
+    if (x > 1023.0) {
+        return INFINITY;
+    }
+    if (std::isnan(x)) {
+        return x;
+    }
+
+    // 2^x = 2^n * e^(f ln 2) with n the nearest integer, so |f ln 2| <= 0.347.
+    // Truncating conversion is much cheaper than std::nearbyint when SSE4.1 rounding isn't available.
+    double n = (double) (int64_t) (x + ((x < 0) ? -0.5 : 0.5));
+    double r = (x - n) * 0.693147180559945309417232121458;
+
+    // Taylor series of e^r to order 13, the truncation error is below 1e-17 for |r| <= 0.347.
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // Build 2^n directly from its exponent bits.
+    uint64_t bits = (uint64_t) ((int64_t) n + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+
+double integer_power(double base, unsigned int exponent) {
+    double result = 1.0;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result *= base;
+        }
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+
+double forgetting_decay(double forgettingFactor, double log2ForgettingFactor, double steps) {
+    if (forgettingFactor == 1.0) {
+        return 1.0;
+    }
+    if (steps <= 64.0 && steps == std::floor(steps)) {
+        return integer_power(forgettingFactor, (unsigned int) steps);
+    }
+    return fast_exp2(log2ForgettingFactor * steps);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+
+/**
+ * 2^x accurate to a few ulp (relative error below 1e-15) without calling std::pow or std::exp2.
+ * Returns 0 below 2^-1022 (no subnormals) and infinity above 2^1023.
+ */
+double fast_exp2(double x);
+
+/**
+ * base^exponent by repeated squaring, exact up to rounding for every step.
+ */
+double integer_power(double base, unsigned int exponent);
+
+/**
+ * Decay applied to recursive statistics after a number of sample periods with a forgetting factor,
+ * i.e. forgettingFactor^steps.
+ *
+ * Whole numbers of steps (up to 64) are computed exactly by repeated squaring,
+ * anything else uses fast_exp2(log2ForgettingFactor * steps).
+ *
+ * @param forgettingFactor forgetting factor per sample period (0 < f <= 1)
+ * @param log2ForgettingFactor precomputed std::log2(forgettingFactor)
+ * @param steps elapsed time in sample periods (must be at least 0)
+ */
+double forgetting_decay(double forgettingFactor, double log2ForgettingFactor, double steps);
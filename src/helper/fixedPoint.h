@@ -0,0 +1,350 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Q format fixed point arithmetic for targets without a floating point unit: integer only multiplies with rounding,
+// a Newton reciprocal in place of hardware division, a digit by digit square root and saturation instead of wrap around.
+
+
+/**
+ * Integer types a fixed point value of some storage is widened to for products.
+ */
+template <typename Storage>
+struct FixedPointTraits;
+
+template <>
+struct FixedPointTraits<int16_t> {
+    typedef int32_t Wide;
+    typedef uint32_t UnsignedWide;
+};
+
+template <>
+struct FixedPointTraits<int32_t> {
+    typedef int64_t Wide;
+    typedef uint64_t UnsignedWide;
+};
+
+#if defined(__SIZEOF_INT128__)
+template <>
+struct FixedPointTraits<int64_t> {
+    typedef __int128 Wide;
+    typedef unsigned __int128 UnsignedWide;
+};
+#endif
+
+
+/**
+ * Signed Q format number, raw / 2^FractionBits held in Storage.
+ *
+ * Arithmetic rounds to nearest and saturates at the ends of the range rather than wrapping.
+ * Conversions from and to double are only meant for the host, e.g. to set up parameters or check results.
+ *
+ * @tparam Storage int16_t, int32_t or (where the compiler has 128 bit integers) int64_t
+ * @tparam FractionBits number of fraction bits, leaving at least one integer bit
+ */
+template <typename Storage, int FractionBits>
+class FixedPoint {
+    public:
+        typedef typename FixedPointTraits<Storage>::Wide Wide;
+
+        static constexpr int bits = 8 * sizeof(Storage);
+        static constexpr int fractionBits = FractionBits;
+
+        static_assert(FractionBits > 0 && FractionBits < bits - 1, "FixedPoint needs at least one integer and one fraction bit");
+
+        constexpr FixedPoint() : value(0) {}
+
+        /**
+         * @brief Value with the given raw representation, i.e. raw / 2^FractionBits
+         */
+        static constexpr FixedPoint fromRaw(Storage raw) {
+            return FixedPoint(raw, 0);
+        }
+
+        /**
+         * @brief Nearest value to an integer, saturating
+         */
+        static FixedPoint fromInteger(long long integer);
+
+        /**
+         * @brief Nearest value to a double, saturating (NaN becomes 0)
+         */
+        static FixedPoint fromDouble(double value);
+
+        static constexpr FixedPoint one() {
+            return FixedPoint(static_cast<Storage>(Storage(1) << FractionBits), 0);
+        }
+
+        static constexpr FixedPoint max() {
+            return FixedPoint(std::numeric_limits<Storage>::max(), 0);
+        }
+
+        static constexpr FixedPoint min() {
+            return FixedPoint(std::numeric_limits<Storage>::min(), 0);
+        }
+
+        /**
+         * @brief Narrow a wide raw value to Storage, clamping it to the range
+         */
+        static Storage saturate(Wide raw);
+
+        constexpr Storage raw() const {
+            return this->value;
+        }
+
+        double toDouble() const;
+
+        FixedPoint operator+(FixedPoint other) const;
+        FixedPoint operator-(FixedPoint other) const;
+        FixedPoint operator-() const;
+        FixedPoint operator*(FixedPoint other) const;
+
+        bool operator==(FixedPoint other) const { return this->value == other.value; }
+        bool operator!=(FixedPoint other) const { return this->value != other.value; }
+        bool operator<(FixedPoint other) const { return this->value < other.value; }
+        bool operator<=(FixedPoint other) const { return this->value <= other.value; }
+        bool operator>(FixedPoint other) const { return this->value > other.value; }
+        bool operator>=(FixedPoint other) const { return this->value >= other.value; }
+
+        /**
+         * @brief Whether the value is at either end of the range, i.e. may have saturated
+         */
+        bool isSaturated() const {
+            return this->value == std::numeric_limits<Storage>::max() || this->value == std::numeric_limits<Storage>::min();
+        }
+
+    private:
+        Storage value;
+
+        constexpr FixedPoint(Storage raw, int) : value(raw) {}
+};
+
+
+/**
+ * Number of significant bits in value (0 for 0).
+ */
+inline int fixed_bit_length(uint32_t value) {
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+}
+
+inline int fixed_bit_length(uint64_t value) {
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+#if defined(__SIZEOF_INT128__)
+inline int fixed_bit_length(unsigned __int128 value) {
+    uint64_t high = static_cast<uint64_t>(value >> 64);
+    return high != 0 ? 64 + fixed_bit_length(high) : fixed_bit_length(static_cast<uint64_t>(value));
+}
+#endif
+
+/**
+ * value / 2^shift rounded to nearest (ties up), or value * 2^-shift for a negative shift. value * 2^-shift must fit.
+ */
+template <typename Integer>
+Integer fixed_round_shift(Integer value, int shift) {
+    if (shift <= 0) {
+        return value * (Integer(1) << -shift);
+    }
+    if (shift >= static_cast<int>(8 * sizeof(Integer)) - 1) {
+        return 0;
+    }
+    return (value + (Integer(1) << (shift - 1))) >> shift;
+}
+
+/**
+ * floor(sqrt(value)), one result bit per iteration.
+ */
+template <typename UnsignedInteger>
+UnsignedInteger fixed_integer_sqrt(UnsignedInteger value) {
+    if (value == 0) {
+        return 0;
+    }
+    UnsignedInteger root = 0;
+    UnsignedInteger bit = UnsignedInteger(1) << ((fixed_bit_length(value) - 1) & ~1);
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * 2^(2 bits - 3) / divisor for a divisor normalised to [2^(bits - 2), 2^(bits - 1)), i.e. the reciprocal of a value
+ * in [0.5, 1) with bits - 2 fraction bits. Newton iteration from the 48/17 - 32/17 d line, doubling the correct
+ * bits each time until they cover bits, so it is accurate to about an ulp.
+ *
+ * @tparam bits width of the storage the result is used with, the arithmetic is done in twice that
+ */
+template <int bits, typename UnsignedWide>
+UnsignedWide fixed_normalised_reciprocal(UnsignedWide divisor) {
+    typedef typename std::make_signed<UnsignedWide>::type Wide;
+    const UnsignedWide one = UnsignedWide(1) << (bits - 2);
+    const UnsignedWide initialOffset = (48 * one + 8) / 17;
+    const UnsignedWide initialSlope = (32 * one + 8) / 17;
+
+    UnsignedWide reciprocal = initialOffset - ((initialSlope * divisor) >> (bits - 1));
+    for (int correctBits = 4; correctBits < bits; correctBits *= 2) {
+        // reciprocal += reciprocal * (1 - divisor * reciprocal), with the error scaled down first so the product fits.
+        Wide error = static_cast<Wide>((UnsignedWide(1) << (2 * bits - 3)) - divisor * reciprocal);
+        Wide correction = fixed_round_shift<Wide>(static_cast<Wide>(reciprocal) * fixed_round_shift<Wide>(error, bits - 1), bits - 2);
+        reciprocal = static_cast<UnsignedWide>(static_cast<Wide>(reciprocal) + correction);
+    }
+    return reciprocal;
+}
+
+/**
+ * numerator / denominator * 2^shift as Storage, saturating where it doesn't fit (including a zero denominator).
+ * Only the leading bits - 1 bits of each operand are used, so the result is within about two ulp, and wide operands
+ * lose relative precision beyond that.
+ *
+ * @param saturated set when the result saturated, left alone otherwise
+ */
+template <typename Storage>
+Storage fixed_divide(typename FixedPointTraits<Storage>::Wide numerator, typename FixedPointTraits<Storage>::Wide denominator, int shift, bool& saturated) {
+    typedef typename FixedPointTraits<Storage>::Wide Wide;
+    typedef typename FixedPointTraits<Storage>::UnsignedWide UnsignedWide;
+    constexpr int bits = 8 * sizeof(Storage);
+
+    bool negative = (numerator < 0) != (denominator < 0);
+    UnsignedWide top = numerator < 0 ? UnsignedWide(0) - static_cast<UnsignedWide>(numerator) : static_cast<UnsignedWide>(numerator);
+    UnsignedWide bottom = denominator < 0 ? UnsignedWide(0) - static_cast<UnsignedWide>(denominator) : static_cast<UnsignedWide>(denominator);
+    if (top == 0) {
+        return 0;
+    }
+    if (bottom == 0) {
+        saturated = true;
+        return negative ? std::numeric_limits<Storage>::min() : std::numeric_limits<Storage>::max();
+    }
+
+    // Normalise both into [2^(bits - 2), 2^(bits - 1)) and keep track of the powers of two taken out.
+    int topLength = fixed_bit_length(top);
+    int bottomLength = fixed_bit_length(bottom);
+    top = topLength > bits - 1 ? top >> (topLength - (bits - 1)) : top << ((bits - 1) - topLength);
+    bottom = bottomLength > bits - 1 ? bottom >> (bottomLength - (bits - 1)) : bottom << ((bits - 1) - bottomLength);
+
+    // top * reciprocal is the quotient times 2^(2 bits - 3), and at least 2^(2 bits - 4).
+    UnsignedWide quotient = top * fixed_normalised_reciprocal<bits>(bottom);
+    int exponent = topLength - bottomLength + shift - (2 * bits - 3);
+    if (exponent >= 0) {
+        saturated = true;
+        return negative ? std::numeric_limits<Storage>::min() : std::numeric_limits<Storage>::max();
+    }
+
+    Wide magnitude = static_cast<Wide>(fixed_round_shift<UnsignedWide>(quotient, -exponent));
+    Storage result = FixedPoint<Storage, 1>::saturate(negative ? -magnitude : magnitude);
+    if (result == std::numeric_limits<Storage>::max() || result == std::numeric_limits<Storage>::min()) {
+        saturated = true;
+    }
+    return result;
+}
+
+/**
+ * numerator / denominator, saturating.
+ */
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> fixed_divide(FixedPoint<Storage, FractionBits> numerator, FixedPoint<Storage, FractionBits> denominator) {
+    bool saturated = false;
+    return FixedPoint<Storage, FractionBits>::fromRaw(fixed_divide<Storage>(numerator.raw(), denominator.raw(), FractionBits, saturated));
+}
+
+/**
+ * 1 / value, saturating.
+ */
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> fixed_reciprocal(FixedPoint<Storage, FractionBits> value) {
+    return fixed_divide(FixedPoint<Storage, FractionBits>::one(), value);
+}
+
+/**
+ * Square root, rounded down to the nearest representable value. Negative values give 0.
+ */
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> fixed_sqrt(FixedPoint<Storage, FractionBits> value) {
+    typedef typename FixedPointTraits<Storage>::UnsignedWide UnsignedWide;
+    if (value.raw() <= 0) {
+        return FixedPoint<Storage, FractionBits>();
+    }
+    // sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F)
+    UnsignedWide root = fixed_integer_sqrt<UnsignedWide>(static_cast<UnsignedWide>(value.raw()) << FractionBits);
+    return FixedPoint<Storage, FractionBits>::fromRaw(static_cast<Storage>(root));
+}
+
+
+template <typename Storage, int FractionBits>
+Storage FixedPoint<Storage, FractionBits>::saturate(Wide raw) {
+    if (raw > std::numeric_limits<Storage>::max()) {
+        return std::numeric_limits<Storage>::max();
+    }
+    if (raw < std::numeric_limits<Storage>::min()) {
+        return std::numeric_limits<Storage>::min();
+    }
+    return static_cast<Storage>(raw);
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::fromInteger(long long integer) {
+    const long long limit = static_cast<long long>(std::numeric_limits<Storage>::max() >> FractionBits);
+    if (integer > limit) {
+        return max();
+    }
+    if (integer < -limit - 1) {
+        return min();
+    }
+    return fromRaw(static_cast<Storage>(static_cast<Wide>(integer) * (Wide(1) << FractionBits)));
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::fromDouble(double value) {
+    double scaled = std::round(std::ldexp(value, FractionBits));
+    if (std::isnan(scaled)) {
+        return FixedPoint();
+    }
+    // Compare in double, the limits of a 64 bit Storage aren't exact doubles but the comparison still clamps correctly.
+    if (scaled >= static_cast<double>(std::numeric_limits<Storage>::max())) {
+        return max();
+    }
+    if (scaled <= static_cast<double>(std::numeric_limits<Storage>::min())) {
+        return min();
+    }
+    return fromRaw(static_cast<Storage>(scaled));
+}
+
+
+template <typename Storage, int FractionBits>
+double FixedPoint<Storage, FractionBits>::toDouble() const {
+    return std::ldexp(static_cast<double>(this->value), -FractionBits);
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::operator+(FixedPoint other) const {
+    return fromRaw(saturate(static_cast<Wide>(this->value) + other.value));
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::operator-(FixedPoint other) const {
+    return fromRaw(saturate(static_cast<Wide>(this->value) - other.value));
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::operator-() const {
+    return fromRaw(saturate(-static_cast<Wide>(this->value)));
+}
+
+
+template <typename Storage, int FractionBits>
+FixedPoint<Storage, FractionBits> FixedPoint<Storage, FractionBits>::operator*(FixedPoint other) const {
+    return fromRaw(saturate(fixed_round_shift<Wide>(static_cast<Wide>(this->value) * other.value, FractionBits)));
+}
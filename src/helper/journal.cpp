@@ -0,0 +1,323 @@
+#include "journal.h"
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+void write_all(int fd, const unsigned char* data, size_t size, const std::string& what) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "write " + what);
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+std::string parent_directory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    if (slash == 0) {
+        return "/";
+    }
+    return path.substr(0, slash);
+}
+
+}
+
+
+void put_varint(std::vector<unsigned char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+
+bool get_varint(const unsigned char*& data, const unsigned char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 70 && data < end; shift += 7) {
+        unsigned char byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void put_fixed64(std::vector<unsigned char>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+
+bool get_fixed64(const unsigned char*& data, const unsigned char* end, uint64_t& value) {
+    if (end - data < 8) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    data += 8;
+    return true;
+}
+
+
+uint64_t checksum_64(const unsigned char* data, size_t size) {
+    // Four independent lanes so the multiplies overlap instead of forming one long dependency chain.
+    const uint64_t prime = 0x100000001b3ull;
+    uint64_t lanes[4] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull, 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full};
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data + i + 8 * lane, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+
+    uint64_t hash = size;
+    for (int lane = 0; lane < 4; ++lane) {
+        hash = (hash ^ lanes[lane]) * prime;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash;
+}
+
+
+void write_file_atomically(const std::string& path, const std::vector<unsigned char>& data, bool sync) {
+    std::string temporary = path + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + temporary);
+    }
+    try {
+        write_all(fd, data.data(), data.size(), temporary);
+        if (sync && fsync(fd) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fsync " + temporary);
+        }
+    } catch (...) {
+        close(fd);
+        unlink(temporary.c_str());
+        throw;
+    }
+    close(fd);
+
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        int error = errno;
+        unlink(temporary.c_str());
+        throw std::system_error(error, std::generic_category(), "rename " + temporary);
+    }
+
+    if (sync) {
+        // The rename is only durable once the directory entry is.
+        int directory = open(parent_directory(path).c_str(), O_RDONLY | O_DIRECTORY);
+        if (directory >= 0) {
+            fsync(directory);
+            close(directory);
+        }
+    }
+}
+
+
+void append_to_file(int fd, const std::vector<unsigned char>& data, bool sync) {
+    write_all(fd, data.data(), data.size(), "journal");
+    if (sync && fdatasync(fd) != 0) {
+        throw std::system_error(errno, std::generic_category(), "fdatasync journal");
+    }
+}
+
+
+std::vector<unsigned char> read_file(const std::string& path, bool* exists) {
+    std::vector<unsigned char> data;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT && exists != nullptr) {
+            *exists = false;
+            return data;
+        }
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    if (exists != nullptr) {
+        *exists = true;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    data.resize(static_cast<size_t>(status.st_size));
+
+    size_t total = 0;
+    while (total < data.size()) {
+        ssize_t got = read(fd, data.data() + total, data.size() - total);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "read " + path);
+        }
+        if (got == 0) {
+            break;
+        }
+        total += static_cast<size_t>(got);
+    }
+    data.resize(total);
+    close(fd);
+    return data;
+}
+
+
+void put_word_delta(std::vector<unsigned char>& out, const uint64_t* reference, const uint64_t* words, size_t count) {
+    uint64_t mask = 0;
+    for (size_t w = 0; w < count; ++w) {
+        if (words[w] != reference[w]) {
+            mask |= uint64_t(1) << w;
+        }
+    }
+
+    put_varint(out, mask);
+    for (size_t w = 0; w < count; ++w) {
+        if (mask & (uint64_t(1) << w)) {
+            put_varint(out, words[w] ^ reference[w]);
+        }
+    }
+}
+
+
+bool get_word_delta(const unsigned char*& data, const unsigned char* end, uint64_t* words, size_t count) {
+    uint64_t mask;
+    if (!get_varint(data, end, mask) || (count < 64 && (mask >> count) != 0)) {
+        return false;
+    }
+
+    for (size_t w = 0; w < count; ++w) {
+        if (mask & (uint64_t(1) << w)) {
+            uint64_t delta;
+            if (!get_varint(data, end, delta)) {
+                return false;
+            }
+            words[w] ^= delta;
+        }
+    }
+    return true;
+}
+
+
+namespace {
+
+// Bytes of a packed delta word between its leading and trailing zero bytes.
+int packed_significant_bytes(uint64_t delta, int& trailing) {
+    if (delta == 0) {
+        trailing = 0;
+        return 0;
+    }
+    trailing = __builtin_ctzll(delta) / 8;
+    return 8 - trailing - __builtin_clzll(delta) / 8;
+}
+
+}
+
+
+void put_packed_word_delta(std::vector<unsigned char>& out, const uint64_t* reference, const uint64_t* words, size_t count) {
+    uint64_t mask = 0;
+    uint64_t raw = 0;
+    unsigned char headers[64];
+    uint64_t deltas[64];
+    for (size_t w = 0; w < count; ++w) {
+        if (words[w] == reference[w]) {
+            continue;
+        }
+        mask |= uint64_t(1) << w;
+
+        // Against the reference word, or whichever of the previous few words of this state leaves the fewest bytes.
+        int bestBytes = 8;
+        for (size_t back = 0; back <= packedMaxBack && back <= w; ++back) {
+            uint64_t delta = words[w] ^ (back == 0 ? reference[w] : words[w - back]);
+            int trailing;
+            int bytes = packed_significant_bytes(delta, trailing);
+            if (bytes < bestBytes) {
+                bestBytes = bytes;
+                headers[w] = static_cast<unsigned char>(bytes | (trailing << 3) | (back << 6));
+                deltas[w] = delta >> (8 * trailing);
+            }
+        }
+        if (bestBytes == 8) {
+            raw |= uint64_t(1) << w;
+        }
+    }
+
+    put_varint(out, mask);
+    put_varint(out, raw);
+    for (size_t w = 0; w < count; ++w) {
+        if (raw & (uint64_t(1) << w)) {
+            put_fixed64(out, words[w]);
+        } else if (mask & (uint64_t(1) << w)) {
+            out.push_back(headers[w]);
+            for (int b = 0; b < (headers[w] & 7); ++b) {
+                out.push_back(static_cast<unsigned char>(deltas[w] >> (8 * b)));
+            }
+        }
+    }
+}
+
+
+bool get_packed_word_delta(const unsigned char*& data, const unsigned char* end, uint64_t* words, size_t count) {
+    uint64_t mask;
+    uint64_t raw;
+    if (!get_varint(data, end, mask) || !get_varint(data, end, raw) || (raw & ~mask) != 0
+        || (count < 64 && (mask >> count) != 0)) {
+        return false;
+    }
+
+    for (size_t w = 0; w < count; ++w) {
+        if (raw & (uint64_t(1) << w)) {
+            if (!get_fixed64(data, end, words[w])) {
+                return false;
+            }
+        } else if (mask & (uint64_t(1) << w)) {
+            if (data == end) {
+                return false;
+            }
+            unsigned char header = *data++;
+            int bytes = header & 7;
+            int trailing = (header >> 3) & 7;
+            size_t back = header >> 6;
+            if (back > w || bytes + trailing > 8 || end - data < bytes) {
+                return false;
+            }
+
+            uint64_t delta = 0;
+            for (int b = 0; b < bytes; ++b) {
+                delta |= static_cast<uint64_t>(*data++) << (8 * b);
+            }
+            words[w] = (back == 0 ? words[w] : words[w - back]) ^ (delta << (8 * trailing));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/**
+ * Append value as an unsigned LEB128 varint (7 bits per byte, low bits first).
+ */
+void put_varint(std::vector<unsigned char>& out, uint64_t value);
+
+/**
+ * Read an unsigned LEB128 varint, advancing data.
+ *
+ * @return false if the varint runs past end or is longer than 10 bytes
+ */
+bool get_varint(const unsigned char*& data, const unsigned char* end, uint64_t& value);
+
+/**
+ * Append the raw little endian bytes of a fixed width value.
+ */
+void put_fixed64(std::vector<unsigned char>& out, uint64_t value);
+
+/**
+ * Read the raw little endian bytes of a fixed width value, advancing data.
+ *
+ * @return false if there are fewer than 8 bytes left
+ */
+bool get_fixed64(const unsigned char*& data, const unsigned char* end, uint64_t& value);
+
+/**
+ * 64 bit FNV-1a style hash taken a word at a time over four lanes, used to detect torn or corrupt journal records.
+ * Not cryptographic.
+ */
+uint64_t checksum_64(const unsigned char* data, size_t size);
+
+/**
+ * Replace a file by writing a temporary file next to it and renaming it over the original,
+ * so a crash leaves either the old or the new file but never a partial one.
+ *
+ * @param sync fsync the file and its directory before returning
+ */
+void write_file_atomically(const std::string& path, const std::vector<unsigned char>& data, bool sync);
+
+/**
+ * Append bytes to a file opened with O_APPEND.
+ *
+ * @param sync fdatasync after writing
+ */
+void append_to_file(int fd, const std::vector<unsigned char>& data, bool sync);
+
+/**
+ * Read a whole file.
+ *
+ * @param exists set to whether the file exists, a missing file is not an error
+ */
+std::vector<unsigned char> read_file(const std::string& path, bool* exists);
+
+/**
+ * Append the words that differ from a reference as a varint bit mask of the differing words followed by the
+ * XOR of each differing word with its reference as a varint.
+ *
+ * @param count number of words, at most 64
+ */
+void put_word_delta(std::vector<unsigned char>& out, const uint64_t* reference, const uint64_t* words, size_t count);
+
+/**
+ * Read a delta written by put_word_delta, XORing it into words, advancing data.
+ *
+ * @param words set to the reference the delta was taken against, on return holds the encoded words
+ * @return false if the delta is truncated or names a word past count
+ */
+bool get_word_delta(const unsigned char*& data, const unsigned char* end, uint64_t* words, size_t count);
+
+/**
+ * How many words back put_packed_word_delta looks for a word to take a delta against.
+ */
+constexpr size_t packedMaxBack = 3;
+
+/**
+ * Append the words that differ from a reference, each in at most 8 bytes, for states whose words are correlated.
+ *
+ * A varint bit mask of the differing words is followed by a varint mask of the ones stored as their raw 8 bytes.
+ * Every other differing word is XORed against its reference word or one of the packedMaxBack words before it
+ * (e.g. statistics with the same sign and exponent, or repeated ones), whichever leaves the fewest bytes between
+ * leading and trailing zero bytes. It is written as a header byte (byte count, trailing zero bytes and how far back)
+ * and those bytes.
+ *
+ * @param count number of words, at most 64
+ */
+void put_packed_word_delta(std::vector<unsigned char>& out, const uint64_t* reference, const uint64_t* words, size_t count);
+
+/**
+ * Read a delta written by put_packed_word_delta, advancing data.
+ *
+ * @param words set to the reference the delta was taken against, on return holds the encoded words
+ * @return false if the delta is truncated or names a word past count
+ */
+bool get_packed_word_delta(const unsigned char*& data, const unsigned char* end, uint64_t* words, size_t count);
@@ -0,0 +1,126 @@
+#include "numa.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// Parses the kernel cpulist format, e.g. "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return std::vector<int>();
+        }
+    }
+    return cpus;
+}
+
+}
+
+
+std::vector<std::vector<int>> numa_node_cpus() {
+    std::vector<int> allowed = allowed_cpus();
+    std::vector<bool> isAllowed;
+    for (int cpu : allowed) {
+        if (cpu >= (int) isAllowed.size()) {
+            isAllowed.resize(cpu + 1, false);
+        }
+        isAllowed[cpu] = true;
+    }
+
+    std::vector<std::vector<int>> nodes;
+    // Node ids can have gaps, so keep looking a little past the last one found.
+    for (int node = 0, missing = 0; missing < 8; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            ++missing;
+            continue;
+        }
+        missing = 0;
+
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(list)) {
+            if (cpu < (int) isAllowed.size() && isAllowed[cpu]) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+
+    if (nodes.empty()) {
+        nodes.push_back(allowed);
+    }
+    return nodes;
+}
+
+
+std::vector<int> numa_cpu_order(std::vector<int>* nodes) {
+    std::vector<int> order;
+    std::vector<std::vector<int>> topology = numa_node_cpus();
+    for (size_t node = 0; node < topology.size(); ++node) {
+        for (int cpu : topology[node]) {
+            order.push_back(cpu);
+            if (nodes != nullptr) {
+                nodes->push_back(node);
+            }
+        }
+    }
+    return order;
+}
+
+
+bool pin_thread_to_cpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
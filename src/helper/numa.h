@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <thread>
+
+
+/**
+ * CPUs of each NUMA node as reported by /sys/devices/system/node, restricted to the CPUs this process may run on.
+ * Falls back to a single node holding every allowed CPU when the topology is unavailable.
+ */
+std::vector<std::vector<int>> numa_node_cpus();
+
+/**
+ * Order in which to hand out CPUs to threads, filling one NUMA node before moving on to the next,
+ * so that threads given neighbouring work end up on the same node.
+ *
+ * @param nodes set to the NUMA node of each returned CPU, may be null
+ */
+std::vector<int> numa_cpu_order(std::vector<int>* nodes);
+
+/**
+ * Pin a thread to a single CPU.
+ *
+ * @return true on success, pinning is best effort and failure leaves the thread unpinned
+ */
+bool pin_thread_to_cpu(std::thread& thread, int cpu);
@@ -0,0 +1,397 @@
+#include "roots.h"
+#include <chrono>
+#include <limits>
+#include <Eigen/Dense>
+
+// Alternative quartic solvers to the modified NBS method in roots.cpp, and the calibration that picks between them.
+
+namespace {
+
+// Eigenvalues with an imaginary part below this (relative above 1) are taken as real roots.
+constexpr double companionImaginaryTolerance = 1e-6;
+
+inline double scale_of(double x) {
+    return std::max(1.0, std::fabs(x));
+}
+
+inline void newton_polish(double a, double b, double c, double d, double e, double* roots, size_t count, int iterations) {
+    for (size_t r = 0; r < count; ++r) {
+        for (int i = 0; i < iterations; ++i) {
+            double x = roots[r];
+            double function = (((a * x + b) * x + c) * x + d) * x + e;
+            double derivative = ((4.0 * a * x + 3.0 * b) * x + 2.0 * c) * x + d;
+            if (function == 0 || derivative == 0) {
+                break;
+            }
+            roots[r] = x - function / derivative;
+        }
+    }
+}
+
+/**
+ * Depressed form y^4 + p y^2 + q y + r of a quartic, with x = y + shift.
+ */
+struct DepressedQuartic {
+    double A;
+    double p;
+    double q;
+    double r;
+    double shift;
+
+    DepressedQuartic(double a, double b, double c, double d, double e) {
+        this->A = b / a;
+        double B = c / a;
+        double C = d / a;
+        double D = e / a;
+        double A2 = this->A * this->A;
+
+        this->p = B - 3.0 * A2 / 8.0;
+        this->q = C - this->A * B / 2.0 + A2 * this->A / 8.0;
+        this->r = D - this->A * C / 4.0 + A2 * B / 16.0 - 3.0 * A2 * A2 / 256.0;
+        this->shift = -this->A / 4.0;
+    }
+};
+
+/**
+ * Split a depressed quartic into (y^2 + s y + t1)(y^2 - s y + t2) with Ferrari's resolvent cubic.
+ */
+void ferrari_split(const DepressedQuartic& quartic, double& s, double& t1, double& t2) {
+    double p = quartic.p;
+    double q = quartic.q;
+    double r = quartic.r;
+
+    if (q != 0) {
+        // m^3 + p m^2 + (p^2/4 - r) m - q^2/8 is negative at 0, so it has a positive root.
+        double resolvent[3];
+        size_t count = calculate_real_roots(1.0, p, p * p / 4.0 - r, -q * q / 8.0, resolvent);
+        double m = *std::max_element(resolvent, resolvent + count);
+        if (m > 0) {
+            s = std::sqrt(2.0 * m);
+            t1 = p / 2.0 + m - q / (2.0 * s);
+            t2 = p / 2.0 + m + q / (2.0 * s);
+            return;
+        }
+    }
+
+    // Biquadratic y^4 + p y^2 + r.
+    double inner = p * p - 4.0 * r;
+    if (inner >= 0) {
+        double root = std::sqrt(inner);
+        s = 0.0;
+        t1 = (p + root) / 2.0;
+        t2 = (p - root) / 2.0;
+        return;
+    }
+    // (y^2 + sqrt(r))^2 - (2 sqrt(r) - p) y^2, r > p^2/4 >= 0 here.
+    double sqrtR = std::sqrt(r);
+    s = std::sqrt(std::max(0.0, 2.0 * sqrtR - p));
+    t1 = sqrtR;
+    t2 = sqrtR;
+}
+
+Eigen::Matrix4d companion_matrix(double a, double b, double c, double d, double e) {
+    Eigen::Matrix4d companion = Eigen::Matrix4d::Zero();
+    companion(1, 0) = 1.0;
+    companion(2, 1) = 1.0;
+    companion(3, 2) = 1.0;
+    companion(0, 3) = -e / a;
+    companion(1, 3) = -d / a;
+    companion(2, 3) = -c / a;
+    companion(3, 3) = -b / a;
+    return companion;
+}
+
+inline size_t quadratic_factor_roots(double alpha, double beta, double* roots) {
+    return calculate_real_roots(1.0, alpha, beta, roots);
+}
+
+size_t ferrari_roots(double a, double b, double c, double d, double e, double* roots) {
+    DepressedQuartic quartic(a, b, c, d, e);
+    double s, t1, t2;
+    ferrari_split(quartic, s, t1, t2);
+
+    size_t count = quadratic_factor_roots(s, t1, roots);
+    count += quadratic_factor_roots(-s, t2, roots + count);
+    for (size_t i = 0; i < count; ++i) {
+        roots[i] += quartic.shift;
+    }
+    return count;
+}
+
+size_t fast_quartic_roots(double a, double b, double c, double d, double e, double* roots) {
+    // Strobach's fast quartic solver refines a factorisation into two quadratics rather than the roots,
+    // which keeps close and double roots well conditioned. Start from Ferrari's split moved back to x.
+    DepressedQuartic quartic(a, b, c, d, e);
+    double s, t1, t2;
+    ferrari_split(quartic, s, t1, t2);
+
+    double A = quartic.A;
+    double B = c / a;
+    double C = d / a;
+    double D = e / a;
+
+    double alpha1 = A / 2.0 + s;
+    double beta1 = A * A / 16.0 + s * A / 4.0 + t1;
+    double alpha2 = A / 2.0 - s;
+    double beta2 = A * A / 16.0 - s * A / 4.0 + t2;
+
+    // Newton iteration on (x^2 + alpha1 x + beta1)(x^2 + alpha2 x + beta2) = x^4 + A x^3 + B x^2 + C x + D.
+    for (int i = 0; i < 4; ++i) {
+        Eigen::Vector4d residual(
+            alpha1 + alpha2 - A,
+            beta1 + beta2 + alpha1 * alpha2 - B,
+            alpha1 * beta2 + alpha2 * beta1 - C,
+            beta1 * beta2 - D
+        );
+        double size = scale_of(A) + scale_of(B) + scale_of(C) + scale_of(D);
+        if (residual.cwiseAbs().maxCoeff() <= 1e-15 * size) {
+            break;
+        }
+
+        Eigen::Matrix4d jacobian;
+        jacobian << 1.0,    0.0,    1.0,    0.0,
+                    alpha2, 1.0,    alpha1, 1.0,
+                    beta2,  alpha2, beta1,  alpha1,
+                    0.0,    beta2,  0.0,    beta1;
+        Eigen::Vector4d step = jacobian.partialPivLu().solve(residual);
+        if (!step.allFinite()) {
+            // Singular when the factors are equal (a double quadratic factor), Ferrari's split is as good as it gets.
+            break;
+        }
+        alpha1 -= step(0);
+        beta1 -= step(1);
+        alpha2 -= step(2);
+        beta2 -= step(3);
+    }
+
+    size_t count = quadratic_factor_roots(alpha1, beta1, roots);
+    count += quadratic_factor_roots(alpha2, beta2, roots + count);
+    return count;
+}
+
+/**
+ * Solve with the roots inverted (coefficients reversed) when that makes the cubic coefficient smaller relative to the
+ * leading one. One huge root makes b / a huge, and the shift to the depressed quartic then swamps the other roots.
+ */
+template <typename Solver>
+size_t solve_reoriented(Solver solver, double a, double b, double c, double d, double e, double* roots) {
+    if (e != 0 && std::fabs(d / e) < std::fabs(b / a)) {
+        size_t count = solver(e, d, c, b, a, roots);
+        // Polish before inverting, a root near 0 here is only accurate in absolute terms.
+        newton_polish(e, d, c, b, a, roots, count, 2);
+        for (size_t i = 0; i < count; ++i) {
+            roots[i] = 1.0 / roots[i];
+        }
+        return count;
+    }
+    return solver(a, b, c, d, e, roots);
+}
+
+}
+
+
+const char* toString(QuarticMethod method) {
+    switch (method) {
+        case QuarticMethod::NBS:
+            return "nbs";
+        case QuarticMethod::Ferrari:
+            return "ferrari";
+        case QuarticMethod::FastQuartic:
+            return "fast_quartic";
+        case QuarticMethod::Companion:
+            return "companion";
+    }
+    return "unknown";
+}
+
+
+size_t calculate_real_roots(QuarticMethod method, double a,double b,double c,double d,double e, double* roots) {
+    switch (method) {
+        case QuarticMethod::Ferrari:
+            return calculate_real_roots_ferrari(a,b,c,d,e,roots);
+        case QuarticMethod::FastQuartic:
+            return calculate_real_roots_fast_quartic(a,b,c,d,e,roots);
+        case QuarticMethod::Companion:
+            return calculate_real_roots_companion(a,b,c,d,e,roots);
+        default:
+            return calculate_real_roots_nbs(a,b,c,d,e,roots);
+    }
+}
+
+
+size_t calculate_real_roots_ferrari(double a,double b,double c,double d,double e, double* roots) {
+    if (a == 0) {
+        return calculate_real_roots(b,c,d,e,roots);
+    }
+
+    size_t count = solve_reoriented(ferrari_roots, a, b, c, d, e, roots);
+    newton_polish(a, b, c, d, e, roots, count, 2);
+    return count;
+}
+
+
+size_t calculate_real_roots_fast_quartic(double a,double b,double c,double d,double e, double* roots) {
+    if (a == 0) {
+        return calculate_real_roots(b,c,d,e,roots);
+    }
+
+    size_t count = solve_reoriented(fast_quartic_roots, a, b, c, d, e, roots);
+    newton_polish(a, b, c, d, e, roots, count, 1);
+    return count;
+}
+
+
+size_t calculate_real_roots_companion(double a,double b,double c,double d,double e, double* roots) {
+    if (a == 0) {
+        return calculate_real_roots(b,c,d,e,roots);
+    }
+
+    Eigen::EigenSolver<Eigen::Matrix4d> solver(companion_matrix(a, b, c, d, e), false);
+    if (solver.info() != Eigen::Success) {
+        return calculate_real_roots_nbs(a,b,c,d,e,roots);
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < 4; ++i) {
+        std::complex<double> value = solver.eigenvalues()(i);
+        if (std::fabs(value.imag()) <= companionImaginaryTolerance * scale_of(value.real())) {
+            roots[count++] = value.real();
+        }
+    }
+
+    newton_polish(a, b, c, d, e, roots, count, 2);
+    return count;
+}
+
+
+namespace {
+
+/**
+ * Reference roots for calibration, companion matrix eigenvalues polished in long double.
+ * Roots with a small imaginary part are optional: a method may find them (e.g. a near double root) or not.
+ */
+void reference_roots(
+    double a, double b, double c, double d, double e,
+    std::vector<double>& required, std::vector<double>& optional
+) {
+    required.clear();
+    optional.clear();
+    if (a == 0) {
+        double roots[3];
+        size_t count = calculate_real_roots(b, c, d, e, roots);
+        required.assign(roots, roots + count);
+        return;
+    }
+
+    Eigen::EigenSolver<Eigen::Matrix4d> solver(companion_matrix(a, b, c, d, e), false);
+
+    for (int i = 0; i < 4; ++i) {
+        std::complex<double> value = solver.eigenvalues()(i);
+        double imaginary = std::fabs(value.imag()) / scale_of(value.real());
+        if (imaginary > companionImaginaryTolerance) {
+            continue;
+        }
+
+        long double x = value.real();
+        for (int step = 0; step < 4; ++step) {
+            long double function = ((((long double) a * x + b) * x + c) * x + d) * x + e;
+            long double derivative = ((4.0L * a * x + 3.0L * b) * x + 2.0L * c) * x + d;
+            if (function == 0 || derivative == 0) {
+                break;
+            }
+            x -= function / derivative;
+        }
+        (imaginary <= 1e-10 ? required : optional).push_back((double) x);
+    }
+}
+
+double root_error(const double* roots, size_t count, const std::vector<double>& required, const std::vector<double>& optional) {
+    double error = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double nearest = std::numeric_limits<double>::infinity();
+        for (double reference : required) {
+            nearest = std::min(nearest, std::fabs(roots[i] - reference) / scale_of(reference));
+        }
+        for (double reference : optional) {
+            nearest = std::min(nearest, std::fabs(roots[i] - reference) / scale_of(reference));
+        }
+        error = std::max(error, nearest);
+    }
+    for (double reference : required) {
+        double nearest = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < count; ++i) {
+            nearest = std::min(nearest, std::fabs(roots[i] - reference) / scale_of(reference));
+        }
+        error = std::max(error, nearest);
+    }
+    // Not a number (e.g. from a NaN root) is as bad as a missed root.
+    return std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+}
+
+}
+
+
+QuarticCalibration calibrate_quartic_method(
+    const double* a, const double* b, const double* c, const double* d, const double* e,
+    size_t count, double tolerance
+) {
+    const QuarticMethod methods[quarticMethodCount] = {
+        QuarticMethod::NBS, QuarticMethod::Ferrari, QuarticMethod::FastQuartic, QuarticMethod::Companion
+    };
+
+    QuarticCalibration calibration;
+    std::vector<double> required;
+    std::vector<double> optional;
+    double roots[4];
+
+    for (size_t m = 0; m < quarticMethodCount; ++m) {
+        calibration.maxError[m] = 0.0;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        reference_roots(a[i], b[i], c[i], d[i], e[i], required, optional);
+        for (size_t m = 0; m < quarticMethodCount; ++m) {
+            size_t found = calculate_real_roots(methods[m], a[i], b[i], c[i], d[i], e[i], roots);
+            calibration.maxError[m] = std::max(calibration.maxError[m], root_error(roots, found, required, optional));
+        }
+    }
+
+    // Time whole passes over the sample, repeating until each method has run for at least a millisecond.
+    for (size_t m = 0; m < quarticMethodCount; ++m) {
+        double sink = 0.0;
+        size_t solves = 0;
+        std::chrono::steady_clock::duration elapsed(0);
+        do {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                size_t found = calculate_real_roots(methods[m], a[i], b[i], c[i], d[i], e[i], roots);
+                sink += found > 0 ? roots[0] : 0.0;
+            }
+            elapsed += std::chrono::steady_clock::now() - start;
+            solves += count;
+        } while (count > 0 && elapsed < std::chrono::milliseconds(1));
+
+        volatile double keep = sink;
+        (void) keep;
+        calibration.nanosecondsPerSolve[m] = (solves == 0) ? 0.0
+            : std::chrono::duration<double, std::nano>(elapsed).count() / solves;
+    }
+
+    int best = -1;
+    for (size_t m = 0; m < quarticMethodCount; ++m) {
+        if (calibration.maxError[m] <= tolerance
+            && (best == -1 || calibration.nanosecondsPerSolve[m] < calibration.nanosecondsPerSolve[best])) {
+            best = static_cast<int>(m);
+        }
+    }
+    if (best == -1) {
+        best = 0;
+        for (size_t m = 1; m < quarticMethodCount; ++m) {
+            if (calibration.maxError[m] < calibration.maxError[best]) {
+                best = static_cast<int>(m);
+            }
+        }
+    }
+
+    calibration.method = methods[best];
+    return calibration;
+}
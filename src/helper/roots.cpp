@@ -1,4 +1,5 @@
 #include "roots.h"
+#include <limits>
 
 // ignore complex and imaganery roots
 
@@ -123,8 +124,9 @@ double approximate_2_cos_arccos_over_3(double x) {
 }
 
 double calculate_real_root_helper(double b,double c,double d) {
-    std::vector<double> v = calculate_real_roots(1.0,b,c,d);
-    return *max_element(v.begin(), v.end());
+    double roots[3];
+    size_t count = calculate_real_roots(1.0,b,c,d,roots);
+    return *std::max_element(roots, roots + count);
 }
 
 inline double safe_sqrt(double value) {
@@ -197,33 +199,38 @@ inline double newton_step(double x, double a, double b, double c, double d, doub
     
 }
 
-inline double newton_step(double x, double a, double b, double c, double d) {
-    // https://arxiv.org/pdf/2003.00372v1
-    double xSq = x * x;
-
-    double function = xSq * x * a + xSq * b + x * c + d;
-    double dir1 = 3.0 * xSq * x * a + 2.0 * x * b + c;
-    double dir2 = 6.0 * x * a + 2.0 * b;
-    double dir3 = 6.0 * a;
+// Newton's method on a x^3 + b x^2 + c x + d, stopping once a step no longer reduces the residual.
+inline double polish_cubic_root(double x, double a, double b, double c, double d) {
+    double value = ((a * x + b) * x + c) * x + d;
+    for (int i = 0; i < 8 && value != 0; i++) {
+        double slope = (3.0 * a * x + 2.0 * b) * x + c;
+        if (slope == 0) {
+            break;
+        }
+        double next = x - value / slope;
+        double nextValue = ((a * next + b) * next + c) * next + d;
+        if (!(std::fabs(nextValue) < std::fabs(value))) {
+            break;
+        }
+        x = next;
+        value = nextValue;
+    }
+    return x;
+}
 
-    // max of p(j)(x) / j!
-    double A = std::max(
-        std::max(fabs(function),fabs(dir1)),
-        std::max(fabs(dir2)/2.0, fabs(dir3)/6.0)
-    );
 
-    // as all are real there complex conjagate are equal
-    return x - function * dir1 / (9.0 * A * A);
 }
 
 
-}
 
+size_t calculate_real_roots(double a,double b,double c,double d,double e, double* roots) {
+    return calculate_real_roots_nbs(a,b,c,d,e,roots);
+}
 
 
-std::vector<double> calculate_real_roots(double a,double b,double c,double d,double e) {
+size_t calculate_real_roots_nbs(double a,double b,double c,double d,double e, double* roots) {
     if (a == 0) {
-        return calculate_real_roots(b,c,d,e);
+        return calculate_real_roots(b,c,d,e,roots);
     }
 
     // https://quarticequations.com/Quartic2.pdf use modifyed NBS method
@@ -252,24 +259,24 @@ std::vector<double> calculate_real_roots(double a,double b,double c,double d,dou
     double inner1 = p1*p1/4.0 - q1;
     double inner2 = p2*p2/4.0 - q2;
 
-    std::vector<double> roots;
+    size_t count = 0;
 
     if (inner1 >= MIN_ZERO ) {
         double root = safe_sqrt(inner1);
-        roots.push_back(-p1/2.0 + root);
-        roots.push_back(-p1/2.0 - root);
+        roots[count++] = -p1/2.0 + root;
+        roots[count++] = -p1/2.0 - root;
     }
 
     if (inner2 >= MIN_ZERO ) {
         double root = safe_sqrt(inner2);
-        roots.push_back(-p2/2.0 + root);
-        roots.push_back(-p2/2.0 - root);
+        roots[count++] = -p2/2.0 + root;
+        roots[count++] = -p2/2.0 - root;
     }
 
-    for (std::vector<double>::iterator it = roots.begin(); it != roots.end(); ++it) {
+    for (size_t r = 0; r < count; ++r) {
         for (int i = 0; i < 10; i++) {
         
-            double x = *it;
+            double x = roots[r];
             double x2 = x*x;
             double x3 = x2*x;
             double x4 = x2*x2;
@@ -280,79 +287,125 @@ std::vector<double> calculate_real_roots(double a,double b,double c,double d,dou
             }
 
             
-            *it = newton_step(x,a,b,c,d,e);
+            roots[r] = newton_step(x,a,b,c,d,e);
         }
     }
     
-    return roots;
+    return count;
 }
 
 
-std::vector<double> calculate_real_roots(double a,double b,double c,double d) {
-    if (abs(a) <= 1e-8) {
-        return calculate_real_roots(b,c,d);
+size_t calculate_real_roots(double a,double b,double c,double d, double* roots) {
+    if (a == 0) {
+        return calculate_real_roots(b,c,d,roots);
     }
 
-    // https://proofwiki.org/wiki/Cardano%27s_Formula
-    double Q = (3.0*a*c - b*b) / (9.0*a*a);
-    double R = (9.0*a*b*c - 27.0*a*a*d - 2.0*b*b*b) / (54.0*a*a*a);
-
-    std::vector<double> roots;
-    double D = Q*Q*Q + R*R;
-    if (D > 0) {
-        double inner = sqrt(D);
-        double S = cbrt(R+inner);
-        double T = cbrt(R-inner);
+    // Work on the monic cubic, a leading coefficient too small to divide by leaves the quadratic.
+    double B = b / a;
+    double C = c / a;
+    double D = d / a;
+    if (!std::isfinite(B) || !std::isfinite(C) || !std::isfinite(D)) {
+        return calculate_real_roots(b,c,d,roots);
+    }
 
-        
-        roots = std::vector<double>({
-            S + T - b / (3.0*a)
-        });
-    } else if (D >= MIN_ZERO) {
-        double S = cbrt(R);
-        roots = std::vector<double>({
-            2.0 * S - b / (3.0*a),
-            -S - b / (3.0*a)
-        });
+    // Find one simple root, https://proofwiki.org/wiki/Cardano%27s_Formula
+    double Q = (3.0*C - B*B) / 9.0;
+    double R = (9.0*B*C - 27.0*D - 2.0*B*B*B) / 54.0;
+    double shift = -B / 3.0;
+
+    double root;
+    double discriminant = Q*Q*Q + R*R;
+    if (discriminant >= 0) {
+        // The only real root (or the simple one of a double root), with S and T = -Q / S taken so they don't cancel.
+        double S = cbrt(R + std::copysign(sqrt(discriminant), R));
+        double T = (S == 0) ? 0.0 : -Q / S;
+        root = S + T + shift;
     } else {
         // https://proofwiki.org/wiki/Cardano%27s_Formula/Trigonometric_Form
-        double sqQ = safe_sqrt(-Q);
-        double ratio = R / safe_sqrt(-(Q*Q*Q));
-        double part2 = -b / (3.0*a);
-        
-        roots = std::vector<double>({
-            sqQ * approximate_2_cos_arccos_over_3(ratio) + part2,
-            -sqQ * approximate_2_cos_arccos_over_3(-ratio) + part2, // cos(arccos(x)/3 + 2 * pi / 3) = -cos(arccos(-x)/3)
-            sqQ * approximate_2_cos_arccos_over_3_plus_4pi_over_3(ratio) + part2
-        });
+        // Of the largest and smallest of the three, take the one further from the middle root, so it isn't half of a near double root.
+        double sqQ = sqrt(-Q);
+        double ratio = std::max(-1.0, std::min(1.0, R / sqrt(-(Q*Q*Q))));
+        double largest = sqQ * approximate_2_cos_arccos_over_3(ratio);
+        double smallest = -sqQ * approximate_2_cos_arccos_over_3(-ratio); // cos(arccos(x)/3 + 2 * pi / 3) = -cos(arccos(-x)/3)
+        double middle = sqQ * approximate_2_cos_arccos_over_3_plus_4pi_over_3(ratio);
+        root = ((largest - middle > middle - smallest) ? largest : smallest) + shift;
     }
-
-    for (std::vector<double>::iterator it = roots.begin(); it != roots.end(); ++it) {
-        for (int i = 0; i < 5; i++) {
-            *it = newton_step(*it,a,b,c,d);
-        }
+    if (!std::isfinite(root)) {
+        return calculate_real_roots(b,c,d,roots);
+    }
+    roots[0] = polish_cubic_root(root,a,b,c,d);
+
+    // Divide out (x - root) leaving x^2 + p x + q, from the constant term when the root is larger than the other two
+    // (their product is q) and from the leading term otherwise, the directions that don't amplify rounding.
+    double p;
+    double q;
+    if (std::fabs(roots[0]) * roots[0] * roots[0] > std::fabs(D)) {
+        q = -D / roots[0];
+        p = (q - C) / roots[0];
+    } else {
+        p = B + roots[0];
+        q = C + roots[0] * p;
     }
 
-    return roots;
+    size_t count = 1 + calculate_real_roots(1.0,p,q,roots + 1);
+    for (size_t r = 1; r < count; ++r) {
+        roots[r] = polish_cubic_root(roots[r],a,b,c,d);
+    }
+    return count;
 }
 
 
-std::vector<double> calculate_real_roots(double a,double b,double c) {
+size_t calculate_real_roots(double a,double b,double c, double* roots) {
     if (a == 0) {
-        return std::vector<double>({-c / b});
+        roots[0] = -c / b;
+        return 1;
     }
-    double inner = b*b-4.0*a*c;
-    if (inner > 0) {
-        inner = sqrt(inner);
-        return std::vector<double>({
-            (-b+inner)/(2.0*a),
-            (-b-inner)/(2.0*a)
-        });
-    } else if (inner >= MIN_ZERO) {
-        return std::vector<double>({
-            -b/(2.0*a)
-        });
+
+    // A discriminant within the rounding of b^2 - 4ac of 0 is a double root.
+    double discriminant = b*b - 4.0*a*c;
+    double tolerance = 4.0 * std::numeric_limits<double>::epsilon() * (b*b + std::fabs(4.0*a*c));
+    if (discriminant > tolerance) {
+        // Take the root where -b and the square root add, and the other from their product c / a, so neither cancels.
+        // (-b + sqrt) / 2a first as before.
+        double q = -0.5 * (b + std::copysign(sqrt(discriminant), b));
+        roots[0] = std::signbit(b) ? q / a : c / q;
+        roots[1] = std::signbit(b) ? c / q : q / a;
+        return 2;
+    } else if (discriminant >= -tolerance) {
+        roots[0] = -b/(2.0*a);
+        return 1;
     } else {
-        return std::vector<double>();
+        return 0;
+    }
+}
+
+
+std::vector<double> calculate_real_roots(double a,double b,double c,double d,double e) {
+    double roots[4];
+    size_t count = calculate_real_roots(a,b,c,d,e,roots);
+    return std::vector<double>(roots, roots + count);
+}
+
+
+std::vector<double> calculate_real_roots(double a,double b,double c,double d) {
+    double roots[3];
+    size_t count = calculate_real_roots(a,b,c,d,roots);
+    return std::vector<double>(roots, roots + count);
+}
+
+
+std::vector<double> calculate_real_roots(double a,double b,double c) {
+    double roots[2];
+    size_t count = calculate_real_roots(a,b,c,roots);
+    return std::vector<double>(roots, roots + count);
+}
+
+
+void calculate_real_roots_batch(
+    const double* a, const double* b, const double* c, const double* d, const double* e,
+    size_t count, double* roots, unsigned char* rootCounts, QuarticMethod method
+) {
+    for (size_t i = 0; i < count; ++i) {
+        rootCounts[i] = static_cast<unsigned char>(calculate_real_roots(method, a[i], b[i], c[i], d[i], e[i], roots + 4 * i));
     }
-}
\ No newline at end of file
+}
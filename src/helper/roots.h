@@ -12,3 +12,79 @@ std::vector<double> calculate_real_roots(double a,double b,double c,double d,dou
 std::vector<double> calculate_real_roots(double a,double b,double c,double d);
 
 std::vector<double> calculate_real_roots(double a,double b,double c);
+
+// Non allocating versions, roots must have room for 4, 3 and 2 roots respectively, returns the number of real roots found.
+
+// The quartic version uses QuarticMethod::NBS, pass a QuarticMethod to calculate_real_roots for another.
+
+size_t calculate_real_roots(double a,double b,double c,double d,double e, double* roots);
+
+size_t calculate_real_roots(double a,double b,double c,double d, double* roots);
+
+size_t calculate_real_roots(double a,double b,double c, double* roots);
+
+/**
+ * Algorithms for the real roots of a quartic, all fall back to the cubic solver when a is 0.
+ */
+enum class QuarticMethod {
+    NBS = 0,     // modified NBS method with Newton polishing, the original solver
+    Ferrari,     // Ferrari's resolvent cubic split into two quadratics, with Newton polishing
+    FastQuartic, // Strobach style, Ferrari's split refined by Newton iteration on the quadratic factors
+    Companion    // eigenvalues of the companion matrix (Eigen), slow but robust for near degenerate quartics
+};
+
+constexpr size_t quarticMethodCount = 4;
+
+/**
+ * @brief Get a static name for a quartic method
+ */
+const char* toString(QuarticMethod method);
+
+/**
+ * @brief Real roots of a quartic with a given method, roots must have room for 4, returns the number of real roots found.
+ */
+size_t calculate_real_roots(QuarticMethod method, double a,double b,double c,double d,double e, double* roots);
+
+size_t calculate_real_roots_nbs(double a,double b,double c,double d,double e, double* roots);
+
+size_t calculate_real_roots_ferrari(double a,double b,double c,double d,double e, double* roots);
+
+size_t calculate_real_roots_fast_quartic(double a,double b,double c,double d,double e, double* roots);
+
+size_t calculate_real_roots_companion(double a,double b,double c,double d,double e, double* roots);
+
+/**
+ * Result of calibrate_quartic_method, indexed by QuarticMethod.
+ */
+struct QuarticCalibration {
+    QuarticMethod method; // fastest method within the tolerance, or the most accurate if none are
+    double nanosecondsPerSolve[quarticMethodCount];
+    double maxError[quarticMethodCount]; // largest distance to a reference root (relative above 1), infinite if a root was missed or spurious
+};
+
+/**
+ * Time every quartic method on a sample of coefficients and pick the fastest whose roots all lie within tolerance of
+ * reference roots (companion matrix eigenvalues polished in long double).
+ * Nothing is changed, pass the chosen method to the estimators or batch calls that should use it
+ * (e.g. DualVarianceWeightedTotalLeastSquares::setQuarticMethod).
+ *
+ * @param count number of sample quartics a[i] x^4 + b[i] x^3 + c[i] x^2 + d[i] x + e[i]
+ * @param tolerance largest accepted error, absolute for roots below 1 and relative above
+ */
+QuarticCalibration calibrate_quartic_method(
+    const double* a, const double* b, const double* c, const double* d, const double* e,
+    size_t count, double tolerance=1e-8
+);
+
+/**
+ * Real roots of count quartics a[i] x^4 + b[i] x^3 + c[i] x^2 + d[i] x + e[i].
+ * Only built generically, the solver is scalar and branchy and AVX2/AVX-512 builds of it were no faster.
+ *
+ * @param roots caller provided storage for 4 * count roots, the roots of quartic i start at roots[4 * i]
+ * @param rootCounts caller provided storage for count, set to the number of real roots of each quartic
+ * @param method algorithm to solve every quartic with
+ */
+void calculate_real_roots_batch(
+    const double* a, const double* b, const double* c, const double* d, const double* e,
+    size_t count, double* roots, unsigned char* rootCounts, QuarticMethod method=QuarticMethod::NBS
+);
@@ -0,0 +1,66 @@
+#include "wrls.h"
+#include "cpuDispatch.h"
+
+namespace {
+
+CPU_DISPATCH_INLINE void wrls_update_batch_body(
+    const double* forgettingFactor, double* c1, double* c2,
+    const double* x, const double* y, const double* yPrecision, size_t count
+) {
+    // No dependency between lanes, so this vectorises across estimators.
+    for (size_t i = 0; i < count; ++i) {
+        double xWeighted = x[i] * yPrecision[i];
+        c1[i] = forgettingFactor[i] * c1[i] + x[i] * xWeighted;
+        c2[i] = forgettingFactor[i] * c2[i] + y[i] * xWeighted;
+    }
+}
+
+CPU_DISPATCH_INLINE void wrls_estimate_batch_body(const double* c1, const double* c2, size_t count, double* estimates, double* variances) {
+    for (size_t i = 0; i < count; ++i) {
+        estimates[i] = wrls_estimate(c1[i], c2[i]);
+    }
+    if (variances != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            variances[i] = wrls_variance(c1[i]);
+        }
+    }
+}
+
+typedef void (*WrlsUpdateBatchKernel)(
+    const double*, double*, double*, const double*, const double*, const double*, size_t
+);
+typedef void (*WrlsEstimateBatchKernel)(const double*, const double*, size_t, double*, double*);
+
+#define WRLS_BATCH_KERNELS(suffix, target) \
+    target void wrls_update_batch_##suffix( \
+        const double* forgettingFactor, double* c1, double* c2, \
+        const double* x, const double* y, const double* yPrecision, size_t count \
+    ) { \
+        wrls_update_batch_body(forgettingFactor, c1, c2, x, y, yPrecision, count); \
+    } \
+    target void wrls_estimate_batch_##suffix(const double* c1, const double* c2, size_t count, double* estimates, double* variances) { \
+        wrls_estimate_batch_body(c1, c2, count, estimates, variances); \
+    }
+
+WRLS_BATCH_KERNELS(generic, )
+#if CPU_DISPATCH_X86
+WRLS_BATCH_KERNELS(avx2, CPU_DISPATCH_TARGET_AVX2)
+WRLS_BATCH_KERNELS(avx512, CPU_DISPATCH_TARGET_AVX512)
+#endif
+
+}
+
+
+void wrls_update_batch(
+    const double* forgettingFactor, double* c1, double* c2,
+    const double* x, const double* y, const double* yPrecision, size_t count
+) {
+    WrlsUpdateBatchKernel kernel = CPU_DISPATCH_SELECT(wrls_update_batch);
+    kernel(forgettingFactor, c1, c2, x, y, yPrecision, count);
+}
+
+
+void wrls_estimate_batch(const double* c1, const double* c2, size_t count, double* estimates, double* variances) {
+    WrlsEstimateBatchKernel kernel = CPU_DISPATCH_SELECT(wrls_estimate_batch);
+    kernel(c1, c2, count, estimates, variances);
+}
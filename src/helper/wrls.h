@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+
+// Closed forms of WeightedRecursiveLeastSquares, in terms of its recursive statistics
+// c1 = sum of x^2 / yVariance and c2 = sum of x y / yVariance (both forgotten like the total least squares ones).
+
+
+/**
+ * Weighted least squares estimate of w in y = w x.
+ */
+inline double wrls_estimate(double c1, double c2) {
+    return c2 / c1;
+}
+
+/**
+ * Variance of wrls_estimate, the inverse of the information c1.
+ */
+inline double wrls_variance(double c1) {
+    return 1 / c1;
+}
+
+
+// Batch kernels over statistics stored as arrays (one entry per estimator), built for several instruction sets
+// and dispatched at run time (see cpuDispatch.h).
+
+/**
+ * Fold one precision weighted measurement into each of count sets of WeightedRecursiveLeastSquares statistics.
+ */
+void wrls_update_batch(
+    const double* forgettingFactor, double* c1, double* c2,
+    const double* x, const double* y, const double* yPrecision, size_t count
+);
+
+/**
+ * wrls_estimate (and wrls_variance) for count sets of statistics.
+ *
+ * @param variances caller provided storage for count variances, may be null to skip them
+ */
+void wrls_estimate_batch(const double* c1, const double* c2, size_t count, double* estimates, double* variances);
@@ -0,0 +1,242 @@
+#include "wtls.h"
+#include "roots.h"
+#include "cpuDispatch.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+double dual_wtls_merit(double c1, double c2, double c3, double c4, double c5, double c6, double estimate) {
+    
+    double estimateSq = estimate * estimate;
+    double top = c4 * estimateSq * estimateSq + 
+                -2 * c5 * estimateSq * estimate +
+                (c1 + c6) * estimateSq +
+                -2 * c2 * estimate + 
+                c3;
+    
+    double bottom = estimateSq + 1;
+
+    return top / (bottom * bottom);
+}
+
+inline EstimatorStatus dual_wtls_select_root(
+    double c1, double c2, double c3, double c4, double c5, double c6,
+    const double* roots, int rootCount, double& estimate
+) {
+    int bestRootPos = -1;
+    double bestMerit;
+    for (int i = 0; i < rootCount; ++i) {
+        double merit = dual_wtls_merit(c1, c2, c3, c4, c5, c6, roots[i]);
+        if (bestRootPos == -1 || merit <= bestMerit) {
+            bestRootPos = i;
+            bestMerit = merit;
+        }
+    }
+
+    if (bestRootPos == -1) {
+        return EstimatorStatus::NoRealRoot;
+    }
+
+    estimate = roots[bestRootPos];
+    return EstimatorStatus::Ok;
+}
+
+}
+
+
+EstimatorStatus dual_wtls_estimate(
+    double c1, double c2, double c3, double c4, double c5, double c6, double& estimate,
+    QuarticMethod method
+) {
+    double roots[4];
+    int rootCount = static_cast<int>(calculate_real_roots(
+        method, dual_wtls_quartic_a(c5), dual_wtls_quartic_b(c1, c4, c6), dual_wtls_quartic_c(c2, c5),
+        dual_wtls_quartic_d(c1, c3, c6), dual_wtls_quartic_e(c2), roots
+    ));
+    return dual_wtls_select_root(c1, c2, c3, c4, c5, c6, roots, rootCount, estimate);
+}
+
+
+namespace {
+
+CPU_DISPATCH_INLINE void wtls_update_batch_body(
+    const double* forgettingFactor, double* c1, double* c2, double* c3,
+    const double* x, const double* y, const double* yPrecision, size_t count
+) {
+    // No dependency between lanes, so this vectorises across estimators.
+    for (size_t i = 0; i < count; ++i) {
+        double xWeighted = x[i] * yPrecision[i];
+        c1[i] = forgettingFactor[i] * c1[i] + x[i] * xWeighted;
+        c2[i] = forgettingFactor[i] * c2[i] + y[i] * xWeighted;
+        c3[i] = forgettingFactor[i] * c3[i] + y[i] * y[i] * yPrecision[i];
+    }
+}
+
+CPU_DISPATCH_INLINE void wtls_estimate_batch_body(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+) {
+    if (variances != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            wtls_estimate_variance(c1[i], c2[i], c3[i], varianceRatioSquared[i], estimates[i], variances[i]);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        estimates[i] = wtls_estimate(c1[i], c2[i], c3[i], varianceRatioSquared[i]);
+    }
+}
+
+CPU_DISPATCH_INLINE void wtls_estimate_variance_batch_body(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+) {
+    for (size_t i = 0; i < count; ++i) {
+        wtls_estimate_variance(c1[i], c2[i], c3[i], varianceRatioSquared[i], estimates[i], variances[i]);
+    }
+}
+
+CPU_DISPATCH_INLINE void dual_wtls_approximate_estimate_batch_body(
+    const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6,
+    size_t count, int newtonSteps, double* estimates, double* variances
+) {
+    for (size_t i = 0; i < count; ++i) {
+        estimates[i] = dual_wtls_approximate_estimate(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], newtonSteps);
+    }
+    if (variances != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            variances[i] = dual_wtls_variance(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], estimates[i]);
+        }
+    }
+}
+
+typedef void (*WtlsUpdateBatchKernel)(
+    const double*, double*, double*, double*, const double*, const double*, const double*, size_t
+);
+typedef void (*WtlsEstimateBatchKernel)(
+    const double*, const double*, const double*, const double*, size_t, double*, double*
+);
+typedef void (*DualWtlsApproximateEstimateBatchKernel)(
+    const double*, const double*, const double*, const double*, const double*, const double*,
+    size_t, int, double*, double*
+);
+
+#define WTLS_BATCH_KERNELS(suffix, target) \
+    target void wtls_update_batch_##suffix( \
+        const double* forgettingFactor, double* c1, double* c2, double* c3, \
+        const double* x, const double* y, const double* yPrecision, size_t count \
+    ) { \
+        wtls_update_batch_body(forgettingFactor, c1, c2, c3, x, y, yPrecision, count); \
+    } \
+    target void wtls_estimate_batch_##suffix( \
+        const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared, \
+        size_t count, double* estimates, double* variances \
+    ) { \
+        wtls_estimate_batch_body(c1, c2, c3, varianceRatioSquared, count, estimates, variances); \
+    } \
+    target void wtls_estimate_variance_batch_##suffix( \
+        const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared, \
+        size_t count, double* estimates, double* variances \
+    ) { \
+        wtls_estimate_variance_batch_body(c1, c2, c3, varianceRatioSquared, count, estimates, variances); \
+    } \
+    target void dual_wtls_approximate_estimate_batch_##suffix( \
+        const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6, \
+        size_t count, int newtonSteps, double* estimates, double* variances \
+    ) { \
+        dual_wtls_approximate_estimate_batch_body(c1, c2, c3, c4, c5, c6, count, newtonSteps, estimates, variances); \
+    }
+
+WTLS_BATCH_KERNELS(generic, )
+#if CPU_DISPATCH_X86
+WTLS_BATCH_KERNELS(avx2, CPU_DISPATCH_TARGET_AVX2)
+WTLS_BATCH_KERNELS(avx512, CPU_DISPATCH_TARGET_AVX512)
+#endif
+
+}
+
+
+void wtls_update_batch(
+    const double* forgettingFactor, double* c1, double* c2, double* c3,
+    const double* x, const double* y, const double* yPrecision, size_t count
+) {
+    WtlsUpdateBatchKernel kernel = CPU_DISPATCH_SELECT(wtls_update_batch);
+    kernel(forgettingFactor, c1, c2, c3, x, y, yPrecision, count);
+}
+
+
+void wtls_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+) {
+    WtlsEstimateBatchKernel kernel = CPU_DISPATCH_SELECT(wtls_estimate_batch);
+    kernel(c1, c2, c3, varianceRatioSquared, count, estimates, variances);
+}
+
+
+void wtls_estimate_variance_batch(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+) {
+    WtlsEstimateBatchKernel kernel = CPU_DISPATCH_SELECT(wtls_estimate_variance_batch);
+    kernel(c1, c2, c3, varianceRatioSquared, count, estimates, variances);
+}
+
+
+void dual_wtls_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6,
+    size_t count, double* estimates, double* variances, EstimatorStatus* statuses,
+    QuarticMethod method
+) {
+    // Solve in chunks so the quartic coefficients and roots stay on the stack and in cache.
+    const size_t chunk = 256;
+    double a[chunk], b[chunk], c[chunk], d[chunk], e[chunk];
+    double roots[4 * chunk];
+    unsigned char rootCounts[chunk];
+
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t n = std::min(chunk, count - begin);
+        const double* C1 = c1 + begin;
+        const double* C2 = c2 + begin;
+        const double* C3 = c3 + begin;
+        const double* C4 = c4 + begin;
+        const double* C5 = c5 + begin;
+        const double* C6 = c6 + begin;
+
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = dual_wtls_quartic_a(C5[i]);
+            b[i] = dual_wtls_quartic_b(C1[i], C4[i], C6[i]);
+            c[i] = dual_wtls_quartic_c(C2[i], C5[i]);
+            d[i] = dual_wtls_quartic_d(C1[i], C3[i], C6[i]);
+            e[i] = dual_wtls_quartic_e(C2[i]);
+        }
+
+        calculate_real_roots_batch(a, b, c, d, e, n, roots, rootCounts, method);
+
+        for (size_t i = 0; i < n; ++i) {
+            double estimate = std::numeric_limits<double>::quiet_NaN();
+            EstimatorStatus status = dual_wtls_select_root(
+                C1[i], C2[i], C3[i], C4[i], C5[i], C6[i], roots + 4 * i, rootCounts[i], estimate
+            );
+            estimates[begin + i] = estimate;
+            if (variances != nullptr) {
+                variances[begin + i] = (status == EstimatorStatus::Ok)
+                    ? dual_wtls_variance(C1[i], C2[i], C3[i], C4[i], C5[i], C6[i], estimate)
+                    : std::numeric_limits<double>::quiet_NaN();
+            }
+            if (statuses != nullptr) {
+                statuses[begin + i] = status;
+            }
+        }
+    }
+}
+
+
+void dual_wtls_approximate_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6,
+    size_t count, int newtonSteps, double* estimates, double* variances
+) {
+    DualWtlsApproximateEstimateBatchKernel kernel = CPU_DISPATCH_SELECT(dual_wtls_approximate_estimate_batch);
+    kernel(c1, c2, c3, c4, c5, c6, count, newtonSteps, estimates, variances);
+}
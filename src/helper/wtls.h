@@ -0,0 +1,193 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include "../EstimatorStatus.h"
+#include "roots.h"
+
+// Closed forms shared by the estimators, written in terms of their recursive statistics c1..c6
+// so the runtime and compile time parameter versions evaluate exactly the same expressions.
+
+
+/**
+ * Weighted total least squares estimate for proportional x and y variances (VarianceWeightedTotalLeastSquares).
+ */
+inline double wtls_estimate(double c1, double c2, double c3, double varianceRatioSquared) {
+    if (varianceRatioSquared == 0 || c2 == 0) {
+        return 0.0;
+    }
+    
+    double top_left = -c1 + varianceRatioSquared * c3;
+    double top_right_inner = (c1 - varianceRatioSquared * c3);
+    double top_right = std::sqrt(top_right_inner * top_right_inner + 4 * varianceRatioSquared * c2 * c2);
+
+    return (top_left + top_right) / (2 * varianceRatioSquared * c2);
+}
+
+/**
+ * Variance of wtls_estimate from the Hessian of its merit function at estimate.
+ *
+ * At the estimate itself wtls_estimate_variance gives the same value more cheaply, this form is for other estimates.
+ */
+inline double wtls_variance(double c1, double c2, double c3, double varianceRatioSquared, double estimate) {
+    double bottom = (estimate * estimate * varianceRatioSquared + 1);
+
+    double top = (-4.0 * varianceRatioSquared * varianceRatioSquared * c2) * estimate * estimate * estimate
+           + (6.0 * varianceRatioSquared * c3 - 6.0 * c1) * varianceRatioSquared * estimate * estimate
+           + 12.0 * varianceRatioSquared * c2 * estimate
+           + 2.0 * (c1 - varianceRatioSquared * c3);
+
+    double hessian = top / (bottom * bottom * bottom);
+    
+    return 2 / hessian;
+}
+
+/**
+ * wtls_estimate and its variance together, sharing one square root.
+ *
+ * The variance is 2 / Hessian from the closed form of Plett's paper (page 6): at the minimum the Hessian of the
+ * merit function reduces to 2 S / (1 + varianceRatio^2 estimate^2)^2, where S is the square root in the estimate.
+ */
+inline void wtls_estimate_variance(double c1, double c2, double c3, double varianceRatioSquared, double& estimate, double& variance) {
+    double inner = c1 - varianceRatioSquared * c3;
+    double root = std::sqrt(inner * inner + 4 * varianceRatioSquared * c2 * c2);
+
+    // Same degenerate case as wtls_estimate, written as a select so batches still vectorise.
+    bool degenerate = varianceRatioSquared == 0 || c2 == 0;
+    estimate = degenerate ? 0.0 : (-inner + root) / (2 * varianceRatioSquared * c2);
+
+    double bottom = 1 + varianceRatioSquared * estimate * estimate;
+    variance = bottom * bottom / root;
+}
+
+// Coefficients a x^4 + b x^3 + c x^2 + d x + e of the quartic whose real roots are the stationary points of the
+// DualVarianceWeightedTotalLeastSquares merit function, e.g. to sample for calibrate_quartic_method.
+
+inline double dual_wtls_quartic_a(double c5) {
+    return c5;
+}
+
+inline double dual_wtls_quartic_b(double c1, double c4, double c6) {
+    return 2 * c4 - c1 - c6;
+}
+
+inline double dual_wtls_quartic_c(double c2, double c5) {
+    return 3 * c2 - 3 * c5;
+}
+
+inline double dual_wtls_quartic_d(double c1, double c3, double c6) {
+    return c1 - 2 * c3 + c6;
+}
+
+inline double dual_wtls_quartic_e(double c2) {
+    return -c2;
+}
+
+/**
+ * Estimate for separate x and y variances (DualVarianceWeightedTotalLeastSquares), in variance ratio scaled units.
+ * Picks the real root of the stationary point quartic with the lowest merit.
+ *
+ * @param estimate set to the estimate when the return is EstimatorStatus::Ok
+ * @param method algorithm to solve the quartic with
+ */
+EstimatorStatus dual_wtls_estimate(
+    double c1, double c2, double c3, double c4, double c5, double c6, double& estimate,
+    QuarticMethod method=QuarticMethod::NBS
+);
+
+/**
+ * Variance of dual_wtls_estimate from the Hessian of its merit function at estimate, in variance ratio scaled units.
+ */
+inline double dual_wtls_variance(double c1, double c2, double c3, double c4, double c5, double c6, double estimate) {
+    double estimateSq = estimate * estimate;
+
+    double top = -2 * c5 * estimateSq * estimateSq * estimate + 
+                (3 * c3 - 6 * c4 + 3 * c6) * estimateSq * estimateSq +
+                (-12 * c2 + 16 * c5) * estimateSq * estimate +
+                (-8 * c1 + 10 * c3 + 6 * c4 - 8 * c6) * estimateSq +
+                (12 * c2 - 6 * c5) * estimate +
+                c1 - 2 * c3 + c6;
+
+    double bottom = estimateSq + 1;
+
+    double hessian = 2 * top / (bottom * bottom * bottom * bottom);
+    return 2.0 / hessian;
+}
+
+/**
+ * Approximate dual_wtls_estimate without a root solver (AWTLS), in variance ratio scaled units.
+ *
+ * Starts from wtls_estimate of the x and y weighted statistics averaged, which is exact when the x and y variances
+ * are in proportion (the merit function then reduces to the VarianceWeightedTotalLeastSquares one), then takes
+ * newtonSteps Newton steps on the stationary point quartic. Nothing checks that the root reached has the lowest merit.
+ */
+inline double dual_wtls_approximate_estimate(double c1, double c2, double c3, double c4, double c5, double c6, int newtonSteps) {
+    double estimate = wtls_estimate(0.5 * (c1 + c4), 0.5 * (c2 + c5), 0.5 * (c3 + c6), 1.0);
+
+    double a = dual_wtls_quartic_a(c5);
+    double b = dual_wtls_quartic_b(c1, c4, c6);
+    double c = dual_wtls_quartic_c(c2, c5);
+    double d = dual_wtls_quartic_d(c1, c3, c6);
+    double e = dual_wtls_quartic_e(c2);
+    for (int i = 0; i < newtonSteps; ++i) {
+        double value = (((a * estimate + b) * estimate + c) * estimate + d) * estimate + e;
+        double slope = ((4 * a * estimate + 3 * b) * estimate + 2 * c) * estimate + d;
+        double step = value / slope;
+        // A flat quartic would send the estimate to infinity, keep the last one instead.
+        estimate = std::isfinite(step) ? estimate - step : estimate;
+    }
+    return estimate;
+}
+
+
+// Batch kernels over statistics stored as arrays (one entry per estimator). The closed form ones are built for several
+// instruction sets and dispatched at run time (see cpuDispatch.h), dual_wtls_estimate_batch is bound by the generic
+// quartic solver (see calculate_real_roots_batch) so it is only built generically.
+
+/**
+ * Fold one precision weighted measurement into each of count sets of VarianceWeightedTotalLeastSquares statistics.
+ */
+void wtls_update_batch(
+    const double* forgettingFactor, double* c1, double* c2, double* c3,
+    const double* x, const double* y, const double* yPrecision, size_t count
+);
+
+/**
+ * wtls_estimate (and wtls_variance) for count sets of statistics.
+ *
+ * @param variances caller provided storage for count variances, may be null to skip them
+ */
+void wtls_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+);
+
+/**
+ * wtls_estimate_variance for count sets of statistics.
+ */
+void wtls_estimate_variance_batch(
+    const double* c1, const double* c2, const double* c3, const double* varianceRatioSquared,
+    size_t count, double* estimates, double* variances
+);
+
+/**
+ * dual_wtls_approximate_estimate (and dual_wtls_variance) for count sets of statistics.
+ *
+ * @param variances caller provided storage for count variances, may be null to skip them
+ */
+void dual_wtls_approximate_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6,
+    size_t count, int newtonSteps, double* estimates, double* variances
+);
+
+/**
+ * dual_wtls_estimate (and dual_wtls_variance) for count sets of statistics, NaN where there is no real root.
+ *
+ * @param variances caller provided storage for count variances, may be null to skip them
+ * @param statuses caller provided storage for count statuses, may be null
+ * @param method algorithm to solve every quartic with
+ */
+void dual_wtls_estimate_batch(
+    const double* c1, const double* c2, const double* c3, const double* c4, const double* c5, const double* c6,
+    size_t count, double* estimates, double* variances, EstimatorStatus* statuses,
+    QuarticMethod method=QuarticMethod::NBS
+);
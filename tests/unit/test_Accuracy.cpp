@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <helper/accuracy.h>
+#include <cmath>
+#include <tuple>
+
+
+TEST(AccuracyUnitTest, UlpErrorCountsDoubleSteps) {
+    EXPECT_EQ(ulp_error(1.0, 1.0), 0.0);
+    EXPECT_EQ(ulp_error(1.0 + 3 * std::ldexp(1.0, -52), 1.0), 3.0);
+    EXPECT_EQ(ulp_error(-1024.0 - std::ldexp(1.0, -42), -1024.0), 1.0);
+    // Half way between two doubles is half an ulp, which only the reference can represent.
+    EXPECT_EQ(ulp_error(1.0, ReferenceReal(1.0) + ReferenceReal(std::ldexp(1.0, -53))), 0.5);
+    EXPECT_TRUE(std::isinf(ulp_error(NAN, 1.0)));
+}
+
+TEST(AccuracyUnitTest, SummaryPercentiles) {
+    std::vector<double> errors;
+    for (int i = 1000; i >= 1; --i) {
+        errors.push_back(i);
+    }
+    UlpSummary summary = summarize_ulp_errors(errors, 3);
+    EXPECT_EQ(summary.samples, 1000u);
+    EXPECT_EQ(summary.failures, 3u);
+    EXPECT_EQ(summary.max, 1000.0);
+    EXPECT_EQ(summary.mean, 500.5);
+    EXPECT_EQ(summary.p50, 500.0);
+    EXPECT_EQ(summary.p99, 990.0);
+}
+
+TEST(AccuracyUnitTest, ReferenceRootsOfKnownPolynomials) {
+    ReferenceReal roots[4];
+    bool required[4];
+
+    // (x - 1)(x - 2)(x - 3)(x - 4)
+    const double distinct[5] = {1.0, -10.0, 35.0, -50.0, 24.0};
+    ASSERT_EQ(reference_real_roots(distinct, 4, roots, required), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(static_cast<double>(roots[i]), i + 1.0);
+        EXPECT_TRUE(required[i]);
+    }
+
+    // (x - 1)^2 (x - 3): the double root may or may not be found by a double solver.
+    const double doubleRoot[4] = {1.0, -5.0, 7.0, -3.0};
+    ASSERT_EQ(reference_real_roots(doubleRoot, 3, roots, required), 2u);
+    EXPECT_EQ(static_cast<double>(roots[0]), 1.0);
+    EXPECT_FALSE(required[0]);
+    EXPECT_EQ(static_cast<double>(roots[1]), 3.0);
+    EXPECT_TRUE(required[1]);
+
+    // x^2 + 1, and a leading zero lowering the degree.
+    const double complexPair[3] = {1.0, 0.0, 1.0};
+    EXPECT_EQ(reference_real_roots(complexPair, 2, roots, required), 0u);
+    const double linear[3] = {0.0, 2.0, -1.0};
+    ASSERT_EQ(reference_real_roots(linear, 2, roots, required), 1u);
+    EXPECT_EQ(static_cast<double>(roots[0]), 0.5);
+}
+
+TEST(AccuracyUnitTest, SamplesAreReproducible) {
+    PolynomialSample first = generate_polynomials(AccuracyCase::ClusteredRoots, 4, 16, 42);
+    PolynomialSample second = generate_polynomials(AccuracyCase::ClusteredRoots, 4, 16, 42);
+    EXPECT_EQ(first.e, second.e);
+    EXPECT_EQ(first.a.size(), 16u);
+
+    StatisticsSample statistics = generate_statistics(AccuracyCase::WideScale, 16, 42);
+    EXPECT_EQ(statistics.c6, generate_statistics(AccuracyCase::WideScale, 16, 42).c6);
+    EXPECT_THROW(generate_polynomials(AccuracyCase::Random, 5, 1, 0), std::invalid_argument);
+}
+
+// Closed forms without approximations should stay within a few ulp on well conditioned input.
+TEST(AccuracyUnitTest, ExactFormsStayWithinBudget) {
+    AccuracyReport quadratic = measure_quadratic_accuracy(generate_polynomials(AccuracyCase::Random, 2, 200, 1));
+    EXPECT_EQ(quadratic.error.failures, 0u);
+    EXPECT_LE(quadratic.error.p99, 64.0);
+
+    AccuracyReport companion = measure_quartic_accuracy(QuarticMethod::Companion, generate_polynomials(AccuracyCase::Random, 4, 200, 3));
+    EXPECT_EQ(companion.error.failures, 0u);
+    EXPECT_LE(companion.error.p50, 4.0);
+
+    EstimatorAccuracyReport wtls = measure_wtls_accuracy(generate_statistics(AccuracyCase::Random, 200, 4));
+    EXPECT_EQ(wtls.estimate.failures, 0u);
+    EXPECT_LE(wtls.estimate.p99, 16.0);
+    EXPECT_LE(wtls.variance.p99, 64.0);
+
+    EstimatorAccuracyReport fused = measure_wtls_estimate_variance_accuracy(generate_statistics(AccuracyCase::Random, 200, 4));
+    EXPECT_EQ(fused.estimate.failures, 0u);
+    EXPECT_LE(fused.estimate.p99, 16.0);
+    EXPECT_LE(fused.variance.p99, 64.0);
+}
+
+
+// The measured frontier of the approximating solvers, so a faster kernel that loses accuracy fails here.
+// Budgets are about twice what the current solvers reach on these samples.
+class AccuracyFrontierParamTest : public ::testing::TestWithParam<std::tuple<AccuracyCase, double, double, double, double>> {};
+
+TEST_P(AccuracyFrontierParamTest, ApproximationsDoNotRegress) {
+    AccuracyCase accuracyCase = std::get<0>(GetParam());
+    double cubicFailureBudget = std::get<1>(GetParam());
+    double cubicUlpBudget = std::get<2>(GetParam());
+    double quarticFailureBudget = std::get<3>(GetParam());
+    double dualEstimateBudget = std::get<4>(GetParam());
+    const size_t count = 200;
+
+    AccuracyReport cubic = measure_cubic_accuracy(generate_polynomials(accuracyCase, 3, count, 2));
+    EXPECT_LE(cubic.error.failures, cubicFailureBudget * count);
+    EXPECT_LE(cubic.error.p99, cubicUlpBudget);
+
+    AccuracyReport quartic = measure_quartic_accuracy(QuarticMethod::NBS, generate_polynomials(accuracyCase, 4, count, 3));
+    EXPECT_LE(quartic.error.failures, quarticFailureBudget * count);
+
+    EstimatorAccuracyReport dual = measure_dual_wtls_accuracy(generate_statistics(accuracyCase, count, 4));
+    EXPECT_EQ(dual.estimate.failures, 0u);
+    EXPECT_LE(dual.estimate.p50, dualEstimateBudget);
+}
+
+// The approximate dual estimate reaches the exact one's median error within three Newton steps,
+// even on these samples whose statistics aren't ratio scaled, so the closed form start is far off.
+TEST(AccuracyUnitTest, ApproximateDualConverges) {
+    StatisticsSample sample = generate_statistics(AccuracyCase::Random, 200, 4);
+    EstimatorAccuracyReport closedForm = measure_dual_wtls_approximate_accuracy(sample, 0);
+    EstimatorAccuracyReport refined = measure_dual_wtls_approximate_accuracy(sample, 3);
+    EXPECT_EQ(refined.estimate.failures, 0u);
+    EXPECT_LT(refined.estimate.p50, closedForm.estimate.p50);
+    EXPECT_LE(refined.estimate.p50, 2.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AccuracyFrontierParamTests,
+    AccuracyFrontierParamTest,
+    ::testing::Values(
+        // case, cubic failures per polynomial, cubic p99 ulp, NBS quartic failures per polynomial, dual estimate median ulp.
+        // Clustered roots are only resolved to about the cube root of the rounding of the coefficients, so some land further
+        // from the reference than the match tolerance (the companion matrix misses as many) and their ulp errors aren't bounded.
+        std::make_tuple(AccuracyCase::Random, 0.02, 256.0, 0.02, 2.0),
+        std::make_tuple(AccuracyCase::ClusteredRoots, 0.4, INFINITY, 0.9, 2.0),
+        std::make_tuple(AccuracyCase::WideScale, 0.02, 4.0, 0.4, 192.0),
+        std::make_tuple(AccuracyCase::NearDegenerate, 0.02, 4.0, 0.02, 2.0)
+    )
+);
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <ApproximateDualVarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <cmath>
+#include <vector>
+
+
+TEST(AWTLSUnitTest, MatchesDualWhenVariancesAreProportional) {
+    // The prior is in the same proportion as every measurement.
+    ApproximateDualVarianceWeightedTotalLeastSquares approximate(1.0, 0.99, 40.0, 10.0);
+    DualVarianceWeightedTotalLeastSquares dual(1.0, 0.99, 40.0, 10.0);
+    approximate.setNewtonSteps(0);
+    for (int i = 0; i < 50; i++) {
+        double x = 1.0 + 0.05 * i;
+        double y = 2.5 * x + 0.02 * ((i * 7) % 5) - 0.04;
+        double yVariance = 0.01 * (1 + i % 3);
+        approximate.update(x, y, 4 * yVariance, yVariance);
+        dual.update(x, y, 4 * yVariance, yVariance);
+    }
+
+    // The closed form alone is the minimum, the quartic solve only adds rounding.
+    EXPECT_NEAR(approximate.getEstimate(), dual.getEstimate(), 1e-9);
+    EXPECT_NEAR(approximate.getVariance(), dual.getVariance(), 1e-9);
+}
+
+TEST(AWTLSUnitTest, NewtonStepsConvergeToDual) {
+    ApproximateDualVarianceWeightedTotalLeastSquares approximate(1.0, 0.99, 10.0, 10.0);
+    DualVarianceWeightedTotalLeastSquares dual(1.0, 0.99, 10.0, 10.0);
+    std::vector<double> x, y, xPrecision, yPrecision;
+    for (int i = 0; i < 50; i++) {
+        x.push_back(1.0 + 0.05 * i);
+        y.push_back(-1.5 * x.back() + 0.05 * ((i * 3) % 7) - 0.15);
+        // The x to y variance ratio wanders between 1 and 16.
+        yPrecision.push_back(100.0 / (1 + i % 3));
+        xPrecision.push_back(yPrecision.back() / (1 + (i * 5) % 16));
+    }
+    approximate.updatePrecision(x.data(), y.data(), xPrecision.data(), yPrecision.data(), x.size());
+    dual.updatePrecision(x.data(), y.data(), xPrecision.data(), yPrecision.data(), x.size());
+
+    double expected = dual.getEstimate();
+    double previousError = INFINITY;
+    for (int steps = 0; steps <= 3; ++steps) {
+        approximate.setNewtonSteps(steps);
+        double error = std::fabs(approximate.getEstimate() - expected);
+        EXPECT_LE(error, previousError + 1e-12) << steps;
+        previousError = error;
+    }
+    EXPECT_NEAR(approximate.getEstimate(), expected, 1e-9 * std::fabs(expected));
+    EXPECT_EQ(approximate.tryGetEstimate().status, EstimatorStatus::Ok);
+    EXPECT_NEAR(approximate.tryGetVariance().value, dual.getVariance(), 1e-6 * dual.getVariance());
+
+    EstimatorResult estimate, variance;
+    approximate.tryGetEstimateAndVariance(estimate, variance);
+    EXPECT_EQ(estimate.value, approximate.getEstimate());
+    EXPECT_EQ(variance.value, approximate.getVariance());
+}
+
+TEST(AWTLSUnitTest, BatchMatchesScalar) {
+    const size_t count = 19;
+    std::vector<double> c1(count), c2(count), c3(count), c4(count), c5(count), c6(count);
+    for (size_t i = 0; i < count; ++i) {
+        double k = 0.5 + 0.1 * i;
+        c1[i] = 10.0;
+        c2[i] = 10.0 * k;
+        c3[i] = 10.0 * k * k + 0.1;
+        c4[i] = 5.0 + i;
+        c5[i] = (5.0 + i) * k;
+        c6[i] = (5.0 + i) * k * k + 0.2;
+    }
+
+    std::vector<double> estimates(count), variances(count);
+    dual_wtls_approximate_estimate_batch(
+        c1.data(), c2.data(), c3.data(), c4.data(), c5.data(), c6.data(), count, 2, estimates.data(), variances.data()
+    );
+    for (size_t i = 0; i < count; ++i) {
+        double expected = dual_wtls_approximate_estimate(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], 2);
+        EXPECT_NEAR(estimates[i], expected, 1e-12) << i;
+        EXPECT_NEAR(variances[i], dual_wtls_variance(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], expected), 1e-9) << i;
+    }
+}
+
+TEST(AWTLSUnitTest, InvalidParameters) {
+    EXPECT_THROW(ApproximateDualVarianceWeightedTotalLeastSquares(0.0, 1.5), std::invalid_argument);
+    EXPECT_THROW(ApproximateDualVarianceWeightedTotalLeastSquares(0.0, 1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(ApproximateDualVarianceWeightedTotalLeastSquares(0.0, 1.0, 1.0, -1.0), std::invalid_argument);
+    EXPECT_THROW(ApproximateDualVarianceWeightedTotalLeastSquares(0.0, 1.0, 1.0, 1.0, 0.0), std::invalid_argument);
+
+    ApproximateDualVarianceWeightedTotalLeastSquares estimator;
+    EXPECT_EQ(estimator.getNewtonSteps(), 3);
+    EXPECT_THROW(estimator.setNewtonSteps(-1), std::invalid_argument);
+    EXPECT_EQ(ApproximateDualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 0.0, 1.0, 1.0, -1.0), EstimatorStatus::InvalidForgettingFactor);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <CheckpointJournal.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+
+std::string journalPath(const char* test) {
+    return "/tmp/recursive-optimizers-" + std::string(test) + "-" + std::to_string(getpid());
+}
+
+void removeJournal(const std::string& path) {
+    std::remove((path + ".base").c_str());
+    std::remove((path + ".journal").c_str());
+}
+
+template <typename Estimator>
+bool sameState(const std::vector<Estimator>& a, const std::vector<Estimator>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Estimator)) == 0;
+}
+
+}
+
+
+TEST(CheckpointJournalUnitTest, RecoversLastCheckpoint) {
+    std::string path = journalPath("recover");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(100, prototype);
+    {
+        CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+        for (int tick = 0; tick < 10; ++tick) {
+            for (size_t i = tick; i < fleet.size(); i += 7) {
+                fleet[i].update(1.0 + tick, 2.0 + tick, 1e-2, 1e-2);
+            }
+            journal.checkpoint(fleet.data());
+        }
+    }
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> recovered(fleet.size(), prototype);
+    EXPECT_EQ(CheckpointJournal<DualVarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), recovered.size()), 10);
+    EXPECT_TRUE(sameState(fleet, recovered));
+    EXPECT_EQ(recovered[3].getEstimate(), fleet[3].getEstimate());
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, WritesOnlyChangedEstimators) {
+    std::string path = journalPath("changed");
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(10000);
+    CheckpointJournal<VarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+
+    size_t before = journal.journalBytes();
+    EXPECT_EQ(journal.checkpoint(fleet.data()), 0);
+    EXPECT_EQ(journal.journalBytes(), before);
+
+    fleet[17].update(1.0, 3.0, 1e-2);
+    fleet[9000].update(1.0, 3.0, 1e-2);
+    EXPECT_EQ(journal.checkpoint(fleet.data()), 2);
+    EXPECT_LT(journal.journalBytes() - before, 200);
+    EXPECT_GT(journal.snapshotBytes(), fleet.size() * sizeof(VarianceWeightedTotalLeastSquares));
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, ReadsDontMarkEstimatorsChanged) {
+    std::string path = journalPath("reads");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(10, prototype);
+    fleet[2].update(1.0, 2.0, 1e-2, 1e-2);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+
+    // The try getters cache the result in the estimator, which is not a change to journal.
+    EstimatorResult estimate, variance;
+    fleet[2].tryGetEstimateAndVariance(estimate, variance);
+    EXPECT_EQ(journal.checkpoint(fleet.data()), 0);
+
+    fleet[2].update(2.0, 4.0, 1e-2, 1e-2);
+    EXPECT_EQ(journal.checkpoint(fleet.data()), 1);
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> recovered(fleet.size(), prototype);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), recovered.size());
+    EXPECT_EQ(recovered[2].getEstimate(), fleet[2].getEstimate());
+    EXPECT_EQ(recovered[2].getVariance(), fleet[2].getVariance());
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, CandidateCheckpointMatchesScan) {
+    std::string path = journalPath("candidates");
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(1000);
+    {
+        CheckpointJournal<VarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+        std::vector<size_t> touched = {900, 3, 3, 42};
+        for (size_t i : touched) {
+            fleet[i].update(1.0, 3.0, 1e-2);
+        }
+        EXPECT_EQ(journal.checkpoint(fleet.data(), touched.data(), touched.size()), 3);
+        EXPECT_EQ(journal.checkpoint(fleet.data()), 0);
+
+        std::vector<size_t> outside = {1000};
+        EXPECT_THROW(journal.checkpoint(fleet.data(), outside.data(), outside.size()), std::out_of_range);
+    }
+
+    std::vector<VarianceWeightedTotalLeastSquares> recovered(fleet.size());
+    CheckpointJournal<VarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), recovered.size());
+    EXPECT_TRUE(sameState(fleet, recovered));
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, CompactsOnceTheJournalOutgrowsTheSnapshot) {
+    std::string path = journalPath("compact");
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(8);
+    CheckpointJournal<VarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0.5, false);
+
+    for (int tick = 0; tick < 50; ++tick) {
+        for (VarianceWeightedTotalLeastSquares& estimator : fleet) {
+            estimator.update(1.0, tick, 1e-2);
+        }
+        journal.checkpoint(fleet.data());
+        EXPECT_LE(journal.journalBytes(), 0.5 * journal.snapshotBytes() + 1);
+    }
+
+    std::vector<VarianceWeightedTotalLeastSquares> recovered(fleet.size());
+    CheckpointJournal<VarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), recovered.size());
+    EXPECT_TRUE(sameState(fleet, recovered));
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, DropsTornRecord) {
+    std::string path = journalPath("torn");
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(4);
+    std::vector<VarianceWeightedTotalLeastSquares> expected;
+    {
+        CheckpointJournal<VarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+        fleet[0].update(1.0, 3.0, 1e-2);
+        journal.checkpoint(fleet.data());
+        expected = fleet;
+        fleet[1].update(1.0, 3.0, 1e-2);
+        fleet[2].update(1.0, 3.0, 1e-2);
+        journal.checkpoint(fleet.data());
+    }
+
+    // Lose the tail of the last record as a crash mid write would.
+    std::string journalFile = path + ".journal";
+    size_t size = read_file(journalFile, nullptr).size();
+    ASSERT_EQ(truncate(journalFile.c_str(), size - 3), 0);
+
+    std::vector<VarianceWeightedTotalLeastSquares> recovered(fleet.size());
+    EXPECT_EQ(CheckpointJournal<VarianceWeightedTotalLeastSquares>::recover(path, recovered.data(), recovered.size()), 1);
+    EXPECT_TRUE(sameState(expected, recovered));
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, ParallelReplayMatchesSerial) {
+    std::string path = journalPath("parallel");
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(1000, prototype);
+    {
+        CheckpointJournal<DualVarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+        for (int tick = 0; tick < 40; ++tick) {
+            for (size_t i = tick % 5; i < fleet.size(); i += 5) {
+                fleet[i].update(1.0, 1.0 + tick * 1e-3, 1e-2, 1e-2);
+            }
+            journal.checkpoint(fleet.data());
+        }
+    }
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> serial(fleet.size(), prototype);
+    std::vector<DualVarianceWeightedTotalLeastSquares> parallel(fleet.size(), prototype);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares>::recover(path, serial.data(), serial.size(), 1);
+    CheckpointJournal<DualVarianceWeightedTotalLeastSquares>::recover(path, parallel.data(), parallel.size(), 8);
+    EXPECT_TRUE(sameState(fleet, serial));
+    EXPECT_TRUE(sameState(fleet, parallel));
+    removeJournal(path);
+}
+
+TEST(CheckpointJournalUnitTest, RejectsMismatchedFleet) {
+    std::string path = journalPath("mismatch");
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(4);
+    {
+        CheckpointJournal<VarianceWeightedTotalLeastSquares> journal(path, fleet.data(), fleet.size(), 0, false);
+    }
+    std::vector<VarianceWeightedTotalLeastSquares> other(5);
+    EXPECT_THROW(CheckpointJournal<VarianceWeightedTotalLeastSquares>::recover(path, other.data(), other.size()), std::invalid_argument);
+    removeJournal(path);
+    EXPECT_THROW(CheckpointJournal<VarianceWeightedTotalLeastSquares>::recover(path, fleet.data(), fleet.size()), std::system_error);
+}
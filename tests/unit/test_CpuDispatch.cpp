@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <helper/cpuDispatch.h>
+#include <helper/roots.h>
+#include <helper/wtls.h>
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+std::vector<IsaLevel> supportedLevels() {
+    std::vector<IsaLevel> levels;
+    for (IsaLevel level : {IsaLevel::Generic, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (level <= detected_isa_level()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+// Restores the active level when a test finishes.
+struct IsaLevelGuard {
+    IsaLevel saved = active_isa_level();
+    ~IsaLevelGuard() {
+        set_isa_level(this->saved);
+    }
+};
+
+}
+
+
+TEST(CpuDispatchUnitTest, LevelNames) {
+    EXPECT_STREQ(toString(IsaLevel::Generic), "generic");
+    EXPECT_STREQ(toString(IsaLevel::AVX2), "avx2");
+    EXPECT_STREQ(toString(IsaLevel::AVX512), "avx512");
+}
+
+TEST(CpuDispatchUnitTest, ActiveLevelIsSupported) {
+    EXPECT_LE(active_isa_level(), detected_isa_level());
+    if (detected_isa_level() < IsaLevel::AVX512) {
+        EXPECT_THROW(set_isa_level(IsaLevel::AVX512), std::invalid_argument);
+    }
+}
+
+TEST(CpuDispatchUnitTest, NonAllocatingRootsMatchVector) {
+    double roots[4];
+    std::vector<double> expected = calculate_real_roots(1.0, -10.0, 35.0, -50.0, 24.0);
+    ASSERT_EQ(calculate_real_roots(1.0, -10.0, 35.0, -50.0, 24.0, roots), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(roots[i], expected[i]);
+    }
+
+    expected = calculate_real_roots(1.0, -6.0, 11.0, -6.0);
+    ASSERT_EQ(calculate_real_roots(1.0, -6.0, 11.0, -6.0, roots), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(roots[i], expected[i]);
+    }
+
+    EXPECT_EQ(calculate_real_roots(1.0, 0.0, 1.0, roots), 0u);
+}
+
+TEST(CpuDispatchUnitTest, RootsBatchMatchesScalar) {
+    const size_t count = 300;
+    std::vector<double> a(count), b(count), c(count), d(count), e(count);
+    for (size_t i = 0; i < count; ++i) {
+        // (x - 1)(x - 2)(x - 3)(x - r) with r varying, plus some with no real roots.
+        double r = 0.5 + 0.01 * i;
+        a[i] = 1.0;
+        b[i] = -(6.0 + r);
+        c[i] = 11.0 + 6.0 * r;
+        d[i] = -(6.0 + 11.0 * r);
+        e[i] = (i % 7 == 0) ? 100.0 : 6.0 * r;
+    }
+
+    std::vector<double> roots(4 * count);
+    std::vector<unsigned char> rootCounts(count);
+    calculate_real_roots_batch(a.data(), b.data(), c.data(), d.data(), e.data(), count, roots.data(), rootCounts.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<double> expected = calculate_real_roots(a[i], b[i], c[i], d[i], e[i]);
+        ASSERT_EQ(rootCounts[i], expected.size()) << "quartic " << i;
+        for (size_t r = 0; r < expected.size(); ++r) {
+            EXPECT_NEAR(roots[4 * i + r], expected[r], 1e-7) << "quartic " << i;
+        }
+    }
+}
+
+TEST(CpuDispatchUnitTest, WtlsBatchMatchesScalarAtEveryLevel) {
+    IsaLevelGuard guard;
+    const size_t count = 37;
+    for (IsaLevel level : supportedLevels()) {
+        set_isa_level(level);
+        std::vector<double> forgettingFactor(count, 0.95), ratioSq(count), c1(count, 1.0), c2(count, 0.5), c3(count, 1.0);
+        std::vector<double> x(count), y(count), precision(count);
+        for (size_t i = 0; i < count; ++i) {
+            ratioSq[i] = 0.5 + 0.1 * i;
+            x[i] = 1.0 + 0.1 * i;
+            y[i] = 2.0 * x[i] + 0.01;
+            precision[i] = 10.0;
+        }
+
+        wtls_update_batch(forgettingFactor.data(), c1.data(), c2.data(), c3.data(), x.data(), y.data(), precision.data(), count);
+        std::vector<double> estimates(count), variances(count);
+        wtls_estimate_batch(c1.data(), c2.data(), c3.data(), ratioSq.data(), count, estimates.data(), variances.data());
+        std::vector<double> fusedEstimates(count), fusedVariances(count);
+        wtls_estimate_variance_batch(c1.data(), c2.data(), c3.data(), ratioSq.data(), count, fusedEstimates.data(), fusedVariances.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            double s1 = 0.95 + x[i] * x[i] * 10.0;
+            double s2 = 0.95 * 0.5 + x[i] * y[i] * 10.0;
+            double s3 = 0.95 + y[i] * y[i] * 10.0;
+            EXPECT_NEAR(c1[i], s1, 1e-12);
+            double expected = wtls_estimate(s1, s2, s3, ratioSq[i]);
+            EXPECT_NEAR(estimates[i], expected, 1e-12) << toString(level);
+            EXPECT_NEAR(variances[i], wtls_variance(s1, s2, s3, ratioSq[i], expected), 1e-9) << toString(level);
+            double fusedEstimate, fusedVariance;
+            wtls_estimate_variance(s1, s2, s3, ratioSq[i], fusedEstimate, fusedVariance);
+            EXPECT_NEAR(fusedEstimates[i], fusedEstimate, 1e-12) << toString(level);
+            EXPECT_NEAR(fusedVariances[i], fusedVariance, 1e-12) << toString(level);
+        }
+    }
+}
+
+TEST(CpuDispatchUnitTest, DualWtlsBatchMatchesScalar) {
+    const size_t count = 260;
+    std::vector<double> c1(count), c2(count), c3(count), c4(count), c5(count), c6(count);
+    for (size_t i = 0; i < count; ++i) {
+        double k = 0.5 + 0.01 * i;
+        c1[i] = 10.0;
+        c2[i] = 10.0 * k;
+        c3[i] = 10.0 * k * k + 0.1;
+        c4[i] = 20.0;
+        c5[i] = 20.0 * k;
+        c6[i] = 20.0 * k * k + 0.2;
+    }
+    // What a measurement with zero x variance leaves behind, which has no real root.
+    c4[3] = INFINITY;
+    c5[3] = INFINITY;
+    c6[3] = INFINITY;
+
+    std::vector<double> estimates(count), variances(count);
+    std::vector<EstimatorStatus> statuses(count);
+    dual_wtls_estimate_batch(
+        c1.data(), c2.data(), c3.data(), c4.data(), c5.data(), c6.data(),
+        count, estimates.data(), variances.data(), statuses.data()
+    );
+
+    for (size_t i = 0; i < count; ++i) {
+        double expected = NAN;
+        EstimatorStatus status = dual_wtls_estimate(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], expected);
+        ASSERT_EQ(statuses[i], status) << i;
+        EXPECT_EQ(status == EstimatorStatus::NoRealRoot, i == 3);
+        if (status == EstimatorStatus::Ok) {
+            EXPECT_NEAR(estimates[i], expected, 1e-9) << i;
+            EXPECT_NEAR(variances[i], dual_wtls_variance(c1[i], c2[i], c3[i], c4[i], c5[i], c6[i], expected), 1e-6);
+        } else {
+            EXPECT_TRUE(std::isnan(estimates[i]));
+        }
+    }
+}
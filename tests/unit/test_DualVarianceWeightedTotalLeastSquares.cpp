@@ -52,3 +52,153 @@ TEST(DVWTLSUnitTest, UpdateToTwo) {
     EXPECT_NEAR(estimator.getEstimate(), 2.0, 1e-4);
 }
 
+
+TEST(DVWTLSUnitTest, TryGetEstimateMatchesGetEstimate) {
+    DualVarianceWeightedTotalLeastSquares estimator = DualVarianceWeightedTotalLeastSquares();
+    estimator.update(1,2,1e-4,1e-4);
+
+    EstimatorResult result = estimator.tryGetEstimate();
+    EXPECT_TRUE(result.ok());
+    EXPECT_NEAR(result.value, estimator.getEstimate(), 1e-12);
+}
+
+TEST(DVWTLSUnitTest, TryGetEstimateKeepsLastGoodEstimate) {
+    DualVarianceWeightedTotalLeastSquares estimator(3.0, 1.0, 1.0, 1.0, 1.0);
+    
+    estimator.update(1,1,0.0,1.0);
+    EstimatorResult result = estimator.tryGetEstimate();
+    EXPECT_EQ(result.status, EstimatorStatus::NoRealRoot);
+    EXPECT_EQ(result.value, 3.0);
+    EXPECT_THROW(estimator.getEstimate(), std::domain_error);
+}
+
+TEST(DVWTLSUnitTest, TryGetVarianceWithoutGoodVarianceIsNaN) {
+    DualVarianceWeightedTotalLeastSquares estimator(3.0, 1.0, 1.0, 1.0, 1.0);
+    
+    estimator.update(1,1,0.0,1.0);
+    EstimatorResult result = estimator.tryGetVariance();
+    EXPECT_EQ(result.status, EstimatorStatus::NoRealRoot);
+    EXPECT_TRUE(std::isnan(result.value));
+}
+
+TEST(DVWTLSUnitTest, TryGetEstimateAndVarianceMatchesSeparateCalls) {
+    DualVarianceWeightedTotalLeastSquares estimator(1.0, 0.9, 1.0, 1.0, 2.0);
+    for (int i = 0; i < 10; i++) {
+        estimator.update(1.0 + i, 2.0 * i + 0.5, 0.2, 0.1);
+    }
+
+    EstimatorResult estimate, variance;
+    estimator.tryGetEstimateAndVariance(estimate, variance);
+    EXPECT_EQ(estimate.status, EstimatorStatus::Ok);
+    EXPECT_EQ(variance.status, EstimatorStatus::Ok);
+    EXPECT_EQ(estimate.value, estimator.tryGetEstimate().value);
+    EXPECT_EQ(variance.value, estimator.tryGetVariance().value);
+
+    DualVarianceWeightedTotalLeastSquares failing(3.0, 1.0, 1.0, 1.0, 1.0);
+    failing.update(1,1,0.0,1.0);
+    failing.tryGetEstimateAndVariance(estimate, variance);
+    EXPECT_EQ(estimate.status, EstimatorStatus::NoRealRoot);
+    EXPECT_EQ(estimate.value, 3.0);
+    EXPECT_EQ(variance.status, EstimatorStatus::NoRealRoot);
+    EXPECT_TRUE(std::isnan(variance.value));
+}
+
+TEST(DVWTLSUnitTest, TryCreateRejectsInvalidParameters) {
+    DualVarianceWeightedTotalLeastSquares estimator;
+    EXPECT_EQ(DualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 0.0, 1.0, 1.0, 1.0), EstimatorStatus::InvalidForgettingFactor);
+    EXPECT_EQ(DualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 0.0, 1.0, 1.0), EstimatorStatus::InvalidInitialXVariance);
+    EXPECT_EQ(DualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 1.0, 0.0, 1.0), EstimatorStatus::InvalidInitialYVariance);
+    EXPECT_EQ(DualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 1.0, 1.0, 0.0), EstimatorStatus::InvalidVarianceRatio);
+    EXPECT_EQ(DualVarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 1.0, 1.0, -1), EstimatorStatus::Ok);
+}
+
+TEST(DVWTLSUnitTest, CreateBatch) {
+    double nominal[] = {1.0, 2.0, 3.0};
+    double forgettingFactors[] = {1.0, 0.0, 0.9};
+    double variances[] = {1.0, 1.0, 1.0};
+    double ratios[] = {1.0, 1.0, -1};
+
+    DualVarianceWeightedTotalLeastSquares estimators[3];
+    EstimatorStatus statuses[3];
+    size_t created = DualVarianceWeightedTotalLeastSquares::createBatch(
+        nominal, forgettingFactors, variances, variances, ratios, 3, estimators, statuses
+    );
+
+    EXPECT_EQ(created, 2);
+    EXPECT_EQ(statuses[0], EstimatorStatus::Ok);
+    EXPECT_EQ(statuses[1], EstimatorStatus::InvalidForgettingFactor);
+    EXPECT_EQ(statuses[2], EstimatorStatus::Ok);
+    EXPECT_NEAR(estimators[0].getEstimate(), 1.0, 1e-6);
+    EXPECT_NEAR(estimators[2].getEstimate(), 3.0, 1e-6);
+}
+
+TEST(DVWTLSUnitTest, MergePartialMatchesSerial) {
+    DualVarianceWeightedTotalLeastSquares serial(1.0, 0.95, 1.0, 1.0, 2.0);
+    DualVarianceWeightedTotalLeastSquares merged(1.0, 0.95, 1.0, 1.0, 2.0);
+    DualVarianceWeightedTotalLeastSquares first = merged.partial();
+    DualVarianceWeightedTotalLeastSquares second = merged.partial();
+
+    for (int i = 0; i < 20; i++) {
+        serial.update(1.0 + i, 2.0 * i, 0.2, 0.1);
+        (i < 7 ? first : second).update(1.0 + i, 2.0 * i, 0.2, 0.1);
+    }
+    first.merge(second, 13);
+    merged.merge(first, 20);
+    EXPECT_NEAR(merged.getEstimate(), serial.getEstimate(), 1e-10);
+}
+
+TEST(DVWTLSUnitTest, MergeRescalesVarianceRatio) {
+    // Both take their ratio from the first update, so the second partial is on a different scale.
+    DualVarianceWeightedTotalLeastSquares serial(1.0, 1.0, 1.0, 1.0, 0.5);
+    DualVarianceWeightedTotalLeastSquares first(1.0, 1.0, 1.0, 1.0, 0.5);
+    DualVarianceWeightedTotalLeastSquares second = DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 3.0).partial();
+
+    for (int i = 0; i < 10; i++) {
+        serial.update(1.0 + i, 2.0 * i + 1.0, 0.2, 0.1);
+        (i < 5 ? first : second).update(1.0 + i, 2.0 * i + 1.0, 0.2, 0.1);
+    }
+    first.merge(second, 5);
+    EXPECT_NEAR(first.getEstimate(), serial.getEstimate(), 1e-10);
+}
+
+TEST(DVWTLSUnitTest, PrecisionUpdateMatchesUpdate) {
+    // No ratio given, so both take it from the first measurement.
+    DualVarianceWeightedTotalLeastSquares byVariance(1.0, 0.9, 1.0, 1.0);
+    DualVarianceWeightedTotalLeastSquares byPrecision(1.0, 0.9, 1.0, 1.0);
+    DualVarianceWeightedTotalLeastSquares byBatch(1.0, 0.9, 1.0, 1.0);
+    DualVarianceWeightedTotalLeastSquares byPrecisionBatch(1.0, 0.9, 1.0, 1.0);
+
+    double x[12], y[12], xVariance[12], yVariance[12], xPrecision[12], yPrecision[12];
+    for (int i = 0; i < 12; i++) {
+        x[i] = 1.0 + i;
+        y[i] = 2.0 * i + 0.5;
+        xVariance[i] = 0.2 + 0.01 * i;
+        yVariance[i] = 0.1 + 0.02 * i;
+        xPrecision[i] = 1 / xVariance[i];
+        yPrecision[i] = 1 / yVariance[i];
+        byVariance.update(x[i], y[i], xVariance[i], yVariance[i]);
+        byPrecision.updatePrecision(x[i], y[i], xPrecision[i], yPrecision[i]);
+    }
+    byBatch.update(x, y, xVariance, yVariance, 12);
+    byPrecisionBatch.updatePrecision(x, y, xPrecision, yPrecision, 12);
+
+    double expected = byVariance.getEstimate();
+    EXPECT_NEAR(byPrecision.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byBatch.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byPrecisionBatch.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byPrecisionBatch.getVariance(), byVariance.getVariance(), 1e-12);
+}
+
+TEST(DVWTLSUnitTest, QuarticMethodIsPerEstimator) {
+    DualVarianceWeightedTotalLeastSquares nbs(1.0, 0.95, 1.0, 1.0, 2.0);
+    DualVarianceWeightedTotalLeastSquares companion(1.0, 0.95, 1.0, 1.0, 2.0);
+    companion.setQuarticMethod(QuarticMethod::Companion);
+
+    for (int i = 0; i < 20; i++) {
+        nbs.update(1.0 + i, 2.0 * i + 1.0, 0.2, 0.1);
+        companion.update(1.0 + i, 2.0 * i + 1.0, 0.2, 0.1);
+    }
+    EXPECT_EQ(nbs.getQuarticMethod(), QuarticMethod::NBS);
+    EXPECT_EQ(companion.getQuarticMethod(), QuarticMethod::Companion);
+    EXPECT_NEAR(companion.getEstimate(), nbs.getEstimate(), 1e-8);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <EstimatorPool.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <vector>
+
+
+TEST(EstimatorPoolUnitTest, CreateAndGet) {
+    EstimatorPool<VarianceWeightedTotalLeastSquares> pool;
+    EstimatorHandle first = pool.create(VarianceWeightedTotalLeastSquares(2.0));
+    EstimatorHandle second = pool.create(VarianceWeightedTotalLeastSquares(-1.0));
+    EXPECT_NE(first, second);
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_NEAR(pool.get(first).getEstimate(), 2.0, 1e-8);
+    EXPECT_NEAR(pool.get(second).getEstimate(), -1.0, 1e-8);
+
+    pool.update(first, 1.0, 3.0, 1e-4);
+    EXPECT_NEAR(pool.get(first).getEstimate(), 3.0, 1e-3);
+}
+
+TEST(EstimatorPoolUnitTest, StaleHandlesAreRejected) {
+    EstimatorPool<VarianceWeightedTotalLeastSquares> pool;
+    EstimatorHandle handle = pool.create();
+    pool.destroy(handle);
+    EXPECT_FALSE(pool.contains(handle));
+    EXPECT_EQ(pool.tryGet(handle), nullptr);
+    EXPECT_THROW(pool.get(handle), std::out_of_range);
+    EXPECT_THROW(pool.destroy(handle), std::out_of_range);
+
+    // The slot is reused with a new generation, the old handle still doesn't reach it.
+    EstimatorHandle reused = pool.create(VarianceWeightedTotalLeastSquares(5.0));
+    EXPECT_EQ(reused.slot, handle.slot);
+    EXPECT_NE(reused.generation, handle.generation);
+    EXPECT_FALSE(pool.contains(handle));
+    EXPECT_TRUE(pool.contains(reused));
+    EXPECT_FALSE(pool.contains(invalidEstimatorHandle));
+}
+
+TEST(EstimatorPoolUnitTest, HolesAreReusedAndCompacted) {
+    EstimatorPool<VarianceWeightedTotalLeastSquares> pool;
+    std::vector<EstimatorHandle> handles;
+    for (int i = 0; i < 10; ++i) {
+        handles.push_back(pool.create(VarianceWeightedTotalLeastSquares(i)));
+    }
+    for (int i = 0; i < 10; i += 2) {
+        pool.destroy(handles[i]);
+    }
+    EXPECT_EQ(pool.size(), 5u);
+    EXPECT_EQ(pool.holeCount(), 5u);
+    EXPECT_EQ(pool.handleAt(0), invalidEstimatorHandle);
+
+    EstimatorHandle filled = pool.create(VarianceWeightedTotalLeastSquares(100.0));
+    EXPECT_EQ(pool.storageSize(), 10u);
+    EXPECT_EQ(pool.holeCount(), 4u);
+
+    EXPECT_FALSE(pool.compactIfFragmented(0.5));
+    EXPECT_TRUE(pool.compactIfFragmented(0.25));
+    EXPECT_EQ(pool.storageSize(), 6u);
+    EXPECT_EQ(pool.holeCount(), 0u);
+
+    // Handles survive, and the storage is exactly the live estimators in their previous order.
+    for (int i = 1; i < 10; i += 2) {
+        EXPECT_NEAR(pool.get(handles[i]).getEstimate(), i, 1e-8);
+    }
+    EXPECT_NEAR(pool.get(filled).getEstimate(), 100.0, 1e-6);
+    for (size_t i = 1; i < pool.storageSize(); ++i) {
+        EXPECT_LT(pool.storageIndex(pool.handleAt(i - 1)), pool.storageIndex(pool.handleAt(i)));
+        EXPECT_EQ(&pool.get(pool.handleAt(i)), pool.data() + i);
+    }
+
+    size_t visited = 0;
+    pool.forEach([&](EstimatorHandle handle, VarianceWeightedTotalLeastSquares& estimator) {
+        EXPECT_EQ(&pool.get(handle), &estimator);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 6u);
+}
+
+TEST(EstimatorPoolUnitTest, BatchLifecycle) {
+    EstimatorPool<DualVarianceWeightedTotalLeastSquares> pool(4);
+    const double nominalValues[4] = {1.0, 2.0, 3.0, 4.0};
+    const double forgettingFactors[4] = {1.0, 0.99, 2.0, 1.0};
+    const double initialXVariances[4] = {1.0, 1.0, 1.0, 1.0};
+    const double initialYVariances[4] = {1.0, 1.0, 1.0, -1.0};
+    const double varianceRatios[4] = {-1.0, -1.0, -1.0, -1.0};
+    EstimatorHandle handles[4];
+    EstimatorStatus statuses[4];
+
+    EXPECT_EQ(pool.createBatch(4, handles, statuses, nominalValues, forgettingFactors, initialXVariances, initialYVariances, varianceRatios), 2u);
+    EXPECT_EQ(statuses[2], EstimatorStatus::InvalidForgettingFactor);
+    EXPECT_EQ(statuses[3], EstimatorStatus::InvalidInitialYVariance);
+    EXPECT_EQ(handles[2], invalidEstimatorHandle);
+    EXPECT_EQ(pool.size(), 2u);
+
+    const double x[2] = {1.0, 1.0};
+    const double y[2] = {1.5, 2.5};
+    const double variances[2] = {1e-2, 1e-2};
+    pool.updateBatch(handles, 2, x, y, variances, variances);
+    DualVarianceWeightedTotalLeastSquares expected(2.0, 0.99, 1.0, 1.0);
+    expected.update(1.0, 2.5, 1e-2, 1e-2);
+    EXPECT_EQ(pool.get(handles[1]).getEstimate(), expected.getEstimate());
+
+    EXPECT_EQ(pool.destroyBatch(handles, 4), 2u);
+    EXPECT_EQ(pool.size(), 0u);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <helper/fastMath.h>
+#include <tuple>
+
+
+class FastExp2ParamTest : public ::testing::TestWithParam<double> {};
+
+TEST_P(FastExp2ParamTest, MatchesExp2) {
+    double x = GetParam();
+    EXPECT_NEAR(fast_exp2(x) / std::exp2(x), 1.0, 1e-15);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FastExp2ParamTests,
+    FastExp2ParamTest,
+    ::testing::Values(0.0, 0.5, -0.5, 1.0, -1.0, 0.49999, 3.3, -7.25, -100.1, 200.9, -1021.7, 1022.4)
+);
+
+TEST(FastMathUnitTest, FastExp2Limits) {
+    EXPECT_EQ(fast_exp2(-2000.0), 0.0);
+    EXPECT_TRUE(std::isinf(fast_exp2(2000.0)));
+    EXPECT_TRUE(std::isnan(fast_exp2(NAN)));
+}
+
+TEST(FastMathUnitTest, IntegerPower) {
+    EXPECT_EQ(integer_power(0.5, 0), 1.0);
+    EXPECT_EQ(integer_power(0.5, 3), 0.125);
+    EXPECT_NEAR(integer_power(0.99, 37), std::pow(0.99, 37), 1e-15);
+}
+
+class ForgettingDecayParamTest : public ::testing::TestWithParam<std::tuple<double, double>> {};
+
+TEST_P(ForgettingDecayParamTest, MatchesPow) {
+    double forgettingFactor = std::get<0>(GetParam());
+    double steps = std::get<1>(GetParam());
+    EXPECT_NEAR(
+        forgetting_decay(forgettingFactor, std::log2(forgettingFactor), steps) / std::pow(forgettingFactor, steps),
+        1.0, 1e-14
+    );
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ForgettingDecayParamTests,
+    ForgettingDecayParamTest,
+    ::testing::Values(
+        std::make_tuple(1.0, 3.5),
+        std::make_tuple(0.99, 0.0),
+        std::make_tuple(0.99, 1.0),
+        std::make_tuple(0.99, 64.0),
+        std::make_tuple(0.97, 2.5),
+        std::make_tuple(0.5, 0.001),
+        std::make_tuple(0.999, 12345.6)
+    )
+);
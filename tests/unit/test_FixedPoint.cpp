@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <helper/fixedPoint.h>
+#include <FixedPointVarianceWeightedTotalLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <cmath>
+#include <random>
+
+
+typedef FixedPoint<int32_t, 16> Q16;
+typedef FixedPoint<int16_t, 8> Q8;
+
+TEST(FixedPointUnitTest, ConversionsRoundAndSaturate) {
+    EXPECT_EQ(Q16::fromDouble(1.5).raw(), 3 << 15);
+    EXPECT_EQ(Q16::fromDouble(-0.25).toDouble(), -0.25);
+    EXPECT_EQ(Q16::fromDouble(1e9), Q16::max());
+    EXPECT_EQ(Q16::fromDouble(-1e9), Q16::min());
+    EXPECT_EQ(Q16::fromDouble(NAN), Q16());
+    EXPECT_EQ(Q16::fromInteger(-3).toDouble(), -3.0);
+    EXPECT_EQ(Q8::fromInteger(1000), Q8::max());
+}
+
+TEST(FixedPointUnitTest, ArithmeticSaturates) {
+    EXPECT_EQ((Q16::fromDouble(1.5) * Q16::fromDouble(-2.25)).toDouble(), -3.375);
+    EXPECT_EQ((Q16::fromDouble(2.0) + Q16::fromDouble(0.5)).toDouble(), 2.5);
+    EXPECT_EQ(Q16::fromInteger(30000) * Q16::fromInteger(3), Q16::max());
+    EXPECT_EQ(Q16::fromInteger(-30000) - Q16::fromInteger(30000), Q16::min());
+    EXPECT_EQ(-Q16::min(), Q16::max());
+    EXPECT_TRUE(Q8::fromInteger(100) * Q8::fromInteger(100) == Q8::max());
+}
+
+TEST(FixedPointUnitTest, ReciprocalAndDivideWithinTwoUlp) {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> exponent(-12.0, 12.0);
+    for (int i = 0; i < 2000; ++i) {
+        Q16 value = Q16::fromDouble(std::exp2(exponent(generator)) * (i % 2 == 0 ? 1 : -1));
+        EXPECT_NEAR(fixed_reciprocal(value).toDouble(), 1.0 / value.toDouble(), std::ldexp(1.0, -15)) << value.toDouble();
+
+        Q16 numerator = Q16::fromDouble(std::exp2(exponent(generator)));
+        double expected = numerator.toDouble() / value.toDouble();
+        if (std::fabs(expected) < 32000) {
+            EXPECT_NEAR(fixed_divide(numerator, value).toDouble(), expected, std::ldexp(1.0, -15)) << numerator.toDouble() << " / " << value.toDouble();
+        }
+    }
+
+    EXPECT_EQ(fixed_reciprocal(Q16()), Q16::max());
+    EXPECT_EQ(fixed_reciprocal(Q16::fromRaw(1)), Q16::max());
+    EXPECT_EQ(fixed_divide(-Q16::one(), Q16()), Q16::min());
+
+#if defined(__SIZEOF_INT128__)
+    typedef FixedPoint<int64_t, 32> Q32;
+    EXPECT_NEAR(fixed_reciprocal(Q32::fromDouble(3.0)).toDouble(), 1.0 / 3.0, std::ldexp(1.0, -31));
+    EXPECT_NEAR(fixed_divide(Q32::fromDouble(-1e6), Q32::fromDouble(7.0)).toDouble(), -1e6 / 7.0, std::ldexp(1.0, -31));
+#endif
+}
+
+TEST(FixedPointUnitTest, SqrtRoundsDown) {
+    EXPECT_EQ(fixed_sqrt(Q16::fromInteger(4)).toDouble(), 2.0);
+    EXPECT_EQ(fixed_sqrt(Q16::fromDouble(-1.0)), Q16());
+    EXPECT_EQ(fixed_integer_sqrt<uint64_t>(99), 9u);
+    for (double value : {0.5, 2.0, 1000.0, 32767.0, 1e-4}) {
+        double root = fixed_sqrt(Q16::fromDouble(value)).toDouble();
+        EXPECT_LE(root, std::sqrt(Q16::fromDouble(value).toDouble()));
+        EXPECT_GT(root + std::ldexp(1.0, -16), std::sqrt(Q16::fromDouble(value).toDouble()));
+    }
+}
+
+
+// Feed both estimators the same quantised measurements and compare to within the resolution of the Q format.
+template <typename Storage, int FractionBits>
+void expectMatchesDoublePrecision(double noiseDeviation, double relativeTolerance) {
+    typedef FixedPoint<Storage, FractionBits> Fixed;
+    const double ulp = std::ldexp(1.0, -FractionBits);
+    VarianceWeightedTotalLeastSquares reference(0.5, 0.8, 0.98, 2.0);
+    FixedPointVarianceWeightedTotalLeastSquares<Storage, FractionBits> fixed(
+        Fixed::fromDouble(0.5), Fixed::fromDouble(0.8), Fixed::fromDouble(0.98), Fixed::fromDouble(2.0)
+    );
+
+    std::mt19937_64 generator(3);
+    std::normal_distribution<double> noise(0.0, noiseDeviation);
+    Fixed yVariance = Fixed::fromDouble(noiseDeviation * noiseDeviation);
+    for (int i = 1; i <= 500; ++i) {
+        Fixed x = Fixed::fromDouble(2.0 + std::sin(0.1 * i));
+        Fixed y = Fixed::fromDouble(1.7 * x.toDouble() + noise(generator));
+        reference.update(x.toDouble(), y.toDouble(), yVariance.toDouble());
+        fixed.update(x, y, yVariance);
+
+        if (i % 50 == 0) {
+            EXPECT_NEAR(fixed.getEstimate().toDouble(), reference.getEstimate(), relativeTolerance * std::fabs(reference.getEstimate()) + 2 * ulp);
+            EXPECT_NEAR(fixed.getVariance().toDouble(), reference.getVariance(), relativeTolerance * reference.getVariance() + 2 * ulp);
+        }
+    }
+    EXPECT_TRUE(fixed.tryGetEstimate().ok());
+    EXPECT_TRUE(fixed.tryGetVariance().ok());
+}
+
+TEST(FixedPointVWTLSUnitTest, MatchesDoublePrecision) {
+    expectMatchesDoublePrecision<int32_t, 16>(0.5, 1e-3);
+    // A variance of a few ulp, only the absolute error is small.
+    expectMatchesDoublePrecision<int32_t, 16>(0.05, 1e-4);
+#if defined(__SIZEOF_INT128__)
+    expectMatchesDoublePrecision<int64_t, 32>(0.05, 1e-6);
+#endif
+}
+
+TEST(FixedPointVWTLSUnitTest, StatisticsDoNotSaturateWithoutForgetting) {
+    // c1 grows to 1e6, far beyond the Q15.16 range, which the shared exponent absorbs.
+    VarianceWeightedTotalLeastSquares reference(-3.0, 2.0, 1.0, 1.0);
+    FixedPointVarianceWeightedTotalLeastSquares<> fixed(Q16::fromInteger(-3), Q16::fromInteger(2));
+    for (int i = 0; i < 10000; ++i) {
+        Q16 x = Q16::fromDouble(10.0 + 0.001 * (i % 17));
+        Q16 y = Q16::fromDouble(-3.0 * x.toDouble() + 0.01 * ((i * 7) % 13 - 6));
+        reference.updatePrecision(x.toDouble(), y.toDouble(), 1.0);
+        fixed.updatePrecision(x, y, Q16::one());
+    }
+    EXPECT_NEAR(fixed.getEstimate().toDouble(), reference.getEstimate(), 1e-3);
+    EXPECT_NEAR(fixed.getVariance().toDouble(), reference.getVariance(), std::ldexp(1.0, -15));
+}
+
+TEST(FixedPointVWTLSUnitTest, SixteenBitStorage) {
+    VarianceWeightedTotalLeastSquares reference(1.0, 1.0, 0.9, 1.0);
+    FixedPointVarianceWeightedTotalLeastSquares<int16_t, 8> fixed(Q8::one(), Q8::one(), Q8::fromDouble(0.9));
+    for (int i = 1; i <= 100; ++i) {
+        Q8 x = Q8::fromDouble(0.5 + 0.01 * (i % 50));
+        Q8 y = Q8::fromDouble(0.75 * x.toDouble());
+        reference.update(x.toDouble(), y.toDouble(), 0.5);
+        fixed.update(x, y, Q8::fromDouble(0.5));
+    }
+    EXPECT_NEAR(fixed.getEstimate().toDouble(), reference.getEstimate(), 0.02);
+}
+
+TEST(FixedPointVWTLSUnitTest, SaturatedResultsAreReported) {
+    // A slope beyond the Q7.8 range.
+    FixedPointVarianceWeightedTotalLeastSquares<int16_t, 8> fixed;
+    for (int i = 0; i < 10; ++i) {
+        fixed.update(Q8::fromDouble(0.01), Q8::fromInteger(100), Q8::one());
+    }
+    EXPECT_EQ(fixed.tryGetEstimate().status, EstimatorStatus::NotFinite);
+    EXPECT_EQ(fixed.getEstimate(), Q8::max());
+    EXPECT_EQ(fixed.tryGetVariance().status, EstimatorStatus::NotFinite);
+}
+
+TEST(FixedPointVWTLSUnitTest, InvalidParameters) {
+    typedef FixedPointVarianceWeightedTotalLeastSquares<> Estimator;
+    EXPECT_THROW(Estimator(Q16(), Q16(), Q16::one(), Q16::one()), std::invalid_argument);
+    EXPECT_THROW(Estimator(Q16(), Q16::one(), Q16::fromDouble(1.5), Q16::one()), std::invalid_argument);
+    EXPECT_THROW(Estimator(Q16(), Q16::one(), Q16::one(), Q16()), std::invalid_argument);
+
+    EXPECT_EQ(Estimator::checkParameters(Q16::fromInteger(1000), Q16::one(), Q16::one()), EstimatorStatus::InvalidVarianceRatio);
+    EXPECT_EQ(Estimator::checkParameters(Q16::one(), Q16::one(), Q16::fromRaw(1)), EstimatorStatus::InvalidInitialVariance);
+
+    Estimator out(Q16::fromInteger(2));
+    EXPECT_EQ(Estimator::tryCreate(out, Q16(), Q16(), Q16::one(), Q16::one()), EstimatorStatus::InvalidVarianceRatio);
+    EXPECT_EQ(out.getEstimate().toDouble(), 2.0);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <FleetExecutor.h>
+#include <vector>
+
+
+TEST(FleetExecutorUnitTest, DualMatchesSerial) {
+    const size_t count = 3000;
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(count, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    std::vector<DualVarianceWeightedTotalLeastSquares> serial = fleet;
+    std::vector<double> x(count), y(count), xVariance(count, 1e-2), yVariance(count, 1e-2);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + 1e-3 * i;
+        y[i] = 2.0 * x[i];
+    }
+    // A degenerate estimator must not stop the rest of the fleet.
+    xVariance[7] = 0.0;
+
+    std::vector<double> estimates(count), variances(count);
+    std::vector<EstimatorStatus> statuses(count);
+    FleetExecutor executor(4, false, 1024);
+    executor.updateAndEstimate(fleet.data(), count, x.data(), y.data(), xVariance.data(), yVariance.data(),
+                               estimates.data(), variances.data(), statuses.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        serial[i].update(x[i], y[i], xVariance[i], yVariance[i]);
+        EXPECT_EQ(estimates[i], serial[i].tryGetEstimate().value);
+        if (i != 7) {
+            EXPECT_EQ(variances[i], serial[i].tryGetVariance().value);
+            EXPECT_EQ(statuses[i], EstimatorStatus::Ok);
+        }
+    }
+    EXPECT_EQ(statuses[7], EstimatorStatus::NoRealRoot);
+    EXPECT_EQ(estimates[7], 1.0);
+}
+
+TEST(FleetExecutorUnitTest, VWTLSWithoutVariances) {
+    const size_t count = 500;
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(count);
+    std::vector<double> x(count, 1.0), y(count, 3.0), yVariance(count, 1e-4);
+    std::vector<double> estimates(count);
+
+    FleetExecutor executor(2, false);
+    executor.updateAndEstimate(fleet.data(), count, x.data(), y.data(), yVariance.data(), estimates.data(), nullptr, nullptr);
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_NEAR(estimates[i], 3.0, 1e-3);
+    }
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <IngestPipeline.h>
+#include <helper/SpscRing.h>
+#include <thread>
+#include <vector>
+
+
+TEST(SpscRingUnitTest, FullAndEmpty) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4);
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(4));
+
+    int out[8];
+    EXPECT_EQ(ring.popBatch(out, 8), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_FALSE(ring.tryPop(out[0]));
+}
+
+TEST(SpscRingUnitTest, InvalidCapacity) {
+    EXPECT_THROW(SpscRing<int>(0), std::invalid_argument);
+}
+
+TEST(SpscRingUnitTest, KeepsOrderAcrossThreads) {
+    SpscRing<int> ring(16);
+    const int items = 100000;
+    std::thread producer([&]() {
+        for (int i = 0; i < items; ++i) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int value;
+    while (expected < items) {
+        if (ring.tryPop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(IngestPipelineUnitTest, InvalidShards) {
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(4);
+    EXPECT_THROW(IngestPipeline<VarianceWeightedTotalLeastSquares>(fleet.data(), fleet.size(), 0, 1), std::invalid_argument);
+}
+
+TEST(IngestPipelineUnitTest, RejectsUnknownEstimator) {
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(4);
+    IngestPipeline<VarianceWeightedTotalLeastSquares> pipeline(fleet.data(), fleet.size(), 2, 1);
+    IngestPipeline<VarianceWeightedTotalLeastSquares>::Producer& producer = pipeline.getProducer(0);
+    EXPECT_THROW(producer.push({4, 1.0, 1.0, 1.0, 1.0}), std::out_of_range);
+    EXPECT_THROW(producer.tryPush({1000, 1.0, 1.0, 1.0, 1.0}), std::out_of_range);
+    EXPECT_TRUE(producer.tryPush({3, 1.0, 1.0, 1.0, 1.0}));
+
+    pipeline.start();
+    pipeline.stop();
+    EXPECT_EQ(pipeline.getAppliedCount(), 1u);
+}
+
+TEST(IngestPipelineUnitTest, MatchesSerialUpdates) {
+    const size_t estimators = 100;
+    const unsigned int producers = 3;
+    const size_t recordsPerProducer = 20000;
+
+    std::vector<DualVarianceWeightedTotalLeastSquares> fleet(estimators, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    std::vector<DualVarianceWeightedTotalLeastSquares> serial = fleet;
+
+    // Small rings so producers regularly hit back-pressure.
+    IngestPipeline<DualVarianceWeightedTotalLeastSquares> pipeline(fleet.data(), fleet.size(), 4, producers, 8, 4);
+    pipeline.start();
+
+    std::vector<std::thread> readers;
+    for (unsigned int p = 0; p < producers; ++p) {
+        readers.emplace_back([&pipeline, p, estimators, recordsPerProducer]() {
+            IngestPipeline<DualVarianceWeightedTotalLeastSquares>::Producer& producer = pipeline.getProducer(p);
+            for (size_t i = 0; i < recordsPerProducer; ++i) {
+                double x = 1.0 + (i % 7);
+                producer.push({(i * 7 + p) % estimators, x, 2.0 * x, 1e-2, 1e-2});
+            }
+        });
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(pipeline.getAppliedCount(), producers * recordsPerProducer);
+
+    for (unsigned int p = 0; p < producers; ++p) {
+        for (size_t i = 0; i < recordsPerProducer; ++i) {
+            double x = 1.0 + (i % 7);
+            serial[(i * 7 + p) % estimators].update(x, 2.0 * x, 1e-2, 1e-2);
+        }
+    }
+    // Forgetting factor of one, so only the summation order differs.
+    for (size_t i = 0; i < estimators; ++i) {
+        EXPECT_NEAR(fleet[i].getEstimate(), serial[i].getEstimate(), 1e-9);
+    }
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <LazyEstimatorBank.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+
+
+TEST(LazyBankUnitTest, StartsDirty) {
+    LazyEstimatorBank<VarianceWeightedTotalLeastSquares> bank(4, VarianceWeightedTotalLeastSquares(2.0));
+    EXPECT_EQ(bank.size(), 4);
+    EXPECT_EQ(bank.dirtyCount(), 4);
+
+    bank.recomputeDirty();
+    EXPECT_EQ(bank.dirtyCount(), 0);
+    EXPECT_NEAR(bank.getEstimate(3).value, 2.0, 1e-8);
+}
+
+TEST(LazyBankUnitTest, UpdateMarksOnlyThatCellDirty) {
+    LazyEstimatorBank<VarianceWeightedTotalLeastSquares> bank(4);
+    bank.recomputeDirty();
+
+    bank.update(1, 1.0, 3.0, 1e-4);
+    bank.update(1, 2.0, 6.0, 1e-4);
+    EXPECT_FALSE(bank.isDirty(0));
+    EXPECT_TRUE(bank.isDirty(1));
+    EXPECT_EQ(bank.dirtyCount(), 1);
+}
+
+TEST(LazyBankUnitTest, MatchesEagerEstimator) {
+    LazyEstimatorBank<VarianceWeightedTotalLeastSquares> bank(2);
+    VarianceWeightedTotalLeastSquares eager;
+
+    bank.update(0, 1.0, 3.0, 1e-2);
+    eager.update(1.0, 3.0, 1e-2);
+    EXPECT_EQ(bank.getEstimate(0).value, eager.getEstimate());
+    EXPECT_EQ(bank.getVariance(0).value, eager.getVariance());
+    EXPECT_FALSE(bank.isDirty(0));
+
+    bank.update(0, 2.0, 5.0, 1e-2);
+    eager.update(2.0, 5.0, 1e-2);
+    EXPECT_TRUE(bank.isDirty(0));
+    EXPECT_EQ(bank.getEstimate(0).value, eager.getEstimate());
+}
+
+TEST(LazyBankUnitTest, ParallelRecomputeMatchesSerial) {
+    const size_t cells = 4096;
+    LazyEstimatorBank<DualVarianceWeightedTotalLeastSquares> bank(cells, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    std::vector<DualVarianceWeightedTotalLeastSquares> serial(cells, DualVarianceWeightedTotalLeastSquares(1.0, 1.0, 1.0, 1.0, 1.0));
+    bank.recomputeDirty();
+
+    for (size_t i = 0; i < cells; i += 3) {
+        bank.update(i, 1.0, 1.0 + 1e-3 * i, 1e-2, 1e-2);
+        serial[i].update(1.0, 1.0 + 1e-3 * i, 1e-2, 1e-2);
+    }
+    bank.recomputeDirty(4);
+
+    EXPECT_EQ(bank.dirtyCount(), 0);
+    for (size_t i = 0; i < cells; ++i) {
+        EXPECT_EQ(bank.getEstimate(i).value, serial[i].tryGetEstimate().value);
+        EXPECT_EQ(bank.getVariance(i).value, serial[i].tryGetVariance().value);
+    }
+}
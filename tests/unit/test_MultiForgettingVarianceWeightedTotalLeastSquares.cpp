@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <MultiForgettingVarianceWeightedTotalLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+TEST(MultiForgettingVWTLSUnitTest, MatchesIndependentEstimators) {
+    const std::vector<double> forgettingFactors = {1.0, 0.99, 0.95, 0.8, 0.5};
+    MultiForgettingVarianceWeightedTotalLeastSquares multi(forgettingFactors, 1.0, 0.5, 10.0);
+    std::vector<VarianceWeightedTotalLeastSquares> single;
+    for (double forgettingFactor : forgettingFactors) {
+        single.push_back(VarianceWeightedTotalLeastSquares(1.0, 0.5, forgettingFactor, 10.0));
+    }
+
+    for (int i = 0; i < 40; i++) {
+        double x = 1.0 + 0.1 * i;
+        double y = 1.5 * x + 0.01 * ((i * 7) % 5);
+        double yVariance = 0.01 * (1 + i % 3);
+        if (i % 2 == 0) {
+            multi.update(x, y, yVariance);
+        } else {
+            multi.updatePrecision(x, y, 1 / yVariance);
+        }
+        for (VarianceWeightedTotalLeastSquares& estimator : single) {
+            estimator.update(x, y, yVariance);
+        }
+    }
+
+    size_t count = forgettingFactors.size();
+    std::vector<double> estimates(count), variances(count);
+    std::vector<EstimatorStatus> statuses(count);
+    multi.getEstimates(estimates.data(), variances.data(), statuses.data());
+
+    ASSERT_EQ(multi.hypotheses(), count);
+    for (size_t k = 0; k < count; ++k) {
+        double expected = single[k].getEstimate();
+        EXPECT_EQ(multi.getForgettingFactor(k), forgettingFactors[k]);
+        EXPECT_NEAR(multi.getEstimate(k), expected, 1e-9) << k;
+        EXPECT_NEAR(multi.getVariance(k), single[k].getVariance(), 1e-9) << k;
+        EXPECT_EQ(statuses[k], EstimatorStatus::Ok);
+        EXPECT_NEAR(estimates[k], expected, 1e-9) << k;
+        EXPECT_NEAR(variances[k], single[k].getVariance(), 1e-9) << k;
+    }
+}
+
+TEST(MultiForgettingVWTLSUnitTest, SelectsHypothesisThatPredictsBest) {
+    MultiForgettingVarianceWeightedTotalLeastSquares multi({1.0, 0.9}, 2.0, 0.1, 1.0, 0.95);
+    std::mt19937 generator(3);
+    std::normal_distribution<double> noise(0.0, 0.1);
+
+    // A steady slope favours remembering everything.
+    for (int i = 0; i < 300; i++) {
+        double x = 1.0 + (i % 10) * 0.1;
+        multi.update(x, 2.0 * x + noise(generator), 0.01);
+    }
+    EXPECT_EQ(multi.bestHypothesis(), 0u);
+    EXPECT_GT(multi.getScore(0), multi.getScore(1));
+
+    // After the slope steps, only the short memory follows it.
+    for (int i = 0; i < 50; i++) {
+        double x = 1.0 + (i % 10) * 0.1;
+        multi.update(x, 3.0 * x + noise(generator), 0.01);
+    }
+    EXPECT_EQ(multi.bestHypothesis(), 1u);
+    EXPECT_NEAR(multi.tryGetSelectedEstimate().value, 3.0, 0.1);
+    EXPECT_EQ(multi.tryGetSelectedVariance().status, EstimatorStatus::Ok);
+}
+
+TEST(MultiForgettingVWTLSUnitTest, BlendIsWeightedByScore) {
+    MultiForgettingVarianceWeightedTotalLeastSquares multi({1.0, 0.95, 0.7}, 1.0, 0.2, 1.0, 0.9);
+    for (int i = 0; i < 60; i++) {
+        double x = 0.5 + 0.05 * i;
+        double slope = i < 40 ? 1.0 : 1.5;
+        multi.update(x, slope * x + 0.02 * ((i * 5) % 7), 0.01);
+    }
+
+    double weights[3];
+    multi.getWeights(weights);
+    EXPECT_NEAR(weights[0] + weights[1] + weights[2], 1.0, 1e-12);
+    EXPECT_EQ(std::max_element(weights, weights + 3) - weights, static_cast<std::ptrdiff_t>(multi.bestHypothesis()));
+
+    double expected = 0.0;
+    for (size_t k = 0; k < 3; ++k) {
+        expected += weights[k] * multi.getEstimate(k);
+    }
+    EstimatorResult blended = multi.tryGetBlendedEstimate();
+    EXPECT_EQ(blended.status, EstimatorStatus::Ok);
+    EXPECT_NEAR(blended.value, expected, 1e-12);
+
+    // The mixture is at least as uncertain as its members on average.
+    double averageVariance = 0.0;
+    for (size_t k = 0; k < 3; ++k) {
+        averageVariance += weights[k] * multi.getVariance(k);
+    }
+    EstimatorResult variance = multi.tryGetBlendedVariance();
+    EXPECT_EQ(variance.status, EstimatorStatus::Ok);
+    EXPECT_GE(variance.value, averageVariance * (1 - 1e-12));
+}
+
+TEST(MultiForgettingVWTLSUnitTest, InvalidParameters) {
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares(std::vector<double>()), std::invalid_argument);
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares({1.0, 1.5}), std::invalid_argument);
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares({1.0, 0.0}), std::invalid_argument);
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares({1.0}, 0.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares({1.0}, 0.0, 1.0, -1.0), std::invalid_argument);
+    EXPECT_THROW(MultiForgettingVarianceWeightedTotalLeastSquares({1.0}, 0.0, 1.0, 1.0, 0.0), std::invalid_argument);
+}
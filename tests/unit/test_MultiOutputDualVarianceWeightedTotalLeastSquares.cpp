@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <MultiOutputDualVarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <tuple>
+#include <vector>
+
+
+class MultiOutputDVWTLSParamTest : public ::testing::TestWithParam<std::tuple<double, bool>> {};
+
+TEST_P(MultiOutputDVWTLSParamTest, MatchesIndependentEstimators) {
+    double varianceRatio = std::get<0>(GetParam());
+    bool precision = std::get<1>(GetParam());
+    const size_t outputs = 13;
+
+    MultiOutputDualVarianceWeightedTotalLeastSquares multi(outputs, 1.0, 0.98, 10.0, 10.0, varianceRatio);
+    std::vector<DualVarianceWeightedTotalLeastSquares> single(
+        outputs, DualVarianceWeightedTotalLeastSquares(1.0, 0.98, 10.0, 10.0, varianceRatio)
+    );
+
+    std::vector<double> y(outputs), yVariance(outputs), yPrecision(outputs);
+    for (int i = 0; i < 30; i++) {
+        double x = 1.0 + 0.1 * i;
+        double xVariance = 0.02 + 0.001 * i;
+        for (size_t k = 0; k < outputs; ++k) {
+            y[k] = (0.5 + 0.25 * k) * x + 0.01 * ((i * 7 + k) % 5);
+            yVariance[k] = 0.01 * (1 + k % 3);
+            yPrecision[k] = 1 / yVariance[k];
+            single[k].update(x, y[k], xVariance, yVariance[k]);
+        }
+        if (precision) {
+            multi.updatePrecision(x, 1 / xVariance, y.data(), yPrecision.data());
+        } else {
+            multi.update(x, xVariance, y.data(), yVariance.data());
+        }
+    }
+
+    std::vector<double> estimates(outputs), variances(outputs);
+    std::vector<EstimatorStatus> statuses(outputs);
+    multi.getEstimates(estimates.data(), variances.data(), statuses.data());
+
+    for (size_t k = 0; k < outputs; ++k) {
+        double expected = single[k].getEstimate();
+        EXPECT_NEAR(multi.getEstimate(k), expected, 1e-9) << k;
+        EXPECT_NEAR(multi.getVariance(k), single[k].getVariance(), 1e-9) << k;
+        EXPECT_EQ(statuses[k], EstimatorStatus::Ok);
+        EXPECT_NEAR(estimates[k], expected, 1e-9) << k;
+        EXPECT_NEAR(variances[k], single[k].getVariance(), 1e-9) << k;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MultiOutputDVWTLSParamTests,
+    MultiOutputDVWTLSParamTest,
+    ::testing::Values(
+        std::make_tuple(-1.0, false),
+        std::make_tuple(-1.0, true),
+        std::make_tuple(2.0, false),
+        std::make_tuple(0.5, true)
+    )
+);
+
+TEST(MultiOutputDVWTLSUnitTest, InvalidParameters) {
+    EXPECT_THROW(MultiOutputDualVarianceWeightedTotalLeastSquares(4, 0.0, 1.5), std::invalid_argument);
+    EXPECT_THROW(MultiOutputDualVarianceWeightedTotalLeastSquares(4, 0.0, 1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(MultiOutputDualVarianceWeightedTotalLeastSquares(4, 0.0, 1.0, 1.0, -1.0), std::invalid_argument);
+    EXPECT_THROW(MultiOutputDualVarianceWeightedTotalLeastSquares(4, 0.0, 1.0, 1.0, 1.0, 0.0), std::invalid_argument);
+}
+
+TEST(MultiOutputDVWTLSUnitTest, DegenerateOutputKeepsLastGoodValue) {
+    MultiOutputDualVarianceWeightedTotalLeastSquares multi(2, 1.0, 1.0, 1.0, 1.0);
+    double y[2] = {1.0, 1.0};
+    double yVariance[2] = {1.0, 1.0};
+    // Zero x variance leaves every output with no real root.
+    multi.update(1.0, 0.0, y, yVariance);
+
+    double estimates[2];
+    double variances[2];
+    EstimatorStatus statuses[2];
+    multi.getEstimates(estimates, variances, statuses);
+    EXPECT_EQ(statuses[0], EstimatorStatus::NoRealRoot);
+    EXPECT_EQ(estimates[0], 1.0);
+    EXPECT_TRUE(std::isnan(variances[0]));
+    EXPECT_EQ(multi.tryGetEstimate(1).status, EstimatorStatus::NoRealRoot);
+    EXPECT_THROW(multi.getEstimate(1), std::domain_error);
+    EXPECT_EQ(multi.outputs(), 2u);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <ParallelAccumulate.h>
+#include <TimestampedEstimator.h>
+#include <vector>
+
+
+TEST(ParallelAccumulateUnitTest, MatchesSerialVWTLS) {
+    const size_t count = 10000;
+    std::vector<double> x(count), y(count), variances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 13);
+        y[i] = 3.0 * x[i] + ((i % 5) - 2.0) * 0.01;
+    }
+
+    VarianceWeightedTotalLeastSquares serial(0.0, 1.0, 0.999);
+    for (size_t i = 0; i < count; ++i) {
+        serial.update(x[i], y[i], variances[i]);
+    }
+
+    WorkStealingPool pool(4);
+    VarianceWeightedTotalLeastSquares parallel = parallelAccumulate(
+        VarianceWeightedTotalLeastSquares(0.0, 1.0, 0.999), x.data(), y.data(), variances.data(), count, pool, 333
+    );
+    EXPECT_NEAR(parallel.getEstimate(), serial.getEstimate(), 1e-10);
+    EXPECT_NEAR(parallel.getVariance(), serial.getVariance(), 1e-10);
+}
+
+TEST(ParallelAccumulateUnitTest, MatchesSerialAfterTimestamps) {
+    const size_t count = 1000;
+    std::vector<double> x(count), y(count), variances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 13);
+        y[i] = 3.0 * x[i] + ((i % 5) - 2.0) * 0.01;
+    }
+
+    // An initial estimator that has been updated by time stamp, its partials must still be aged by their updates.
+    TimestampedEstimator<VarianceWeightedTotalLeastSquares> timestamped(VarianceWeightedTotalLeastSquares(0.0, 1.0, 0.99));
+    timestamped.updateAt(0.0, 1.0, 1.0, 0.1);
+    VarianceWeightedTotalLeastSquares initial = timestamped.getEstimator();
+    VarianceWeightedTotalLeastSquares serial = initial;
+    for (size_t i = 0; i < count; ++i) {
+        serial.update(x[i], y[i], variances[i]);
+    }
+
+    WorkStealingPool pool(4);
+    VarianceWeightedTotalLeastSquares parallel = parallelAccumulate(initial, x.data(), y.data(), variances.data(), count, pool, 64);
+    EXPECT_NEAR(parallel.getEstimate(), serial.getEstimate(), 1e-10);
+    EXPECT_NEAR(parallel.getVariance(), serial.getVariance(), 1e-10);
+}
+
+TEST(ParallelAccumulateUnitTest, DeterministicAcrossThreadCounts) {
+    const size_t count = 5000;
+    std::vector<double> x(count), y(count), xVariances(count, 0.2), yVariances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 11) * 0.1;
+        y[i] = -2.0 * x[i] + ((i % 7) - 3.0) * 0.01;
+    }
+
+    DualVarianceWeightedTotalLeastSquares initial(0.0, 0.99, 1.0, 1.0, 1.0);
+    WorkStealingPool one(1);
+    WorkStealingPool many(3);
+    double single = parallelAccumulate(initial, x.data(), y.data(), xVariances.data(), yVariances.data(), count, one, 100).getEstimate();
+    double multiple = parallelAccumulate(initial, x.data(), y.data(), xVariances.data(), yVariances.data(), count, many, 100).getEstimate();
+    EXPECT_EQ(single, multiple);
+    EXPECT_NEAR(single, -2.0, 1e-2);
+}
+
+TEST(ParallelAccumulateUnitTest, InvalidBlockSize) {
+    WorkStealingPool pool(1);
+    double x = 1.0, y = 1.0, yVariance = 1.0;
+    EXPECT_THROW(parallelAccumulate(VarianceWeightedTotalLeastSquares(), &x, &y, &yVariance, 1, pool, 0), std::invalid_argument);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <ParallelTrajectory.h>
+#include <TimestampedEstimator.h>
+#include <cmath>
+#include <vector>
+
+
+TEST(ParallelTrajectoryUnitTest, MatchesSerialVWTLS) {
+    const size_t count = 5000;
+    std::vector<double> x(count), y(count), yVariances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 13);
+        y[i] = (i < count / 2 ? 3.0 : 2.0) * x[i] + ((i % 5) - 2.0) * 0.01;
+    }
+
+    WorkStealingPool pool(4);
+    std::vector<EstimatorResult> estimates(count), variances(count);
+    VarianceWeightedTotalLeastSquares final = parallelTrajectory(
+        VarianceWeightedTotalLeastSquares(0.0, 1.0, 0.99), x.data(), y.data(), yVariances.data(), count,
+        estimates.data(), variances.data(), pool, 333
+    );
+
+    VarianceWeightedTotalLeastSquares serial(0.0, 1.0, 0.99);
+    for (size_t i = 0; i < count; ++i) {
+        serial.update(x[i], y[i], yVariances[i]);
+        double estimate = serial.getEstimate();
+        double variance = serial.getVariance();
+        ASSERT_TRUE(estimates[i].ok());
+        ASSERT_NEAR(estimates[i].value, estimate, 1e-9 * std::abs(estimate));
+        ASSERT_NEAR(variances[i].value, variance, 1e-8 * std::abs(variance));
+    }
+    EXPECT_NEAR(final.getEstimate(), serial.getEstimate(), 1e-10);
+}
+
+TEST(ParallelTrajectoryUnitTest, MatchesSerialDVWTLS) {
+    const size_t count = 3000;
+    std::vector<double> x(count), y(count), xVariances(count, 0.2), yVariances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 11) * 0.1;
+        y[i] = -2.0 * x[i] + ((i % 7) - 3.0) * 0.01;
+    }
+
+    DualVarianceWeightedTotalLeastSquares initial(0.0, 0.995, 1.0, 1.0, 1.0);
+    WorkStealingPool pool(3);
+    std::vector<EstimatorResult> estimates(count);
+    parallelTrajectory(initial, x.data(), y.data(), xVariances.data(), yVariances.data(), count, estimates.data(), nullptr, pool, 256);
+
+    DualVarianceWeightedTotalLeastSquares serial = initial;
+    for (size_t i = 0; i < count; ++i) {
+        serial.update(x[i], y[i], xVariances[i], yVariances[i]);
+        ASSERT_NEAR(estimates[i].value, serial.getEstimate(), 1e-8);
+    }
+}
+
+TEST(ParallelTrajectoryUnitTest, DeterministicAcrossThreadCounts) {
+    const size_t count = 4000;
+    std::vector<double> x(count), y(count), yVariances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 13);
+        y[i] = 3.0 * x[i] + ((i % 5) - 2.0) * 0.01;
+    }
+
+    WorkStealingPool one(1);
+    WorkStealingPool many(4);
+    std::vector<EstimatorResult> single(count), multiple(count);
+    VarianceWeightedTotalLeastSquares initial(0.0, 1.0, 0.999);
+    parallelTrajectory(initial, x.data(), y.data(), yVariances.data(), count, single.data(), nullptr, one, 100);
+    parallelTrajectory(initial, x.data(), y.data(), yVariances.data(), count, multiple.data(), nullptr, many, 100);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(single[i].value, multiple[i].value);
+    }
+}
+
+TEST(ParallelTrajectoryUnitTest, MatchesSerialAfterTimestamps) {
+    const size_t count = 2000;
+    std::vector<double> x(count), y(count), yVariances(count, 0.1);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = 1.0 + (i % 13);
+        y[i] = (i < count / 2 ? 3.0 : 2.0) * x[i] + ((i % 5) - 2.0) * 0.01;
+    }
+
+    // The initial estimator has been updated by time stamp, its partials must still be aged by their updates.
+    TimestampedEstimator<VarianceWeightedTotalLeastSquares> timestamped(VarianceWeightedTotalLeastSquares(0.0, 1.0, 0.99));
+    timestamped.updateAt(0.0, 1.0, 1.0, 0.1);
+    VarianceWeightedTotalLeastSquares initial = timestamped.getEstimator();
+
+    WorkStealingPool pool(4);
+    std::vector<EstimatorResult> estimates(count), variances(count);
+    VarianceWeightedTotalLeastSquares final = parallelTrajectory(
+        initial, x.data(), y.data(), yVariances.data(), count, estimates.data(), variances.data(), pool, 128
+    );
+
+    VarianceWeightedTotalLeastSquares serial = initial;
+    for (size_t i = 0; i < count; ++i) {
+        serial.update(x[i], y[i], yVariances[i]);
+        double estimate = serial.getEstimate();
+        double variance = serial.getVariance();
+        ASSERT_NEAR(estimates[i].value, estimate, 1e-9 * std::abs(estimate));
+        ASSERT_NEAR(variances[i].value, variance, 1e-8 * std::abs(variance));
+    }
+    EXPECT_NEAR(final.getEstimate(), serial.getEstimate(), 1e-10);
+}
+
+TEST(ParallelTrajectoryUnitTest, InvalidBlockSize) {
+    WorkStealingPool pool(1);
+    double x = 1.0, y = 1.0, yVariance = 1.0;
+    EstimatorResult estimate;
+    EXPECT_THROW(
+        parallelTrajectory(VarianceWeightedTotalLeastSquares(), &x, &y, &yVariance, 1, &estimate, nullptr, pool, 0),
+        std::invalid_argument
+    );
+}
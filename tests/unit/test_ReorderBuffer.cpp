@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <ReorderBuffer.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <TimestampedEstimator.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace {
+
+// Measurements of y = 2x for two estimators at integer times, in time stamp order.
+std::vector<TimestampedRecord> inOrder(size_t count) {
+    std::vector<TimestampedRecord> records;
+    for (size_t i = 0; i < count; ++i) {
+        double x = 1.0 + (i % 7);
+        records.push_back({i % 2, static_cast<double>(i), x, 2.0 * x + 0.1 * (i % 3), 1e-2, 1e-2});
+    }
+    return records;
+}
+
+// Swap neighbours so every record is at most a couple of steps out of place, each estimator's first record stays first.
+std::vector<TimestampedRecord> jittered(std::vector<TimestampedRecord> records) {
+    for (size_t i = 2; i + 2 < records.size(); i += 3) {
+        std::swap(records[i], records[i + 2]);
+    }
+    return records;
+}
+
+}
+
+
+TEST(ReorderBufferUnitTest, SequentialReleasesInTimestampOrder) {
+    std::vector<TimestampedRecord> records = inOrder(60);
+    std::vector<VarianceWeightedTotalLeastSquares> expected(2, VarianceWeightedTotalLeastSquares(0.0, 0.9));
+    for (const TimestampedRecord& record : records) {
+        expected[record.estimatorId].update(record.x, record.y, record.yVariance);
+    }
+
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(2, VarianceWeightedTotalLeastSquares(0.0, 0.9));
+    ReorderBuffer<VarianceWeightedTotalLeastSquares> buffer(fleet.data(), fleet.size(), 3.0, 16);
+    for (const TimestampedRecord& record : jittered(records)) {
+        buffer.push(record);
+    }
+    EXPECT_GT(buffer.pending(), 0);
+    buffer.flush();
+
+    EXPECT_EQ(buffer.pending(), 0);
+    EXPECT_EQ(buffer.released(), records.size());
+    EXPECT_EQ(buffer.late(), 0);
+    EXPECT_EQ(fleet[0].getEstimate(), expected[0].getEstimate());
+    EXPECT_EQ(fleet[1].getEstimate(), expected[1].getEstimate());
+}
+
+TEST(ReorderBufferUnitTest, HoldsForTheWindow) {
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(1);
+    ReorderBuffer<VarianceWeightedTotalLeastSquares> buffer(fleet.data(), fleet.size(), 5.0, 16);
+
+    EXPECT_EQ(buffer.push({0, 10.0, 1.0, 2.0, 0.0, 1e-2}), 0);
+    EXPECT_EQ(buffer.push({0, 14.0, 1.0, 2.0, 0.0, 1e-2}), 0);
+    EXPECT_EQ(buffer.push({0, 15.0, 1.0, 2.0, 0.0, 1e-2}), 1);
+    EXPECT_EQ(buffer.advance(18.0), 0);
+    EXPECT_EQ(buffer.advance(19.0), 1);
+    EXPECT_EQ(buffer.pending(), 1);
+}
+
+TEST(ReorderBufferUnitTest, TimestampedLateSampleIsExact) {
+    typedef TimestampedEstimator<DualVarianceWeightedTotalLeastSquares> Timestamped;
+    std::vector<TimestampedRecord> records = inOrder(40);
+    std::vector<Timestamped> expected(2, Timestamped(DualVarianceWeightedTotalLeastSquares(1.0, 0.95)));
+    for (const TimestampedRecord& record : records) {
+        applyTimestampedRecord(expected[record.estimatorId], record);
+    }
+
+    // A window of 0 puts nothing back in order, every out of place record is late and goes straight to updateAt.
+    std::vector<Timestamped> fleet(2, Timestamped(DualVarianceWeightedTotalLeastSquares(1.0, 0.95)));
+    ReorderBuffer<Timestamped> buffer(fleet.data(), fleet.size(), 0.0, 16);
+    for (const TimestampedRecord& record : jittered(records)) {
+        buffer.push(record);
+    }
+    buffer.flush();
+
+    EXPECT_GT(buffer.late(), 0);
+    EXPECT_NEAR(fleet[0].getEstimate(), expected[0].getEstimate(), 1e-9);
+    EXPECT_NEAR(fleet[1].getEstimate(), expected[1].getEstimate(), 1e-9);
+}
+
+TEST(ReorderBufferUnitTest, FullBufferReleasesOldest) {
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(1, VarianceWeightedTotalLeastSquares(0.0, 1.0, 0.9));
+    ReorderBuffer<VarianceWeightedTotalLeastSquares> buffer(fleet.data(), fleet.size(), 100.0, 2);
+
+    buffer.push({0, 3.0, 3.0, 2.0, 0.0, 1e-2});
+    buffer.push({0, 1.0, 1.0, 2.0, 0.0, 1e-2});
+    EXPECT_EQ(buffer.push({0, 2.0, 2.0, 2.0, 0.0, 1e-2}), 1);
+    EXPECT_EQ(buffer.overflowed(), 1);
+    EXPECT_EQ(buffer.pending(), 2);
+
+    // Released at time 1, so time 0 is late.
+    buffer.push({0, 0.0, 0.5, 2.0, 0.0, 1e-2});
+    EXPECT_EQ(buffer.late(), 1);
+
+    // Older than everything pending, so the incoming measurement is the one released early and 1.8 is not late.
+    EXPECT_EQ(buffer.push({0, 1.5, 1.5, 2.0, 0.0, 1e-2}), 1);
+    EXPECT_EQ(buffer.push({0, 1.8, 1.8, 2.0, 0.0, 1e-2}), 1);
+    EXPECT_EQ(buffer.overflowed(), 3);
+    EXPECT_EQ(buffer.late(), 1);
+    EXPECT_EQ(buffer.pending(), 2);
+    buffer.flush();
+
+    VarianceWeightedTotalLeastSquares expected(0.0, 1.0, 0.9);
+    for (double x : {1.0, 0.5, 1.5, 1.8, 2.0, 3.0}) {
+        expected.update(x, 2.0, 1e-2);
+    }
+    EXPECT_EQ(fleet[0].getEstimate(), expected.getEstimate());
+}
+
+TEST(ReorderBufferUnitTest, RejectsBadArguments) {
+    std::vector<VarianceWeightedTotalLeastSquares> fleet(1);
+    EXPECT_THROW(ReorderBuffer<VarianceWeightedTotalLeastSquares>(fleet.data(), 1, -1.0, 4), std::invalid_argument);
+    EXPECT_THROW(ReorderBuffer<VarianceWeightedTotalLeastSquares>(fleet.data(), 1, 1.0, 0), std::invalid_argument);
+
+    ReorderBuffer<VarianceWeightedTotalLeastSquares> buffer(fleet.data(), 1, 1.0, 4);
+    EXPECT_THROW(buffer.push({1, 0.0, 1.0, 2.0, 0.0, 1e-2}), std::out_of_range);
+}
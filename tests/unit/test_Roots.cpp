@@ -295,4 +295,83 @@ INSTANTIATE_TEST_SUITE_P(
 //         }
 //     }
 //     EXPECT_LE(counter,250);
-// }
\ No newline at end of file
+// }
+
+class QuarticMethodParamTest : public ::testing::TestWithParam<QuarticMethod> {};
+
+TEST_P(QuarticMethodParamTest, FindsKnownRoots) {
+    QuarticMethod method = GetParam();
+    double roots[4];
+
+    ASSERT_EQ(calculate_real_roots(method, 1.0,10.0,35.0,50.0,24.0, roots), 4u);
+    std::vector<double> out(roots, roots + 4);
+    expect_double_in(out,-1.0,1e-8);
+    expect_double_in(out,-2.0,1e-8);
+    expect_double_in(out,-3.0,1e-8);
+    expect_double_in(out,-4.0,1e-8);
+
+    ASSERT_EQ(calculate_real_roots(method, 1.0,-6.0,17.0,-24.0,12.0, roots), 2u);
+    out.assign(roots, roots + 2);
+    expect_double_in(out,1.0,1e-8);
+    expect_double_in(out,2.0,1e-8);
+
+    EXPECT_EQ(calculate_real_roots(method, 1.0,0.0,0.0,0.0,1.0, roots), 0u);
+
+    ASSERT_EQ(calculate_real_roots(method, 1.0e10,10.0e10,35.0e10,50.0e10,24.0e10, roots), 4u);
+    out.assign(roots, roots + 4);
+    expect_double_in(out,-4.0,1e-8);
+
+    // Cubic when the leading coefficient is 0.
+    ASSERT_EQ(calculate_real_roots(method, 0.0,1.0,-6.0,11.0,-6.0, roots), 3u);
+    out.assign(roots, roots + 3);
+    expect_double_in(out,3.0,1e-8);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    QuarticMethodParamTests,
+    QuarticMethodParamTest,
+    ::testing::Values(QuarticMethod::NBS, QuarticMethod::Ferrari, QuarticMethod::FastQuartic, QuarticMethod::Companion)
+);
+
+
+TEST(QuarticMethodTest, CalibrationPicksAnAccurateMethod) {
+    const size_t count = 64;
+    std::vector<double> a(count, 1.0), b(count), c(count), d(count), e(count);
+    for (size_t i = 0; i < count; ++i) {
+        // (x - 1)(x - 2)(x - 3)(x - r)
+        double r = -5.0 + 0.17 * i;
+        b[i] = -(6.0 + r);
+        c[i] = 11.0 + 6.0 * r;
+        d[i] = -(6.0 + 11.0 * r);
+        e[i] = 6.0 * r;
+    }
+
+    QuarticCalibration calibration = calibrate_quartic_method(a.data(), b.data(), c.data(), d.data(), e.data(), count, 1e-6);
+    EXPECT_LE(calibration.maxError[static_cast<size_t>(calibration.method)], 1e-6);
+    for (size_t m = 0; m < quarticMethodCount; ++m) {
+        EXPECT_GT(calibration.nanosecondsPerSolve[m], 0.0) << toString(static_cast<QuarticMethod>(m));
+        if (calibration.maxError[m] <= 1e-6) {
+            EXPECT_GE(calibration.nanosecondsPerSolve[m], calibration.nanosecondsPerSolve[static_cast<size_t>(calibration.method)]);
+        }
+    }
+}
+
+TEST(QuarticMethodTest, AlternativesAgreeOnOneHugeRoot) {
+    // Like Poly4DegreeParamTests 8, one root dwarfs the others and the modified NBS method loses the small ones.
+    double reference[4];
+    ASSERT_EQ(calculate_real_roots(QuarticMethod::Companion, 11.7257,-7.76751e+15,3.5177e+13,7.76748e+15,-1.17257e+13, reference), 4u);
+    std::vector<double> expected(reference, reference + 4);
+    expect_double_in(expected,6.624e+14,1e+12);
+    expect_double_in(expected,-0.9985,1e-4);
+    expect_double_in(expected,0.0015,1e-4);
+    expect_double_in(expected,1.0015,1e-4);
+
+    for (QuarticMethod method : {QuarticMethod::Ferrari, QuarticMethod::FastQuartic}) {
+        double roots[4];
+        ASSERT_EQ(calculate_real_roots(method, 11.7257,-7.76751e+15,3.5177e+13,7.76748e+15,-1.17257e+13, roots), 4u) << toString(method);
+        std::vector<double> out(roots, roots + 4);
+        for (double root : expected) {
+            expect_double_in(out,root,1e-10 * std::max(1.0, std::fabs(root)));
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <SharedEstimatorBank.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+
+namespace {
+
+std::string uniqueName(const char* test) {
+    return std::string("/recursive-optimizers-") + test + "-" + std::to_string(getpid());
+}
+
+}
+
+
+TEST(SharedBankUnitTest, ReaderSeesPublishedValues) {
+    std::string name = uniqueName("publish");
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 3, VarianceWeightedTotalLeastSquares(2.0));
+    VarianceWeightedTotalLeastSquares local(2.0);
+
+    writer.update(1, 1.0, 3.0, 1e-2);
+    writer.update(1, 2.0, 5.0, 1e-2);
+    local.update(1.0, 3.0, 1e-2);
+    local.update(2.0, 5.0, 1e-2);
+    writer.publish(1);
+
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(name);
+    EXPECT_FALSE(reader.writable());
+    EXPECT_EQ(reader.size(), 3);
+    EXPECT_EQ(reader.readEstimate(1).value, local.getEstimate());
+    EXPECT_EQ(reader.readVariance(1).value, local.getVariance());
+    EXPECT_NEAR(reader.readEstimate(0).value, 2.0, 1e-8);
+
+    // The copied state computes the same thing locally.
+    VarianceWeightedTotalLeastSquares state;
+    reader.read(1, state);
+    EXPECT_EQ(state.getEstimate(), local.getEstimate());
+}
+
+TEST(SharedBankUnitTest, UnpublishedUpdatesOnlyChangeTheState) {
+    std::string name = uniqueName("unpublished");
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 1, VarianceWeightedTotalLeastSquares(2.0));
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(name);
+
+    writer.update(0, 1.0, 3.0, 1e-4);
+    EXPECT_NEAR(reader.readEstimate(0).value, 2.0, 1e-8);
+
+    VarianceWeightedTotalLeastSquares state;
+    reader.read(0, state);
+    EXPECT_NEAR(state.getEstimate(), 3.0, 1e-2);
+}
+
+TEST(SharedBankUnitTest, ReaderCanNotWrite) {
+    std::string name = uniqueName("readonly");
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 1);
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(name);
+    EXPECT_THROW(reader.update(0, 1.0, 1.0, 1.0), std::logic_error);
+    EXPECT_THROW(reader.publishAll(), std::logic_error);
+}
+
+TEST(SharedBankUnitTest, RejectsWrongEstimatorType) {
+    std::string name = uniqueName("type");
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 1);
+    EXPECT_THROW(SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> reader(name), std::invalid_argument);
+}
+
+TEST(SharedBankUnitTest, RejectsCountBeyondTheRegion) {
+    std::string name = uniqueName("truncated");
+    SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 4);
+
+    // A copy cut short keeps the header's count of 4 but only has room for fewer slots.
+    SharedMemoryRegion original(name);
+    SharedMemoryRegion truncated(name + "-short", original.size() / 2);
+    std::memcpy(truncated.data(), original.data(), truncated.size());
+    EXPECT_THROW(SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(name + "-short"), std::invalid_argument);
+}
+
+TEST(SharedBankUnitTest, MissingNameThrows) {
+    EXPECT_THROW(SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(uniqueName("missing")), std::system_error);
+}
+
+TEST(SharedBankUnitTest, WriterUnlinksOnDestruction) {
+    std::string name = uniqueName("unlink");
+    {
+        SharedEstimatorBank<VarianceWeightedTotalLeastSquares> writer(name, 1);
+    }
+    EXPECT_THROW(SharedEstimatorBank<VarianceWeightedTotalLeastSquares> reader(name), std::system_error);
+}
+
+TEST(SharedBankUnitTest, ReaderNeverSeesATornSlot) {
+    std::string name = uniqueName("torn");
+    const int updates = 5000;
+    DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+    SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> writer(name, 1, prototype);
+    SharedEstimatorBank<DualVarianceWeightedTotalLeastSquares> reader(name);
+
+    // Every state the writer passes through, a torn copy would almost surely be none of them.
+    std::set<double> states;
+    DualVarianceWeightedTotalLeastSquares local = prototype;
+    states.insert(local.tryGetEstimate().value);
+    for (int i = 0; i < updates; ++i) {
+        local.update(1.0 + i * 1e-3, 1.0 + i * 2e-3, 1e-2, 1e-2);
+        states.insert(local.tryGetEstimate().value);
+    }
+
+    std::atomic<bool> done(false);
+    std::thread producer([&]() {
+        for (int i = 0; i < updates; ++i) {
+            writer.update(0, 1.0 + i * 1e-3, 1.0 + i * 2e-3, 1e-2, 1e-2);
+        }
+        done.store(true);
+    });
+
+    size_t checked = 0;
+    while (!done.load() || checked == 0) {
+        DualVarianceWeightedTotalLeastSquares state;
+        reader.read(0, state);
+        EXPECT_EQ(states.count(state.tryGetEstimate().value), 1u);
+        ++checked;
+    }
+    producer.join();
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <StaticVarianceWeightedTotalLeastSquares.h>
+#include <StaticDualVarianceWeightedTotalLeastSquares.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <cmath>
+
+
+TEST(StaticVWTLSUnitTest, MatchesRuntimeWithNoForgetting) {
+    VarianceWeightedTotalLeastSquares runtime(0.5, 1.0, 1.0, 2.0);
+    StaticVarianceWeightedTotalLeastSquares<> fixed(0.5, 2.0);
+
+    for (int i = 1; i <= 20; ++i) {
+        double x = 0.1 * i;
+        double y = 1.7 * x + 0.01 * std::sin(i);
+        runtime.update(x, y, 0.2);
+        fixed.update(x, y, 0.2);
+    }
+
+    EXPECT_DOUBLE_EQ(fixed.getEstimate(), runtime.getEstimate());
+    EXPECT_DOUBLE_EQ(fixed.getVariance(), runtime.getVariance());
+}
+
+TEST(StaticVWTLSUnitTest, MatchesRuntimeWithConstantPolicies) {
+    VarianceWeightedTotalLeastSquares runtime(0.0, 0.5, 0.95);
+    StaticVarianceWeightedTotalLeastSquares<ConstantForgetting<95, 100>, ConstantVarianceRatio<1, 2>> fixed;
+    StaticVarianceWeightedTotalLeastSquares<RuntimeForgetting, RuntimeVarianceRatio> dynamic(
+        0.0, 1.0, RuntimeForgetting(0.95), RuntimeVarianceRatio(0.5)
+    );
+
+    for (int i = 1; i <= 20; ++i) {
+        double x = 0.3 * i;
+        double y = -2.1 * x + 0.05 * std::cos(i);
+        runtime.update(x, y, 0.5);
+        fixed.update(x, y, 0.5);
+        dynamic.update(x, y, 0.5);
+    }
+
+    EXPECT_DOUBLE_EQ(fixed.getEstimate(), runtime.getEstimate());
+    EXPECT_DOUBLE_EQ(fixed.getVariance(), runtime.getVariance());
+    EXPECT_DOUBLE_EQ(dynamic.getEstimate(), runtime.getEstimate());
+    EXPECT_DOUBLE_EQ(dynamic.getVariance(), runtime.getVariance());
+}
+
+TEST(StaticVWTLSUnitTest, ConstantPoliciesTakeNoSpace) {
+    EXPECT_EQ(sizeof(StaticVarianceWeightedTotalLeastSquares<>), 3 * sizeof(double));
+    EXPECT_EQ((sizeof(StaticVarianceWeightedTotalLeastSquares<ConstantForgetting<99, 100>, ConstantVarianceRatio<3, 1>>)), 3 * sizeof(double));
+    EXPECT_EQ(sizeof(StaticDualVarianceWeightedTotalLeastSquares<>), 6 * sizeof(double));
+    EXPECT_LT(sizeof(StaticVarianceWeightedTotalLeastSquares<>), sizeof(VarianceWeightedTotalLeastSquares));
+    EXPECT_LT(sizeof(StaticDualVarianceWeightedTotalLeastSquares<>), sizeof(DualVarianceWeightedTotalLeastSquares));
+}
+
+TEST(StaticVWTLSUnitTest, InvalidParameters) {
+    EXPECT_THROW(StaticVarianceWeightedTotalLeastSquares<>(0.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(RuntimeForgetting(1.5), std::invalid_argument);
+    EXPECT_THROW(RuntimeForgetting(0.0), std::invalid_argument);
+    EXPECT_THROW(RuntimeVarianceRatio(-1.0), std::invalid_argument);
+    EXPECT_THROW(StaticDualVarianceWeightedTotalLeastSquares<>(0.0, 0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(StaticDualVarianceWeightedTotalLeastSquares<>(0.0, 1.0, 0.0), std::invalid_argument);
+}
+
+TEST(StaticDVWTLSUnitTest, MatchesRuntimeWithFixedRatio) {
+    DualVarianceWeightedTotalLeastSquares runtime(0.5, 0.98, 10.0, 10.0, 2.0);
+    StaticDualVarianceWeightedTotalLeastSquares<ConstantForgetting<98, 100>, ConstantVarianceRatio<2, 1>> fixed(0.5, 10.0, 10.0);
+
+    for (int i = 1; i <= 20; ++i) {
+        double x = 0.2 * i;
+        double y = 3.0 * x + 0.02 * std::sin(3 * i);
+        runtime.update(x, y, 0.1, 0.3);
+        fixed.update(x, y, 0.1, 0.3);
+    }
+
+    EXPECT_NEAR(fixed.getEstimate(), runtime.getEstimate(), 1e-12);
+    EXPECT_NEAR(fixed.getVariance(), runtime.getVariance(), 1e-12);
+}
+
+TEST(StaticDVWTLSUnitTest, TryGetReportsNoRealRoot) {
+    StaticDualVarianceWeightedTotalLeastSquares<> estimator;
+    estimator.update(1, 1, 0, 1);
+
+    EXPECT_THROW(estimator.getEstimate(), std::domain_error);
+    EstimatorResult estimate = estimator.tryGetEstimate();
+    EXPECT_EQ(estimate.status, EstimatorStatus::NoRealRoot);
+    EXPECT_TRUE(std::isnan(estimate.value));
+    EXPECT_EQ(estimator.tryGetVariance().status, EstimatorStatus::NoRealRoot);
+}
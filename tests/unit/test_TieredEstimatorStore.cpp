@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <TieredEstimatorStore.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+const DualVarianceWeightedTotalLeastSquares prototype(1.0, 1.0, 1.0, 1.0, 1.0);
+
+template <typename Estimator>
+bool sameState(const Estimator& a, const Estimator& b) {
+    return std::memcmp(&a, &b, sizeof(Estimator)) == 0;
+}
+
+}
+
+
+TEST(TieredStoreUnitTest, StartsCold) {
+    TieredEstimatorStore<VarianceWeightedTotalLeastSquares> store(1000, VarianceWeightedTotalLeastSquares(2.0));
+    EXPECT_EQ(store.size(), 1000);
+    EXPECT_EQ(store.hotCount(), 0);
+    EXPECT_FALSE(store.isHot(10));
+    EXPECT_NEAR(store.peek(10).getEstimate(), 2.0, 1e-8);
+    EXPECT_FALSE(store.isHot(10));
+}
+
+TEST(TieredStoreUnitTest, UpdatePromotes) {
+    TieredEstimatorStore<VarianceWeightedTotalLeastSquares> store(10);
+    store.update(3, 1.0, 3.0, 1e-2);
+    EXPECT_TRUE(store.isHot(3));
+    EXPECT_EQ(store.hotCount(), 1);
+
+    store.getEstimate(5);
+    EXPECT_TRUE(store.isHot(5));
+    EXPECT_EQ(store.hotCount(), 2);
+}
+
+TEST(TieredStoreUnitTest, DemotionIsLossless) {
+    TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(50, prototype);
+    std::vector<DualVarianceWeightedTotalLeastSquares> plain(50, prototype);
+
+    for (int round = 0; round < 20; ++round) {
+        for (size_t i = round % 3; i < plain.size(); i += 3) {
+            store.update(i, 1.0 + round, 2.0 + round * 0.9, 1e-2, 2e-2);
+            plain[i].update(1.0 + round, 2.0 + round * 0.9, 1e-2, 2e-2);
+        }
+        store.tick();
+        store.demoteIdle(2);
+    }
+
+    for (size_t i = 0; i < plain.size(); ++i) {
+        EXPECT_TRUE(sameState(store.peek(i), plain[i]));
+        EXPECT_EQ(store.getEstimate(i).value, plain[i].tryGetEstimate().value);
+        EXPECT_EQ(store.getVariance(i).value, plain[i].tryGetVariance().value);
+    }
+}
+
+TEST(TieredStoreUnitTest, DemotionIsLosslessForUnrelatedStatistics) {
+    // Random measurements leave statistics sharing no bytes with the prototype or each other, mixed with equal ones.
+    TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(40, prototype);
+    std::vector<DualVarianceWeightedTotalLeastSquares> plain(40, prototype);
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> value(-3.0, 3.0);
+    std::uniform_real_distribution<double> variance(1e-3, 1.0);
+
+    for (int round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < plain.size(); ++i) {
+            double x = value(generator), y = value(generator);
+            double xVariance = variance(generator);
+            double yVariance = i % 2 == 0 ? xVariance : variance(generator);
+            store.update(i, x, y, xVariance, yVariance);
+            plain[i].update(x, y, xVariance, yVariance);
+        }
+        store.tick();
+        store.demoteIdle(0);
+    }
+
+    for (size_t i = 0; i < plain.size(); ++i) {
+        EXPECT_FALSE(store.isHot(i));
+        EXPECT_TRUE(sameState(store.peek(i), plain[i])) << i;
+    }
+}
+
+TEST(TieredStoreUnitTest, DemoteIdleOnlyDemotesIdle) {
+    TieredEstimatorStore<VarianceWeightedTotalLeastSquares> store(10);
+    store.update(1, 1.0, 3.0, 1e-2);
+    store.update(2, 1.0, 3.0, 1e-2);
+    store.tick();
+    store.tick();
+    store.update(2, 2.0, 6.0, 1e-2);
+
+    EXPECT_EQ(store.demoteIdle(2), 1);
+    EXPECT_FALSE(store.isHot(1));
+    EXPECT_TRUE(store.isHot(2));
+    EXPECT_NEAR(store.peek(1).getEstimate(), 3.0, 1e-2);
+}
+
+TEST(TieredStoreUnitTest, ColdIsSmallerThanHot) {
+    const size_t count = 10000;
+    TieredEstimatorStore<DualVarianceWeightedTotalLeastSquares> store(count, prototype);
+    size_t empty = store.memoryBytes();
+    EXPECT_LT(empty, count * sizeof(DualVarianceWeightedTotalLeastSquares) / 4);
+
+    for (size_t i = 0; i < count; ++i) {
+        store.update(i, 1.0, 1.5, 1e-2, 1e-2);
+    }
+    store.tick();
+    EXPECT_EQ(store.demoteIdle(1), count);
+    store.compactCold();
+    EXPECT_LT(store.memoryBytes(), count * sizeof(DualVarianceWeightedTotalLeastSquares));
+}
+
+TEST(TieredStoreUnitTest, CompactColdKeepsState) {
+    TieredEstimatorStore<VarianceWeightedTotalLeastSquares> store(100);
+    std::vector<VarianceWeightedTotalLeastSquares> plain(100);
+    for (int round = 0; round < 5; ++round) {
+        for (size_t i = 0; i < plain.size(); ++i) {
+            store.update(i, 1.0, 3.0 + round + i, 1e-2);
+            plain[i].update(1.0, 3.0 + round + i, 1e-2);
+            store.demote(i);
+        }
+    }
+    store.compactCold();
+    for (size_t i = 0; i < plain.size(); ++i) {
+        EXPECT_TRUE(sameState(store.peek(i), plain[i]));
+    }
+}
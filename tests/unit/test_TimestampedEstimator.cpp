@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <TimestampedEstimator.h>
+#include <VarianceWeightedTotalLeastSquares.h>
+#include <DualVarianceWeightedTotalLeastSquares.h>
+
+
+typedef TimestampedEstimator<VarianceWeightedTotalLeastSquares> TimestampedVWTLS;
+typedef TimestampedEstimator<DualVarianceWeightedTotalLeastSquares> TimestampedDVWTLS;
+
+
+TEST(TimestampedEstimatorUnitTest, InvalidSamplePeriod) {
+    EXPECT_THROW(TimestampedVWTLS(VarianceWeightedTotalLeastSquares(), 0.0), std::invalid_argument);
+    TimestampedDVWTLS estimator;
+    EXPECT_THROW(estimator.setSamplePeriod(-1.0), std::invalid_argument);
+}
+
+TEST(TimestampedEstimatorUnitTest, RegularTimestampsMatchUpdate) {
+    TimestampedVWTLS timed(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.95), 0.1);
+    VarianceWeightedTotalLeastSquares counted(1.0, 1.0, 0.95);
+
+    for (int i = 0; i < 50; i++) {
+        timed.updateAt(0.1 * i, 1.0 + i % 3, 2.0 + i % 5, 0.01);
+        counted.update(1.0 + i % 3, 2.0 + i % 5, 0.01);
+    }
+    EXPECT_NEAR(timed.getEstimate(), counted.getEstimate(), 1e-9);
+}
+
+TEST(TimestampedEstimatorUnitTest, RegularTimestampsMatchUpdateDVWTLS) {
+    TimestampedDVWTLS timed(DualVarianceWeightedTotalLeastSquares(1.0, 0.95), 2.0);
+    DualVarianceWeightedTotalLeastSquares counted(1.0, 0.95);
+
+    for (int i = 0; i < 50; i++) {
+        timed.updateAt(2.0 * i, 1.0 + i % 3, 2.0 + i % 5, 0.02, 0.01);
+        counted.update(1.0 + i % 3, 2.0 + i % 5, 0.02, 0.01);
+    }
+    EXPECT_NEAR(timed.getEstimate(), counted.getEstimate(), 1e-9);
+}
+
+TEST(TimestampedEstimatorUnitTest, GapForgetsByElapsedTime) {
+    TimestampedVWTLS timed(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9));
+    VarianceWeightedTotalLeastSquares counted(1.0, 1.0, 0.9);
+
+    timed.updateAt(0.0, 1.0, 1.0, 0.01);
+    counted.update(1.0, 1.0, 0.01);
+    // A drop out of ten periods ages the history like ten updates with no information.
+    timed.updateAt(10.0, 1.0, 3.0, 0.01);
+    for (int i = 0; i < 9; i++) {
+        counted.update(0.0, 0.0, 1.0);
+    }
+    counted.update(1.0, 3.0, 0.01);
+    EXPECT_NEAR(timed.getEstimate(), counted.getEstimate(), 1e-9);
+}
+
+TEST(TimestampedEstimatorUnitTest, LateTimestampIsExact) {
+    TimestampedVWTLS inOrder(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9));
+    TimestampedVWTLS late(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9));
+    double timestamps[] = {0.0, 1.5, 2.7};
+    double x[] = {1.0, 2.0, 3.0};
+    double y[] = {2.0, 3.0, 7.0};
+    double variances[] = {0.1, 0.2, 0.3};
+
+    inOrder.updateAt(timestamps, x, y, variances, 3);
+    late.updateAt(timestamps[0], x[0], y[0], variances[0]);
+    late.updateAt(timestamps[2], x[2], y[2], variances[2]);
+    late.updateAt(timestamps[1], x[1], y[1], variances[1]);
+    EXPECT_NEAR(late.getEstimate(), inOrder.getEstimate(), 1e-12);
+    EXPECT_NEAR(late.getVariance(), inOrder.getVariance(), 1e-12);
+}
+
+TEST(TimestampedEstimatorUnitTest, LateTimestampIsExactDVWTLS) {
+    TimestampedDVWTLS inOrder(DualVarianceWeightedTotalLeastSquares(1.0, 0.9, 1.0, 1.0, 1.0));
+    TimestampedDVWTLS late(DualVarianceWeightedTotalLeastSquares(1.0, 0.9, 1.0, 1.0, 1.0));
+
+    inOrder.updateAt(0.0, 1.0, 2.0, 0.1, 0.1);
+    inOrder.updateAt(0.4, 2.0, 4.1, 0.1, 0.2);
+    inOrder.updateAt(3.3, 3.0, 5.9, 0.1, 0.1);
+
+    late.updateAt(0.0, 1.0, 2.0, 0.1, 0.1);
+    late.updateAt(3.3, 3.0, 5.9, 0.1, 0.1);
+    late.updateAt(0.4, 2.0, 4.1, 0.1, 0.2);
+    EXPECT_NEAR(late.getEstimate(), inOrder.getEstimate(), 1e-12);
+}
+
+TEST(TimestampedEstimatorUnitTest, MergeIsOrderIndependent) {
+    TimestampedVWTLS serial(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9));
+    TimestampedVWTLS merged = serial;
+    TimestampedVWTLS first = serial.partial();
+    TimestampedVWTLS second = serial.partial();
+
+    serial.updateAt(0.0, 1.0, 2.0, 0.1);
+    serial.updateAt(1.5, 2.0, 3.0, 0.1);
+    serial.updateAt(4.0, 3.0, 7.0, 0.1);
+    first.updateAt(0.0, 1.0, 2.0, 0.1);
+    first.updateAt(4.0, 3.0, 7.0, 0.1);
+    second.updateAt(1.5, 2.0, 3.0, 0.1);
+
+    second.merge(first);
+    merged.merge(second);
+    EXPECT_NEAR(merged.getEstimate(), serial.getEstimate(), 1e-12);
+    EXPECT_NEAR(merged.getVariance(), serial.getVariance(), 1e-12);
+}
+
+TEST(TimestampedEstimatorUnitTest, MergePartialMatchesSerial) {
+    TimestampedDVWTLS serial(DualVarianceWeightedTotalLeastSquares(1.0, 0.9, 1.0, 1.0, 2.0));
+    TimestampedDVWTLS merged = serial;
+    serial.updateAt(0.0, 1.0, 1.0, 0.2, 0.1);
+    merged.updateAt(0.0, 1.0, 1.0, 0.2, 0.1);
+
+    // The partial is taken after a time stamped update, the history is aged to its newest time stamp.
+    TimestampedDVWTLS partial = merged.partial();
+    for (int i = 1; i <= 50; i++) {
+        serial.updateAt(0.5 * i, 1.0 + i % 3, 2.0 * (1.0 + i % 3), 0.2, 0.1);
+        partial.updateAt(0.5 * i, 1.0 + i % 3, 2.0 * (1.0 + i % 3), 0.2, 0.1);
+    }
+    merged.merge(partial);
+    EXPECT_NEAR(merged.getEstimate(), serial.getEstimate(), 1e-10);
+
+    // A partial with no updates leaves the statistics alone.
+    merged.merge(merged.partial());
+    EXPECT_NEAR(merged.getEstimate(), serial.getEstimate(), 1e-10);
+}
+
+TEST(TimestampedEstimatorUnitTest, MergeDifferentSamplePeriod) {
+    TimestampedVWTLS estimator(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9), 1.0);
+    EXPECT_THROW(estimator.merge(TimestampedVWTLS(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.9), 2.0)), std::invalid_argument);
+}
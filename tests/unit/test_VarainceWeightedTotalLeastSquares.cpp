@@ -108,4 +108,129 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(9.27450, 8.18914, 3.13302, 0.00123),
         std::make_tuple(2.78746, 1.70555, 0.66330, 450.541)
     )
-);
\ No newline at end of file
+);
+
+TEST(VWTLSUnitTest, TryGetEstimateMatchesGetEstimate) {
+    VarianceWeightedTotalLeastSquares estimator(2.0);
+    estimator.update(1.0, 3.0, 0.1);
+
+    EstimatorResult result = estimator.tryGetEstimate();
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.value, estimator.getEstimate());
+}
+
+TEST(VWTLSUnitTest, TryGetVarianceKeepsLastGoodVariance) {
+    VarianceWeightedTotalLeastSquares estimator(2.0);
+    EstimatorResult good = estimator.tryGetVariance();
+    EXPECT_TRUE(good.ok());
+
+    estimator.update(1.0, 3.0, 0.0);
+    EstimatorResult result = estimator.tryGetVariance();
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(result.value, good.value);
+}
+
+TEST(VWTLSUnitTest, TryCreateRejectsInvalidParameters) {
+    VarianceWeightedTotalLeastSquares estimator;
+    EXPECT_EQ(VarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 0.0, 1.0), EstimatorStatus::InvalidForgettingFactor);
+    EXPECT_EQ(VarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 0.0, 1.0, 1.0), EstimatorStatus::InvalidVarianceRatio);
+    EXPECT_EQ(VarianceWeightedTotalLeastSquares::tryCreate(estimator, 0.0, 1.0, 1.0, 0.0), EstimatorStatus::InvalidInitialVariance);
+    EXPECT_EQ(VarianceWeightedTotalLeastSquares::tryCreate(estimator, 4.0, 1.0, 1.0, 1.0), EstimatorStatus::Ok);
+    EXPECT_NEAR(estimator.getEstimate(), 4.0, 1e-8);
+}
+
+TEST(VWTLSUnitTest, CreateBatch) {
+    double nominal[] = {1.0, 2.0};
+    double ratios[] = {1.0, 1.0};
+    double forgettingFactors[] = {1.0, 1.0};
+    double variances[] = {1.0, -1.0};
+
+    VarianceWeightedTotalLeastSquares estimators[2];
+    EstimatorStatus statuses[2];
+    EXPECT_EQ(VarianceWeightedTotalLeastSquares::createBatch(nominal, ratios, forgettingFactors, variances, 2, estimators, statuses), 1);
+    EXPECT_EQ(statuses[0], EstimatorStatus::Ok);
+    EXPECT_EQ(statuses[1], EstimatorStatus::InvalidInitialVariance);
+}
+
+TEST(VWTLSUnitTest, MergePartialMatchesSerial) {
+    VarianceWeightedTotalLeastSquares serial(1.0, 1.0, 0.9);
+    VarianceWeightedTotalLeastSquares merged(1.0, 1.0, 0.9);
+    VarianceWeightedTotalLeastSquares first = merged.partial();
+    VarianceWeightedTotalLeastSquares second = merged.partial();
+
+    for (int i = 0; i < 20; i++) {
+        serial.update(1.0 + i, 2.0 * i, 0.1);
+        (i < 12 ? first : second).update(1.0 + i, 2.0 * i, 0.1);
+    }
+    first.merge(second, 8);
+    merged.merge(first, 20);
+    EXPECT_NEAR(merged.getEstimate(), serial.getEstimate(), 1e-12);
+    EXPECT_NEAR(merged.getVariance(), serial.getVariance(), 1e-12);
+}
+
+TEST(VWTLSUnitTest, MergeDifferentForgettingFactor) {
+    VarianceWeightedTotalLeastSquares estimator(1.0, 1.0, 0.9);
+    EXPECT_THROW(estimator.merge(VarianceWeightedTotalLeastSquares(1.0, 1.0, 0.8), 1), std::invalid_argument);
+}
+
+TEST(VWTLSUnitTest, PrecisionUpdateMatchesUpdate) {
+    VarianceWeightedTotalLeastSquares byVariance(1.0, 0.5, 0.9);
+    VarianceWeightedTotalLeastSquares byPrecision(1.0, 0.5, 0.9);
+    VarianceWeightedTotalLeastSquares byBatch(1.0, 0.5, 0.9);
+    VarianceWeightedTotalLeastSquares byPrecisionBatch(1.0, 0.5, 0.9);
+
+    double x[12], y[12], yVariance[12], yPrecision[12];
+    for (int i = 0; i < 12; i++) {
+        x[i] = 1.0 + i;
+        y[i] = 2.0 * i + 0.5;
+        yVariance[i] = 0.1 + 0.02 * i;
+        yPrecision[i] = 1 / yVariance[i];
+        byVariance.update(x[i], y[i], yVariance[i]);
+        byPrecision.updatePrecision(x[i], y[i], yPrecision[i]);
+    }
+    byBatch.update(x, y, yVariance, 12);
+    byPrecisionBatch.updatePrecision(x, y, yPrecision, 12);
+
+    double expected = byVariance.getEstimate();
+    EXPECT_NEAR(byPrecision.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byBatch.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byPrecisionBatch.getEstimate(), expected, 1e-12);
+    EXPECT_NEAR(byPrecisionBatch.getVariance(), byVariance.getVariance(), 1e-12);
+}
+
+TEST(VWTLSUnitTest, EstimateAndVarianceUsesExactHessian) {
+    const double ratioSq = 0.49;
+    VarianceWeightedTotalLeastSquares estimator(1.0, 0.7, 0.99, 10.0);
+    double c1 = 0.1, c2 = 0.1, c3 = 0.1;
+    for (int i = 0; i < 20; i++) {
+        double x = 1.0 + 0.1 * i;
+        double y = -1.5 * x + 0.01 * ((i * 7) % 5);
+        estimator.update(x, y, 0.01);
+        c1 = 0.99 * c1 + x * x / 0.01;
+        c2 = 0.99 * c2 + x * y / 0.01;
+        c3 = 0.99 * c3 + y * y / 0.01;
+    }
+
+    double estimate, variance;
+    estimator.getEstimateAndVariance(estimate, variance);
+    EXPECT_NEAR(estimate, estimator.getEstimate(), 1e-12);
+
+    // 2 / second difference of the merit function at the estimate.
+    auto merit = [&](double w) {
+        return (c1 * w * w - 2 * c2 * w + c3) / (1 + ratioSq * w * w);
+    };
+    double h = 1e-4;
+    double hessian = (merit(estimate + h) - 2 * merit(estimate) + merit(estimate - h)) / (h * h);
+    EXPECT_NEAR(variance, 2 / hessian, 1e-5 * variance);
+
+    // getVariance is the same Hessian.
+    EXPECT_NEAR(estimator.getVariance(), variance, 1e-12 * variance);
+    EXPECT_NEAR(wtls_variance(c1, c2, c3, ratioSq, estimate), variance, 1e-9 * variance);
+
+    EstimatorResult estimateResult, varianceResult;
+    estimator.tryGetEstimateAndVariance(estimateResult, varianceResult);
+    EXPECT_EQ(estimateResult.status, EstimatorStatus::Ok);
+    EXPECT_EQ(varianceResult.status, EstimatorStatus::Ok);
+    EXPECT_EQ(estimateResult.value, estimate);
+    EXPECT_EQ(varianceResult.value, variance);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <WeightedRecursiveLeastSquares.h>
+#include <MultiInputWeightedRecursiveLeastSquares.h>
+#include <cmath>
+#include <vector>
+
+
+TEST(WRLSUnitTest, MatchesWeightedLeastSquaresWithForgetting) {
+    const double forgettingFactor = 0.95;
+    WeightedRecursiveLeastSquares estimator(0.5, forgettingFactor, 4.0);
+
+    // Normal equation of sum f^(n - t) (y - w x)^2 / yVariance plus the prior, built directly.
+    double information = 1 / 4.0;
+    double weighted = 0.5 / 4.0;
+    for (int i = 0; i < 40; i++) {
+        double x = 0.5 + 0.1 * i;
+        double y = 3.0 * x + 0.1 * ((i * 5) % 7) - 0.3;
+        double yVariance = 0.01 * (1 + i % 4);
+        estimator.update(x, y, yVariance);
+        information = forgettingFactor * information + x * x / yVariance;
+        weighted = forgettingFactor * weighted + x * y / yVariance;
+    }
+
+    EXPECT_NEAR(estimator.getEstimate(), weighted / information, 1e-12);
+    EXPECT_NEAR(estimator.getVariance(), 1 / information, 1e-15);
+    EXPECT_EQ(estimator.tryGetEstimate().status, EstimatorStatus::Ok);
+    EXPECT_EQ(estimator.tryGetVariance().status, EstimatorStatus::Ok);
+}
+
+TEST(WRLSUnitTest, MultiInputMatchesNormalEquations) {
+    const double forgettingFactor = 0.98;
+    MultiInputWeightedRecursiveLeastSquares estimator(2, 1.0, forgettingFactor, 10.0);
+    MultiInputWeightedRecursiveLeastSquares single(1, 1.0, forgettingFactor, 10.0);
+    WeightedRecursiveLeastSquares scalar(1.0, forgettingFactor, 10.0);
+
+    // Normal equations of the same cost, A w = b, with the prior as the first term.
+    double a11 = 1 / 10.0, a12 = 0.0, a22 = 1 / 10.0;
+    double b1 = 1 / 10.0, b2 = 1 / 10.0;
+    for (int i = 0; i < 60; i++) {
+        double x[2] = {1.0 + 0.05 * i, std::sin(0.3 * i)};
+        double y = 2.0 * x[0] - 0.7 * x[1] + 0.01 * ((i * 3) % 5);
+        double yVariance = 0.1 * (1 + i % 2);
+        estimator.update(x, y, yVariance);
+        single.update(x, y, yVariance);
+        scalar.update(x[0], y, yVariance);
+
+        a11 = forgettingFactor * a11 + x[0] * x[0] / yVariance;
+        a12 = forgettingFactor * a12 + x[0] * x[1] / yVariance;
+        a22 = forgettingFactor * a22 + x[1] * x[1] / yVariance;
+        b1 = forgettingFactor * b1 + x[0] * y / yVariance;
+        b2 = forgettingFactor * b2 + x[1] * y / yVariance;
+    }
+
+    double determinant = a11 * a22 - a12 * a12;
+    EXPECT_NEAR(estimator.getEstimate(0), (a22 * b1 - a12 * b2) / determinant, 1e-9);
+    EXPECT_NEAR(estimator.getEstimate(1), (a11 * b2 - a12 * b1) / determinant, 1e-9);
+    EXPECT_NEAR(estimator.getVariance(0), a22 / determinant, 1e-9);
+    EXPECT_NEAR(estimator.getVariance(1), a11 / determinant, 1e-9);
+
+    std::vector<double> covariance(4);
+    estimator.getCovariance(covariance.data());
+    EXPECT_NEAR(covariance[1], -a12 / determinant, 1e-9);
+    EXPECT_NEAR(covariance[1], covariance[2], 1e-15);
+
+    // One input is the scalar estimator.
+    EXPECT_NEAR(single.getEstimate(0), scalar.getEstimate(), 1e-9);
+    EXPECT_NEAR(single.getVariance(0), scalar.getVariance(), 1e-12);
+    EXPECT_EQ(single.tryGetVariance(0).status, EstimatorStatus::Ok);
+}
+
+TEST(WRLSUnitTest, BatchMatchesScalar) {
+    const size_t count = 19;
+    std::vector<WeightedRecursiveLeastSquares> estimators;
+    std::vector<double> forgettingFactor(count), c1(count), c2(count);
+    for (size_t i = 0; i < count; ++i) {
+        forgettingFactor[i] = 1.0 - 0.01 * i;
+        estimators.emplace_back(0.0, forgettingFactor[i], 1.0);
+        c1[i] = 1.0;
+        c2[i] = 0.0;
+    }
+
+    std::vector<double> x(count), y(count), yPrecision(count);
+    for (int m = 0; m < 20; m++) {
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = 1.0 + 0.1 * m;
+            y[i] = (0.5 + 0.1 * i) * x[i] + 0.01 * ((m + i) % 3);
+            yPrecision[i] = 10.0 + m % 4;
+            estimators[i].updatePrecision(x[i], y[i], yPrecision[i]);
+        }
+        wrls_update_batch(forgettingFactor.data(), c1.data(), c2.data(), x.data(), y.data(), yPrecision.data(), count);
+    }
+
+    std::vector<double> estimates(count), variances(count);
+    wrls_estimate_batch(c1.data(), c2.data(), count, estimates.data(), variances.data());
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_NEAR(estimates[i], estimators[i].getEstimate(), 1e-12) << i;
+        EXPECT_NEAR(variances[i], estimators[i].getVariance(), 1e-15) << i;
+    }
+}
+
+TEST(WRLSUnitTest, InvalidParameters) {
+    EXPECT_THROW(WeightedRecursiveLeastSquares(0.0, 1.5), std::invalid_argument);
+    EXPECT_THROW(WeightedRecursiveLeastSquares(0.0, 1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(MultiInputWeightedRecursiveLeastSquares(0), std::invalid_argument);
+    EXPECT_THROW(MultiInputWeightedRecursiveLeastSquares(2, 0.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(MultiInputWeightedRecursiveLeastSquares(2, 0.0, 1.0, -1.0), std::invalid_argument);
+
+    WeightedRecursiveLeastSquares estimator;
+    EXPECT_EQ(WeightedRecursiveLeastSquares::tryCreate(estimator, 0.0, 0.0, 1.0), EstimatorStatus::InvalidForgettingFactor);
+    EXPECT_EQ(WeightedRecursiveLeastSquares::tryCreate(estimator, 0.0, 1.0, 0.0), EstimatorStatus::InvalidInitialVariance);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <helper/WorkStealingPool.h>
+#include <helper/numa.h>
+#include <atomic>
+#include <stdexcept>
+
+
+TEST(WorkStealingPoolUnitTest, NumaOrderCoversAllowedCpus) {
+    std::vector<int> nodes;
+    std::vector<int> cpus = numa_cpu_order(&nodes);
+    EXPECT_FALSE(cpus.empty());
+    EXPECT_EQ(cpus.size(), nodes.size());
+}
+
+TEST(WorkStealingPoolUnitTest, VisitsEveryIndexOnce) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::vector<std::atomic<int>> visits(10007);
+    for (std::atomic<int>& visit : visits) {
+        visit = 0;
+    }
+
+    pool.parallelFor(visits.size(), 13, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            visits[i]++;
+        }
+    });
+
+    for (std::atomic<int>& visit : visits) {
+        EXPECT_EQ(visit.load(), 1);
+    }
+}
+
+TEST(WorkStealingPoolUnitTest, ReusableAcrossLoops) {
+    WorkStealingPool pool(3, true);
+    std::atomic<size_t> total(0);
+    for (int loop = 0; loop < 50; ++loop) {
+        pool.parallelFor(1000, 7, [&](size_t begin, size_t end) {
+            total += end - begin;
+        });
+    }
+    EXPECT_EQ(total.load(), 50000);
+}
+
+TEST(WorkStealingPoolUnitTest, RethrowsTaskException) {
+    WorkStealingPool pool(2);
+    EXPECT_THROW(
+        pool.parallelFor(100, 1, [](size_t begin, size_t) {
+            if (begin == 42) {
+                throw std::runtime_error("fail");
+            }
+        }),
+        std::runtime_error
+    );
+}